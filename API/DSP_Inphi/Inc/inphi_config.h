@@ -76,6 +76,29 @@
 // can be set to 0.
 #define INPHI_HAS_INBPIF_READ_POLLING  1
 
+// Set to 1 if the platform implements spica_reg_set_burst(), the
+// inbound PIF writes of a f/w download are then sent as bursts of
+// data to the same register instead of one register write each.
+#define INPHI_HAS_REG_BURST_WRITE      1
+
+// Set to 1 if the platform implements spica_crc32(), the blocks of
+// compressed f/w images are then checked against their CRC-32.
+#define INPHI_HAS_HW_CRC32             1
+
+// Set to 1 if the platform implements spica_boot_mark(), the API
+// then reports the start and end of each phase of the bring-up.
+#define INPHI_HAS_BOOT_PROFILE         1
+
+// Set to 1 if the platform implements spica_event_wait(), the API
+// then sleeps on the DSP interrupt instead of fixed delays while it
+// waits for the mailbox, a link or an algorithm.
+#define INPHI_HAS_EVENT_WAIT           1
+
+// Set to 1 if the platform implements spica_timestamp_ms(), the
+// resumable histogram capture then times its waits for the FW instead
+// of counting its polls.
+#define INPHI_HAS_TIMESTAMP            1
+
 #define INPHI_HAS_LOG_NOTE 0    // Modify define follow Inphi document "Normal production driver", Lance 20201004.
 #define INPHI_HAS_LOG_WARN 0    // Modify define follow Inphi document "Normal production driver", Lance 20201004.
 #define INPHI_HAS_LOG_CRIT 0    // Modify define follow Inphi document "Normal production driver", Lance 20201004.
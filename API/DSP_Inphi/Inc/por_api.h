@@ -285,6 +285,40 @@ void por_package_cache_clear(void);
  */
 void por_package_cache_dump(void);
 
+/**
+ * This method is called to load the package type cache with a
+ * package type discovered earlier and kept by the host, typically
+ * in flash, so that por_package_get_type() and por_init() do not
+ * power up and fetch the EFUSE again. Only use it when the device
+ * is known to be the one the package type was read from, see
+ * por_package_device_id_query().
+ *
+ * @param package [I] - The package type returned by
+ *                      por_package_get_type() on that device.
+ *
+ * @since 1.2.0.929
+ */
+void por_package_cache_set(
+    e_por_package_type package);
+
+/**
+ * This method is used to read the device identification of the
+ * ASIC (MMD30 DEVICE_ID registers: OUI, model number and revision).
+ * It does not depend on the EFUSE.
+ *
+ * @param die       [I] - The ASIC die being accessed.
+ * @param device_id [O] - DEVICE_ID_HIGH in the upper 16 bits and
+ *                        DEVICE_ID_LOW in the lower 16 bits.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR when the device does
+ *         not answer.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_package_device_id_query(
+    uint32_t  die,
+    uint32_t* device_id);
+
 
 /**
  * @h2 Register Access Methods
@@ -343,6 +377,167 @@ inphi_status_t spica_reg_set(
     uint32_t addr,
     uint32_t data);
 
+#if defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+/**
+ * @brief
+ * Burst register set function, must be implemented by the end
+ * user when INPHI_HAS_REG_BURST_WRITE is set. It writes every
+ * 16 bit value of data to the same register, in order, in as
+ * few bus transactions as the interface allows. This is used
+ * for the inbound PIF data register while the MCU burst mode
+ * (MCU_MDIO_CFG) is enabled.
+ *
+ * NOTE: Do not use spica_reg_set_burst directly in your code.
+ *
+ * @param die      [I] - The ASIC die being accessed.
+ * @param addr     [I] - The address of the register being
+ *                       accessed.
+ * @param data     [I] - The data to write to the register.
+ * @param num_data [I] - The number of 16 bit values in data.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_reg_set_burst(
+    uint32_t        die,
+    uint32_t        addr,
+    const uint16_t* data,
+    uint32_t        num_data);
+#endif // defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+
+#if defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+/**
+ * @brief
+ * CRC-32 function, must be implemented by the end user when
+ * INPHI_HAS_HW_CRC32 is set, typically on a CRC unit of the
+ * host. It is the usual CRC-32 (polynomial 0x04C11DB7,
+ * reflected, initial value and final XOR 0xFFFFFFFF) of the
+ * words taken as little endian bytes.
+ *
+ * @param crc       [I] - The CRC-32 of the data before words,
+ *                        0 to start a new calculation.
+ * @param words     [I] - The data.
+ * @param num_words [I] - The number of 32 bit words in data.
+ *
+ * @return The CRC-32 of the data up to the end of words.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_crc32(
+    uint32_t        crc,
+    const uint32_t* words,
+    uint32_t        num_words);
+#endif // defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+
+/**
+ * Phases of the bring-up reported to spica_boot_mark()
+ */
+typedef enum
+{
+    /** por_init() or por_init_start() until done */
+    POR_BOOT_PHASE_INIT       = 0,
+    /** Waiting for the bootloader after the global reset is released */
+    POR_BOOT_PHASE_BOOTLOADER = 1,
+    /** EFUSE fetch to discover the package type */
+    POR_BOOT_PHASE_EFUSE      = 2,
+    /** Waiting for the MCU to run the application firmware */
+    POR_BOOT_PHASE_APP_MODE   = 3,
+    /** Top level chip init request until the FW acks it */
+    POR_BOOT_PHASE_CHIP_INIT  = 4,
+    /** por_enter_operational_state() or its _start() until done */
+    POR_BOOT_PHASE_ENTER_OP   = 5,
+    /** Writing the rules to the overlays */
+    POR_BOOT_PHASE_RULES      = 6,
+    /** Update all rules request until the FW acks it */
+    POR_BOOT_PHASE_RULES_ACK  = 7,
+    /** MCU reset and IRAM/DRAM init ahead of a direct download */
+    POR_BOOT_PHASE_RAM_INIT   = 8,
+    /** Programming the blocks of a direct download */
+    POR_BOOT_PHASE_DOWNLOAD   = 9,
+    /** Reading programmed blocks back */
+    POR_BOOT_PHASE_VERIFY     = 10,
+
+    POR_BOOT_PHASE_NUM        = 11
+}e_por_boot_phase;
+
+#if defined(INPHI_HAS_BOOT_PROFILE) && (INPHI_HAS_BOOT_PROFILE==1)
+/**
+ * @brief
+ * Boot profiling hook, must be implemented by the end user when
+ * INPHI_HAS_BOOT_PROFILE is set. The API calls it when a phase of
+ * the bring-up starts and when it ends. A phase may span several
+ * calls of a resumable method, and a phase abandoned on an error
+ * is not always ended.
+ *
+ * @param die   [I] - The ASIC die being accessed.
+ * @param phase [I] - The phase, see e_por_boot_phase.
+ * @param enter [I] - true when the phase starts, false when it ends.
+ *
+ * @since 1.2.0.929
+ */
+void spica_boot_mark(
+    uint32_t die,
+    uint32_t phase,
+    bool     enter);
+#endif // defined(INPHI_HAS_BOOT_PROFILE) && (INPHI_HAS_BOOT_PROFILE==1)
+
+/**
+ * Events the API waits for, see spica_event_wait()
+ */
+typedef enum
+{
+    /** Mailbox or msg2 buffer activity from the FW */
+    POR_EVENT_MBOX = 1,
+    /** Link state change of an interface */
+    POR_EVENT_LINK = 2,
+    /** FW algorithm request or status change */
+    POR_EVENT_ALG  = 4
+}e_por_event;
+
+#if defined(INPHI_HAS_EVENT_WAIT) && (INPHI_HAS_EVENT_WAIT==1)
+/**
+ * @brief
+ * Event wait hook, must be implemented by the end user when
+ * INPHI_HAS_EVENT_WAIT is set. The API calls it instead of a fixed
+ * delay between two polls of a condition. It may return as soon as
+ * the DSP signals one of the events, the API then checks its
+ * condition again, so an early or spurious return is harmless.
+ * The time returned is added up against the timeouts of the API,
+ * it must be the time actually spent.
+ *
+ * @param die    [I] - The ASIC die being accessed.
+ * @param events [I] - The events that may end the wait, see e_por_event.
+ * @param msecs  [I] - The longest time to wait.
+ *
+ * @return The time waited in micro-seconds, at most msecs*1000.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_event_wait(
+    uint32_t die,
+    uint32_t events,
+    uint32_t msecs);
+#endif // defined(INPHI_HAS_EVENT_WAIT) && (INPHI_HAS_EVENT_WAIT==1)
+
+#if defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+/**
+ * @brief
+ * Timestamp hook, must be implemented by the end user when
+ * INPHI_HAS_TIMESTAMP is set. The methods that return to the caller
+ * between two polls of the FW, such as por_lrx_dsp_hist_resume(),
+ * time their waits against it.
+ *
+ * @param die [I] - The ASIC die being accessed.
+ *
+ * @return A free running count of milli-seconds, it may wrap.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_timestamp_ms(
+    uint32_t die);
+#endif // defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+
 #if 0
 /**
  * This method is called to manage re-mapping the channel based on
@@ -702,6 +897,128 @@ inphi_status_t por_mcu_download_firmware_from_external_memory(
     bool     verify,
     void*    user_data);
 
+/**
+ * Source of a firmware image read a chunk at a time, for images that
+ * are not in the host address space or should not be copied to RAM
+ * whole (external SPI/QSPI flash, DMA from the host flash).
+ */
+typedef struct
+{
+    /**
+     * Start reading num_words 32b words of the image, from word offset,
+     * into buf. The read may complete in the background, buf is only
+     * used once read_wait returned.
+     */
+    inphi_status_t (*read_start)(uint32_t offset, uint32_t* buf, uint32_t num_words, void* user_data);
+    /** Wait for the read started last, NULL if read_start completes the read */
+    inphi_status_t (*read_wait)(void* user_data);
+    /** Passed back to the callbacks */
+    void* user_data;
+} por_fw_source_t;
+
+/**
+ * This method is called to download the firmware directly
+ * to the MCUs RAM memory, reading the image from a source a
+ * chunk at a time. Only two chunks of 32 words are kept in
+ * RAM whatever the size of the image; the next chunk is
+ * requested before the current one is programmed, so a
+ * source that reads in the background (DMA) overlaps the
+ * register writes.
+ *
+ * It will program the microcode, jump to the new application
+ * image and verify it is running properly.
+ *
+ * @param die       [I] - The die used to identify which ASIC
+ *                        is being accessed.
+ * @param source    [I] - The image source.
+ * @param fw_length [I] - The length of the firmware image
+ *                        in 32 bit words.
+ * @param verify    [I] - Optionally read back the programmed values
+ *                        to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_download_firmware_from_source(
+    uint32_t die,
+    const por_fw_source_t* source,
+    uint32_t fw_length,
+    bool     verify);
+
+/**
+ * This method is called to download a compressed firmware
+ * image directly to the MCUs RAM memory instead of booting
+ * from EEPROM, typically an image kept in the host MCU flash.
+ * It will program the microcode, jump to the new application
+ * image and verify it is running properly.
+ *
+ * The image is decompressed a few words at a time while it is
+ * programmed, using a small fixed buffer and a 4KB history
+ * window. See spica_mcu_download_firmware_lz() for the format.
+ * Images carrying per block CRC-32 values are checked block by
+ * block as they are programmed.
+ *
+ * @param die       [I] - The die used to identify which ASIC
+ *                        is being accessed.
+ * @param lz_image  [I] - The compressed firmware image.
+ * @param lz_length [I] - The length of the compressed image
+ *                        in bytes.
+ * @param verify    [I] - Optionally read back the programmed values
+ *                        to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_download_firmware_lz(
+    uint32_t       die,
+    const uint8_t* lz_image,
+    uint32_t       lz_length,
+    bool           verify);
+
+/**
+ * This method is called to program the same application firmware
+ * into several dies at once and start it on all of them. Each
+ * block of the image is written once per broadcast handle (the
+ * platform fans the writes of a handle out to the dies behind it,
+ * one handle per bus), or to each die in turn when no broadcast
+ * handle is given. All MCUs are released before waiting for
+ * application mode, so the boot time of the writes stays flat as
+ * the die count grows.
+ *
+ * Verification is serial: reads cannot be broadcast, so each block
+ * is read back from one die after the other right after it is
+ * written, and the verify time grows with the die count.
+ *
+ * @param dies         [I] - The ASIC dies to program.
+ * @param num_dies     [I] - The number of entries in dies.
+ * @param bcast_dies   [I] - The broadcast handles reaching the dies,
+ *                           may be NULL.
+ * @param num_bcast    [I] - The number of entries in bcast_dies.
+ * @param image        [I] - The uncompressed firmware image.
+ * @param image_length [I] - The length of the image in 32b words.
+ * @param verify       [I] - Optionally read back the programmed values
+ *                           from every die to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ * The API must have direct download support. It must be
+ * compiled with the following flags set to 1:
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_download_firmware_multi(
+    const uint32_t* dies,
+    uint32_t        num_dies,
+    const uint32_t* bcast_dies,
+    uint32_t        num_bcast,
+    const uint32_t* image,
+    uint32_t        image_length,
+    bool            verify);
+
 /**
  * This method is called to download the firmware directly
  * to the MCUs RAM memory instead of booting from EEPROM.
@@ -961,6 +1278,73 @@ inphi_status_t por_mcu_check_boot_from_eeprom_complete(
     bool*    complete,
     bool*    abort_polling);
 
+/**
+ * Most dies booted from one shared EEPROM by por_mcu_shared_boot_start()
+ */
+#define POR_SHARED_BOOT_MAX_DIES 8
+
+/**
+ * State of a boot of several dies from a shared EEPROM. The caller owns
+ * the storage; latency may be read once the boot is done, the other
+ * fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t dies[POR_SHARED_BOOT_MAX_DIES];
+    uint32_t num_dies;
+    uint32_t current;
+    uint32_t elapsed;
+    uint32_t expected;
+    /** Resume calls (about 1ms each) every die took to boot, in dies[] order */
+    uint32_t latency[POR_SHARED_BOOT_MAX_DIES];
+} por_shared_boot_ctx_t;
+
+/**
+ * This method starts booting several dies from one shared EEPROM and
+ * returns without waiting, the non-blocking form of
+ * por_mcu_boot_from_shared_eeprom(). The bootloader is programmed into
+ * every die up front with all of them held as SPI slaves, then the
+ * first die is given the SPI bus. por_mcu_shared_boot_resume() must
+ * then be called about once per millisecond until done.
+ *
+ * @param ctx      [O] - The boot state.
+ * @param dies     [I] - The dies sharing the EEPROM, in boot order.
+ * @param num_dies [I] - The number of dies, at most POR_SHARED_BOOT_MAX_DIES.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ *     INPHI_HAS_SHARED_EEPROM must be defined when compiling or in inphi_config.h
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_shared_boot_start(
+    por_shared_boot_ctx_t* ctx,
+    const uint32_t* dies,
+    uint32_t num_dies);
+
+/**
+ * This method advances a boot started by por_mcu_shared_boot_start().
+ * The die on the SPI bus is only polled once most of the time the
+ * previous die took has gone by, and the next die is given the bus in
+ * the same call the previous one reaches application mode. The boot
+ * latency of every die is left in ctx->latency.
+ *
+ * @param ctx  [I/O] - The boot state.
+ * @param done [O]   - Set to true once every die is in application mode.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or if a die took
+ *         more than 3000 calls.
+ *
+ * @requires
+ *     INPHI_HAS_SHARED_EEPROM must be defined when compiling or in inphi_config.h
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_shared_boot_resume(
+    por_shared_boot_ctx_t* ctx,
+    bool* done);
+
 #endif // defined(INPHI_HAS_SHARED_EEPROM) && (INPHI_HAS_SHARED_EEPROM==1)
 
 #endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
@@ -1106,6 +1490,161 @@ inphi_status_t por_enter_operational_state(
     uint32_t die,
     por_rules_t* rules);
 
+/**
+ * State of a resumable por_init()/por_enter_operational_state(). The
+ * caller owns the storage, the fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t bundle_idx;
+    uint32_t step;
+    uint32_t package_type;
+    uint32_t fw_dwld_timeout;
+    uint32_t polls;
+} por_init_ctx_t;
+
+/**
+ * Start resetting the device without blocking. This performs the same
+ * init as por_init() but the FW handshakes (bootloader, application mode,
+ * chip init ack) are polled one at a time by por_init_resume() instead of
+ * being waited for.
+ *
+ * por_init_resume() counts its timeouts in calls and is meant to be
+ * called about once per millisecond, which gives the same limits as
+ * por_init().
+ *
+ * @param ctx   [O] - The init state.
+ * @param die   [I] - The physical ASIC die being accessed.
+ * @param rules [I] - The device initialization rules, only read by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_init_start(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules);
+
+/**
+ * Advance an init started with por_init_start() by at most one
+ * register handshake.
+ *
+ * @param ctx  [I/O] - The init state.
+ * @param done [O]   - Set to true once the init has completed.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or timeout.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_init_resume(
+    por_init_ctx_t* ctx,
+    bool* done);
+
+/**
+ * Send the rules to the device without waiting for the FW to pick them
+ * up, the acks are polled by por_enter_operational_state_resume(). This
+ * MUST be preceded by a completed init.
+ *
+ * @param ctx   [O] - The operational state request.
+ * @param die   [I] - The physical ASIC die being accessed.
+ * @param rules [I] - The device initialization rules, only read by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_enter_operational_state_start(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules);
+
+/**
+ * Advance a request started with por_enter_operational_state_start() by
+ * at most one register handshake.
+ *
+ * @param ctx  [I/O] - The operational state request.
+ * @param done [O]   - Set to true once the device is operational.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or timeout.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_enter_operational_state_resume(
+    por_init_ctx_t* ctx,
+    bool* done);
+
+/**
+ * A register write kept in a configuration snapshot
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint16_t data;
+    uint8_t  die;
+    uint8_t  reserved;
+} por_reg_pair_t;
+
+/**
+ * Configuration snapshot, the register writes made by the rules. The
+ * caller owns the storage for the pairs.
+ */
+typedef struct
+{
+    /** Storage for the pairs */
+    por_reg_pair_t* pairs;
+    /** Number of entries in pairs */
+    uint32_t        max_pairs;
+    /** Number of pairs captured */
+    uint32_t        num_pairs;
+    /** Set when more registers were written than pairs can hold */
+    bool            overflow;
+} por_config_snapshot_t;
+
+/**
+ * Send the rules to the device like por_enter_operational_state_start()
+ * and record the final value of every register written in a snapshot.
+ * After a DSP reset and a completed init, por_enter_operational_state_replay()
+ * writes the snapshot back instead of running the rules again: plain
+ * writes, no read/modify/write. The snapshot is only valid for the same
+ * rules and FW version.
+ *
+ * @param ctx   [O]   - The operational state request.
+ * @param die   [I]   - The physical ASIC die being accessed.
+ * @param rules [I]   - The device initialization rules, only read by this call.
+ * @param snap  [I/O] - The snapshot, pairs and max_pairs set by the caller.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure. Running out of
+ *         pairs is not a failure, it sets snap->overflow.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_enter_operational_state_capture(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules,
+    por_config_snapshot_t* snap);
+
+/**
+ * Write a snapshot taken by por_enter_operational_state_capture() back
+ * to the device, the acks are polled by por_enter_operational_state_resume().
+ * This MUST be preceded by a completed init.
+ *
+ * @param ctx  [O] - The operational state request.
+ * @param die  [I] - The physical ASIC die being accessed.
+ * @param snap [I] - The snapshot.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or if the
+ *         snapshot is incomplete.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_enter_operational_state_replay(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    const por_config_snapshot_t* snap);
+
 
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
 /**
@@ -1212,6 +1751,69 @@ inphi_status_t por_tx_squelch(
     e_por_intf intf,
     bool       squelch);
 
+/**
+ * Upper bound on the number of lanes handled by por_tx_squelch_lanes().
+ */
+#define POR_TX_SQUELCH_MAX_LANES 16
+
+/**
+ * Squelch register addresses of all the channels of a TX interface, resolved
+ * once by por_tx_squelch_map_init(). The caller owns the storage, the fields
+ * are private to the API.
+ */
+typedef struct
+{
+    uint32_t num_lanes;
+    uint32_t die[POR_TX_SQUELCH_MAX_LANES];
+    uint32_t addr[POR_TX_SQUELCH_MAX_LANES];
+    bool     bcast_ok;
+    uint32_t bcast_die;
+    uint32_t bcast_addr;
+    uint32_t squelched;
+} por_tx_squelch_map_t;
+
+/**
+ * Resolve the squelch register of every channel of a TX interface and read
+ * back the current squelch state, for use by por_tx_squelch_lanes(). Call
+ * again after the ASIC has been re-initialized.
+ *
+ * @param map     [O] - The resolved map.
+ * @param die     [I] - The physical ASIC die being accessed.
+ * @param intf    [I] - The TX interface (POR_INTF_LTX or POR_INTF_HTX)
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_tx_squelch_map_init(
+    por_tx_squelch_map_t* map,
+    uint32_t              die,
+    e_por_intf            intf);
+
+/**
+ * Squelch or unsquelch a set of lanes with the minimum number of register
+ * writes. Lanes already in the requested state are not written, the channel
+ * re-mapping and the read/modify/write of por_tx_squelch() are skipped, and
+ * when all the lanes of the die end up in the same state a single broadcast
+ * write is used.
+ *
+ * The map tracks the state last written, so every change to the squelch
+ * of these lanes must go through this method (or be followed by
+ * por_tx_squelch_map_init()).
+ *
+ * @param map          [I/O] - Map from por_tx_squelch_map_init().
+ * @param lane_mask    [I] - Lanes to update, bit 0 is the first channel of the interface.
+ * @param squelch_mask [I] - Lanes of lane_mask to squelch, the others are unsquelched.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_tx_squelch_lanes(
+    por_tx_squelch_map_t* map,
+    uint32_t              lane_mask,
+    uint32_t              squelch_mask);
+
 /**
  * This method may be called to enable or disable the squelch lock for the
  * output transmitter
@@ -1528,6 +2130,23 @@ inphi_status_t por_mcu_fw_mode_query(
     uint32_t die,
     e_por_fw_mode *mode);
 
+/**
+ * Forget the FW state cached for messaging on a die.
+ *
+ * The API checks the FW mode once rather than before every message, and
+ * reads the addresses and lengths of the FW message buffers once, only
+ * their indexes per message afterwards. It drops this state itself when it
+ * resets the MCU, waits for the application to start, finds the MCU out of
+ * application mode or a message fails; call this after resetting the DSP
+ * by other means.
+ *
+ * @param die [I] - The physical ASIC being accessed.
+ *
+ * @since 1.2.0.929
+ */
+void por_mcu_msg2_cache_invalidate(
+    uint32_t die);
+
 /**
  * This method fetches a trace of the program counter for debug
  * purposes.
@@ -1661,6 +2280,26 @@ inphi_status_t por_version_firmware(
     char*    buffer,
     uint32_t buffer_len);
 
+/**
+ * @brief
+ * This method is used to retrieve the version of the application
+ * firmware running as a number, to check it against an expected
+ * version without parsing the por_version_firmware() string.
+ *
+ * @param die     [I] - The ASIC die being accessed.
+ * @param version [O] - Major.minor.revision (FIRMWARE_REV1_OVL) in
+ *                      the upper 16 bits, build (FIRMWARE_REV0_OVL)
+ *                      in the lower 16 bits.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR when the firmware is
+ *         not in application mode.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_mcu_fw_version_query(
+    uint32_t  die,
+    uint32_t* version);
+
 
 /**
  * @h2 Link Status
@@ -2807,6 +3446,88 @@ inphi_status_t por_spi_write_data_block(
 inphi_status_t por_spi_eeprom_erase(
     uint32_t die);
 
+/**
+ * Number of 32 bit words accepted by one por_spi_eeprom_stream_write
+ * call. Segments aligned to this size never cross an EEPROM page.
+ */
+#define POR_SPI_EEPROM_SEGMENT_WORDS 32
+
+/**
+ * Time the EEPROM needs to finish its internal write cycle after
+ * each streamed segment, units are milli-seconds.
+ */
+#define POR_SPI_EEPROM_WRITE_CYCLE_MS 10
+
+/**
+ * This method prepares the device for streaming an image into the
+ * external EEPROM a segment at a time, for callers that do not have
+ * the whole image in memory or on a file system. The MCU(s) are
+ * stalled and the SPI master is configured once for the stream.
+ *
+ * @param die    [I] - The physical ASIC die being accessed.
+ * @param clkdiv [I] - The SPI clock divide ratio.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must be have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t por_spi_eeprom_stream_begin(
+    uint32_t          die,
+    e_por_spi_clk_div clkdiv);
+
+/**
+ * This method writes one segment of an EEPROM stream. It returns as
+ * soon as the data has been shifted out; the caller must let
+ * POR_SPI_EEPROM_WRITE_CYCLE_MS elapse before the next segment or
+ * before calling por_spi_eeprom_stream_end.
+ *
+ * @param die         [I] - The physical ASIC die being accessed.
+ * @param eeprom_addr [I] - The EEPROM byte address to write to.
+ * @param words       [I] - The 32 bit words to write, not byte swapped.
+ * @param num_words   [I] - The number of words, 1 to
+ *                          POR_SPI_EEPROM_SEGMENT_WORDS, not crossing
+ *                          an EEPROM page boundary.
+ * @param clkdiv      [I] - The SPI clock divide ratio.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must be have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t por_spi_eeprom_stream_write(
+    uint32_t          die,
+    uint32_t          eeprom_addr,
+    const uint32_t    *words,
+    uint32_t          num_words,
+    e_por_spi_clk_div clkdiv);
+
+/**
+ * This method ends an EEPROM stream, resetting the SPI block and
+ * releasing the MCU(s) from stall.
+ *
+ * @param die [I] - The physical ASIC die being accessed.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must be have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t por_spi_eeprom_stream_end(
+    uint32_t die);
+
 #endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
 
 /**
@@ -3068,6 +3789,105 @@ inphi_status_t por_lrx_dsp_get_histogram(
     uint32_t channel,
     uint32_t *hist_data);
 
+/**
+ * State of a resumable LRX histogram capture. The caller owns the
+ * storage, the fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t channel;
+    uint32_t intf;
+    bool     active;
+    bool     is_nrz;
+    bool     step_running;
+    uint32_t step;
+    uint32_t num_steps;
+    uint32_t polls;
+    uint32_t first_slice;
+    uint32_t num_slices;
+    uint32_t sem_state;
+    uint32_t sem_stamp;
+    uint32_t amp_locs[16*4];
+} por_lrx_hist_ctx_t;
+
+/**
+ * Start capturing the LRX DSP histogram without blocking. This captures
+ * the same data as por_lrx_dsp_get_histogram() but the SNR estimation
+ * steps are run one at a time by por_lrx_dsp_hist_resume(), so the
+ * caller can keep servicing other work while the capture runs.
+ *
+ * @param ctx        [O] - The capture state.
+ * @param die        [I] - The ASIC die being accessed.
+ * @param channel    [I] - The channel through the device to query.
+ * @param hist_data  [O] - Array of exactly [16x256] entries of uint32_t,
+ *                         cleared by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_lrx_dsp_hist_start(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t die,
+    uint32_t channel,
+    uint32_t *hist_data);
+
+/**
+ * Start capturing one track and hold slice of the LRX DSP histogram
+ * without blocking. Same as por_lrx_dsp_hist_start() but only the bins
+ * of the slice are kept, capture the slices one after the other to save
+ * the storage of the full histogram.
+ *
+ * @param ctx        [O] - The capture state.
+ * @param die        [I] - The ASIC die being accessed.
+ * @param channel    [I] - The channel through the device to query.
+ * @param slice      [I] - The track and hold slice, 0..15.
+ * @param hist_data  [O] - Array of exactly [4x256] entries of uint32_t,
+ *                         cleared by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_lrx_dsp_hist_start_slice(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t die,
+    uint32_t channel,
+    uint32_t slice,
+    uint32_t *hist_data);
+
+/**
+ * Advance a capture started with por_lrx_dsp_hist_start(). Each call
+ * does a bounded amount of work and never waits for the DSP.
+ *
+ * @param ctx        [I/O] - The capture state.
+ * @param hist_data  [O]   - The array passed to por_lrx_dsp_hist_start()
+ *                           or por_lrx_dsp_hist_start_slice().
+ * @param done       [O]   - Set to true once the histogram is complete.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure. The capture is
+ *         aborted on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_lrx_dsp_hist_resume(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t *hist_data,
+    bool *done);
+
+/**
+ * Abandon a capture started with por_lrx_dsp_hist_start().
+ *
+ * @param ctx [I/O] - The capture state.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_lrx_dsp_hist_abort(
+    por_lrx_hist_ctx_t *ctx);
+
 
 
 /**
@@ -3599,6 +4419,150 @@ inphi_status_t por_fec_stats_poller_clear(
     uint32_t   die, 
     e_por_intf intf);
 
+/**
+ * Most requests a por_msg2_async_t can have in flight
+ */
+#define POR_MSG2_ASYNC_MAX_REQS 8
+
+/**
+ * por_msg2_async_service() calls (about 1ms each) a request waits for its response
+ */
+#define POR_MSG2_ASYNC_POLLS 2000
+
+/**
+ * Called by por_msg2_async_service() when a request completes.
+ *
+ * @param die       [I] - The physical ASIC die the request was sent to.
+ * @param msg_id    [I] - The message ID of the request.
+ * @param status    [I] - INPHI_OK if the response was received into the request buffer,
+ *                        INPHI_ERROR on a bad or missing response.
+ * @param resp_len  [I] - Number of 32 bit words the FW sent.
+ * @param user_data [I] - The user data given with the request.
+ */
+typedef void (*por_msg2_async_callback_t)(
+    uint32_t       die,
+    uint8_t        msg_id,
+    inphi_status_t status,
+    uint16_t       resp_len,
+    void*          user_data);
+
+/**
+ * A request in flight, private to the API
+ */
+typedef struct
+{
+    bool           in_use;
+    bool           done;
+    uint8_t        msg_id;
+    uint8_t        resp_type;
+    uint16_t       resp_min;
+    uint16_t       resp_max;
+    uint16_t       resp_len;
+    inphi_status_t status;
+    uint32_t       polls;
+    uint32_t*      resp;
+    por_msg2_async_callback_t callback;
+    void*          user_data;
+} por_msg2_async_req_t;
+
+/**
+ * Asynchronous requests in flight on a die. The caller owns the storage and
+ * sets it up with por_msg2_async_init(); num_in_flight may be read, the
+ * other fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t num_in_flight;
+    por_msg2_async_req_t reqs[POR_MSG2_ASYNC_MAX_REQS];
+} por_msg2_async_t;
+
+/**
+ * Set up the asynchronous requests of a die.
+ *
+ * The request methods ending in _async queue their message with its own
+ * message ID and return straight away, so the FW works on several requests
+ * (the FEC stats and the pulse responses of several channels, say) while
+ * the host goes on. por_msg2_async_service() matches the responses to the
+ * requests and calls their completion callbacks.
+ *
+ * The synchronous messaging methods discard the pending responses, do not
+ * call them on a die while it has asynchronous requests in flight.
+ *
+ * @param async [O] - The request state.
+ * @param die   [I] - The physical ASIC die the requests are sent to.
+ *
+ * @since 1.2.0.929
+ */
+void por_msg2_async_init(
+    por_msg2_async_t* async,
+    uint32_t          die);
+
+/**
+ * Collect the responses that have arrived, and time out the requests that
+ * have waited POR_MSG2_ASYNC_POLLS calls. Does not wait for the FW, call it
+ * about once per ms while num_in_flight is not 0. The completion callbacks
+ * are called from here and may queue new requests.
+ *
+ * @param async [IO] - The request state.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the responses could not be read.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_msg2_async_service(
+    por_msg2_async_t* async);
+
+/**
+ * Queue a FEC stats request, the asynchronous form of
+ * por_fec_stats_poller_request() followed by por_fec_stats_poller_get()
+ * of every block.
+ *
+ * stats holds the stats copied by the FW once the callback reports
+ * INPHI_OK. A poll_count of 0 means the FW has not captured any stats yet.
+ *
+ * @param async         [IO] - The request state.
+ * @param intf          [I]  - The interface being accessed, must be POR_INTF_IG_FEC.
+ * @param clear_on_read [I]  - True to clear all stats counters in the FW after reading. Atomic.
+ * @param stats         [O]  - The stats structure, must stay valid until the callback.
+ * @param callback      [I]  - Called when the request completes, may be NULL.
+ * @param user_data     [I]  - Passed to the callback.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the request could not be queued (retry later).
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_fec_stats_poller_request_async(
+    por_msg2_async_t*         async,
+    e_por_intf                intf,
+    bool                      clear_on_read,
+    por_fec_stats_cp_block_t* stats,
+    por_msg2_async_callback_t callback,
+    void*                     user_data);
+
+/**
+ * Queue a pulse response request, the asynchronous form of
+ * por_hrx_pulse_resp_query(). The channel must be on the die of async.
+ *
+ * @param async       [IO] - The request state.
+ * @param channel     [I]  - The channel to query.
+ * @param resp_values [O]  - Resulting response values, must hold len elements and stay valid until the callback.
+ * @param len         [I]  - Number of elements in resp_values (2<=len<=19).
+ * @param callback    [I]  - Called when the request completes, may be NULL.
+ * @param user_data   [I]  - Passed to the callback.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the request could not be queued (retry later).
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t por_hrx_pulse_resp_query_async(
+    por_msg2_async_t*         async,
+    uint32_t                  channel,
+    int32_t*                  resp_values,
+    uint32_t                  len,
+    por_msg2_async_callback_t callback,
+    void*                     user_data);
+
 #if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
 #if defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
 
@@ -1449,6 +1449,39 @@ void spica_package_cache_dump(void);
  */
 void spica_package_cache_clear();
 
+/**
+ * This method is called to load the package type cache with a
+ * package type discovered earlier, typically kept in non-volatile
+ * memory by the host, so that the EFUSE does not have to be powered
+ * up and fetched again. Only use it when the device is known to be
+ * the one the package type was read from, see
+ * spica_package_device_id_query().
+ *
+ * @param package [I] - The package type returned by
+ *                      spica_package_get_type() on that device.
+ *
+ * @since 1.2.0.929
+ */
+void spica_package_cache_set(
+    e_spica_package_type package);
+
+/**
+ * This method is used to read the device identification of the
+ * ASIC (MMD30 DEVICE_ID registers: OUI, model number and revision).
+ * It does not depend on the EFUSE.
+ *
+ * @param die       [I] - The ASIC die being accessed.
+ * @param device_id [O] - DEVICE_ID_HIGH in the upper 16 bits and
+ *                        DEVICE_ID_LOW in the lower 16 bits.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_package_device_id_query(
+    uint32_t  die,
+    uint32_t* device_id);
+
 /**
  * @h2 Register Access Methods
  * =======================================================
@@ -1506,6 +1539,194 @@ inphi_status_t spica_reg_set(
     uint32_t addr,
     uint32_t data);
 
+#if defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+/**
+ * @brief
+ * Burst register set function, must be implemented by the end
+ * user when INPHI_HAS_REG_BURST_WRITE is set. It writes every
+ * 16 bit value of data to the same register, in order, in as
+ * few bus transactions as the interface allows. This is used
+ * for the inbound PIF data register while the MCU burst mode
+ * (MCU_MDIO_CFG) is enabled.
+ *
+ * NOTE: Do not use spica_reg_set_burst directly in your code.
+ *
+ * @param die      [I] - The ASIC die being accessed.
+ * @param addr     [I] - The address of the register being
+ *                       accessed.
+ * @param data     [I] - The data to write to the register.
+ * @param num_data [I] - The number of 16 bit values in data.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_reg_set_burst(
+    uint32_t        die,
+    uint32_t        addr,
+    const uint16_t* data,
+    uint32_t        num_data);
+#endif // defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+
+#if defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+/**
+ * @brief
+ * CRC-32 function, must be implemented by the end user when
+ * INPHI_HAS_HW_CRC32 is set, typically on a CRC unit of the
+ * host. It is the usual CRC-32 (polynomial 0x04C11DB7,
+ * reflected, initial value and final XOR 0xFFFFFFFF) of the
+ * words taken as little endian bytes.
+ *
+ * @param crc       [I] - The CRC-32 of the data before words,
+ *                        0 to start a new calculation.
+ * @param words     [I] - The data.
+ * @param num_words [I] - The number of 32 bit words in data.
+ *
+ * @return The CRC-32 of the data up to the end of words.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_crc32(
+    uint32_t        crc,
+    const uint32_t* words,
+    uint32_t        num_words);
+#endif // defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+
+/**
+ * Phases of the bring-up timed by spica_boot_mark()
+ */
+typedef enum
+{
+    /** spica_init() or spica_init_start() until done */
+    SPICA_BOOT_PHASE_INIT       = 0,
+    /** Waiting for the bootloader after the global reset is released */
+    SPICA_BOOT_PHASE_BOOTLOADER = 1,
+    /** EFUSE fetch to discover the package type */
+    SPICA_BOOT_PHASE_EFUSE      = 2,
+    /** Waiting for the MCU to run the application firmware */
+    SPICA_BOOT_PHASE_APP_MODE   = 3,
+    /** Top level chip init request until the FW acks it */
+    SPICA_BOOT_PHASE_CHIP_INIT  = 4,
+    /** spica_enter_operational_state() or its _start() until done */
+    SPICA_BOOT_PHASE_ENTER_OP   = 5,
+    /** Writing the rules to the overlays */
+    SPICA_BOOT_PHASE_RULES      = 6,
+    /** Update all rules request until the FW acks it */
+    SPICA_BOOT_PHASE_RULES_ACK  = 7,
+    /** MCU reset and IRAM/DRAM init ahead of a direct download */
+    SPICA_BOOT_PHASE_RAM_INIT   = 8,
+    /** Programming the blocks of a direct download */
+    SPICA_BOOT_PHASE_DOWNLOAD   = 9,
+    /** Reading programmed blocks back */
+    SPICA_BOOT_PHASE_VERIFY     = 10,
+
+    SPICA_BOOT_PHASE_NUM        = 11
+}e_spica_boot_phase;
+
+#if defined(INPHI_HAS_BOOT_PROFILE) && (INPHI_HAS_BOOT_PROFILE==1)
+/**
+ * @brief
+ * Boot profiling hook, must be implemented by the end user when
+ * INPHI_HAS_BOOT_PROFILE is set. It is called when a phase of the
+ * bring-up starts and when it ends, typically to timestamp them.
+ * A phase may take several calls of a resumable method, and a
+ * phase left on an error is not always ended.
+ *
+ * @param die   [I] - The ASIC die being accessed.
+ * @param phase [I] - The phase, see e_spica_boot_phase.
+ * @param enter [I] - true when the phase starts, false when it ends.
+ *
+ * @since 1.2.0.929
+ */
+void spica_boot_mark(
+    uint32_t die,
+    uint32_t phase,
+    bool     enter);
+
+#define SPICA_BOOT_ENTER(die, phase) spica_boot_mark(die, phase, true)
+#define SPICA_BOOT_EXIT(die, phase)  spica_boot_mark(die, phase, false)
+#else
+#define SPICA_BOOT_ENTER(die, phase)
+#define SPICA_BOOT_EXIT(die, phase)
+#endif // defined(INPHI_HAS_BOOT_PROFILE) && (INPHI_HAS_BOOT_PROFILE==1)
+
+/**
+ * Events the API waits for, see spica_event_wait()
+ */
+typedef enum
+{
+    /** Mailbox or msg2 buffer activity from the FW */
+    SPICA_EVENT_MBOX = 1,
+    /** Link state change of an interface */
+    SPICA_EVENT_LINK = 2,
+    /** FW algorithm request or status change */
+    SPICA_EVENT_ALG  = 4
+}e_spica_event;
+
+#if defined(INPHI_HAS_EVENT_WAIT) && (INPHI_HAS_EVENT_WAIT==1)
+/**
+ * @brief
+ * Event wait hook, must be implemented by the end user when
+ * INPHI_HAS_EVENT_WAIT is set. It replaces the fixed delay between
+ * two polls of a condition and may return as soon as the DSP
+ * signals one of the events. The condition is always checked again
+ * afterwards, so an early or spurious return is harmless.
+ *
+ * @param die    [I] - The ASIC die being accessed.
+ * @param events [I] - The events that may end the wait, see e_spica_event.
+ * @param msecs  [I] - The longest time to wait.
+ *
+ * @return The time waited in micro-seconds, at most msecs*1000.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_event_wait(
+    uint32_t die,
+    uint32_t events,
+    uint32_t msecs);
+
+/**
+ * Waits through spica_event_wait() and returns the time to add up
+ * against a timeout, in whole milli-seconds. The part of a milli-second
+ * left over is carried to the next wait, so the timeouts follow the
+ * time actually spent however short the wakes are.
+ *
+ * @private
+ */
+static uint32_t spica_event_wait_counted(
+    uint32_t die,
+    uint32_t events,
+    uint32_t msecs)
+{
+    static uint32_t carry_usecs = 0;
+    uint32_t usecs = carry_usecs + spica_event_wait(die, events, msecs);
+
+    carry_usecs = usecs % 1000;
+    return usecs / 1000;
+}
+
+#define SPICA_EVENT_WAIT(die, events, msecs) spica_event_wait_counted(die, events, msecs)
+#else
+#define SPICA_EVENT_WAIT(die, events, msecs) (INPHI_MDELAY(msecs), (uint32_t)(msecs))
+#endif // defined(INPHI_HAS_EVENT_WAIT) && (INPHI_HAS_EVENT_WAIT==1)
+
+#if defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+/**
+ * @brief
+ * Timestamp hook, must be implemented by the end user when
+ * INPHI_HAS_TIMESTAMP is set. The methods that return to the caller
+ * between two polls of the FW time their waits against it.
+ *
+ * @param die [I] - The ASIC die being accessed.
+ *
+ * @return A free running count of milli-seconds, it may wrap.
+ *
+ * @since 1.2.0.929
+ */
+uint32_t spica_timestamp_ms(
+    uint32_t die);
+#endif // defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+
 /**
  * @h3 API Register Access Methods
  * ===============================
@@ -1876,6 +2097,24 @@ inphi_status_t spica_mcu_fw_mode_query(
     uint32_t         die, 
     e_spica_fw_mode* fw_mode);
 
+/**
+ * Forget the FW state cached for messaging on a die.
+ *
+ * Once the FW is seen in application mode the messaging methods no longer
+ * read the FW mode before every message, and the addresses and lengths of
+ * the msg2 rings are read once, only their read/write indexes are read per
+ * message. The API drops the cache itself whenever it resets the MCU, waits
+ * for the application to start, sees the MCU out of application mode or a
+ * message fails; call this after resetting the DSP by other means (reset
+ * pin, power cycle).
+ *
+ * @param die [I] - The physical ASIC die being accessed.
+ *
+ * @since 1.2.0.929
+ */
+void spica_mcu_msg2_cache_invalidate(
+    uint32_t die);
+
 /**
  * Write to MCU memory via the inbound PIF interface
  *
@@ -2168,6 +2407,83 @@ inphi_status_t spica_mcu_get_inline_bootloader(
     const uint32_t** ptr,
     uint32_t*        length);
 
+#if defined(INPHI_HAS_SHARED_EEPROM) && (INPHI_HAS_SHARED_EEPROM==1)
+/**
+ * Most dies booted from one shared EEPROM by
+ * spica_mcu_shared_boot_start()
+ */
+#define SPICA_SHARED_BOOT_MAX_DIES 8
+
+/**
+ * State of a boot of several dies from a shared EEPROM. The caller owns
+ * the storage; latency may be read once the boot is done, the other
+ * fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t dies[SPICA_SHARED_BOOT_MAX_DIES];
+    uint32_t num_dies;
+    /** Index of the die that owns the SPI bus */
+    uint32_t current;
+    /** Resume calls since the current die was started */
+    uint32_t elapsed;
+    /** Resume calls the previous die took, no polling before most of it */
+    uint32_t expected;
+    /** Resume calls (about 1ms each) every die took to boot, in dies[] order */
+    uint32_t latency[SPICA_SHARED_BOOT_MAX_DIES];
+} spica_shared_boot_ctx_t;
+
+/**
+ * This method starts booting several dies from one shared EEPROM, one
+ * die at a time on the SPI bus, and returns without waiting. The
+ * bootloader is programmed into every die up front with all of them
+ * held as SPI slaves (MCU_RESET.SPIRST=1), then the first die is
+ * started. spica_mcu_shared_boot_resume() must then be called about
+ * once per millisecond until done.
+ *
+ * @param ctx      [O] - The boot state.
+ * @param dies     [I] - The dies sharing the EEPROM, in boot order.
+ * @param num_dies [I] - The number of dies, at most SPICA_SHARED_BOOT_MAX_DIES.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ * - INPHI_HAS_INLINE_BOOTLOADER_FW
+ * - INPHI_HAS_SHARED_EEPROM
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_shared_boot_start(
+    spica_shared_boot_ctx_t* ctx,
+    const uint32_t*          dies,
+    uint32_t                 num_dies);
+
+/**
+ * This method advances a boot started by spica_mcu_shared_boot_start().
+ * The FW mode of the die on the SPI bus is only polled once most of the
+ * time the previous die took has gone by. As soon as it reaches
+ * application mode it is put back to SPI slave and the next die is
+ * started in the same call.
+ *
+ * @param ctx  [I/O] - The boot state.
+ * @param done [O]   - Set to true once every die is in application mode.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or if a die took
+ *         more than SPICA_INIT_RESUME_POLLS calls.
+ *
+ * @requires
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ * - INPHI_HAS_INLINE_BOOTLOADER_FW
+ * - INPHI_HAS_SHARED_EEPROM
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_shared_boot_resume(
+    spica_shared_boot_ctx_t* ctx,
+    bool*                    done);
+#endif // defined(INPHI_HAS_SHARED_EEPROM) && (INPHI_HAS_SHARED_EEPROM==1)
+
 /**
  * This method may be called to broadcast the firmware download to
  * multiple ASICs.
@@ -2229,6 +2545,147 @@ inphi_status_t spica_mcu_direct_download_image_bcast_buffer(
     const uint32_t* image_ptr,
     uint32_t        length);
 
+/**
+ * This method is called to download a compressed firmware image
+ * directly to the MCUs RAM memory, jump to the new application
+ * image and verify it is running properly.
+ *
+ * The image is decompressed on the fly a few words at a time
+ * so only a small fixed buffer and a 4KB history window are
+ * needed in RAM, whatever the size of the image.
+ *
+ * The compressed image starts with an 8 byte header, the magic
+ * "SPLZ" then the length in 32b words of the uncompressed image,
+ * both little endian. It is followed by LZSS tokens over the
+ * little endian bytes of the uncompressed image: a flag byte,
+ * LSB first, announces the next 8 tokens, a 1 for a literal byte
+ * and a 0 for a 16 bit little endian match whose low 12 bits are
+ * the distance back minus 1 and top 4 bits the length minus 3.
+ *
+ * With the magic "SPZC" instead, every block of the uncompressed
+ * image is followed by the CRC-32 of its data words (not counted
+ * in the header length). It is checked against a CRC-32 of the
+ * words programmed when the API has INPHI_HAS_HW_CRC32.
+ *
+ * @param die       [I] - The ASIC die being accessed.
+ * @param lz_image  [I] - The compressed firmware image.
+ * @param lz_length [I] - The length of the compressed image in bytes.
+ * @param verify    [I] - Optionally read back the programmed values
+ *                        to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ * The API must have direct download support. It must be
+ * compiled with the following flags set to 1:
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_download_firmware_lz(
+    uint32_t       die,
+    const uint8_t* lz_image,
+    uint32_t       lz_length,
+    bool           verify);
+
+/**
+ * Source of a firmware image read a chunk at a time, for images that
+ * are not in the host address space or should not be copied to RAM
+ * whole (external SPI/QSPI flash, DMA from the host flash).
+ */
+typedef struct
+{
+    /**
+     * Start reading num_words 32b words of the image, from word offset,
+     * into buf. The read may complete in the background, buf is only
+     * used once read_wait returned.
+     */
+    inphi_status_t (*read_start)(uint32_t offset, uint32_t* buf, uint32_t num_words, void* user_data);
+    /** Wait for the read started last, NULL if read_start completes the read */
+    inphi_status_t (*read_wait)(void* user_data);
+    /** Passed back to the callbacks */
+    void* user_data;
+} spica_fw_source_t;
+
+/**
+ * This method is called to download a firmware image read from a
+ * source a chunk at a time directly to the MCUs RAM memory, jump to
+ * the new application image and verify it is running properly.
+ *
+ * Two chunks of SPICA_MCU_SOURCE_CHUNK_WORDS are kept in RAM: the next
+ * one is requested before the current one is programmed, so a source
+ * reading in the background overlaps the PIF writes.
+ *
+ * @param die          [I] - The ASIC die being accessed.
+ * @param source       [I] - The image source.
+ * @param image_length [I] - The length of the image in 32b words.
+ * @param verify       [I] - Optionally read back the programmed values
+ *                           to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ * The API must have direct download support. It must be
+ * compiled with the following flags set to 1:
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_download_firmware_from_source(
+    uint32_t                 die,
+    const spica_fw_source_t* source,
+    uint32_t                 image_length,
+    bool                     verify);
+
+/**
+ * This method is called to program the same application firmware
+ * into several dies at once, all dies of a package or the dies of
+ * several packages, and start it on all of them.
+ *
+ * Every block of the image is written once per broadcast handle
+ * through spica_mcu_pif_write_bcast(), the platform fanning the
+ * register writes of a broadcast handle out to all the dies behind
+ * it (one handle per bus when the packages are on different buses).
+ * When no broadcast handle is given the blocks are written to each
+ * die in turn, still in a single pass over the image.
+ *
+ * The MCUs of all dies are released before waiting for any of them
+ * to reach application mode, so the boot time of the writes barely
+ * grows with the number of dies.
+ *
+ * Verification is serial: reads cannot be broadcast, so once a block
+ * is written it is read back from one die after the other, and the
+ * verify time grows with the number of dies.
+ *
+ * @param dies         [I] - The ASIC dies to program.
+ * @param num_dies     [I] - The number of entries in dies.
+ * @param bcast_dies   [I] - The broadcast handles reaching the dies,
+ *                           may be NULL.
+ * @param num_bcast    [I] - The number of entries in bcast_dies.
+ * @param image        [I] - The firmware image, in the format of
+ *                           spica_mcu_direct_download_image().
+ * @param image_length [I] - The length of the image in 32b words.
+ * @param verify       [I] - Optionally read back the programmed values
+ *                           from every die to verify the results.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @requires
+ * The API must have direct download support. It must be
+ * compiled with the following flags set to 1:
+ * - INPHI_HAS_DIRECT_DOWNLOAD
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_download_firmware_multi(
+    const uint32_t* dies,
+    uint32_t        num_dies,
+    const uint32_t* bcast_dies,
+    uint32_t        num_bcast,
+    const uint32_t* image,
+    uint32_t        image_length,
+    bool            verify);
+
 #if 0
 /**
  * This wrapper method may be called after programming the firmware to
@@ -2458,6 +2915,15 @@ inphi_status_t spica_mcu_eeprom_read_metadata(
 #define SPICA_RX_DSP_FORMAT_12b       0x1000
 #define SPICA_RX_DSP_FORMAT_32b       0x2000
 #define SPICA_RX_DSP_FW_TIME_OUT      2000  // 2 sec timeout
+#define SPICA_RX_DSP_FW_POLL_MS       10    // longest wait between two polls of the FW
+#define SPICA_RX_DSP_SEM_SETTLE_MS    1000  // algorithms disabled to the semaphore request
+
+// estimation semaphore acquire of a resumable histogram capture
+#define SPICA_RX_DSP_SEM_WAIT_IDLE    0     // until rsp and ctrl are 0
+#define SPICA_RX_DSP_SEM_SETTLE       1     // algorithms disabled, SPICA_RX_DSP_SEM_SETTLE_MS
+#define SPICA_RX_DSP_SEM_WAIT_ALGS    2     // until no algorithm runs
+#define SPICA_RX_DSP_SEM_WAIT_RSP     3     // ctrl set, until the f/w sets rsp
+#define SPICA_RX_DSP_SEM_HELD         4
 #define SPICA_RX_DSP_HIST_BINS        256   // number of histogram bins
 #define SPICA_RX_DSP_HIST_TH_SLICES   16    // number of histogram track and hold slices
 
@@ -2552,6 +3018,119 @@ inphi_status_t spica_rx_dsp_hist_get(
     e_spica_intf intf,   
     uint32_t*    histo);
 
+/**
+ * State of a resumable histogram capture, see spica_rx_dsp_hist_start().
+ * The caller owns the storage, the fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t channel;
+    uint32_t intf;          // e_spica_intf
+    bool     active;        // estimation semaphore held or being acquired
+    bool     is_nrz;
+    bool     step_running;  // SNR estimation of the current step started
+    uint32_t step;          // step being captured
+    uint32_t num_steps;
+    uint32_t polls;         // done polls of the current step or sem_state
+    uint32_t first_slice;   // first track and hold slice captured
+    uint32_t num_slices;    // slices held by histo
+    uint32_t sem_state;     // acquire of the estimation semaphore, SPICA_RX_DSP_SEM_*
+    uint32_t sem_stamp;     // spica_timestamp_ms() sem_state was entered at
+    uint32_t amp_locs[16*4];
+} spica_rx_dsp_hist_ctx_t;
+
+/**
+ * This method starts a histogram capture that is completed a step at a
+ * time by spica_rx_dsp_hist_resume(). It performs the same capture as
+ * spica_rx_dsp_hist_get() but never waits for an SNR estimation to
+ * finish, so the caller can keep servicing other work in between steps.
+ *
+ * The estimation semaphore is acquired by the first calls to
+ * spica_rx_dsp_hist_resume(), which poll the FW handshake and time the
+ * settle of the algorithms instead of waiting for them. It is held until
+ * the capture completes or spica_rx_dsp_hist_abort() is called.
+ *
+ * @param ctx     [O] - The capture state.
+ * @param die     [I] - The ASIC die being accessed.
+ * @param channel [I] - The channel through the device to query.
+ * @param intf    [I] - The interface, SPICA_INTF_ORX or SPICA_INTF_MRX.
+ * @param histo   [O] - The histogram, a buffer of exactly [16384] entries
+ *                      of uint32_t laid out as for spica_rx_dsp_hist_get().
+ *                      It is cleared by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_rx_dsp_hist_start(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t*    histo);
+
+/**
+ * This method starts a capture of a single track and hold slice of the
+ * histogram. It runs the same steps as spica_rx_dsp_hist_start() but only
+ * keeps the bins of the slice, so the caller needs a sixteenth of the
+ * storage and captures the slices one after the other.
+ *
+ * @param ctx     [O] - The capture state.
+ * @param die     [I] - The ASIC die being accessed.
+ * @param channel [I] - The channel through the device to query.
+ * @param intf    [I] - The interface, SPICA_INTF_ORX or SPICA_INTF_MRX.
+ * @param slice   [I] - The track and hold slice, 0..15.
+ * @param histo   [O] - The slice, a buffer of exactly [1024] entries of
+ *                      uint32_t (4 humps of 256 bins). It is cleared by
+ *                      this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_rx_dsp_hist_start_slice(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t     slice,
+    uint32_t*    histo);
+
+/**
+ * This method advances a capture started with spica_rx_dsp_hist_start().
+ * Each call either takes the acquire of the estimation semaphore one poll
+ * further, kicks off the SNR estimation of the next step or, once the
+ * estimation is done, folds its results into the histogram.
+ *
+ * @param ctx   [I/O] - The capture state.
+ * @param histo [O]   - The histogram passed to spica_rx_dsp_hist_start()
+ *                      or spica_rx_dsp_hist_start_slice().
+ * @param done  [O]   - Set to true once the last step has been captured.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure. The capture is
+ *         aborted on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_rx_dsp_hist_resume(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t*    histo,
+    bool*        done);
+
+/**
+ * This method abandons a capture started with spica_rx_dsp_hist_start()
+ * and releases the estimation semaphore.
+ *
+ * @param ctx [I/O] - The capture state.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_rx_dsp_hist_abort(
+    spica_rx_dsp_hist_ctx_t* ctx);
+
 /**
  * This method is called to read the SNR monitor value from the hardware
  * and translate it to a decimal (fixed-point) dB value.
@@ -2903,54 +3482,138 @@ inphi_status_t spica_spi_write_data_block(
 inphi_status_t spica_spi_eeprom_erase(
     uint32_t die);
 
-#endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
-
 /**
- * @h3 Bootloader Status Information
- * @brief
- * The current bootloader error status
+ * Number of 32 bit words that can be programmed with one
+ * spica_spi_eeprom_stream_write call. Segments aligned to this
+ * size never cross an EEPROM page boundary.
  */
-typedef enum
-{
-    /** EEPROM content successfully downloaded to RAMs and CRC passed */
-    SPICA_BOOT_DOWNLOAD_OK = 1,
-    /** Error in total size (IRAM+DRAM) read from EEPROM Header */
-    SPICA_BOOT_ERR_SPI_IMG_SIZE = 2,
-    /** Error in IRAM size read from EEPROM Header */
-    SPICA_BOOT_ERR_SPI_IRAM_SIZE = 3,
-    /** Error in DRAM size read from EEPROM Header */
-    SPICA_BOOT_ERR_SPI_DRAM_SIZE = 4,
-    /** SPI read from EEPROM timed-out */
-    SPICA_BOOT_ERR_SPI_RECEIVE_TIMEOUT = 5,
-    /** CRC check on downloaded EEPROM content failed */
-    SPICA_BOOT_ERR_BOOT_CRC_FAIL = 6,
-    /** Download process is on-going, not yet done */
-    SPICA_BOOT_BOOT_IN_PROGRESS = 7,
-    /** SPI reset timed-out (FW could not confirm SPI had been properly reset) */
-    SPICA_BOOT_ERR_SPI_RESET_TIMEOUT = 8,
-    /** A memory protection error occurred (only in boot upgrade mode) */
-    SPICA_BOOT_ERR_MEMORY_GRANT = 9,
-    /** An unknown parameter was received by the bootloader (only in boot upgrade mode) */
-    SPICA_BOOT_ERR_MESSAGE_UNNOWN_PARAM = 10,
-    /** An invalid message was received by the bootloader (only in boot upgrade mode) */
-    SPICA_BOOT_ERR_MESSAGE_INVALID_TYPE = 11,
-    /** A partial message was aborted by the host (only in boot upgrade mode) */
-    SPICA_BOOT_ERR_MESSAGE_ABORT = 12,
-
-}e_spica_bootloader_error_status;
+#define SPICA_SPI_EEPROM_SEGMENT_WORDS 32
 
 /**
- * The current bootloader status bit map
+ * Time the EEPROM needs to complete an internal write cycle
+ * after each segment, units are milli-seconds.
  */
-typedef enum
-{
-    /** A boot operation complete, the EEPROM has been programmed, and the bootloader jumped to application mode */
-    SPICA_BOOT_COMPLETE = 0x8000,
-    /** A boot from EEPROM operation failed, the bootloader will continue retrying */
-    SPICA_BOOT_FROM_EEPROM_FAILED = 0x4000,
-    /** The boot from EEPROM was aborted by the EEPROM header and jumped to boot upgrade mode */
-    SPICA_BOOT_FROM_EEPROM_ABORTED = 0x2000,
-    /** The bootloader detected an empty EEPROM and jumped to boot upgrade mode */
+#define SPICA_SPI_EEPROM_WRITE_CYCLE_MS 10
+
+/**
+ * This method prepares the package for streaming writes into the
+ * external EEPROM. The MCU(s) are stalled and the SPI master is
+ * reset and configured once for the whole stream, instead of once
+ * per block as spica_spi_write_data_block does.
+ *
+ * @param die    [I] - The physical ASIC die being accessed.
+ * @param clkdiv [I] - The SPI clock divide ratio.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t spica_spi_eeprom_stream_begin(
+    uint32_t            die,
+    e_spica_spi_clk_div clkdiv);
+
+/**
+ * This method programs one segment of a stream started with
+ * spica_spi_eeprom_stream_begin. It does not wait for the EEPROM
+ * write cycle to complete; the caller must allow
+ * SPICA_SPI_EEPROM_WRITE_CYCLE_MS to elapse before the next
+ * segment or before ending the stream.
+ *
+ * @param die         [I] - The physical ASIC die being accessed.
+ * @param eeprom_addr [I] - The EEPROM byte address to write to.
+ * @param words       [I] - The array of 32 bit words to write, not byte swapped.
+ * @param num_words   [I] - The number of words, at most
+ *                          SPICA_SPI_EEPROM_SEGMENT_WORDS and not
+ *                          crossing an EEPROM page boundary.
+ * @param clkdiv      [I] - The SPI clock divide ratio.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t spica_spi_eeprom_stream_write(
+    uint32_t            die,
+    uint32_t            eeprom_addr,
+    const uint32_t*     words,
+    uint32_t            num_words,
+    e_spica_spi_clk_div clkdiv);
+
+/**
+ * This method ends a stream started with spica_spi_eeprom_stream_begin,
+ * resetting the SPI block and releasing the MCU(s) from stall.
+ *
+ * @param die [I] - The physical ASIC die being accessed.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ *
+ * @requires
+ * The API must have EEPROM access support. It must be
+ * compiled with the following flag:
+ * - INPHI_HAS_EEPROM_ACCESS=1
+ */
+inphi_status_t spica_spi_eeprom_stream_end(
+    uint32_t die);
+
+#endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
+
+/**
+ * @h3 Bootloader Status Information
+ * @brief
+ * The current bootloader error status
+ */
+typedef enum
+{
+    /** EEPROM content successfully downloaded to RAMs and CRC passed */
+    SPICA_BOOT_DOWNLOAD_OK = 1,
+    /** Error in total size (IRAM+DRAM) read from EEPROM Header */
+    SPICA_BOOT_ERR_SPI_IMG_SIZE = 2,
+    /** Error in IRAM size read from EEPROM Header */
+    SPICA_BOOT_ERR_SPI_IRAM_SIZE = 3,
+    /** Error in DRAM size read from EEPROM Header */
+    SPICA_BOOT_ERR_SPI_DRAM_SIZE = 4,
+    /** SPI read from EEPROM timed-out */
+    SPICA_BOOT_ERR_SPI_RECEIVE_TIMEOUT = 5,
+    /** CRC check on downloaded EEPROM content failed */
+    SPICA_BOOT_ERR_BOOT_CRC_FAIL = 6,
+    /** Download process is on-going, not yet done */
+    SPICA_BOOT_BOOT_IN_PROGRESS = 7,
+    /** SPI reset timed-out (FW could not confirm SPI had been properly reset) */
+    SPICA_BOOT_ERR_SPI_RESET_TIMEOUT = 8,
+    /** A memory protection error occurred (only in boot upgrade mode) */
+    SPICA_BOOT_ERR_MEMORY_GRANT = 9,
+    /** An unknown parameter was received by the bootloader (only in boot upgrade mode) */
+    SPICA_BOOT_ERR_MESSAGE_UNNOWN_PARAM = 10,
+    /** An invalid message was received by the bootloader (only in boot upgrade mode) */
+    SPICA_BOOT_ERR_MESSAGE_INVALID_TYPE = 11,
+    /** A partial message was aborted by the host (only in boot upgrade mode) */
+    SPICA_BOOT_ERR_MESSAGE_ABORT = 12,
+
+}e_spica_bootloader_error_status;
+
+/**
+ * The current bootloader status bit map
+ */
+typedef enum
+{
+    /** A boot operation complete, the EEPROM has been programmed, and the bootloader jumped to application mode */
+    SPICA_BOOT_COMPLETE = 0x8000,
+    /** A boot from EEPROM operation failed, the bootloader will continue retrying */
+    SPICA_BOOT_FROM_EEPROM_FAILED = 0x4000,
+    /** The boot from EEPROM was aborted by the EEPROM header and jumped to boot upgrade mode */
+    SPICA_BOOT_FROM_EEPROM_ABORTED = 0x2000,
+    /** The bootloader detected an empty EEPROM and jumped to boot upgrade mode */
     SPICA_EEPROM_EMPTY = 0x1000,
     /** A corrupted image was detected during boot */
     SPICA_BOOT_CORRUPT_IMAGE_DETECTED = 0x0800,
@@ -3315,6 +3978,25 @@ inphi_status_t spica_version_firmware(
     char*    buffer, 
     uint32_t buffer_len);
 
+/**
+ * @brief
+ * This method is used to retrieve the version of the application
+ * firmware running, as a number for comparisons.
+ *
+ * @param die     [I] - The ASIC die being accessed.
+ * @param version [O] - FIRMWARE_REV1_OVL in the upper 16 bits
+ *                      (major.minor.revision) and FIRMWARE_REV0_OVL
+ *                      (build) in the lower 16 bits.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR when the firmware is
+ *         not in application mode.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_mcu_fw_version_query(
+    uint32_t  die,
+    uint32_t* version);
+
 /**
  * @h2 PRBS Generator/checker
  * =======================================================
@@ -3996,6 +4678,167 @@ inphi_status_t spica_init(
     uint32_t       die,
     spica_rules_t* rules);
 
+/**
+ * Number of spica_init_resume()/spica_enter_operational_state_resume() calls
+ * a FW handshake may take before it times out. The resumable methods are
+ * expected to be called about once per millisecond, which makes this the
+ * same 3 seconds the blocking methods wait.
+ */
+#define SPICA_INIT_RESUME_POLLS 3000
+
+/**
+ * State of a resumable spica_init()/spica_enter_operational_state(). The
+ * caller owns the storage, the fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t bundle_idx;
+    uint32_t step;
+    uint32_t package_type;
+    uint32_t fw_dwld_timeout;
+    uint32_t polls;
+} spica_init_ctx_t;
+
+/**
+ * This method starts the same device reset as spica_init() but never waits
+ * on the FW, the handshakes are polled by spica_init_resume() instead.
+ *
+ * @param ctx   [O] - The init state.
+ * @param die   [I] - The physical ASIC die being accessed.
+ * @param rules [I] - The device initialization rules, only read by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_init_start(
+    spica_init_ctx_t* ctx,
+    uint32_t          die,
+    spica_rules_t*    rules);
+
+/**
+ * This method advances an init started with spica_init_start() by at most
+ * one register handshake.
+ *
+ * @param ctx  [I/O] - The init state.
+ * @param done [O]   - Set to true once every bundle has acked the chip init.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or timeout.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_init_resume(
+    spica_init_ctx_t* ctx,
+    bool*             done);
+
+/**
+ * This method sends the rules to every bundle, as
+ * spica_enter_operational_state() does, and leaves the FW handshakes to
+ * spica_enter_operational_state_resume(). It MUST be preceded by a
+ * completed init.
+ *
+ * @param ctx   [O] - The operational state request.
+ * @param die   [I] - The physical ASIC die being accessed.
+ * @param rules [I] - The device initialization rules, only read by this call.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_enter_operational_state_start(
+    spica_init_ctx_t* ctx,
+    uint32_t          die,
+    spica_rules_t*    rules);
+
+/**
+ * This method advances a request started with
+ * spica_enter_operational_state_start() by at most one register handshake.
+ *
+ * @param ctx  [I/O] - The operational state request.
+ * @param done [O]   - Set to true once every bundle has acked the rules.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or timeout.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_enter_operational_state_resume(
+    spica_init_ctx_t* ctx,
+    bool*             done);
+
+/**
+ * A register write kept in a configuration snapshot
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint16_t data;
+    uint8_t  die;
+    uint8_t  reserved;
+} spica_reg_pair_t;
+
+/**
+ * Configuration snapshot, the register writes made by the rules. The
+ * caller owns the storage for the pairs.
+ */
+typedef struct
+{
+    /** Storage for the pairs */
+    spica_reg_pair_t* pairs;
+    /** Number of entries in pairs */
+    uint32_t          max_pairs;
+    /** Number of pairs captured */
+    uint32_t          num_pairs;
+    /** Set when more registers were written than pairs can hold */
+    bool              overflow;
+} spica_config_snapshot_t;
+
+/**
+ * This method sends the rules to every bundle like
+ * spica_enter_operational_state_start() and records the final value of
+ * every register it writes in a snapshot. Writing the snapshot back with
+ * spica_enter_operational_state_replay() after a DSP reset and a completed
+ * init gives the same overlays without running the rules again, with
+ * plain writes instead of read/modify/writes.
+ *
+ * The snapshot is only valid for the same rules and FW version.
+ *
+ * @param ctx   [O]   - The operational state request.
+ * @param die   [I]   - The physical ASIC die being accessed.
+ * @param rules [I]   - The device initialization rules, only read by this call.
+ * @param snap  [I/O] - The snapshot, pairs and max_pairs set by the caller.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure. Running out of
+ *         pairs is not a failure, it sets snap->overflow.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_enter_operational_state_capture(
+    spica_init_ctx_t*        ctx,
+    uint32_t                 die,
+    spica_rules_t*           rules,
+    spica_config_snapshot_t* snap);
+
+/**
+ * This method writes a snapshot taken by
+ * spica_enter_operational_state_capture() back to the device and leaves
+ * the FW handshakes to spica_enter_operational_state_resume(). It MUST
+ * be preceded by a completed init.
+ *
+ * @param ctx  [O] - The operational state request.
+ * @param die  [I] - The physical ASIC die being accessed.
+ * @param snap [I] - The snapshot.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure or if the
+ *         snapshot is incomplete.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_enter_operational_state_replay(
+    spica_init_ctx_t*              ctx,
+    uint32_t                       die,
+    const spica_config_snapshot_t* snap);
+
 /*
  * Query the TX FIR configuration.
  */
@@ -4021,6 +4864,63 @@ inphi_status_t spica_tx_squelch(
     e_spica_intf intf,
     bool         squelch);
 
+/**
+ * Upper bound on the number of lanes handled by spica_tx_squelch_lanes().
+ */
+#define SPICA_TX_SQUELCH_MAX_LANES 16
+
+/**
+ * Squelch register addresses of all the channels of a TX interface, resolved
+ * once by spica_tx_squelch_map_init() so that spica_tx_squelch_lanes() does not
+ * go through the channel re-mapping on every call. The caller owns the storage,
+ * the fields are private to the API.
+ */
+typedef struct
+{
+    uint32_t num_lanes;
+    uint32_t die[SPICA_TX_SQUELCH_MAX_LANES];
+    uint32_t addr[SPICA_TX_SQUELCH_MAX_LANES];
+    bool     bcast_ok;
+    uint32_t bcast_die;
+    uint32_t bcast_addr;
+    uint32_t squelched;
+} spica_tx_squelch_map_t;
+
+/**
+ * Resolve the squelch register of every channel of a TX interface and read
+ * back the current squelch state. Call again after the ASIC has been
+ * re-initialized.
+ *
+ * @param map     [O] - The resolved map.
+ * @param die     [I] - The physical ASIC die being accessed.
+ * @param intf    [I] - The TX interface (SPICA_INTF_OTX, SPICA_INTF_MTX, or SPICA_INTF_STX)
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_tx_squelch_map_init(
+    spica_tx_squelch_map_t* map,
+    uint32_t                die,
+    e_spica_intf            intf);
+
+/**
+ * Squelch or unsquelch a set of lanes of a TX interface with the minimum
+ * number of register writes.
+ *
+ * @param map          [I/O] - Map from spica_tx_squelch_map_init().
+ * @param lane_mask    [I] - Lanes to update, bit 0 is the first channel of the interface.
+ * @param squelch_mask [I] - Lanes of lane_mask to squelch, the others are unsquelched.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR on failure.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_tx_squelch_lanes(
+    spica_tx_squelch_map_t* map,
+    uint32_t                lane_mask,
+    uint32_t                squelch_mask);
+
 /**
  * Provides full-manual control of the Tx LUT and COEFF register programming.
  *
@@ -5480,6 +6380,152 @@ inphi_status_t spica_fec_stats_poller_clear(
     e_spica_intf intf
     );
 
+/**
+ * @h3 Asynchronous Messaging
+ * =======================================================
+ * The synchronous request methods push a message and wait for its
+ * response before returning, so the FW processes one request at a time.
+ * The asynchronous methods below queue several requests in the API2FW
+ * buffer, each with its own message ID, and return straight away.
+ * spica_msg2_async_service() then matches the responses in the FW2API
+ * buffer to the requests by ID and calls their completion callbacks.
+ *
+ * The synchronous messaging methods discard the pending responses, do not
+ * call them on a die while it has asynchronous requests in flight.
+ */
+
+/** Most requests a spica_msg2_async_t can have in flight */
+#define SPICA_MSG2_ASYNC_MAX_REQS 8
+
+/** spica_msg2_async_service() calls (about 1ms each) a request waits for its response */
+#define SPICA_MSG2_ASYNC_POLLS 2000
+
+/**
+ * Called by spica_msg2_async_service() when a request completes.
+ *
+ * @param die       [I] - The physical ASIC die the request was sent to.
+ * @param msg_id    [I] - The message ID of the request.
+ * @param status    [I] - INPHI_OK if the response was received into the request buffer,
+ *                        INPHI_ERROR on a bad or missing response.
+ * @param resp_len  [I] - Number of 32 bit words the FW sent.
+ * @param user_data [I] - The user data given with the request.
+ */
+typedef void (*spica_msg2_async_callback_t)(
+    uint32_t       die,
+    uint8_t        msg_id,
+    inphi_status_t status,
+    uint16_t       resp_len,
+    void*          user_data);
+
+/**
+ * A request in flight, private to the API
+ */
+typedef struct
+{
+    bool           in_use;
+    bool           done;
+    uint8_t        msg_id;
+    uint8_t        resp_type;
+    uint16_t       resp_min;
+    uint16_t       resp_max;
+    uint16_t       resp_len;
+    inphi_status_t status;
+    uint32_t       polls;
+    uint32_t*      resp;
+    spica_msg2_async_callback_t callback;
+    void*          user_data;
+} spica_msg2_async_req_t;
+
+/**
+ * Requests in flight on a die. The caller owns the storage and sets it up
+ * with spica_msg2_async_init(); num_in_flight may be read, the other fields
+ * are private to the API.
+ */
+typedef struct
+{
+    uint32_t die;
+    uint32_t num_in_flight;
+    spica_msg2_async_req_t reqs[SPICA_MSG2_ASYNC_MAX_REQS];
+} spica_msg2_async_t;
+
+/**
+ * Set up the asynchronous requests of a die.
+ *
+ * @param async [O] - The request state.
+ * @param die   [I] - The physical ASIC die the requests are sent to.
+ *
+ * @since 1.2.0.929
+ */
+void spica_msg2_async_init(
+    spica_msg2_async_t* async,
+    uint32_t            die);
+
+/**
+ * Collect the responses that have arrived, and time out the requests that
+ * have waited SPICA_MSG2_ASYNC_POLLS calls. Does not wait for the FW. The
+ * completion callbacks are called from here, after the message buffers
+ * are released, so they may queue new requests.
+ *
+ * @param async [IO] - The request state.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the responses could not be read.
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_msg2_async_service(
+    spica_msg2_async_t* async);
+
+/**
+ * Queue a FEC stats request, the asynchronous form of
+ * spica_fec_stats_poller_request() followed by spica_fec_stats_poller_get()
+ * of every block.
+ *
+ * stats is initialized as by spica_fec_stats_poller_request() and holds the
+ * stats copied by the FW once the callback reports INPHI_OK. A poll_count
+ * of 0 means the FW has not captured any stats yet.
+ *
+ * @param async         [IO] - The request state.
+ * @param intf          [I]  - The interface being accessed, must be SPICA_INTF_IG_FEC.
+ * @param clear_on_read [I]  - True to clear all stats counters in the FW after reading. Atomic.
+ * @param stats         [O]  - The stats structure, must stay valid until the callback.
+ * @param callback      [I]  - Called when the request completes, may be NULL.
+ * @param user_data     [I]  - Passed to the callback.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the request could not be queued (retry later).
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_fec_stats_poller_request_async(
+    spica_msg2_async_t*         async,
+    e_spica_intf                intf,
+    bool                        clear_on_read,
+    spica_fec_stats_cp_block_t* stats,
+    spica_msg2_async_callback_t callback,
+    void*                       user_data);
+
+/**
+ * Queue a pulse response request, the asynchronous form of
+ * spica_srx_pulse_resp_query(). The channel must be on the die of async.
+ *
+ * @param async       [IO] - The request state.
+ * @param channel     [I]  - The channel to query.
+ * @param resp_values [O]  - Resulting response values, must hold len elements and stay valid until the callback.
+ * @param len         [I]  - Number of elements in resp_values (2<=len<=19).
+ * @param callback    [I]  - Called when the request completes, may be NULL.
+ * @param user_data   [I]  - Passed to the callback.
+ *
+ * @return INPHI_OK on success, INPHI_ERROR if the request could not be queued (retry later).
+ *
+ * @since 1.2.0.929
+ */
+inphi_status_t spica_srx_pulse_resp_query_async(
+    spica_msg2_async_t*         async,
+    uint32_t                    channel,
+    int32_t*                    resp_values,
+    uint32_t                    len,
+    spica_msg2_async_callback_t callback,
+    void*                       user_data);
+
 #if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
 #if defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
 
@@ -6713,6 +7759,8 @@ static inphi_status_t spica_efuse_fetch(uint32_t die)
         return INPHI_ERROR;
     }
 
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_EFUSE);
+
     SPICA_EFUSE_GENERAL1_CFG__POWER_UP__RMW(die, 1);
     SPICA_EFUSE_GENERAL0_CFG__FETCH__RMW(die, 0);
     SPICA_EFUSE_GENERAL0_CFG__FETCH__RMW(die, 1);
@@ -6735,6 +7783,8 @@ static inphi_status_t spica_efuse_fetch(uint32_t die)
     // Power down the EFUSE
     SPICA_EFUSE_GENERAL1_CFG__POWER_UP__RMW(die, 0);
 
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_EFUSE);
+
     return status;
 }
 
@@ -7033,6 +8083,28 @@ void spica_package_cache_clear()
     g_spica_package_cache_initialized  = true;
 }
 
+void spica_package_cache_set(e_spica_package_type package)
+{
+    g_spica_package_cache_package      = package;
+    g_spica_package_cache_initialized  = true;
+}
+
+inphi_status_t spica_package_device_id_query(uint32_t die, uint32_t* device_id)
+{
+    uint32_t high = SPICA_MMD30_DEVICE_ID_HIGH__READ(die);
+    uint32_t low  = SPICA_MMD30_DEVICE_ID_LOW__READ(die);
+
+    *device_id = (high << 16) | low;
+
+    // All ones or all zeros, nothing answered on the bus
+    if((*device_id == 0) || (*device_id == 0xffffffff))
+    {
+        return INPHI_ERROR;
+    }
+
+    return INPHI_OK;
+}
+
 bool spica_package_has_psr(uint32_t die)
 {
     e_spica_package_type package = spica_package_get_type(die);
@@ -7762,17 +8834,58 @@ uint32_t spica_reg_channel_rmw(
 }
 
 /*
- * Wrapper method that sets a registermodules/comms/spica_reg_access.c
+ * Snapshot recording the register writes, only set while
+ * spica_enter_operational_state_capture() runs
  */
-void spica_reg_write(
-    uint32_t die, 
-    uint32_t addr, 
+static spica_config_snapshot_t* g_spica_config_snapshot = NULL;
+
+/* Keep the last value written to a register in the snapshot */
+static void spica_config_snapshot_record(
+    uint32_t die,
+    uint32_t addr,
+    uint32_t data)
+{
+    spica_config_snapshot_t* snap = g_spica_config_snapshot;
+
+    for(uint32_t i = 0; i < snap->num_pairs; i++)
+    {
+        if((snap->pairs[i].addr == addr) && (snap->pairs[i].die == (uint8_t)die))
+        {
+            snap->pairs[i].data = (uint16_t)data;
+            return;
+        }
+    }
+
+    if(snap->num_pairs >= snap->max_pairs)
+    {
+        snap->overflow = true;
+        return;
+    }
+
+    snap->pairs[snap->num_pairs].addr     = addr;
+    snap->pairs[snap->num_pairs].data     = (uint16_t)data;
+    snap->pairs[snap->num_pairs].die      = (uint8_t)die;
+    snap->pairs[snap->num_pairs].reserved = 0;
+    snap->num_pairs++;
+}
+
+/*
+ * Wrapper method that sets a registermodules/comms/spica_reg_access.c
+ */
+void spica_reg_write(
+    uint32_t die, 
+    uint32_t addr, 
     uint32_t data)
 {
     uint32_t tmp;
 
     tmp = (uint32_t)(data & 0xffff);
     spica_reg_set(die, addr, tmp);
+
+    if(g_spica_config_snapshot != NULL)
+    {
+        spica_config_snapshot_record(die, addr, tmp);
+    }
 }
 
 /*
@@ -9659,6 +10772,32 @@ inphi_status_t spica_version_firmware(
     return status;
 }
 
+/* Get the running application firmware version as a number */
+inphi_status_t spica_mcu_fw_version_query(
+    uint32_t  die,
+    uint32_t* version)
+{
+    inphi_status_t status = INPHI_OK;
+
+    *version = 0;
+
+    SPICA_LOCK(die);
+
+    if(SPICA_MCU_FW_MODE__READ(die) == 0xACC0)
+    {
+        *version  = SPICA_MCU_FIRMWARE_REV1_OVL__READ(die) << 16;
+        *version |= SPICA_MCU_FIRMWARE_REV0_OVL__READ(die);
+    }
+    else
+    {
+        status = INPHI_ERROR;
+    }
+
+    SPICA_UNLOCK(die);
+
+    return status;
+}
+
 void spica_set_callback_for_unlock(
     spica_callback_unlock callback)
 {
@@ -12869,6 +14008,7 @@ inphi_status_t spica_init_per_bundle(
     if(!SPICA_MMD30_RESET_CFG__READ(bundle_die))
     {
         SPICA_MMD30_RESET_CFG__WRITE(bundle_die, 0x0);
+        SPICA_BOOT_ENTER(bundle_die, SPICA_BOOT_PHASE_BOOTLOADER);
 
         int32_t attempts=30000; // 3 seconds
         while(attempts > 0)
@@ -12882,6 +14022,7 @@ inphi_status_t spica_init_per_bundle(
             INPHI_UDELAY(100);
             attempts -= 1;
         }
+        SPICA_BOOT_EXIT(bundle_die, SPICA_BOOT_PHASE_BOOTLOADER);
         if((status) || (attempts <= 0))
         {
             INPHI_CRIT("ERROR: Timed out waiting for bootloader...\n");
@@ -12894,7 +14035,7 @@ inphi_status_t spica_init_per_bundle(
     // need to override the package type
     uint32_t base_die = spica_package_get_base_die(bundle_die);
 
-    e_spica_package_type package = spica_package_query_efuse(base_die);
+    e_spica_package_type package = spica_package_get_type(base_die);
 
     // If the package is not set in the rules then set it to the EFUSE value.
     if(rules->package_type == SPICA_PACKAGE_TYPE_UNMAPPED)
@@ -12929,6 +14070,7 @@ inphi_status_t spica_init_per_bundle(
 
     int32_t attempts=30000; // 3 seconds
     // Signal to the FW to do a top level chip init
+    SPICA_BOOT_ENTER(bundle_die, SPICA_BOOT_PHASE_CHIP_INIT);
     SPICA_TOP_RULES_0__CHIP_INIT_ACK__RMW(bundle_die, 0);
     SPICA_TOP_RULES_0__CHIP_INIT_REQ__RMW(bundle_die, 1);
 
@@ -12944,6 +14086,7 @@ inphi_status_t spica_init_per_bundle(
         INPHI_UDELAY(100);
         attempts -= 1;
     }
+    SPICA_BOOT_EXIT(bundle_die, SPICA_BOOT_PHASE_CHIP_INIT);
 
     if (attempts <= 0)
     {
@@ -12981,6 +14124,8 @@ inphi_status_t spica_init(
         return status;
     }
 
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_INIT);
+
     // init all bundles
     for (uint8_t bundle_idx = 0; bundle_idx < SPICA_MAX_BUNDLES; bundle_idx++) 
     {
@@ -12989,10 +14134,12 @@ inphi_status_t spica_init(
             status |= spica_init_per_bundle(bundle_idx, rules);
             if (INPHI_OK != status)
             {
-                return status;
+                break;
             }
         }
     }
+
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_INIT);
     return status;
 }
 
@@ -13019,7 +14166,9 @@ inphi_status_t spica_enter_operational_state_per_bundle(
         return INPHI_ERROR;
     }
 
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_RULES);
     status |= spica_cp_rules_to_overlays(die, bundle_idx, rules);
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_RULES);
 
     if (status != INPHI_OK)
     {
@@ -13032,6 +14181,7 @@ inphi_status_t spica_enter_operational_state_per_bundle(
 
     int32_t attempts=30000; // 3 seconds
     // Signal to the FW to do a top level chip init
+    SPICA_BOOT_ENTER(bdie, SPICA_BOOT_PHASE_RULES_ACK);
     SPICA_TOP_RULES_0__UPDATE_ALL_RULES_ACK__RMW(bdie, 0);
     SPICA_TOP_RULES_0__UPDATE_ALL_RULES_REQ__RMW(bdie, 1);
 
@@ -13046,6 +14196,7 @@ inphi_status_t spica_enter_operational_state_per_bundle(
         INPHI_UDELAY(100);
         attempts -= 1;
     }
+    SPICA_BOOT_EXIT(bdie, SPICA_BOOT_PHASE_RULES_ACK);
 
     if (attempts <= 0)
     {
@@ -13073,6 +14224,8 @@ inphi_status_t spica_enter_operational_state(
         return INPHI_ERROR;
     }
 
+    SPICA_BOOT_ENTER(base_die, SPICA_BOOT_PHASE_ENTER_OP);
+
     for (uint32_t bundle_idx = 0; bundle_idx < SPICA_MAX_BUNDLES; bundle_idx++)
     {
         if (spica_bundle_is_en(bundle_idx))
@@ -13081,2140 +14234,4156 @@ inphi_status_t spica_enter_operational_state(
             if (status != INPHI_OK)
             {
                 INPHI_CRIT("\nERROR calling enter_operation_state for die 0x%08lu, bundle %lu\n", base_die, bundle_idx);
-                return status;
+                break;
             }
         }
     }
+
+    SPICA_BOOT_EXIT(base_die, SPICA_BOOT_PHASE_ENTER_OP);
     return status;
 }
 
+// Steps of the resumable init/enter operational state
+#define SPICA_INIT_STEP_BUNDLE      0
+#define SPICA_INIT_STEP_BOOT        1
+#define SPICA_INIT_STEP_APP_MODE    2
+#define SPICA_INIT_STEP_CHIP_INIT   3
+#define SPICA_INIT_STEP_OP_REQ      4
+#define SPICA_INIT_STEP_OP_ACK      5
+#define SPICA_INIT_STEP_DONE        6
+
 /*
- * This method is used to setup the default Tx rules
+ * Move a resumable init/enter operational state on to the next enabled
+ * bundle, returns false when there are no more.
  */
-inphi_status_t spica_tx_rules_default_set(
-    uint32_t            die,
-    e_spica_intf        intf,
-    e_spica_driver_type driver_type_ovrd,
-    spica_tx_rules_t*   tx_rules)
+static bool spica_init_next_bundle(
+    spica_init_ctx_t* ctx,
+    uint32_t          first_step)
+{
+    while(ctx->bundle_idx < SPICA_MAX_BUNDLES)
+    {
+        if (spica_bundle_is_en(ctx->bundle_idx))
+        {
+            ctx->step  = first_step;
+            ctx->polls = 0;
+            return true;
+        }
+        ctx->bundle_idx++;
+    }
+    ctx->step = SPICA_INIT_STEP_DONE;
+    return false;
+}
+
+/*
+ * Start resetting the device without blocking
+ */
+inphi_status_t spica_init_start(
+    spica_init_ctx_t* ctx,
+    uint32_t          die,
+    spica_rules_t*    rules)
 {
     inphi_status_t status = INPHI_OK;
 
-    if(!tx_rules)
+    if(!ctx || !rules)
     {
-        INPHI_CRIT("ERROR: tx rules cannot be NULL!\n");
+        INPHI_CRIT("ERROR: ctx and rules cannot be NULL!\n");
         return INPHI_ERROR;
     }
 
-    INPHI_MEMSET(tx_rules, 0, sizeof(spica_tx_rules_t));
-
-    tx_rules->squelch_lock    = false;
-    tx_rules->signalling      = SPICA_SIGNAL_MODE_PAM;
-    tx_rules->baud_rate       = SPICA_BAUD_RATE_53p1;
-    tx_rules->ieee_demap      = true;
-    tx_rules->gray_mapping    = true;
-    tx_rules->invert_chan     = false;
-    tx_rules->swing           = SPICA_TX_SWING_100p; /* default = 100 percent */
-    tx_rules->dfe_precoder_en = false; /* available on OTX only */
-    tx_rules->fll_mode        = SPICA_FLL_MODE_BB_PD; 
+    INPHI_MEMSET(ctx, 0, sizeof(*ctx));
 
-    if (SPICA_INTF_MTX == intf)
-    {
-#if !defined(INPHI_REMOVE_PMR)
-        // Spica HTX
-        tx_rules->lut_mode    = SPICA_LUT_4TAP;
-        tx_rules->fir_taps[0] = -30;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
-        tx_rules->fir_taps[1] = 400;  
-        tx_rules->fir_taps[2] = -30;  
-        tx_rules->fir_taps[3] = 0;    
-        tx_rules->fir_taps[4] = 0;    
-        tx_rules->fir_taps[5] = 0;    
-        tx_rules->fir_taps[6] = 0;    
-        tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
-        tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
-#endif // defined(INPHI_REMOVE_PMR)
-    }
-    else if (SPICA_INTF_STX == intf)
+    status |= spica_check_rules(die, rules);
+    if (INPHI_OK != status)
     {
-#if !defined(INPHI_REMOVE_PSR)
-        // PG3 HTX
-        tx_rules->lut_mode    = SPICA_LUT_4TAP;
-        tx_rules->fir_taps[0] = -30;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
-        tx_rules->fir_taps[1] = 400;  
-        tx_rules->fir_taps[2] = 0;    
-        tx_rules->fir_taps[3] = 0;    
-        tx_rules->fir_taps[4] = 0;    
-        tx_rules->fir_taps[5] = 0;    
-        tx_rules->fir_taps[6] = 0;    
-        tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
-        tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
-#endif // defined(INPHI_REMOVE_PSR)
+        return status;
     }
-    else
+
+    ctx->die             = die;
+    ctx->package_type    = rules->package_type;
+    ctx->fw_dwld_timeout = rules->fw_dwld_timeout;
+
+    if (!spica_init_next_bundle(ctx, SPICA_INIT_STEP_BUNDLE))
     {
-        // Spica/PG3 LTX 
-        if ((SPICA_DRIVER_TYPE_EML  == driver_type_ovrd) ||
-           ((SPICA_DRIVER_TYPE_NONE == driver_type_ovrd) &&
-            (SPICA_DRIVER_TYPE_EML  == spica_package_get_driver_type(die))))
-        {
-            // driver type EML
-            tx_rules->lut_mode    = SPICA_LUT_7TAP_LIN;
-            tx_rules->fir_taps[0] = -50;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
-            tx_rules->fir_taps[1] = 750;  
-            tx_rules->fir_taps[2] = 50;   
-            tx_rules->fir_taps[3] = -40;  
-            tx_rules->fir_taps[4] = -30;  
-            tx_rules->fir_taps[5] = -20;  
-            tx_rules->fir_taps[6] = -10;  
-            tx_rules->inner_eye1  = 1380; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
-            tx_rules->inner_eye2  = 2230; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
-        }
-        else // driver type SiPho, 1Vpp or None 
-        {
-            tx_rules->lut_mode    = SPICA_LUT_7TAP_LIN;
-            tx_rules->fir_taps[0] = -50;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
-            tx_rules->fir_taps[1] = 450;  
-            tx_rules->fir_taps[2] = -50;    
-            tx_rules->fir_taps[3] = 0;    
-            tx_rules->fir_taps[4] = 0;    
-            tx_rules->fir_taps[5] = 0;    
-            tx_rules->fir_taps[6] = 0;    
-            tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
-            tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
-        }
+        INPHI_CRIT("ERROR: No bundle enabled\n");
+        return INPHI_ERROR;
     }
 
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_INIT);
+
     return status;
 }
 
-/**
- * Struct to define channel defaults
- * @private
- */
-typedef struct {
-    /** line baud rate */
-    e_spica_baud_rate lbr;
-    /** line num chs 1-4 */
-    uint8_t lchs;
-    /** line signalling */
-    e_spica_signal_mode lsig;
-    /** host baud rate */
-    e_spica_baud_rate hbr;
-    /** host num chs 1-8 */
-    uint8_t hchs;
-    /** host signalling */
-    e_spica_signal_mode hsig;
-} spica_proto_mode_t;
-
-/* Big LUT of all the protocol modes
+/*
+ * Advance a non-blocking device reset, this follows spica_init_per_bundle()
  */
-const spica_proto_mode_t spica_rules_protocol_mode_lut[] = {
-    [SPICA_MODE_400G_4Px53p1_TO_4Px53p1] = {
-        .hchs = 4, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_53p1, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_100G_4Nx25p8_TO_4Nx25p8] = {
-        .hchs = 4, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_25p8, .hsig = SPICA_SIGNAL_MODE_NRZ,
-        .lbr = SPICA_BAUD_RATE_25p8, .lsig = SPICA_SIGNAL_MODE_NRZ,
-    },
-    [SPICA_MODE_300G_4Px41p3_TO_4Px41p3] = {
-        .hchs = 4, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_41p3, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_41p3, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_200G_4Px26p6_TO_4Px26p6] = {
-        .hchs = 4, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_26p6, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_100G_4Nx25p8_TO_2Px25p8] = {
-        .hchs = 4, .lchs = 2,
-        .hbr = SPICA_BAUD_RATE_25p8, .hsig = SPICA_SIGNAL_MODE_NRZ,
-        .lbr = SPICA_BAUD_RATE_25p8, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_400G_8Px26p6_TO_4Px53p1] = {
-        .hchs = 8, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_200G_4Px26p6_TO_2Px53p1] = {
-        .hchs = 4, .lchs = 2,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_100G_2Px26p6_TO_1Px53p1] = {
-        .hchs = 2, .lchs = 1,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_100G_4Nx26p6_TO_1Px53p1] = {
-        .hchs = 4, .lchs = 1,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_NRZ,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-    [SPICA_MODE_200G_4Nx53p1_TO_4Nx53p1] = {
-        .hchs = 4, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_53p1, .hsig = SPICA_SIGNAL_MODE_NRZ,
-        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_NRZ,
-    },
-    [SPICA_MODE_200G_8Nx26p6_TO_4Px26p6] = {
-        .hchs = 8, .lchs = 4,
-        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_NRZ,
-        .lbr = SPICA_BAUD_RATE_26p6, .lsig = SPICA_SIGNAL_MODE_PAM,
-    },
-
-};
-
-/* setup the default rules structure for a bundle based on the op_mode */
-inphi_status_t spica_rules_default_set_per_bundle(
-    uint32_t                 die,
-    uint32_t                 bundle_idx,
-    e_spica_operational_mode op_mode,
-    e_spica_protocol_mode    protocol_mode,
-    spica_rules_t*           rules)
+inphi_status_t spica_init_resume(
+    spica_init_ctx_t* ctx,
+    bool*             done)
 {
     inphi_status_t status = INPHI_OK;
+    uint32_t bundle_die;
+    e_spica_fw_mode mode;
+    e_spica_package_type package;
 
-    if(!rules)
+    *done = false;
+
+    if(ctx->step == SPICA_INIT_STEP_DONE)
     {
-        INPHI_CRIT("ERROR: rules cannot be NULL!\n");
-        return INPHI_ERROR;
+        *done = true;
+        return INPHI_OK;
     }
-    if (!spica_bundle_is_en(bundle_idx))
+
+    bundle_die = spica_bundle_get_die_from_bundle(ctx->bundle_idx);
+
+    SPICA_LOCK(bundle_die);
+
+    switch(ctx->step)
     {
-        INPHI_CRIT("ERROR: Bundle not enabled %lu\n", bundle_idx);
-        return INPHI_ERROR;
+        case SPICA_INIT_STEP_BUNDLE:
+            // Set the API version in the spare registers
+            spica_init_api_version(bundle_die);
+
+            // Check if part is in reset, then take part out of global reset
+            if(!SPICA_MMD30_RESET_CFG__READ(bundle_die))
+            {
+                SPICA_MMD30_RESET_CFG__WRITE(bundle_die, 0x0);
+            }
+            SPICA_BOOT_ENTER(bundle_die, SPICA_BOOT_PHASE_BOOTLOADER);
+            ctx->step  = SPICA_INIT_STEP_BOOT;
+            ctx->polls = 0;
+            break;
+
+        case SPICA_INIT_STEP_BOOT:
+            //FW mode will be UNKNOWN until something has loaded
+            status |= spica_mcu_fw_mode_query(bundle_die, &mode);
+            if((status == INPHI_OK) && (mode == SPICA_FW_MODE_UNKNOWN))
+            {
+                if(++ctx->polls > SPICA_INIT_RESUME_POLLS)
+                {
+                    INPHI_CRIT("ERROR: Timed out waiting for bootloader...\n");
+                    status |= INPHI_ERROR;
+                }
+                break;
+            }
+            if(status != INPHI_OK)
+            {
+                break;
+            }
+            SPICA_BOOT_EXIT(bundle_die, SPICA_BOOT_PHASE_BOOTLOADER);
+
+            // If the package is not set in the rules then use the EFUSE
+            // value, if it doesn't match then override the package type
+            package = spica_package_get_type(spica_package_get_base_die(bundle_die));
+            if(ctx->package_type == SPICA_PACKAGE_TYPE_UNMAPPED)
+            {
+                ctx->package_type = package;
+            }
+            if(ctx->package_type != (uint32_t)package)
+            {
+                SPICA_MCU_SP4_FW_CFG0__PACKAGE_TYPE_VALUE__RMW(bundle_die, ctx->package_type);
+                SPICA_MCU_SP4_FW_CFG0__PACKAGE_TYPE_OVERRIDE__RMW(bundle_die, 1);
+            }
+            else
+            {
+                SPICA_MCU_SP4_FW_CFG0__PACKAGE_TYPE_OVERRIDE__RMW(bundle_die, 0);
+            }
+
+            // Turn on the PC trace
+            SPICA_MCU_GEN_CFG__PDEBUG_EN__RMW(bundle_die, 1);
+            SPICA_BOOT_ENTER(bundle_die, SPICA_BOOT_PHASE_APP_MODE);
+            ctx->step  = SPICA_INIT_STEP_APP_MODE;
+            ctx->polls = 0;
+            break;
+
+        case SPICA_INIT_STEP_APP_MODE:
+            // We must be in app fw mode to run the chip init
+            status |= spica_mcu_fw_mode_query(bundle_die, &mode);
+            if(status != INPHI_OK)
+            {
+                break;
+            }
+            if(mode == SPICA_FW_MODE_APPLICATION)
+            {
+                SPICA_BOOT_EXIT(bundle_die, SPICA_BOOT_PHASE_APP_MODE);
+                SPICA_BOOT_ENTER(bundle_die, SPICA_BOOT_PHASE_CHIP_INIT);
+                SPICA_TOP_RULES_0__CHIP_INIT_ACK__RMW(bundle_die, 0);
+                SPICA_TOP_RULES_0__CHIP_INIT_REQ__RMW(bundle_die, 1);
+                ctx->step  = SPICA_INIT_STEP_CHIP_INIT;
+                ctx->polls = 0;
+            }
+            else if(mode != 0)
+            {
+                INPHI_CRIT("Invalid FW mode: 0x%x\n", mode);
+                status |= INPHI_ERROR;
+            }
+            else if(++ctx->polls > ctx->fw_dwld_timeout)
+            {
+                INPHI_CRIT("Timed-out waiting for MCU to run Application code, timeout=%lu (ms)\n", ctx->fw_dwld_timeout);
+                status |= INPHI_ERROR;
+            }
+            break;
+
+        case SPICA_INIT_STEP_CHIP_INIT:
+            // Wait for FW to acknowledge the request
+            if(SPICA_TOP_RULES_0__CHIP_INIT_ACK__READ(bundle_die))
+            {
+                SPICA_BOOT_EXIT(bundle_die, SPICA_BOOT_PHASE_CHIP_INIT);
+                ctx->bundle_idx++;
+                *done = !spica_init_next_bundle(ctx, SPICA_INIT_STEP_BUNDLE);
+            }
+            else if(++ctx->polls > SPICA_INIT_RESUME_POLLS)
+            {
+                INPHI_CRIT("ERROR: Timed out waiting for FW on die 0x%08lu to ack chip_init request.\n", bundle_die);
+                status |= INPHI_ERROR;
+            }
+            break;
+
+        default:
+            status |= INPHI_ERROR;
+            break;
     }
-    if(op_mode >= SPICA_MODE_OP_END)
+
+    if(*done || (status != INPHI_OK))
     {
-        INPHI_CRIT("ERROR: Invalid op mode %d\n", op_mode);
-        return INPHI_ERROR;
+        SPICA_BOOT_EXIT(ctx->die, SPICA_BOOT_PHASE_INIT);
     }
-    if(protocol_mode >= SPICA_MODE_PROT_END)
+
+    SPICA_UNLOCK(bundle_die);
+
+    return status;
+}
+
+/*
+ * Send the rules to all the bundles, the acks are polled by
+ * spica_enter_operational_state_resume()
+ */
+inphi_status_t spica_enter_operational_state_start(
+    spica_init_ctx_t* ctx,
+    uint32_t          die,
+    spica_rules_t*    rules)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t base_die = spica_package_get_base_die(die);
+
+    if(!ctx || !rules)
     {
-        INPHI_CRIT("ERROR: Invalid protocol_mode %d\n", protocol_mode);
+        INPHI_CRIT("ERROR: ctx and rules cannot be NULL!\n");
         return INPHI_ERROR;
     }
 
-    //setup the host/line details based on the protocol mode
-    const spica_proto_mode_t *pro = &spica_rules_protocol_mode_lut[protocol_mode];
+    INPHI_MEMSET(ctx, 0, sizeof(*ctx));
+    ctx->die = base_die;
 
-    e_spica_signal_mode host_signalling = pro->hsig;
-    e_spica_signal_mode line_signalling = pro->lsig;
-    uint32_t host_baud_rate             = pro->hbr;
-    uint32_t line_baud_rate             = pro->lbr;
-    uint32_t host_num_channels_en       = pro->hchs;
-    uint32_t line_num_channels_en       = pro->lchs;
+    SPICA_BOOT_ENTER(base_die, SPICA_BOOT_PHASE_ENTER_OP);
+    SPICA_BOOT_ENTER(base_die, SPICA_BOOT_PHASE_RULES);
 
-    rules->fw_dwld_timeout              = 300; /* 15 seconds, units are SPICA_MCU_POLL_DELAY_MS milli-secs */
+    // The FW only picks the overlays up on the UPDATE_ALL_RULES_REQ of
+    // the bundle's die, so they can all be written up front
+    for (uint32_t bundle_idx = 0; bundle_idx < SPICA_MAX_BUNDLES; bundle_idx++)
+    {
+        if (spica_bundle_is_en(bundle_idx))
+        {
+            status |= spica_cp_rules_to_overlays(base_die, bundle_idx, rules);
+            if (status != INPHI_OK)
+            {
+                INPHI_CRIT("\nERROR sending rules to die:0x%08lu, bundle:%lu\n", base_die, bundle_idx);
+                return status;
+            }
+        }
+    }
 
-    // By default warn if the f/w version encountered does not
-    // match the version the API was compiled with.
-    rules->fw_warn_if_mismatched        = true;
+    SPICA_BOOT_EXIT(base_die, SPICA_BOOT_PHASE_RULES);
 
-    //setup the high-level rules
-    rules->operational_mode             = op_mode;
-    rules->protocol_mode                = protocol_mode;
+    spica_init_next_bundle(ctx, SPICA_INIT_STEP_OP_REQ);
 
-    rules->driver_type_override         = SPICA_DRIVER_TYPE_NONE;
+    return status;
+}
 
-    rules->lrx_los_dsrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_200;
+/*
+ * Advance a non-blocking enter operational state, this follows
+ * spica_enter_operational_state_per_bundle()
+ */
+inphi_status_t spica_enter_operational_state_resume(
+    spica_init_ctx_t* ctx,
+    bool*             done)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t bdie;
 
-    // Only needed for NRZ ... hardcode for PAM
-    if(line_signalling == SPICA_SIGNAL_MODE_PAM)
+    *done = false;
+
+    if(ctx->step == SPICA_INIT_STEP_DONE)
     {
-        rules->lrx_los_asrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_100;
-        rules->lrx_los_asrt_ctrl_datamode   = SPICA_LOS_CTRL_AMP_100;
+        *done = true;
+        return INPHI_OK;
     }
-    else // NRZ 
+
+    bdie = spica_bundle_get_die_from_bundle(ctx->bundle_idx);
+
+    if(ctx->step == SPICA_INIT_STEP_OP_REQ)
     {
-        rules->lrx_los_asrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_100;
-        rules->lrx_los_asrt_ctrl_datamode   = SPICA_LOS_CTRL_AMP_100;
+        // Signal to the FW to pick up the rules
+        SPICA_BOOT_ENTER(bdie, SPICA_BOOT_PHASE_RULES_ACK);
+        SPICA_TOP_RULES_0__UPDATE_ALL_RULES_ACK__RMW(bdie, 0);
+        SPICA_TOP_RULES_0__UPDATE_ALL_RULES_REQ__RMW(bdie, 1);
+        ctx->step  = SPICA_INIT_STEP_OP_ACK;
+        ctx->polls = 0;
     }
-
-    if(line_signalling == SPICA_SIGNAL_MODE_PAM)
+    else if(ctx->step == SPICA_INIT_STEP_OP_ACK)
     {
-        rules->lrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_17dB;
-        rules->lrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_16dB;
-        rules->lrx_qc.slc_err_limit          = 50;
-        rules->advanced.lrx_ddlf_en          = true; // hide in public API
-        rules->advanced.lrx_cid_losd_det_en  = true;
+        // Wait for FW to acknowledge the request
+        if(SPICA_TOP_RULES_0__UPDATE_ALL_RULES_ACK__READ(bdie))
+        {
+            SPICA_BOOT_EXIT(bdie, SPICA_BOOT_PHASE_RULES_ACK);
+            ctx->bundle_idx++;
+            *done = !spica_init_next_bundle(ctx, SPICA_INIT_STEP_OP_REQ);
+        }
+        else if(++ctx->polls > SPICA_INIT_RESUME_POLLS)
+        {
+            INPHI_CRIT("ERROR: Timed out waiting for FW on die 0x%08lu to ack update_all_rules request.\n", bdie);
+            status |= INPHI_ERROR;
+        }
     }
-    else // NRZ 
+    else
     {
-        rules->lrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_19dB;
-        rules->lrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_18dB;
-        rules->lrx_qc.slc_err_limit          = 50;
-        rules->advanced.lrx_ddlf_en          = false;
-        rules->advanced.lrx_cid_losd_det_en  = false;
-    }  
- 
-    if(host_signalling == SPICA_SIGNAL_MODE_PAM)
+        status |= INPHI_ERROR;
+    }
+
+    if(*done || (status != INPHI_OK))
     {
-        rules->hrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_17dB;
-        rules->hrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_16dB;
-        rules->hrx_qc.slc_err_limit          = 50;
-        rules->advanced.hrx_ddlf_en          = false;
-        rules->advanced.hrx_cid_losd_det_en  = true;
+        SPICA_BOOT_EXIT(ctx->die, SPICA_BOOT_PHASE_ENTER_OP);
     }
-    else // NRZ 
+
+    return status;
+}
+
+/*
+ * Send the rules to all the bundles, recording the register writes
+ */
+inphi_status_t spica_enter_operational_state_capture(
+    spica_init_ctx_t*        ctx,
+    uint32_t                 die,
+    spica_rules_t*           rules,
+    spica_config_snapshot_t* snap)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(!snap || !snap->pairs)
     {
-        rules->hrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_19dB;
-        rules->hrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_18dB;
-        rules->hrx_qc.slc_err_limit          = 50;
-        rules->advanced.hrx_ddlf_en          = false;
-        rules->advanced.hrx_cid_losd_det_en  = false;
+        INPHI_CRIT("ERROR: snap cannot be NULL!\n");
+        return INPHI_ERROR;
     }
 
-    rules->advanced.lrx_low_loss_det_en      = false;
+    snap->num_pairs = 0;
+    snap->overflow  = false;
 
-    if(host_baud_rate > SPICA_BAUD_RATE_41p3)
-    { 
-        rules->advanced.hrx_low_loss_det_en      = true;
+    g_spica_config_snapshot = snap;
+    status |= spica_enter_operational_state_start(ctx, die, rules);
+    g_spica_config_snapshot = NULL;
+
+    if(snap->overflow)
+    {
+        INPHI_WARN("Snapshot needs more than %lu pairs\n", snap->max_pairs);
     }
-    else if (host_baud_rate == SPICA_BAUD_RATE_41p3)
+
+    return status;
+}
+
+/*
+ * Write a snapshot of the rules back, the acks are polled by
+ * spica_enter_operational_state_resume()
+ */
+inphi_status_t spica_enter_operational_state_replay(
+    spica_init_ctx_t*              ctx,
+    uint32_t                       die,
+    const spica_config_snapshot_t* snap)
+{
+    uint32_t base_die = spica_package_get_base_die(die);
+
+    if(!ctx || !snap || !snap->pairs)
     {
-        rules->advanced.hrx_low_loss_det_en      = false;
+        INPHI_CRIT("ERROR: ctx and snap cannot be NULL!\n");
+        return INPHI_ERROR;
     }
-    else 
+
+    if(snap->overflow || (snap->num_pairs == 0))
     {
-        rules->advanced.hrx_low_loss_det_en      = false;
+        INPHI_CRIT("ERROR: Incomplete snapshot\n");
+        return INPHI_ERROR;
     }
 
-    rules->advanced.lrx_double_restart_dis   = false;
+    INPHI_MEMSET(ctx, 0, sizeof(*ctx));
+    ctx->die = base_die;
 
-    //handle host channel enables and signalling based on the op mode and package
-    bool host_gray_mapping = (host_signalling == SPICA_SIGNAL_MODE_PAM);
-    bool line_gray_mapping = (line_signalling == SPICA_SIGNAL_MODE_PAM);
+    SPICA_BOOT_ENTER(base_die, SPICA_BOOT_PHASE_ENTER_OP);
+    SPICA_BOOT_ENTER(base_die, SPICA_BOOT_PHASE_RULES);
 
-    uint32_t base_die = spica_package_get_base_die(die);
+    // The values are final, no read/modify/write needed
+    for(uint32_t i = 0; i < snap->num_pairs; i++)
+    {
+        spica_reg_write(snap->pairs[i].die, snap->pairs[i].addr, snap->pairs[i].data);
+    }
 
-    //get the enabled interfaces based on the op mode
-    e_spica_intf en_intfs = spica_op_mode_en_intfs(base_die, op_mode);
+    SPICA_BOOT_EXIT(base_die, SPICA_BOOT_PHASE_RULES);
 
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_ORX)
+    spica_init_next_bundle(ctx, SPICA_INIT_STEP_OP_REQ);
+
+    return INPHI_OK;
+}
+
+/*
+ * This method is used to setup the default Tx rules
+ */
+inphi_status_t spica_tx_rules_default_set(
+    uint32_t            die,
+    e_spica_intf        intf,
+    e_spica_driver_type driver_type_ovrd,
+    spica_tx_rules_t*   tx_rules)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(!tx_rules)
     {
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
-        rules->orx[channel].channel_enable      = (en_intfs & SPICA_INTF_ORX) && (((channel-1)%SPICA_NUM_OF_ORX_CHANNELS+1) <= line_num_channels_en);
-        rules->orx[channel].signalling          = line_signalling;
-        rules->orx[channel].baud_rate           = line_baud_rate;
-        rules->orx[channel].ieee_demap          = true;
-        rules->orx[channel].gray_mapping        = line_gray_mapping;
-        rules->orx[channel].invert_chan         = false;
-        rules->orx[channel].sdt_dsp_en          = false;
-        rules->orx[channel].los_dsp_en          = false;
-        rules->orx[channel].six_bit_mode        = SPICA_6BIT_MODE_DISABLE;
-        rules->orx[channel].force_mission_mode  = false;
-        rules->orx[channel].restart_on_los_dis     = false;
-        rules->orx[channel].ffe_const_diff_en   = true;
-        rules->orx[channel].bw_idx_max          = 1;
-        rules->orx[channel].vga1_tracking_period= 4; 
-        rules->orx[channel].alg1_dis            = false; 
-        rules->orx[channel].alg2_dis            = false; 
-        rules->orx[channel].alg3_dis            = false; 
-        rules->orx[channel].alg4_dis            = false; 
-        rules->orx[channel].qc_all_dis          = false; 
-        rules->orx[channel].qc_hist_dis         = false; 
-        rules->orx[channel].qc_slc_dis          = false; 
-        rules->orx[channel].qc_snr_dis          = false; 
+        INPHI_CRIT("ERROR: tx rules cannot be NULL!\n");
+        return INPHI_ERROR;
     }
-#if !defined(INPHI_REMOVE_PMR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MRX)
+
+    INPHI_MEMSET(tx_rules, 0, sizeof(spica_tx_rules_t));
+
+    tx_rules->squelch_lock    = false;
+    tx_rules->signalling      = SPICA_SIGNAL_MODE_PAM;
+    tx_rules->baud_rate       = SPICA_BAUD_RATE_53p1;
+    tx_rules->ieee_demap      = true;
+    tx_rules->gray_mapping    = true;
+    tx_rules->invert_chan     = false;
+    tx_rules->swing           = SPICA_TX_SWING_100p; /* default = 100 percent */
+    tx_rules->dfe_precoder_en = false; /* available on OTX only */
+    tx_rules->fll_mode        = SPICA_FLL_MODE_BB_PD; 
+
+    if (SPICA_INTF_MTX == intf)
     {
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (host_num_channels_en)
-        rules->mrx[channel].channel_enable      = (en_intfs & SPICA_INTF_MRX) && (((channel-1)%SPICA_NUM_OF_MRX_CHANNELS+1) <= host_num_channels_en);
-        rules->mrx[channel].signalling          = host_signalling;
-        rules->mrx[channel].baud_rate           = host_baud_rate;
-        rules->mrx[channel].ieee_demap          = true;
-        rules->mrx[channel].gray_mapping        = host_gray_mapping;
-        rules->mrx[channel].invert_chan         = false;
-        rules->mrx[channel].sdt_dsp_en          = false;
-        rules->mrx[channel].los_dsp_en          = false;
-        rules->mrx[channel].force_mission_mode  = false;
-        rules->mrx[channel].restart_on_los_dis  = false;
-        rules->mrx[channel].ffe_const_diff_en   = true;
-        rules->mrx[channel].bw_idx_max          = 6;
-        rules->mrx[channel].vga1_tracking_period= 4;
-        rules->mrx[channel].alg1_dis            = false; 
-        rules->mrx[channel].alg2_dis            = false; 
-        rules->mrx[channel].alg3_dis            = false; 
-        rules->mrx[channel].alg4_dis            = false;
-        rules->mrx[channel].qc_all_dis          = false; 
-        rules->mrx[channel].qc_hist_dis         = false; 
-        rules->mrx[channel].qc_slc_dis          = false; 
-        rules->mrx[channel].qc_snr_dis          = false;  
-    }
+#if !defined(INPHI_REMOVE_PMR)
+        // Spica HTX
+        tx_rules->lut_mode    = SPICA_LUT_4TAP;
+        tx_rules->fir_taps[0] = -30;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
+        tx_rules->fir_taps[1] = 400;  
+        tx_rules->fir_taps[2] = -30;  
+        tx_rules->fir_taps[3] = 0;    
+        tx_rules->fir_taps[4] = 0;    
+        tx_rules->fir_taps[5] = 0;    
+        tx_rules->fir_taps[6] = 0;    
+        tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
+        tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
 #endif // defined(INPHI_REMOVE_PMR)
+    }
+    else if (SPICA_INTF_STX == intf)
+    {
 #if !defined(INPHI_REMOVE_PSR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_SRX)
+        // PG3 HTX
+        tx_rules->lut_mode    = SPICA_LUT_4TAP;
+        tx_rules->fir_taps[0] = -30;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
+        tx_rules->fir_taps[1] = 400;  
+        tx_rules->fir_taps[2] = 0;    
+        tx_rules->fir_taps[3] = 0;    
+        tx_rules->fir_taps[4] = 0;    
+        tx_rules->fir_taps[5] = 0;    
+        tx_rules->fir_taps[6] = 0;    
+        tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
+        tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
+#endif // defined(INPHI_REMOVE_PSR)
+    }
+    else
     {
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (host_num_channels_en)
-        rules->srx[channel].channel_enable       = (en_intfs & SPICA_INTF_SRX) && (((channel-1)%SPICA_NUM_OF_SRX_CHANNELS+1) <= host_num_channels_en);
-        rules->srx[channel].ctle_adapt_dis       = false;
-        rules->srx[channel].lfeq_adapt_dis       = false;
-        rules->srx[channel].skip_adapt           = false;
-        rules->srx[channel].dfe_adapt_dis        = false;
-        rules->srx[channel].signalling           = host_signalling;
-        rules->srx[channel].data_skew_adapt_dis  = false;
-        rules->srx[channel].edge_skew_adapt_dis  = false;
-        rules->srx[channel].vco_temp_cal_dis     = false;
-        rules->srx[channel].slc_adapt_dis        = false;
-        rules->srx[channel].edge_off_adapt_dis   = false;
-        rules->srx[channel].agc_adapt_dis        = false;
-        rules->srx[channel].gray_mapping         = host_gray_mapping;
-        rules->srx[channel].invert_chan          = false;
-        rules->srx[channel].ieee_demap           = true;
-        rules->srx[channel].ctle_r_adapt_dis     = false;
-        rules->srx[channel].ctle_c_adapt_en      = false;
-        rules->srx[channel].afe_bw_adapt_dis     = false;
-        rules->srx[channel].lfeq_adapt_dis_after_init_adapt = true;
-        rules->srx[channel].vco_mode             = false;
+        // Spica/PG3 LTX 
+        if ((SPICA_DRIVER_TYPE_EML  == driver_type_ovrd) ||
+           ((SPICA_DRIVER_TYPE_NONE == driver_type_ovrd) &&
+            (SPICA_DRIVER_TYPE_EML  == spica_package_get_driver_type(die))))
+        {
+            // driver type EML
+            tx_rules->lut_mode    = SPICA_LUT_7TAP_LIN;
+            tx_rules->fir_taps[0] = -50;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
+            tx_rules->fir_taps[1] = 750;  
+            tx_rules->fir_taps[2] = 50;   
+            tx_rules->fir_taps[3] = -40;  
+            tx_rules->fir_taps[4] = -30;  
+            tx_rules->fir_taps[5] = -20;  
+            tx_rules->fir_taps[6] = -10;  
+            tx_rules->inner_eye1  = 1380; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
+            tx_rules->inner_eye2  = 2230; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
+        }
+        else // driver type SiPho, 1Vpp or None 
+        {
+            tx_rules->lut_mode    = SPICA_LUT_7TAP_LIN;
+            tx_rules->fir_taps[0] = -50;  /* range -1000 to 1000 where -1000 = -1, 1000 = 1  */
+            tx_rules->fir_taps[1] = 450;  
+            tx_rules->fir_taps[2] = -50;    
+            tx_rules->fir_taps[3] = 0;    
+            tx_rules->fir_taps[4] = 0;    
+            tx_rules->fir_taps[5] = 0;    
+            tx_rules->fir_taps[6] = 0;    
+            tx_rules->inner_eye1  = 1000; /* range  500 to 1500 where  500 = 0.5, 1500 = 1.5 */
+            tx_rules->inner_eye2  = 2000; /* range 1500 to 2500 where 1500 = 1.5, 2500 = 2.5 */
+        }
+    }
+
+    return status;
+}
+
+/**
+ * Struct to define channel defaults
+ * @private
+ */
+typedef struct {
+    /** line baud rate */
+    e_spica_baud_rate lbr;
+    /** line num chs 1-4 */
+    uint8_t lchs;
+    /** line signalling */
+    e_spica_signal_mode lsig;
+    /** host baud rate */
+    e_spica_baud_rate hbr;
+    /** host num chs 1-8 */
+    uint8_t hchs;
+    /** host signalling */
+    e_spica_signal_mode hsig;
+} spica_proto_mode_t;
+
+/* Big LUT of all the protocol modes
+ */
+const spica_proto_mode_t spica_rules_protocol_mode_lut[] = {
+    [SPICA_MODE_400G_4Px53p1_TO_4Px53p1] = {
+        .hchs = 4, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_53p1, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_100G_4Nx25p8_TO_4Nx25p8] = {
+        .hchs = 4, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_25p8, .hsig = SPICA_SIGNAL_MODE_NRZ,
+        .lbr = SPICA_BAUD_RATE_25p8, .lsig = SPICA_SIGNAL_MODE_NRZ,
+    },
+    [SPICA_MODE_300G_4Px41p3_TO_4Px41p3] = {
+        .hchs = 4, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_41p3, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_41p3, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_200G_4Px26p6_TO_4Px26p6] = {
+        .hchs = 4, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_26p6, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_100G_4Nx25p8_TO_2Px25p8] = {
+        .hchs = 4, .lchs = 2,
+        .hbr = SPICA_BAUD_RATE_25p8, .hsig = SPICA_SIGNAL_MODE_NRZ,
+        .lbr = SPICA_BAUD_RATE_25p8, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_400G_8Px26p6_TO_4Px53p1] = {
+        .hchs = 8, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_200G_4Px26p6_TO_2Px53p1] = {
+        .hchs = 4, .lchs = 2,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_100G_2Px26p6_TO_1Px53p1] = {
+        .hchs = 2, .lchs = 1,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_PAM,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_100G_4Nx26p6_TO_1Px53p1] = {
+        .hchs = 4, .lchs = 1,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_NRZ,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+    [SPICA_MODE_200G_4Nx53p1_TO_4Nx53p1] = {
+        .hchs = 4, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_53p1, .hsig = SPICA_SIGNAL_MODE_NRZ,
+        .lbr = SPICA_BAUD_RATE_53p1, .lsig = SPICA_SIGNAL_MODE_NRZ,
+    },
+    [SPICA_MODE_200G_8Nx26p6_TO_4Px26p6] = {
+        .hchs = 8, .lchs = 4,
+        .hbr = SPICA_BAUD_RATE_26p6, .hsig = SPICA_SIGNAL_MODE_NRZ,
+        .lbr = SPICA_BAUD_RATE_26p6, .lsig = SPICA_SIGNAL_MODE_PAM,
+    },
+
+};
+
+/* setup the default rules structure for a bundle based on the op_mode */
+inphi_status_t spica_rules_default_set_per_bundle(
+    uint32_t                 die,
+    uint32_t                 bundle_idx,
+    e_spica_operational_mode op_mode,
+    e_spica_protocol_mode    protocol_mode,
+    spica_rules_t*           rules)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(!rules)
+    {
+        INPHI_CRIT("ERROR: rules cannot be NULL!\n");
+        return INPHI_ERROR;
+    }
+    if (!spica_bundle_is_en(bundle_idx))
+    {
+        INPHI_CRIT("ERROR: Bundle not enabled %lu\n", bundle_idx);
+        return INPHI_ERROR;
+    }
+    if(op_mode >= SPICA_MODE_OP_END)
+    {
+        INPHI_CRIT("ERROR: Invalid op mode %d\n", op_mode);
+        return INPHI_ERROR;
+    }
+    if(protocol_mode >= SPICA_MODE_PROT_END)
+    {
+        INPHI_CRIT("ERROR: Invalid protocol_mode %d\n", protocol_mode);
+        return INPHI_ERROR;
+    }
+
+    //setup the host/line details based on the protocol mode
+    const spica_proto_mode_t *pro = &spica_rules_protocol_mode_lut[protocol_mode];
+
+    e_spica_signal_mode host_signalling = pro->hsig;
+    e_spica_signal_mode line_signalling = pro->lsig;
+    uint32_t host_baud_rate             = pro->hbr;
+    uint32_t line_baud_rate             = pro->lbr;
+    uint32_t host_num_channels_en       = pro->hchs;
+    uint32_t line_num_channels_en       = pro->lchs;
+
+    rules->fw_dwld_timeout              = 300; /* 15 seconds, units are SPICA_MCU_POLL_DELAY_MS milli-secs */
+
+    // By default warn if the f/w version encountered does not
+    // match the version the API was compiled with.
+    rules->fw_warn_if_mismatched        = true;
+
+    //setup the high-level rules
+    rules->operational_mode             = op_mode;
+    rules->protocol_mode                = protocol_mode;
+
+    rules->driver_type_override         = SPICA_DRIVER_TYPE_NONE;
+
+    rules->lrx_los_dsrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_200;
+
+    // Only needed for NRZ ... hardcode for PAM
+    if(line_signalling == SPICA_SIGNAL_MODE_PAM)
+    {
+        rules->lrx_los_asrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_100;
+        rules->lrx_los_asrt_ctrl_datamode   = SPICA_LOS_CTRL_AMP_100;
+    }
+    else // NRZ 
+    {
+        rules->lrx_los_asrt_ctrl_startup    = SPICA_LOS_CTRL_AMP_100;
+        rules->lrx_los_asrt_ctrl_datamode   = SPICA_LOS_CTRL_AMP_100;
+    }
+
+    if(line_signalling == SPICA_SIGNAL_MODE_PAM)
+    {
+        rules->lrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_17dB;
+        rules->lrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_16dB;
+        rules->lrx_qc.slc_err_limit          = 50;
+        rules->advanced.lrx_ddlf_en          = true; // hide in public API
+        rules->advanced.lrx_cid_losd_det_en  = true;
+    }
+    else // NRZ 
+    {
+        rules->lrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_19dB;
+        rules->lrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_18dB;
+        rules->lrx_qc.slc_err_limit          = 50;
+        rules->advanced.lrx_ddlf_en          = false;
+        rules->advanced.lrx_cid_losd_det_en  = false;
+    }  
+ 
+    if(host_signalling == SPICA_SIGNAL_MODE_PAM)
+    {
+        rules->hrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_17dB;
+        rules->hrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_16dB;
+        rules->hrx_qc.slc_err_limit          = 50;
+        rules->advanced.hrx_ddlf_en          = false;
+        rules->advanced.hrx_cid_losd_det_en  = true;
+    }
+    else // NRZ 
+    {
+        rules->hrx_qc.snr_threshold_mm_enter = SPICA_RX_QC_SNR_THRESH_19dB;
+        rules->hrx_qc.snr_threshold_mm_exit  = SPICA_RX_QC_SNR_THRESH_18dB;
+        rules->hrx_qc.slc_err_limit          = 50;
+        rules->advanced.hrx_ddlf_en          = false;
+        rules->advanced.hrx_cid_losd_det_en  = false;
+    }
+
+    rules->advanced.lrx_low_loss_det_en      = false;
+
+    if(host_baud_rate > SPICA_BAUD_RATE_41p3)
+    { 
+        rules->advanced.hrx_low_loss_det_en      = true;
+    }
+    else if (host_baud_rate == SPICA_BAUD_RATE_41p3)
+    {
+        rules->advanced.hrx_low_loss_det_en      = false;
+    }
+    else 
+    {
+        rules->advanced.hrx_low_loss_det_en      = false;
+    }
+
+    rules->advanced.lrx_double_restart_dis   = false;
+
+    //handle host channel enables and signalling based on the op mode and package
+    bool host_gray_mapping = (host_signalling == SPICA_SIGNAL_MODE_PAM);
+    bool line_gray_mapping = (line_signalling == SPICA_SIGNAL_MODE_PAM);
+
+    uint32_t base_die = spica_package_get_base_die(die);
+
+    //get the enabled interfaces based on the op mode
+    e_spica_intf en_intfs = spica_op_mode_en_intfs(base_die, op_mode);
+
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_ORX)
+    {
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
+        rules->orx[channel].channel_enable      = (en_intfs & SPICA_INTF_ORX) && (((channel-1)%SPICA_NUM_OF_ORX_CHANNELS+1) <= line_num_channels_en);
+        rules->orx[channel].signalling          = line_signalling;
+        rules->orx[channel].baud_rate           = line_baud_rate;
+        rules->orx[channel].ieee_demap          = true;
+        rules->orx[channel].gray_mapping        = line_gray_mapping;
+        rules->orx[channel].invert_chan         = false;
+        rules->orx[channel].sdt_dsp_en          = false;
+        rules->orx[channel].los_dsp_en          = false;
+        rules->orx[channel].six_bit_mode        = SPICA_6BIT_MODE_DISABLE;
+        rules->orx[channel].force_mission_mode  = false;
+        rules->orx[channel].restart_on_los_dis     = false;
+        rules->orx[channel].ffe_const_diff_en   = true;
+        rules->orx[channel].bw_idx_max          = 1;
+        rules->orx[channel].vga1_tracking_period= 4; 
+        rules->orx[channel].alg1_dis            = false; 
+        rules->orx[channel].alg2_dis            = false; 
+        rules->orx[channel].alg3_dis            = false; 
+        rules->orx[channel].alg4_dis            = false; 
+        rules->orx[channel].qc_all_dis          = false; 
+        rules->orx[channel].qc_hist_dis         = false; 
+        rules->orx[channel].qc_slc_dis          = false; 
+        rules->orx[channel].qc_snr_dis          = false; 
+    }
+#if !defined(INPHI_REMOVE_PMR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MRX)
+    {
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (host_num_channels_en)
+        rules->mrx[channel].channel_enable      = (en_intfs & SPICA_INTF_MRX) && (((channel-1)%SPICA_NUM_OF_MRX_CHANNELS+1) <= host_num_channels_en);
+        rules->mrx[channel].signalling          = host_signalling;
+        rules->mrx[channel].baud_rate           = host_baud_rate;
+        rules->mrx[channel].ieee_demap          = true;
+        rules->mrx[channel].gray_mapping        = host_gray_mapping;
+        rules->mrx[channel].invert_chan         = false;
+        rules->mrx[channel].sdt_dsp_en          = false;
+        rules->mrx[channel].los_dsp_en          = false;
+        rules->mrx[channel].force_mission_mode  = false;
+        rules->mrx[channel].restart_on_los_dis  = false;
+        rules->mrx[channel].ffe_const_diff_en   = true;
+        rules->mrx[channel].bw_idx_max          = 6;
+        rules->mrx[channel].vga1_tracking_period= 4;
+        rules->mrx[channel].alg1_dis            = false; 
+        rules->mrx[channel].alg2_dis            = false; 
+        rules->mrx[channel].alg3_dis            = false; 
+        rules->mrx[channel].alg4_dis            = false;
+        rules->mrx[channel].qc_all_dis          = false; 
+        rules->mrx[channel].qc_hist_dis         = false; 
+        rules->mrx[channel].qc_slc_dis          = false; 
+        rules->mrx[channel].qc_snr_dis          = false;  
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_SRX)
+    {
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (host_num_channels_en)
+        rules->srx[channel].channel_enable       = (en_intfs & SPICA_INTF_SRX) && (((channel-1)%SPICA_NUM_OF_SRX_CHANNELS+1) <= host_num_channels_en);
+        rules->srx[channel].ctle_adapt_dis       = false;
+        rules->srx[channel].lfeq_adapt_dis       = false;
+        rules->srx[channel].skip_adapt           = false;
+        rules->srx[channel].dfe_adapt_dis        = false;
+        rules->srx[channel].signalling           = host_signalling;
+        rules->srx[channel].data_skew_adapt_dis  = false;
+        rules->srx[channel].edge_skew_adapt_dis  = false;
+        rules->srx[channel].vco_temp_cal_dis     = false;
+        rules->srx[channel].slc_adapt_dis        = false;
+        rules->srx[channel].edge_off_adapt_dis   = false;
+        rules->srx[channel].agc_adapt_dis        = false;
+        rules->srx[channel].gray_mapping         = host_gray_mapping;
+        rules->srx[channel].invert_chan          = false;
+        rules->srx[channel].ieee_demap           = true;
+        rules->srx[channel].ctle_r_adapt_dis     = false;
+        rules->srx[channel].ctle_c_adapt_en      = false;
+        rules->srx[channel].afe_bw_adapt_dis     = false;
+        rules->srx[channel].lfeq_adapt_dis_after_init_adapt = true;
+        rules->srx[channel].vco_mode             = false;
+
+        rules->srx[channel].baud_rate            = host_baud_rate;
+
+        rules->srx[channel].ctle_override = SPICA_SRX_RXA_AFE_CTLE_CFG__DEFAULT;
+        rules->srx[channel].lfeq_override = SPICA_SRX_RXA_AFE_LFEQ_CFG__DEFAULT;
+
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+    {
+        // set the default Tx rules
+        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_OTX, rules->driver_type_override, &rules->otx[channel]);
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
+        rules->otx[channel].channel_enable  = (en_intfs & SPICA_INTF_OTX) && (((channel-1)%SPICA_NUM_OF_OTX_CHANNELS+1) <= line_num_channels_en);
+        rules->otx[channel].gray_mapping    = line_gray_mapping;
+        rules->otx[channel].signalling      = line_signalling;
+        rules->otx[channel].baud_rate       = line_baud_rate;
+    }
+#if !defined(INPHI_REMOVE_PMR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
+    {
+        // set the default Tx rules
+        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_MTX, rules->driver_type_override, &rules->mtx[channel]);
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
+        rules->mtx[channel].channel_enable  = (en_intfs & SPICA_INTF_MTX) && (((channel-1)%SPICA_NUM_OF_MTX_CHANNELS+1) <= host_num_channels_en);
+        rules->mtx[channel].gray_mapping    = host_gray_mapping;
+        rules->mtx[channel].signalling      = host_signalling;
+        rules->mtx[channel].baud_rate       = host_baud_rate;
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+    {
+        // set the default Tx rules
+        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_STX, rules->driver_type_override, &rules->stx[channel]);
+        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
+        rules->stx[channel].channel_enable  = (en_intfs & SPICA_INTF_STX) && (((channel-1)%SPICA_NUM_OF_STX_CHANNELS+1) <= host_num_channels_en);
+        rules->stx[channel].gray_mapping    = host_gray_mapping;
+        rules->stx[channel].signalling      = host_signalling;
+        rules->stx[channel].baud_rate       = host_baud_rate;
+        rules->stx[channel].swing           = SPICA_TX_SWING_NA; /* Override, not applicable to STX interface */
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    // OTX/MTX/STX xbar defaults (Dependant on operational mode and protocol mode)
+    int eg_gb_ratio = host_num_channels_en/line_num_channels_en;  // Egress gearbox ratio (host:line)
+    int ig_gb_ratio = eg_gb_ratio;  // Ingress gearbox ratio - default to eg_gb_ratio (host:line)
+
+    // Set all xbar vectors in bundle to 0xf initially
+    uint8_t j;
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+    {
+        for(j=0; j<sizeof(rules->otx_xbar_src_chan[0])/sizeof(rules->otx_xbar_src_chan[0][0]); j++)
+        {
+            rules->otx_xbar_src_chan[channel][j] = 0xf;
+        }
+        rules->otx_clk_xbar[channel] = 0xf;
+    }
+#if !defined(INPHI_REMOVE_PMR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
+    {
+        for(j=0; j<sizeof(rules->mtx_xbar_src_chan[0])/sizeof(rules->mtx_xbar_src_chan[0][0]); j++)
+        {
+            rules->mtx_xbar_src_chan[channel][j] = 0xf;
+        }
+        rules->mtx_clk_xbar[channel] = 0xf;
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+    {
+        for(j=0; j<sizeof(rules->stx_xbar_src_chan[0])/sizeof(rules->stx_xbar_src_chan[0][0]); j++)
+        {
+            rules->stx_xbar_src_chan[channel][j] = 0xf;
+        }
+        rules->stx_clk_xbar[channel] = 0xf;
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    switch(rules->operational_mode) {
+        case SPICA_MODE_LINE_PRBS:
+        case SPICA_MODE_HOST_PRBS:
+        case SPICA_MODE_DUAL_PRBS:
+        case SPICA_MODE_EGRESS_PRBS:
+        case SPICA_MODE_INGRESS_PRBS:
+        case SPICA_MODE_MISSION_MODE:
+            // Default ingress/egress xbar config
+            break;
+        case SPICA_MODE_SHALLOW_LINE_LOOPBACK:
+            // Override default OTX xbar configs
+            eg_gb_ratio = 1;
+            break;
+        case SPICA_MODE_SHALLOW_HOST_LOOPBACK:
+            // Override default MTX/STX xbar settings
+            ig_gb_ratio = 1;
+            break;
+
+        default:
+            break;
+    }
+
+    // OTX XBAR CONFIG
+    uint32_t num_channels=0;
+    uint32_t first_ch_in_gb_set;
+    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+    {
+        if(num_channels>=line_num_channels_en)
+        {
+            // All channels needed for protocol_mode allocated within bundle 
+            break;
+        }
+
+        // Calculate the base channel for gearbox set of channels
+        first_ch_in_gb_set = channel + num_channels*(eg_gb_ratio - 1);
+
+        // clk xbar config
+        rules->otx_clk_xbar[channel] = first_ch_in_gb_set;
+
+        // data xbar config
+        for(int n=0; n<eg_gb_ratio; n++)
+        {
+            // Spread Rx channels equally amongst line channels.
+            // otx_xbar_src_chan[line_channel] = {rx_channel_1, rx_channel_2, etc.}
+            // ie. 4:1 gearbox mode
+            // otx_xbar_src_chan[1] = {1, 2, 3, 4}
+            // ie. 2:2 gearbox mode
+            // otx_xbar_src_chan[1] = {1, 0xf, 0xf, 0xf}
+            // otx_xbar_src_chan[2] = {2, 0xf, 0xf, 0xf}
+
+            rules->otx_xbar_src_chan[channel][n] = first_ch_in_gb_set + n;
+            //INPHI_NOTE("otx_xbar_src_chan[%d][%d] = %d\n", channel, n, rules->otx_xbar_src_chan[channel][n]);
+        }
+        num_channels++;
+    }
+
+#if !defined(INPHI_REMOVE_PMR)
+    num_channels=0;
+    if(SPICA_INTF_PMR & spica_package_get_intf(die))
+    {
+        // MTX XBAR CONFIG
+        SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
+        {
+            if(num_channels>=host_num_channels_en)
+            {
+                // All channels needed for protocol_mode allocated within bundle 
+                break;
+            }
+
+            // Calculate the base channel for gearbox set of channels
+            first_ch_in_gb_set = channel + (num_channels/ig_gb_ratio) - num_channels;
+
+            // clk xbar config
+            rules->mtx_clk_xbar[channel] = first_ch_in_gb_set;
+
+            // data xbar config
+            // Split up the Rx channels (Either ORX or MRX) equally amongst MTX channels.
+            // For each MTX Tx channel specify a src Rx channel, and the interleave index within the channel (Reverse Gearbox)
+            // An Rx channel can contain up to 4 MTX channels (When RX is ORX)
+            // ie. 4:1 gearbox mode
+            // mtx_xbar_src_chan[host_tx_channel][0] = src_channel
+            // mtx_xbar_src_chan[host_tx_channel][1] = interleave index // 0-based
+            // mtx_xbar_src_chan[1][0] = 1 // channel
+            // mtx_xbar_src_chan[1][1] = 0 // interleave index 
+            // mtx_xbar_src_chan[2][0] = 1
+            // mtx_xbar_src_chan[2][1] = 1
+            // mtx_xbar_src_chan[3][0] = 1
+            // mtx_xbar_src_chan[3][1] = 2
+            // mtx_xbar_src_chan[4][0] = 1
+            // mtx_xbar_src_chan[4][1] = 3
+
+            rules->mtx_xbar_src_chan[channel][0] = first_ch_in_gb_set;
+            rules->mtx_xbar_src_chan[channel][1] = (channel-1)%ig_gb_ratio;
+            //INPHI_NOTE("mtx_xbar_src_chan[%d][0] = %d\n", channel, rules->mtx_xbar_src_chan[channel][0]);
+            //INPHI_NOTE("mtx_xbar_src_chan[%d][1] = %d\n", channel, rules->mtx_xbar_src_chan[channel][1]);
+
+            num_channels++;
+       }
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+
+#if !defined(INPHI_REMOVE_PSR)
+    num_channels=0;
+    if(SPICA_INTF_PSR & spica_package_get_intf(die))
+    {   
+        // STX XBAR CONFIG
+        SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+        {
+            if(num_channels>=host_num_channels_en)
+            {
+                // All channels needed for protocol_mode allocated within bundle 
+                break;
+            }
+            // Calculate the base channel for gearbox set of channels
+            first_ch_in_gb_set = channel + (num_channels/ig_gb_ratio) - num_channels;
+
+            // clk xbar config
+            rules->stx_clk_xbar[channel] = first_ch_in_gb_set;
+
+            // data xbar config
+            // Split up the Rx channels (Either ORX or SRX) equally amongst STX channels.
+            // For each STX Tx channel specify a src Rx channel, and the interleave index within the channel (Reverse Gearbox)
+            // An Rx channel can contain up to 4 STX channels (When RX is ORX)
+            // ie. 4:1 gearbox mode
+            // stx_xbar_src_chan[host_tx_channel][0] = src_channel
+            // stx_xbar_src_chan[host_tx_channel][1] = interleave index // 0-based
+            // stx_xbar_src_chan[1][0] = 1 // channel
+            // stx_xbar_src_chan[1][1] = 0 // interleave index 
+            // stx_xbar_src_chan[2][0] = 1
+            // stx_xbar_src_chan[2][1] = 1
+            // stx_xbar_src_chan[3][0] = 1
+            // stx_xbar_src_chan[3][1] = 2
+            // stx_xbar_src_chan[4][0] = 1
+            // stx_xbar_src_chan[4][1] = 3
+            // stx_xbar_src_chan[5][0] = 0xf
+            // stx_xbar_src_chan[5][1] = 0xf
+            // ...
+            // stx_xbar_src_chan[8][0] = 0xf
+            // stx_xbar_src_chan[8][0] = 0xf
+
+            rules->stx_xbar_src_chan[channel][0] = first_ch_in_gb_set;
+            rules->stx_xbar_src_chan[channel][1] = (channel-1)%ig_gb_ratio;
+            //INPHI_NOTE("stx_xbar_src_chan[%d][0] = %d\n", channel, rules->stx_xbar_src_chan[channel][0]);
+            //INPHI_NOTE("stx_xbar_src_chan[%d][1] = %d\n", channel, rules->stx_xbar_src_chan[channel][1]);
+
+            num_channels++;
+        }
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    return status;
+}
+
+/* setup the default rules structure for all bundles */
+inphi_status_t spica_rules_default_set(
+    uint32_t                 die,
+    e_spica_operational_mode op_mode,
+    e_spica_protocol_mode    protocol_mode,
+    spica_rules_t*           rules)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(!rules)
+    {
+        INPHI_CRIT("ERROR: rules cannot be NULL!\n");
+        return INPHI_ERROR;
+    }
+
+    // reset the entire rules structure
+    INPHI_MEMSET(rules, 0, sizeof(spica_rules_t));
+
+    for (uint8_t bundle_idx = 0; bundle_idx < SPICA_MAX_BUNDLES; bundle_idx++) 
+    {
+        if (spica_bundle_is_en(bundle_idx))
+        {   
+            status |= spica_rules_default_set_per_bundle(die, bundle_idx, op_mode, protocol_mode, rules);
+        }
+    }
+
+    return status;
+}
+
+// Squelch the transmit output for the specified channel
+inphi_status_t spica_tx_squelch(
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    bool         squelch)
+{
+    inphi_status_t status = INPHI_OK;
+
+    SPICA_LOCK(die);
+
+    if(intf == SPICA_INTF_OTX)
+    {
+        SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+    }
+    else if (intf == SPICA_INTF_MTX)
+    {
+        SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+    }
+    else if (intf == SPICA_INTF_STX)
+    {
+        SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+    }
+    else
+    {
+        INPHI_CRIT("ERROR: Unsupported Interface\n");
+    }
+
+    SPICA_UNLOCK(die);
+
+    return status;
+}
+
+/*
+ * Resolve the squelch register of every channel of a TX interface.
+ */
+inphi_status_t spica_tx_squelch_map_init(
+    spica_tx_squelch_map_t* map,
+    uint32_t                die,
+    e_spica_intf            intf)
+{
+    uint32_t base_addr;
+    uint32_t die_channels;
+    uint32_t min, max;
+    uint32_t channel;
+    uint32_t remap;
+    uint32_t bcast = SPICA_BROADCAST_CHANNEL;
+    uint32_t lane;
+    uint32_t data;
+    inphi_status_t status = INPHI_OK;
+
+    if(!map)
+    {
+        INPHI_CRIT("ERROR: map cannot be NULL!\n");
+        return INPHI_ERROR;
+    }
+
+    INPHI_MEMSET(map, 0, sizeof(*map));
+
+    if(intf == SPICA_INTF_OTX)
+    {
+        base_addr    = SPICA_OTX_TXD_SQUELCH_EN_CFG__ADDRESS;
+        die_channels = SPICA_NUM_OF_OTX_CHANNELS;
+    }
+    else if(intf == SPICA_INTF_MTX)
+    {
+        base_addr    = SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__ADDRESS;
+        die_channels = SPICA_NUM_OF_MTX_CHANNELS;
+    }
+    else if(intf == SPICA_INTF_STX)
+    {
+        base_addr    = SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__ADDRESS;
+        die_channels = SPICA_NUM_OF_STX_CHANNELS;
+    }
+    else
+    {
+        INPHI_CRIT("ERROR: Unsupported Interface\n");
+        return INPHI_ERROR;
+    }
+
+    spica_package_get_channels(die, intf, &min, &max);
+    if((max < min) || ((max - min + 1) > SPICA_TX_SQUELCH_MAX_LANES))
+    {
+        INPHI_CRIT("ERROR: Unsupported channel range %lu..%lu\n", min, max);
+        return INPHI_ERROR;
+    }
+
+    SPICA_LOCK(die);
+
+    map->num_lanes = max - min + 1;
+    map->bcast_ok  = (map->num_lanes == die_channels);
+
+    for(channel = min; channel <= max; channel++)
+    {
+        lane  = channel - min;
+        remap = channel;
+        map->die[lane]  = die;
+        map->addr[lane] = base_addr;
+        spica_rebase_by_addr(&map->die[lane], &remap, &map->addr[lane]);
+
+        // A single broadcast only reaches the channels of one die
+        if(map->die[lane] != map->die[0])
+        {
+            map->bcast_ok = false;
+        }
+
+        data = 0;
+        status |= spica_reg_get(map->die[lane], map->addr[lane], &data);
+        if(data & 0x1)
+        {
+            map->squelched |= (1 << lane);
+        }
+    }
+
+    map->bcast_die  = die;
+    map->bcast_addr = base_addr;
+    spica_rebase_by_addr(&map->bcast_die, &bcast, &map->bcast_addr);
+
+    SPICA_UNLOCK(die);
+
+    // The squelch state is unknown, leave the map unusable
+    if(status != INPHI_OK)
+    {
+        map->num_lanes = 0;
+    }
+
+    return status;
+}
+
+/*
+ * Squelch or unsquelch a set of lanes. Only the lanes whose state changes
+ * are written. The squelch registers hold nothing but the SQUELCH_EN bit so
+ * a plain write replaces the read/modify/write, and when every lane ends up
+ * in the same state a single broadcast write covers them all. A lane whose
+ * write fails keeps its previous state in the map, the next call writes it
+ * again.
+ */
+inphi_status_t spica_tx_squelch_lanes(
+    spica_tx_squelch_map_t* map,
+    uint32_t                lane_mask,
+    uint32_t                squelch_mask)
+{
+    uint32_t all_lanes;
+    uint32_t target;
+    uint32_t changed;
+    uint32_t lane;
+    uint32_t data;
+    inphi_status_t status = INPHI_OK;
+
+    if(!map || (map->num_lanes == 0))
+    {
+        INPHI_CRIT("ERROR: map not initialized!\n");
+        return INPHI_ERROR;
+    }
+
+    all_lanes = (map->num_lanes >= 32) ? 0xffffffff : ((1u << map->num_lanes) - 1);
+    lane_mask &= all_lanes;
+    target  = (map->squelched & ~lane_mask) | (squelch_mask & lane_mask);
+    changed = target ^ map->squelched;
+
+    if(changed == 0)
+    {
+        return INPHI_OK;
+    }
+
+    SPICA_LOCK(map->die[0]);
+
+    if(map->bcast_ok && ((target == 0) || (target == all_lanes)) && (changed & (changed - 1)))
+    {
+        data = target ? 1 : 0;
+        status = spica_reg_set(map->bcast_die, map->bcast_addr, data);
+        if(status == INPHI_OK)
+        {
+            map->squelched = target;
+            if(g_spica_config_snapshot != NULL)
+            {
+                spica_config_snapshot_record(map->bcast_die, map->bcast_addr, data);
+            }
+        }
+    }
+    else
+    {
+        for(lane = 0; lane < map->num_lanes; lane++)
+        {
+            if(!(changed & (1u << lane)))
+            {
+                continue;
+            }
+            data = (target >> lane) & 0x1;
+            if(spica_reg_set(map->die[lane], map->addr[lane], data) != INPHI_OK)
+            {
+                status = INPHI_ERROR;
+                continue;
+            }
+            map->squelched ^= (1u << lane);
+            if(g_spica_config_snapshot != NULL)
+            {
+                spica_config_snapshot_record(map->die[lane], map->addr[lane], data);
+            }
+        }
+    }
+
+    SPICA_UNLOCK(map->die[0]);
+
+    return status;
+}
+
+/*
+ * This method may be called to query the current configuration of the
+ * transmitters from the ASIC.
+ */
+inphi_status_t spica_tx_fir_query(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    spica_tx_rules_t* tx_rules)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(!tx_rules)
+    {
+        INPHI_CRIT("ERROR: tx rules cannot be NULL!\n");
+        return INPHI_ERROR;
+    }
+
+    INPHI_MEMSET(tx_rules, 0, sizeof(*tx_rules));
+
+    status |= spica_cp_tx_overlays_to_rules(die, channel, intf, tx_rules);
+
+    return status;
+}
+
+/*
+ * Update the TX FIR configuration.
+ */
+inphi_status_t spica_tx_fir_set(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    spica_tx_rules_t* tx_rules)
+{
+    inphi_status_t status = INPHI_OK;
+    bool update_done = false;
+    uint16_t data;
+
+    // NOTE: spica_tx_fir_set() only supported on-the-fly updates to the following rules
+    // - lut_mode 
+    // - swing
+    // - fir_taps
+    // - inner_eye1
+    // - inner_eye2
+    // Check that user has not attempted to change unsupported rules
+    if (intf == SPICA_INTF_OTX) 
+    {
+        data = SPICA_OTX_RULES_0__READ(die, channel);
+        if(tx_rules->squelch_lock   != SPICA_OTX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
+        if(tx_rules->channel_enable != SPICA_OTX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
+        if(tx_rules->signalling     != SPICA_OTX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->ieee_demap     != SPICA_OTX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->invert_chan    != SPICA_OTX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
+        if(tx_rules->gray_mapping   != SPICA_OTX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
+    }
+    else if (intf == SPICA_INTF_MTX) 
+    {
+#if !defined(INPHI_REMOVE_PMR)
+        data = SPICA_MTX_RULES_0__READ(die, channel);
+        if(tx_rules->squelch_lock   != SPICA_MTX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
+        if(tx_rules->channel_enable != SPICA_MTX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
+        if(tx_rules->signalling     != SPICA_MTX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->ieee_demap     != SPICA_MTX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->invert_chan    != SPICA_MTX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
+        if(tx_rules->gray_mapping   != SPICA_MTX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
+#endif // defined(INPHI_REMOVE_PMR)
+    }
+    else // intf == SPICA_INTF_STX 
+    {
+#if !defined(INPHI_REMOVE_PSR)
+        data = SPICA_STX_RULES_0__READ(die, channel);
+        if(tx_rules->squelch_lock   != SPICA_STX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
+        if(tx_rules->channel_enable != SPICA_STX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
+        if(tx_rules->signalling     != SPICA_STX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->ieee_demap     != SPICA_STX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
+        if(tx_rules->invert_chan    != SPICA_STX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
+        if(tx_rules->gray_mapping   != SPICA_STX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
+#endif // defined(INPHI_REMOVE_PSR)
+    }
+
+    if(status != INPHI_OK) 
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Member of tx_rules() not supported by this method has been changed  ...\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        return status;
+    }
+
+    // Checks that settings for rules allowed to be changed are valid
+    status |= spica_tx_check_rules(die, channel, intf, tx_rules);
+
+    //send the rules
+    status |= spica_cp_tx_rules_to_overlays(die, channel, intf, tx_rules);
+
+    if(status != INPHI_OK) 
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Failed copying tx rules to overlays ...\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        return status;
+    }
+
+    // Tell the FW that new tx rules are now available
+    int32_t attempts=30000; // 3 seconds
+    // Signal to the FW to config the Tx with the new rules
+    if (intf == SPICA_INTF_OTX) 
+    {
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear ACK
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
+        // Wait for FW to update rules
+        while(attempts > 0)
+        {
+            update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
+            if(update_done) 
+            {
+                break;
+            }
+            INPHI_UDELAY(100);
+            attempts -= 1;
+        }
+    }
+#if !defined(INPHI_REMOVE_PMR)
+    else if (intf == SPICA_INTF_MTX)
+    {
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear ACK
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
+        // Wait for FW to update rules
+        while(attempts > 0)
+        {
+            update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
+            if(update_done) 
+            {
+                break;
+            }
+            INPHI_UDELAY(100);
+            attempts -= 1;
+        }
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    else // intf == SPICA_INTF_STX
+    {
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
+        // Wait for FW to update rules
+        while(attempts > 0)
+        {
+            update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
+            if(update_done) 
+            {
+                break;
+            }
+            INPHI_UDELAY(100);
+            attempts -= 1;
+        }
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    if((status) || (attempts <= 0))
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update tx_fir...\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        status |= INPHI_ERROR;
+    }
+
+    return status;
+}
+
+/*
+ * This method may be called to query the current status of 
+ * one or more interfaces of a selected channel.
+ */
+bool spica_channel_is_link_ready(
+    uint32_t      die,
+    uint32_t      channel,
+    e_spica_intf  intf)
+{
+    uint32_t fw_lock = 0; // 0/1 bit map, same map as e_spica_intf
+
+    if (SPICA_INTF_OTX & intf)
+    {
+        if (SPICA_OTX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+            fw_lock |= SPICA_INTF_OTX;
+        }
+    }
+    if (SPICA_INTF_ORX & intf)
+    {
+        if (SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+           fw_lock |= SPICA_INTF_ORX;
+        }
+    }
+#if !defined(INPHI_REMOVE_PMR)
+    if (SPICA_INTF_MTX & intf)
+    {
+        if (SPICA_MTX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+            fw_lock |= SPICA_INTF_MTX;
+        }
+    }
+    if (SPICA_INTF_MRX & intf)
+    {
+        if (SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+           fw_lock |= SPICA_INTF_MRX;
+        }
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    if (SPICA_INTF_STX & intf)
+    {
+        if (SPICA_STX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+            fw_lock |= SPICA_INTF_STX;
+        }
+    }
+    if (SPICA_INTF_SRX & intf)
+    {
+        if (SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel))
+        {
+           fw_lock |= SPICA_INTF_SRX;
+        }
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+
+    // INPHI_NOTE("die=0x%08x, channel=%d, intf=0x%08x, fw_lock=0x%08x\n", die, channel, intf, fw_lock);
+
+    if (intf == fw_lock)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Wait for all channels to be in the receive ready state
+ */
+inphi_status_t spica_wait_for_link_ready(
+    uint32_t   die,
+    uint32_t   timeout_in_usecs)
+{
+    // Clear bottom bits to make the next stuff easier
+    die = spica_package_get_base_die(die);
+    uint32_t num_dies = spica_package_get_num_dies(die);
+
+    // If there are multiple dies inside the package then
+    // iterate through each one and check the status of all
+    // channels.
+    for(uint32_t i = 0; i < num_dies; i++)
+    {
+        uint32_t timer = 0;
+        while((timer < timeout_in_usecs) && 
+              (0 == SPICA_MCU_SP6_FW_STATUS__LOCKED__READ(die+i)))
+        {
+            timer += 1000*SPICA_EVENT_WAIT(die+i, SPICA_EVENT_LINK, 1);
+        }
+        if(timer >= timeout_in_usecs)
+        {
+            return INPHI_ERROR;
+        }
+    }
+    return INPHI_OK;
+}
+
+/*
+ * Wait for the selected interfaces of a channel ie ORX,OTX,MRX and MTX 
+ * to be in the locked state.
+ */
+inphi_status_t spica_channel_wait_for_link_ready(
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t     timeout_in_usecs)
+{
+    uint32_t timer = 0;
+
+    while (timer < timeout_in_usecs)
+    {
+        if (spica_channel_is_link_ready(die, channel, intf))
+        {
+            return INPHI_OK;
+        }
+
+        timer += 1000*SPICA_EVENT_WAIT(die, SPICA_EVENT_LINK, 1);
+    }
+
+    return INPHI_ERROR;
+}
+
+/*
+ * This method may be called to query the current link status
+ * of the interfaces of the device.
+ */
+inphi_status_t spica_link_status_query(
+    uint32_t die,
+    spica_link_status_t* link_status)
+{
+    inphi_status_t status = INPHI_OK;
+
+    // Clear bottom bits to make the next stuff easier
+    die = spica_package_get_base_die(die);
+
+    uint32_t num_dies = spica_package_get_num_dies(die);
+
+    // One entry per die
+    uint16_t reset_cfg[SPICA_MAX_DIES_IN_PACKAGE] = {0};
+
+    /* pre-set the status  */
+    INPHI_MEMSET(link_status, 0, sizeof(*link_status));
+
+    link_status->fw_lock = true;
+    for(uint32_t i = 0; i < num_dies; i++) 
+    {
+        // get the reset state of the interface blocks
+        reset_cfg[i] = SPICA_MMD30_RESET_CFG__READ(die+i);
+
+        // Top Level is the LOCKED bit on both dies
+        link_status->fw_lock &= (1 == SPICA_MCU_SP6_FW_STATUS__LOCKED__READ(die+i));
+    }
+
+    // ORX
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_ORX)&1;
+        if (SPICA_MMD30_RESET_CFG__ORX_SR__GET(reset_cfg[i]))
+        {
+            break; //bust out, this block is in reset
+        }
+        link_status->orx_pll_lock[channel]      = SPICA_ORX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+        link_status->orx_pll_fsm_state[channel] = SPICA_ORX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+        link_status->orx_fw_lock[channel]       = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
+        link_status->orx_reset_cnt[channel]     = SPICA_ORX_FW_STATUS__RESET_COUNT__READ(die, channel);
+        link_status->orx_sdt[channel]           = SPICA_ORX_FW_STATUS__SDT__READ(die, channel);
+        link_status->orx_fsm_state[channel]     = SPICA_ORX_FW_STATES__FSM_STATE_TOP__READ(die, channel);
+    }
+
+    // OTX
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_OTX)&1;
+        if (SPICA_MMD30_RESET_CFG__OTX_SR__GET(reset_cfg[i]))
+        {
+            break; //bust out, this block is in reset
+        }
+        link_status->otx_pll_lock[channel]      = SPICA_OTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+        link_status->otx_pll_fsm_state[channel] = SPICA_OTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+        link_status->otx_fw_lock[channel]       = SPICA_OTX_FW_STATUS__LOCKED__READ(die, channel);
+        link_status->otx_reset_cnt[channel]     = SPICA_OTX_FW_STATUS__RESET_COUNT__READ(die, channel);
+        link_status->otx_fsm_state[channel]     = SPICA_OTX_FW_STATUS__STATE__READ(die, channel);
+    }
+
+#if !defined(INPHI_REMOVE_PMR)
+    if (spica_package_has_pmr(die))
+    {
+        // MRX
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_MRX)
+        {
+            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_MRX)&1;
+            if (SPICA_MMD30_RESET_CFG__MRX_SR__GET(reset_cfg[i]))
+            {
+                break; //bust out, this block is in reset or powered down
+            }
+            link_status->hrx_pll_lock[channel]      = SPICA_MRX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->hrx_pll_fsm_state[channel] = SPICA_MRX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+            link_status->hrx_fw_lock[channel]       = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->hrx_reset_cnt[channel]     = SPICA_MRX_FW_STATUS__RESET_COUNT__READ(die, channel);
+            link_status->hrx_sdt[channel]           = SPICA_MRX_FW_STATUS__SDT__READ(die, channel);
+            link_status->hrx_fsm_state[channel]     = SPICA_MRX_FW_STATES__FSM_STATE_TOP__READ(die, channel);
+        }
+
+        // MTX
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_MTX)
+        {
+            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_MTX)&1;
+            if (SPICA_MMD30_RESET_CFG__SMTX_SR__GET(reset_cfg[i]))
+            {
+                break; //bust out, this block is in reset
+            }
+            link_status->htx_pll_lock[channel]      = SPICA_SMTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->htx_pll_fsm_state[channel] = SPICA_SMTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+            link_status->htx_fw_lock[channel]       = SPICA_MTX_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->htx_reset_cnt[channel]     = SPICA_MTX_FW_STATUS__RESET_COUNT__READ(die, channel);
+            link_status->htx_fsm_state[channel]     = SPICA_MTX_FW_STATUS__STATE__READ(die, channel);
+        }
+    }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    if (spica_package_has_psr(die))
+    {
+        // SRX
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_SRX)
+        {
+            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_SRX)&1;
+            if (SPICA_MMD30_RESET_CFG__SRX_SR__GET(reset_cfg[i]))
+            {
+                break; //bust out, this block is in reset
+            }
+            // link_status->hrx_pll_lock[channel]      = SPICA_MRX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+            // link_status->hrx_pll_fsm_state[channel] = SPICA_MRX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+            // link_status->hrx_vco_lock[channel]      = SPICA_SRX_RXD_INTS__CTRL_LOCKDET_LOCK_FILTEREDS__READ(die, channel);
+            link_status->hrx_cdr_lock[channel]      = SPICA_SRX_RXD_INTS__CTRL_LOCKDET_LOCK_FILTEREDS__READ(die, channel);
+            link_status->hrx_fw_lock[channel]       = SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->hrx_reset_cnt[channel]     = SPICA_SRX_FW_STATUS__RESET_COUNT__READ(die, channel);
+            link_status->hrx_fsm_state[channel]     = SPICA_SRX_FW_STATUS__STATE__READ(die, channel);
+            link_status->hrx_sdt[channel]           = SPICA_SRX_CH_STATUS2__SDT__READ(die, channel);
+        }
+
+        // STX
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_STX)
+        {
+            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_STX)&1;
+            if (SPICA_MMD30_RESET_CFG__SMTX_SR__GET(reset_cfg[i]))
+            {
+                break; //bust out, this block is in reset
+            }
+            link_status->htx_pll_lock[channel]      = SPICA_SMTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->htx_pll_fsm_state[channel] = SPICA_SMTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
+            link_status->htx_fw_lock[channel]       = SPICA_STX_FW_STATUS__LOCKED__READ(die, channel);
+            link_status->htx_reset_cnt[channel]     = SPICA_STX_FW_STATUS__RESET_COUNT__READ(die, channel);
+            link_status->htx_fsm_state[channel]     = SPICA_STX_FW_STATUS__STATE__READ(die, channel);
+        }
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+    return status;
+}
+
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+/*
+ * This method may be called to print the current link status
+ * of the interfaces of the device.
+ */
+inphi_status_t spica_link_status_print(
+    uint32_t die,
+    spica_link_status_t* link_status)
+{
+    inphi_status_t status = INPHI_OK;
+    e_spica_intf rx_intf = SPICA_INTF_MRX;
+    e_spica_intf tx_intf = SPICA_INTF_MTX;
+    
+    const spica_channels_t* line_ch;
+    const spica_channels_t* host_ch;
+
+    // get the number of channels on the line and host sides
+    line_ch = spica_channels(die, SPICA_INTF_POR);
+    if (spica_package_has_pmr(die))
+    {     
+        host_ch = spica_channels(die, SPICA_INTF_PMR);
+    }
+    else
+    {     
+        host_ch = spica_channels(die, SPICA_INTF_PSR);
+    }
+
+    INPHI_NOTE("Link Status for die 0x%08lu\n", die);
+    INPHI_NOTE("+---------------------------------------------------------------------------------+\n");
+    INPHI_NOTE("|  Top FW Lock    %s                                                               |\n", link_status->fw_lock ? "Y" : ".");
+    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
+
+    if (spica_package_has_pmr(die))
+    {
+        INPHI_NOTE("|  MTX                                   |  MRX                                   |\n");
+    }
+    if (spica_package_has_psr(die))
+    {
+        rx_intf = SPICA_INTF_SRX;
+        tx_intf = SPICA_INTF_STX;
+        INPHI_NOTE("|  STX                                   |  SRX                                   |\n");
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("|  Channel        1  2  3  4             |  Channel        1  2  3  4             |\n");
+        INPHI_NOTE("|                -----------             |                 ----------             |\n");    
+    }
+    else
+    {
+        INPHI_NOTE("|  Channel        1  2  3  4  5  6  7  8 |  Channel        1  2  3  4  5  6  7  8 |\n");
+        INPHI_NOTE("|                ----------------------- |                ----------------------- |\n");
+    }
+    // ------------------------------ SMTX/SMRX BLOCKS ---------------------------------------
+
+    INPHI_NOTE("|  Reg Instance  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, tx_intf);
+        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE("|  Reg Instance  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+    {
+        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, rx_intf);
+        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE("|\n");
+    INPHI_NOTE("|  FW Lock      ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        INPHI_NOTE("  %s", link_status->htx_fw_lock[channel] ? "Y" : ".");
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  FW Lock      ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+    {
+        INPHI_NOTE("  %s", link_status->hrx_fw_lock[channel] ? "Y" : ".");
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  FSM State    ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        INPHI_NOTE(" %02x", link_status->htx_fsm_state[channel]);
+    }
+
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |  FSM State    ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+    {
+        INPHI_NOTE(" %02x", link_status->hrx_fsm_state[channel]);
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  PLL Lock     ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        INPHI_NOTE("  %s", link_status->htx_pll_lock[channel] ? "Y" : ".");
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    if (spica_package_has_pmr(die))
+    {
+        INPHI_NOTE(" |  PLL Lock     ");
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        {
+            INPHI_NOTE("  %s", link_status->hrx_pll_lock[channel] ? "Y" : ".");
+        }
+        if (host_ch->num == 4)
+        {
+            INPHI_NOTE("            ");
+        }
+        INPHI_NOTE(" |\n");
+    }
+    if (spica_package_has_psr(die))
+    {
+        INPHI_NOTE(" |  CDR Lock     ");
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        {
+            INPHI_NOTE("  %s", link_status->hrx_cdr_lock[channel] ? "Y" : ".");
+        }
+        if (host_ch->num == 4)
+        {
+            INPHI_NOTE("            ");
+        }
+        INPHI_NOTE(" |\n");
+    }
+
+    INPHI_NOTE("|  PLL FSM State");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        INPHI_NOTE(" %02x", link_status->htx_pll_fsm_state[channel]);
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    if (spica_package_has_pmr(die))
+    {
+        INPHI_NOTE(" |  PLL FSM State");
+        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        {
+            INPHI_NOTE(" %02x", link_status->hrx_pll_fsm_state[channel]);
+        }
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+ 
+    INPHI_NOTE("|  Reset Count  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+    {
+        INPHI_NOTE(" %02x", link_status->htx_reset_cnt[channel]);
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  Reset Count  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+    {
+        INPHI_NOTE(" %02x", link_status->hrx_reset_cnt[channel]);
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|                                        ");
+    INPHI_NOTE("|  Signal Detect");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+    {
+        INPHI_NOTE("  %s", link_status->hrx_sdt[channel] ? "Y" : ".");
+    }
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|                                        |                                        |\n");
+    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
+    INPHI_NOTE("|  ORX                                   |  OTX                                   |\n");
+    if (host_ch->num == 4)
+    {
+        INPHI_NOTE("|  Channel        1  2  3  4             |  Channel        1  2  3  4             |\n");
+        INPHI_NOTE("|                -----------             |                -----------             |\n");
+    }
+    else
+    {
+        INPHI_NOTE("|  Channel        1  2  3  4  5  6  7  8 |  Channel        1  2  3  4  5  6  7  8 |\n");
+        INPHI_NOTE("|                ----------------------- |                ----------------------- |\n");
+    }
+    
+    INPHI_NOTE("|  Reg Instance  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, SPICA_INTF_ORX);
+        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE("|  Reg Instance  ");
+    
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, SPICA_INTF_OTX);
+        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE("|\n");
+
+    INPHI_NOTE("|  FW Lock      ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE("  %s", link_status->orx_fw_lock[channel] ? "Y" : ".");
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  FW Lock      ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        INPHI_NOTE("  %s", link_status->otx_fw_lock[channel] ? "Y" : ".");
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  FSM State    ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE(" %02x", link_status->orx_fsm_state[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  FSM State    ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        INPHI_NOTE(" %02x", link_status->otx_fsm_state[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  PLL Lock     ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE("  %s", link_status->orx_pll_lock[channel] ? "Y" : ".");
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  PLL Lock     ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        INPHI_NOTE("  %s", link_status->otx_pll_lock[channel] ? "Y" : ".");
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  PLL FSM State");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE(" %02x", link_status->orx_pll_fsm_state[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  PLL FSM State");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        INPHI_NOTE(" %02x", link_status->otx_pll_fsm_state[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  Reset Count  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE(" %02x", link_status->orx_reset_cnt[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+
+    INPHI_NOTE(" |  Reset Count  ");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    {
+        INPHI_NOTE(" %02x", link_status->otx_reset_cnt[channel]);
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |\n");
+
+    INPHI_NOTE("|  Signal Detect");
+    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    {
+        INPHI_NOTE("  %s", link_status->orx_sdt[channel] ? "Y" : ".");
+    }
+    if (line_ch->num == 4)
+    {
+        INPHI_NOTE("            ");
+    }
+    INPHI_NOTE(" |                                        |\n");
+
+    INPHI_NOTE("|                                        |                                        |\n");
+    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
+    INPHI_NOTE("Legend: Status Y=yes, .=no\n");
+    INPHI_NOTE("        Reg Instance jk, j=die, k=instance\n");
+
+    return status;
+}
+
+/*
+ * This method may be called to query then print the current link status
+ * of the interfaces of the device.
+ */
+inphi_status_t spica_link_status_query_print(
+    uint32_t die)
+{
+    inphi_status_t status = INPHI_OK;
+    spica_link_status_t link_status;
 
-        rules->srx[channel].baud_rate            = host_baud_rate;
+    status |= spica_link_status_query(die, &link_status);
+    status |= spica_link_status_print(die, &link_status);
 
-        rules->srx[channel].ctle_override = SPICA_SRX_RXA_AFE_CTLE_CFG__DEFAULT;
-        rules->srx[channel].lfeq_override = SPICA_SRX_RXA_AFE_LFEQ_CFG__DEFAULT;
+    // check to see if the FW is responsible
+    // spica_is_fw_running_ok(die);
 
-    }
-#endif // defined(INPHI_REMOVE_PSR)
+    return status;
+}
 
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+
+inphi_status_t spica_tx_man_config(
+    uint32_t            die,
+    uint32_t            channel,
+    e_spica_intf        intf,
+    e_spica_lut_mode    lut_mode,
+    bool                is_lut_unsigned,
+    bool                toggle_squelch,
+    int8_t              lut[256],
+    int16_t             coef[28])
+{
+    inphi_status_t status = INPHI_OK;
+    bool squelched = false;
+    uint16_t data = 0;
+
+    // Set the API version in the spare registers
+    spica_init_api_version(die);
+
+    //Check the rules
+    if((!lut) && (lut_mode != SPICA_LUT_7TAP_LIN))
     {
-        // set the default Tx rules
-        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_OTX, rules->driver_type_override, &rules->otx[channel]);
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
-        rules->otx[channel].channel_enable  = (en_intfs & SPICA_INTF_OTX) && (((channel-1)%SPICA_NUM_OF_OTX_CHANNELS+1) <= line_num_channels_en);
-        rules->otx[channel].gray_mapping    = line_gray_mapping;
-        rules->otx[channel].signalling      = line_signalling;
-        rules->otx[channel].baud_rate       = line_baud_rate;
+        INPHI_CRIT("ERROR: Must specify lut unless you're using 7TAP_LIN mode\n");
+        return INPHI_ERROR;
     }
-#if !defined(INPHI_REMOVE_PMR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
+    if((lut_mode == SPICA_LUT_7TAP_LIN) || (lut_mode == SPICA_LUT_7TAP_LUT))
     {
-        // set the default Tx rules
-        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_MTX, rules->driver_type_override, &rules->mtx[channel]);
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
-        rules->mtx[channel].channel_enable  = (en_intfs & SPICA_INTF_MTX) && (((channel-1)%SPICA_NUM_OF_MTX_CHANNELS+1) <= host_num_channels_en);
-        rules->mtx[channel].gray_mapping    = host_gray_mapping;
-        rules->mtx[channel].signalling      = host_signalling;
-        rules->mtx[channel].baud_rate       = host_baud_rate;
+        if((intf != SPICA_INTF_OTX) && (intf != SPICA_INTF_MTX))
+        {
+            INPHI_CRIT("ERROR: Only OTX and MTX interfaces support 7TAP modes\n");
+            return INPHI_ERROR;
+        }
+        if(!coef)
+        {
+            INPHI_CRIT("ERROR: Must specify coef to program in 7TAP_LIN/LUT modes\n");
+            return INPHI_ERROR;
+        }
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+    if(channel == SPICA_BROADCAST_CHANNEL)
     {
-        // set the default Tx rules
-        status |= spica_tx_rules_default_set(base_die, SPICA_INTF_STX, rules->driver_type_override, &rules->stx[channel]);
-        // Channel enable dependant on operational_mode (en_intfs) and protocol_mode (line_num_channels_en)
-        rules->stx[channel].channel_enable  = (en_intfs & SPICA_INTF_STX) && (((channel-1)%SPICA_NUM_OF_STX_CHANNELS+1) <= host_num_channels_en);
-        rules->stx[channel].gray_mapping    = host_gray_mapping;
-        rules->stx[channel].signalling      = host_signalling;
-        rules->stx[channel].baud_rate       = host_baud_rate;
-        rules->stx[channel].swing           = SPICA_TX_SWING_NA; /* Override, not applicable to STX interface */
+        INPHI_CRIT("ERROR: Cannot write Tx LUT to broadcast channel\n");
+        return INPHI_ERROR;
     }
-#endif // defined(INPHI_REMOVE_PSR)
 
-    // OTX/MTX/STX xbar defaults (Dependant on operational mode and protocol mode)
-    int eg_gb_ratio = host_num_channels_en/line_num_channels_en;  // Egress gearbox ratio (host:line)
-    int ig_gb_ratio = eg_gb_ratio;  // Ingress gearbox ratio - default to eg_gb_ratio (host:line)
+    //squelch if we need to
+    if(toggle_squelch)
+    {
+        if(intf == SPICA_INTF_OTX) 
+        {
+            squelched = SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
+            SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
+        }  
+#if !defined(INPHI_REMOVE_PMR)
+        else if (intf == SPICA_INTF_MTX)
+        {
+            squelched = SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
+            SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
+        }    
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+        else if (intf == SPICA_INTF_STX)
+        {
+            squelched = SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
+            SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
+        }    
+#endif // defined(INPHI_REMOVE_PSR)
+        else
+        {
+            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+        } 
+    }
 
-    // Set all xbar vectors in bundle to 0xf initially
-    uint8_t j;
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+    //make sure the FW is past the Power-on state
+    int timeout = 1000;
+    if(intf == SPICA_INTF_OTX)
     {
-        for(j=0; j<sizeof(rules->otx_xbar_src_chan[0])/sizeof(rules->otx_xbar_src_chan[0][0]); j++)
+        data = SPICA_OTX_FW_STATUS__READ(die, channel);
+        while((SPICA_OTX_FW_STATUS__STATE__GET(data) < 7) && (timeout > 0))
         {
-            rules->otx_xbar_src_chan[channel][j] = 0xf;
+            timeout -= 1;
+            INPHI_UDELAY(1000);
+            data = SPICA_OTX_FW_STATUS__READ(die, channel);
         }
-        rules->otx_clk_xbar[channel] = 0xf;
     }
 #if !defined(INPHI_REMOVE_PMR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
+    else if (intf == SPICA_INTF_MTX)
     {
-        for(j=0; j<sizeof(rules->mtx_xbar_src_chan[0])/sizeof(rules->mtx_xbar_src_chan[0][0]); j++)
+        data = SPICA_MTX_FW_STATUS__READ(die, channel);
+        while((SPICA_MTX_FW_STATUS__STATE__GET(data) < 7) && (timeout > 0))
         {
-            rules->mtx_xbar_src_chan[channel][j] = 0xf;
+            timeout -= 1;
+            INPHI_UDELAY(1000);
+            data = SPICA_MTX_FW_STATUS__READ(die, channel);
         }
-        rules->mtx_clk_xbar[channel] = 0xf;
     }
 #endif // defined(INPHI_REMOVE_PMR)
 #if !defined(INPHI_REMOVE_PSR)
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+    else if (intf == SPICA_INTF_STX)
     {
-        for(j=0; j<sizeof(rules->stx_xbar_src_chan[0])/sizeof(rules->stx_xbar_src_chan[0][0]); j++)
+        data = SPICA_STX_FW_STATUS__READ(die, channel);
+        while((SPICA_STX_FW_STATUS__STATE__GET(data) < 8) && (timeout > 0))
         {
-            rules->stx_xbar_src_chan[channel][j] = 0xf;
+            timeout -= 1;
+            INPHI_UDELAY(1000);
+            data = SPICA_STX_FW_STATUS__READ(die, channel);
         }
-        rules->stx_clk_xbar[channel] = 0xf;
     }
 #endif // defined(INPHI_REMOVE_PSR)
-
-    switch(rules->operational_mode) {
-        case SPICA_MODE_LINE_PRBS:
-        case SPICA_MODE_HOST_PRBS:
-        case SPICA_MODE_DUAL_PRBS:
-        case SPICA_MODE_EGRESS_PRBS:
-        case SPICA_MODE_INGRESS_PRBS:
-        case SPICA_MODE_MISSION_MODE:
-            // Default ingress/egress xbar config
-            break;
-        case SPICA_MODE_SHALLOW_LINE_LOOPBACK:
-            // Override default OTX xbar configs
-            eg_gb_ratio = 1;
-            break;
-        case SPICA_MODE_SHALLOW_HOST_LOOPBACK:
-            // Override default MTX/STX xbar settings
-            ig_gb_ratio = 1;
-            break;
-
-        default:
-            break;
+    else
+    {
+        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
     }
-
-    // OTX XBAR CONFIG
-    uint32_t num_channels=0;
-    uint32_t first_ch_in_gb_set;
-    SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_OTX)
+ 
+    if(timeout <= 0)
     {
-        if(num_channels>=line_num_channels_en)
-        {
-            // All channels needed for protocol_mode allocated within bundle 
-            break;
-        }
-
-        // Calculate the base channel for gearbox set of channels
-        first_ch_in_gb_set = channel + num_channels*(eg_gb_ratio - 1);
-
-        // clk xbar config
-        rules->otx_clk_xbar[channel] = first_ch_in_gb_set;
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("Timed out waiting for FW to power-up %s ch %lu\n", spica_dbg_translate_intf(intf), channel);
+#else
+        INPHI_CRIT("Timed out waiting for FW to power-up intf %d ch %d\n", intf, channel);
+#endif
+        return INPHI_ERROR;
+    }
 
-        // data xbar config
-        for(int n=0; n<eg_gb_ratio; n++)
+    //make sure the FW isn't currently accessing the LUT
+    timeout = 100;
+    if(intf == SPICA_INTF_OTX) 
+    {
+        while(SPICA_OTX_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
         {
-            // Spread Rx channels equally amongst line channels.
-            // otx_xbar_src_chan[line_channel] = {rx_channel_1, rx_channel_2, etc.}
-            // ie. 4:1 gearbox mode
-            // otx_xbar_src_chan[1] = {1, 2, 3, 4}
-            // ie. 2:2 gearbox mode
-            // otx_xbar_src_chan[1] = {1, 0xf, 0xf, 0xf}
-            // otx_xbar_src_chan[2] = {2, 0xf, 0xf, 0xf}
-
-            rules->otx_xbar_src_chan[channel][n] = first_ch_in_gb_set + n;
-            //INPHI_NOTE("otx_xbar_src_chan[%d][%d] = %d\n", channel, n, rules->otx_xbar_src_chan[channel][n]);
+            timeout -= 1;
+            INPHI_UDELAY(10);
         }
-        num_channels++;
     }
-
 #if !defined(INPHI_REMOVE_PMR)
-    num_channels=0;
-    if(SPICA_INTF_PMR & spica_package_get_intf(die))
+    else if (intf == SPICA_INTF_MTX) 
     {
-        // MTX XBAR CONFIG
-        SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_MTX)
-        {
-            if(num_channels>=host_num_channels_en)
-            {
-                // All channels needed for protocol_mode allocated within bundle 
-                break;
-            }
-
-            // Calculate the base channel for gearbox set of channels
-            first_ch_in_gb_set = channel + (num_channels/ig_gb_ratio) - num_channels;
-
-            // clk xbar config
-            rules->mtx_clk_xbar[channel] = first_ch_in_gb_set;
-
-            // data xbar config
-            // Split up the Rx channels (Either ORX or MRX) equally amongst MTX channels.
-            // For each MTX Tx channel specify a src Rx channel, and the interleave index within the channel (Reverse Gearbox)
-            // An Rx channel can contain up to 4 MTX channels (When RX is ORX)
-            // ie. 4:1 gearbox mode
-            // mtx_xbar_src_chan[host_tx_channel][0] = src_channel
-            // mtx_xbar_src_chan[host_tx_channel][1] = interleave index // 0-based
-            // mtx_xbar_src_chan[1][0] = 1 // channel
-            // mtx_xbar_src_chan[1][1] = 0 // interleave index 
-            // mtx_xbar_src_chan[2][0] = 1
-            // mtx_xbar_src_chan[2][1] = 1
-            // mtx_xbar_src_chan[3][0] = 1
-            // mtx_xbar_src_chan[3][1] = 2
-            // mtx_xbar_src_chan[4][0] = 1
-            // mtx_xbar_src_chan[4][1] = 3
-
-            rules->mtx_xbar_src_chan[channel][0] = first_ch_in_gb_set;
-            rules->mtx_xbar_src_chan[channel][1] = (channel-1)%ig_gb_ratio;
-            //INPHI_NOTE("mtx_xbar_src_chan[%d][0] = %d\n", channel, rules->mtx_xbar_src_chan[channel][0]);
-            //INPHI_NOTE("mtx_xbar_src_chan[%d][1] = %d\n", channel, rules->mtx_xbar_src_chan[channel][1]);
-
-            num_channels++;
-       }
+        while(SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
+        {
+            timeout -= 1;
+            INPHI_UDELAY(10);
+        }
     }
 #endif // defined(INPHI_REMOVE_PMR)
-
 #if !defined(INPHI_REMOVE_PSR)
-    num_channels=0;
-    if(SPICA_INTF_PSR & spica_package_get_intf(die))
-    {   
-        // STX XBAR CONFIG
-        SPICA_FOR_CHANNEL_IN_BUNDLE(base_die, bundle_idx, SPICA_INTF_STX)
+    else if (intf == SPICA_INTF_STX) 
+    {
+        while(SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
         {
-            if(num_channels>=host_num_channels_en)
-            {
-                // All channels needed for protocol_mode allocated within bundle 
-                break;
-            }
-            // Calculate the base channel for gearbox set of channels
-            first_ch_in_gb_set = channel + (num_channels/ig_gb_ratio) - num_channels;
-
-            // clk xbar config
-            rules->stx_clk_xbar[channel] = first_ch_in_gb_set;
-
-            // data xbar config
-            // Split up the Rx channels (Either ORX or SRX) equally amongst STX channels.
-            // For each STX Tx channel specify a src Rx channel, and the interleave index within the channel (Reverse Gearbox)
-            // An Rx channel can contain up to 4 STX channels (When RX is ORX)
-            // ie. 4:1 gearbox mode
-            // stx_xbar_src_chan[host_tx_channel][0] = src_channel
-            // stx_xbar_src_chan[host_tx_channel][1] = interleave index // 0-based
-            // stx_xbar_src_chan[1][0] = 1 // channel
-            // stx_xbar_src_chan[1][1] = 0 // interleave index 
-            // stx_xbar_src_chan[2][0] = 1
-            // stx_xbar_src_chan[2][1] = 1
-            // stx_xbar_src_chan[3][0] = 1
-            // stx_xbar_src_chan[3][1] = 2
-            // stx_xbar_src_chan[4][0] = 1
-            // stx_xbar_src_chan[4][1] = 3
-            // stx_xbar_src_chan[5][0] = 0xf
-            // stx_xbar_src_chan[5][1] = 0xf
-            // ...
-            // stx_xbar_src_chan[8][0] = 0xf
-            // stx_xbar_src_chan[8][0] = 0xf
-
-            rules->stx_xbar_src_chan[channel][0] = first_ch_in_gb_set;
-            rules->stx_xbar_src_chan[channel][1] = (channel-1)%ig_gb_ratio;
-            //INPHI_NOTE("stx_xbar_src_chan[%d][0] = %d\n", channel, rules->stx_xbar_src_chan[channel][0]);
-            //INPHI_NOTE("stx_xbar_src_chan[%d][1] = %d\n", channel, rules->stx_xbar_src_chan[channel][1]);
-
-            num_channels++;
+            timeout -= 1;
+            INPHI_UDELAY(10);
         }
     }
 #endif // defined(INPHI_REMOVE_PSR)
+    else
+    {
+        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+    }
 
-    return status;
-}
-
-/* setup the default rules structure for all bundles */
-inphi_status_t spica_rules_default_set(
-    uint32_t                 die,
-    e_spica_operational_mode op_mode,
-    e_spica_protocol_mode    protocol_mode,
-    spica_rules_t*           rules)
-{
-    inphi_status_t status = INPHI_OK;
-
-    if(!rules)
+    if(timeout <= 0)
     {
-        INPHI_CRIT("ERROR: rules cannot be NULL!\n");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("ERROR: Timed out waiting for FW to stop writing to %s ch %lu LUT\n", spica_dbg_translate_intf(intf), channel);
+#else
+        INPHI_CRIT("ERROR: Timed out waiting for FW to stop writing to intf %d ch %d LUT\n", intf, channel);
+#endif
         return INPHI_ERROR;
     }
 
-    // reset the entire rules structure
-    INPHI_MEMSET(rules, 0, sizeof(spica_rules_t));
+    //ok, we need to quickly write the LUT now since the FW isn't accessing it
 
-    for (uint8_t bundle_idx = 0; bundle_idx < SPICA_MAX_BUNDLES; bundle_idx++) 
+    if(lut_mode != SPICA_LUT_7TAP_LIN)
     {
-        if (spica_bundle_is_en(bundle_idx))
-        {   
-            status |= spica_rules_default_set_per_bundle(die, bundle_idx, op_mode, protocol_mode, rules);
+        if(intf == SPICA_INTF_OTX) 
+        {
+            //write the big LUT
+            SPICA_OTX_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
+            data = SPICA_OTX_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
+            for(int i=0; i<256; i++)
+            {
+                SPICA_OTX_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
+                data = SPICA_OTX_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
+                SPICA_OTX_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
+            }
+            //set the RBW back to 0
+            SPICA_OTX_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
+        }
+#if !defined(INPHI_REMOVE_PMR)
+        else if (intf == SPICA_INTF_MTX)
+        {
+            //write the big LUT
+            SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
+            data = SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
+            for(int i=0; i<256; i++)
+            {
+                SPICA_SMTX_PMR_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
+                data = SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
+                SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
+            }
+            //set the RBW back to 0
+            SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
+        }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+        else if (intf == SPICA_INTF_STX)
+        {
+            //write the big LUT
+            SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
+            data = SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
+            for(int i=0; i<256; i++)
+            {
+                SPICA_SMTX_PSR_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
+                data = SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
+                SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
+            }
+            //set the RBW back to 0
+            SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
+        }
+#endif // defined(INPHI_REMOVE_PSR)
+        else 
+        {
+            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
         }
+        //leave the RBW set while we do the COEFFs, this will prevent the FW from overwriting stuff
     }
 
-    return status;
-}
-
-// Squelch the transmit output for the specified channel
-inphi_status_t spica_tx_squelch(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    bool         squelch)
-{
-    inphi_status_t status = INPHI_OK;
-
-    SPICA_LOCK(die);
+    //write the small LUT if needed
+    if(((intf == SPICA_INTF_OTX) || (intf == SPICA_INTF_MTX)) && (coef) &&
+            ((lut_mode == SPICA_LUT_7TAP_LIN) || (lut_mode == SPICA_LUT_7TAP_LUT)) )
+    {
+        if(intf == SPICA_INTF_OTX) 
+        {
+            data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__RBW__SET(0, 1);
+            for(int i=0; i<28; i++)
+            {
+                data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__ADDR__SET(data, i);
+                data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE_DATA__SET(data, coef[i]);
+                SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, data);
+            }
+            //set the RBW back to 0
+            SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, 0);
+        }
+#if !defined(INPHI_REMOVE_PMR)
+        else if (intf == SPICA_INTF_MTX)
+        {
+            data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__RBW__SET(0, 1);
+            for(int i=0; i<28; i++)
+            {
+                data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__ADDR__SET(data, i);
+                data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE_DATA__SET(data, coef[i]);
+                SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, data);
+            }
+            //set the RBW back to 0
+            SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, 0);
+        }
+#endif // defined(INPHI_REMOVE_PMR)
+        else 
+        {
+            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+        }
+    }
 
-    if(intf == SPICA_INTF_OTX)
+    if(intf == SPICA_INTF_OTX) 
     {
-        SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+        //set the DSP mode in HW directly
+        data = SPICA_OTX_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
+        data = SPICA_OTX_TXD_DSP_CFG__MODE__SET(data, lut_mode);
+        SPICA_OTX_TXD_DSP_CFG__WRITE(die, channel, data);
+
+        //if the Tx was already unsquelched
+        if(toggle_squelch && !squelched)
+        {
+            SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
+        }
     }
+#if !defined(INPHI_REMOVE_PMR)
     else if (intf == SPICA_INTF_MTX)
     {
-        SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+        //set the DSP mode in HW directly
+        data = SPICA_SMTX_PMR_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
+        data = SPICA_SMTX_PMR_TXD_DSP_CFG__MODE__SET(data, lut_mode);
+        SPICA_SMTX_PMR_TXD_DSP_CFG__WRITE(die, channel, data);
+
+        //if the Tx was already unsquelched
+        if(toggle_squelch && !squelched)
+        {
+            SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
+        }
     }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
     else if (intf == SPICA_INTF_STX)
     {
-        SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, squelch);
+        //set the DSP mode in HW directly
+        data = SPICA_SMTX_PSR_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
+        data = SPICA_SMTX_PSR_TXD_DSP_CFG__MODE__SET(data, lut_mode);
+        SPICA_SMTX_PSR_TXD_DSP_CFG__WRITE(die, channel, data);
+
+        //if the Tx was already unsquelched
+        if(toggle_squelch && !squelched)
+        {
+            SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
+        }
     }
-    else
+#endif // defined(INPHI_REMOVE_PSR)
+    else 
     {
-        INPHI_CRIT("ERROR: Unsupported Interface\n");
+        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
     }
 
-    SPICA_UNLOCK(die);
-
     return status;
 }
 
-/*
- * This method may be called to query the current configuration of the
- * transmitters from the ASIC.
- */
-inphi_status_t spica_tx_fir_query(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    spica_tx_rules_t* tx_rules)
+inphi_status_t spica_clock_group_enable(uint32_t die, uint32_t channel, e_spica_intf intf, bool enable)
 {
     inphi_status_t status = INPHI_OK;
+    bool update_done = false;
+    uint32_t base_die = spica_package_get_base_die(die);
+
+    // Communicate to FW to notify of desired clock group enable/disable
+    // Use overlays
+
+    uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, intf);
+    die = base_die | ((die_inst >> 16) & 0xFF);// Must redefined die since we are writing to MCU reg
+    uint16_t inst = die_inst & 0xFF;
+
+    uint16_t data;
+    data = SPICA_CLOCK_GROUP_ENABLE_CFG__INTF__SET(0, intf);
+    data = SPICA_CLOCK_GROUP_ENABLE_CFG__CHANNEL__SET(data, inst);
+    data = SPICA_CLOCK_GROUP_ENABLE_CFG__ENABLE__SET(data, enable);
+    SPICA_CLOCK_GROUP_ENABLE_CFG__WRITE(die, data);
+
+    SPICA_GENERIC_ACK__CLK_GRP_EN_ACK__RMW(die, 0); // Clear the ACK
+    SPICA_GENERIC_REQ__CLK_GRP_EN_REQ__RMW(die, 1); // Set the REQ
 
-    if(!tx_rules)
+    int32_t attempts=30000; // 3 seconds
+    // Wait for FW to update rules
+    while(attempts > 0)
     {
-        INPHI_CRIT("ERROR: tx rules cannot be NULL!\n");
-        return INPHI_ERROR;
+        update_done = SPICA_GENERIC_ACK__CLK_GRP_EN_ACK__READ(die); // Wait for ACK
+        if(update_done) 
+        {
+            break;
+        }
+        INPHI_UDELAY(100);
+        attempts -= 1;
     }
+    
 
-    INPHI_MEMSET(tx_rules, 0, sizeof(*tx_rules));
-
-    status |= spica_cp_tx_overlays_to_rules(die, channel, intf, tx_rules);
+    if((status) || (attempts <= 0))
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to dis/en clock group...\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        status |= INPHI_ERROR;
+    }
+    
 
     return status;
 }
 
-/*
- * Update the TX FIR configuration.
- */
-inphi_status_t spica_tx_fir_set(
-    uint32_t die,
-    uint32_t channel,
+// Enables or disables the squelch lock for the specified channel
+inphi_status_t spica_tx_squelch_lock(
+    uint32_t     die,
+    uint32_t     channel,
     e_spica_intf intf,
-    spica_tx_rules_t* tx_rules)
+    bool         squelch_lock)
 {
     inphi_status_t status = INPHI_OK;
-    bool update_done = false;
-    uint16_t data;
 
-    // NOTE: spica_tx_fir_set() only supported on-the-fly updates to the following rules
-    // - lut_mode 
-    // - swing
-    // - fir_taps
-    // - inner_eye1
-    // - inner_eye2
-    // Check that user has not attempted to change unsupported rules
-    if (intf == SPICA_INTF_OTX) 
+    if(intf == SPICA_INTF_OTX)
     {
-        data = SPICA_OTX_RULES_0__READ(die, channel);
-        if(tx_rules->squelch_lock   != SPICA_OTX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
-        if(tx_rules->channel_enable != SPICA_OTX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
-        if(tx_rules->signalling     != SPICA_OTX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->ieee_demap     != SPICA_OTX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->invert_chan    != SPICA_OTX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
-        if(tx_rules->gray_mapping   != SPICA_OTX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
+        // Update the overlay rule
+        SPICA_OTX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
+
+        // Now notify FW that squelch_lock rule ready for update
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
     }
-    else if (intf == SPICA_INTF_MTX) 
-    {
 #if !defined(INPHI_REMOVE_PMR)
-        data = SPICA_MTX_RULES_0__READ(die, channel);
-        if(tx_rules->squelch_lock   != SPICA_MTX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
-        if(tx_rules->channel_enable != SPICA_MTX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
-        if(tx_rules->signalling     != SPICA_MTX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->ieee_demap     != SPICA_MTX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->invert_chan    != SPICA_MTX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
-        if(tx_rules->gray_mapping   != SPICA_MTX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
-#endif // defined(INPHI_REMOVE_PMR)
-    }
-    else // intf == SPICA_INTF_STX 
+    else if (intf == SPICA_INTF_MTX)
     {
-#if !defined(INPHI_REMOVE_PSR)
-        data = SPICA_STX_RULES_0__READ(die, channel);
-        if(tx_rules->squelch_lock   != SPICA_STX_RULES_0__SQUELCH_LOCK__GET(data))   status |= INPHI_ERROR;
-        if(tx_rules->channel_enable != SPICA_STX_RULES_0__CHANNEL_ENABLE__GET(data)) status |= INPHI_ERROR;
-        if(tx_rules->signalling     != SPICA_STX_RULES_0__SIGNALLING__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->ieee_demap     != SPICA_STX_RULES_0__IEEE_DEMAP__GET(data))     status |= INPHI_ERROR;
-        if(tx_rules->invert_chan    != SPICA_STX_RULES_0__INVERT_CHAN__GET(data))    status |= INPHI_ERROR;
-        if(tx_rules->gray_mapping   != SPICA_STX_RULES_0__GRAY_MAPPING__GET(data))   status |= INPHI_ERROR;
-#endif // defined(INPHI_REMOVE_PSR)
+        // Update the overlay rule
+        SPICA_MTX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
+
+        // Now notify FW that squelch_lock rule ready for update
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
     }
+#endif // defined(INPHI_REMOVE_PMR)
+#if !defined(INPHI_REMOVE_PSR)
+    else if (intf == SPICA_INTF_STX) 
+    {
+        // Update the overlay rule
+        SPICA_STX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
 
-    if(status != INPHI_OK) 
+        // Now notify FW that squelch_lock rule ready for update
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
+    }
+#endif // defined(INPHI_REMOVE_PSR)
+    else 
     {
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Member of tx_rules() not supported by this method has been changed  ...\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        return status;
+        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
+        status |= INPHI_ERROR;
     }
 
-    // Checks that settings for rules allowed to be changed are valid
-    status |= spica_tx_check_rules(die, channel, intf, tx_rules);
-
-    //send the rules
-    status |= spica_cp_tx_rules_to_overlays(die, channel, intf, tx_rules);
+    bool update_done = false;
+    int32_t attempts=30000; // 3 seconds
+    // Wait for FW to update rules
+    while(attempts > 0)
+    {
+        
+        if(intf == SPICA_INTF_OTX)      update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_MTX) update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_STX) update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
 
-    if(status != INPHI_OK) 
+        if(update_done) 
+        {
+            break;
+        }
+        INPHI_UDELAY(100);
+        attempts -= 1;
+    }
+    
+    if((status) || (attempts <= 0))
     {
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Failed copying tx rules to overlays ...\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        return status;
+        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update squelch_lock...\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        status |= INPHI_ERROR;
     }
+    return status;
+}
 
-    // Tell the FW that new tx rules are now available
-    int32_t attempts=30000; // 3 seconds
-    // Signal to the FW to config the Tx with the new rules
-    if (intf == SPICA_INTF_OTX) 
+// Toggle the invert status of a TX channel
+inphi_status_t spica_tx_invert_toggle(
+    uint32_t          die,
+    uint32_t          channel,
+    e_spica_intf      intf)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(intf == SPICA_INTF_OTX)
     {
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear ACK
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
-        // Wait for FW to update rules
-        while(attempts > 0)
-        {
-            update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
-            if(update_done) 
-            {
-                break;
-            }
-            INPHI_UDELAY(100);
-            attempts -= 1;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
 #if !defined(INPHI_REMOVE_PMR)
     else if (intf == SPICA_INTF_MTX)
     {
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear ACK
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
-        // Wait for FW to update rules
-        while(attempts > 0)
-        {
-            update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
-            if(update_done) 
-            {
-                break;
-            }
-            INPHI_UDELAY(100);
-            attempts -= 1;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
 #endif // defined(INPHI_REMOVE_PMR)
 #if !defined(INPHI_REMOVE_PSR)
-    else // intf == SPICA_INTF_STX
+    else if (intf == SPICA_INTF_STX) 
     {
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_REQ__RMW(die, channel, 1); // Set REQ
-        // Wait for FW to update rules
-        while(attempts > 0)
-        {
-            update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_FIR_ACK__READ(die, channel); // Wait for ACK
-            if(update_done) 
-            {
-                break;
-            }
-            INPHI_UDELAY(100);
-            attempts -= 1;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
 #endif // defined(INPHI_REMOVE_PSR)
+    else 
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
+        status |= INPHI_ERROR;
+    }
+
+    bool update_done = false;
+    int32_t attempts=30000; // 3 seconds
+    // Wait for FW to update rules
+    while(attempts > 0)
+    {
+        
+        if(intf == SPICA_INTF_OTX)      update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_MTX) update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_STX) update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
 
+        if(update_done) 
+        {
+            break;
+        }
+        INPHI_UDELAY(100);
+        attempts -= 1;
+    }
+    
     if((status) || (attempts <= 0))
     {
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update tx_fir...\n", spica_dbg_translate_intf(intf), channel);
+        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update invert_chan...\n", spica_dbg_translate_intf(intf), channel);
 #endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
         status |= INPHI_ERROR;
     }
-
     return status;
-}
 
-/*
- * This method may be called to query the current status of 
- * one or more interfaces of a selected channel.
- */
-bool spica_channel_is_link_ready(
-    uint32_t      die,
-    uint32_t      channel,
-    e_spica_intf  intf)
-{
-    uint32_t fw_lock = 0; // 0/1 bit map, same map as e_spica_intf
+}
 
-    if (SPICA_INTF_OTX & intf)
-    {
-        if (SPICA_OTX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-            fw_lock |= SPICA_INTF_OTX;
-        }
-    }
-    if (SPICA_INTF_ORX & intf)
+// Toggle the invert status of an RX channel
+inphi_status_t spica_rx_invert_toggle(
+    uint32_t          die,
+    uint32_t          channel,
+    e_spica_intf      intf)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if(intf == SPICA_INTF_ORX)
     {
-        if (SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-           fw_lock |= SPICA_INTF_ORX;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
 #if !defined(INPHI_REMOVE_PMR)
-    if (SPICA_INTF_MTX & intf)
-    {
-        if (SPICA_MTX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-            fw_lock |= SPICA_INTF_MTX;
-        }
-    }
-    if (SPICA_INTF_MRX & intf)
+    else if (intf == SPICA_INTF_MRX)
     {
-        if (SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-           fw_lock |= SPICA_INTF_MRX;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
 #endif // defined(INPHI_REMOVE_PMR)
 #if !defined(INPHI_REMOVE_PSR)
-    if (SPICA_INTF_STX & intf)
+    else if (intf == SPICA_INTF_SRX) 
     {
-        if (SPICA_STX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-            fw_lock |= SPICA_INTF_STX;
-        }
+        // notify FW to toggle the invert_chan rule 
+        SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
+        SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
     }
-    if (SPICA_INTF_SRX & intf)
+#endif // defined(INPHI_REMOVE_PSR)
+    else 
     {
-        if (SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel))
-        {
-           fw_lock |= SPICA_INTF_SRX;
-        }
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
+        status |= INPHI_ERROR;
     }
-#endif // defined(INPHI_REMOVE_PSR)
 
-    // INPHI_NOTE("die=0x%08x, channel=%d, intf=0x%08x, fw_lock=0x%08x\n", die, channel, intf, fw_lock);
+    bool update_done = false;
+    int32_t attempts=30000; // 3 seconds
+    // Wait for FW to update rules
+    while(attempts > 0)
+    {
+        
+        if(intf == SPICA_INTF_ORX)      update_done = SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_MRX) update_done = SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
+        else if(intf == SPICA_INTF_SRX) update_done = SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
 
-    if (intf == fw_lock)
+        if(update_done) 
+        {
+            break;
+        }
+        INPHI_UDELAY(100);
+        attempts -= 1;
+    }
+    
+    if((status) || (attempts <= 0))
     {
-        return true;
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update invert_chan...\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+        status |= INPHI_ERROR;
     }
+    return status;
 
-    return false;
 }
 
-/*
- * Wait for all channels to be in the receive ready state
- */
-inphi_status_t spica_wait_for_link_ready(
-    uint32_t   die,
-    uint32_t   timeout_in_usecs)
+// Query the temperature
+inphi_status_t spica_temperature_query(uint32_t die, int16_t* temperature)
 {
-    // Clear bottom bits to make the next stuff easier
-    die = spica_package_get_base_die(die);
-    uint32_t num_dies = spica_package_get_num_dies(die);
+    inphi_status_t status = INPHI_OK;
+	int16_t temp=-273;
 
-    // If there are multiple dies inside the package then
-    // iterate through each one and check the status of all
-    // channels.
-    for(uint32_t i = 0; i < num_dies; i++)
+    if(SPICA_TMON_STATUS_1__IS_VALID__READ(die))
     {
-        uint32_t timer = 0;
-        while((timer < timeout_in_usecs) && 
-              (0 == SPICA_MCU_SP6_FW_STATUS__LOCKED__READ(die+i)))
-        {
-            INPHI_UDELAY(1000);
-            timer += 1000;
-        }
-        if(timer >= timeout_in_usecs)
-        {
-            return INPHI_ERROR;
-        }
+        temp = SPICA_TMON_STATUS__READ(die);
     }
-    return INPHI_OK;
-}
-
-/*
- * Wait for the selected interfaces of a channel ie ORX,OTX,MRX and MTX 
- * to be in the locked state.
- */
-inphi_status_t spica_channel_wait_for_link_ready(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    uint32_t     timeout_in_usecs)
-{
-    uint32_t timer = 0;
-
-    while (timer < timeout_in_usecs)
+    else
     {
-        if (spica_channel_is_link_ready(die, channel, intf))
-        {
-            return INPHI_OK;
-        }
-
-        INPHI_UDELAY(1000);
-
-        timer += 1000;
+        INPHI_CRIT("Temperature not ready to read.\n");
+        status |= INPHI_ERROR;
     }
 
-    return INPHI_ERROR;
+    *temperature = temp;
+
+    return status;
 }
 
-/*
- * This method may be called to query the current link status
- * of the interfaces of the device.
- */
-inphi_status_t spica_link_status_query(
+/** @file spica_dsp.c
+ ****************************************************************************
+ *
+ * @brief
+ *     This module contains the high level DSP diagnostic methods
+ *     implemented by the API.
+ *
+ ****************************************************************************
+ * @author
+ *    This file contains information that is proprietary and confidential to
+ *    Inphi Corporation.
+ *
+ *    This file can be used under the terms of the Inphi Software License
+ *    Agreement. You should have received a copy of the license with this file,
+ *    if not please contact your Inphi support staff.
+ *
+ *    Copyright (C) 2006-2021 Inphi Corporation, Inc. All rights reserved.
+ *
+ *    API Version Number: 1.2.0.929
+ ***************************************************************************/
+
+// needed to save the alg values in order to restore them
+static uint16_t en1;
+static uint16_t en2;
+static uint16_t en3;
+static uint16_t en4;
+ 
+inphi_status_t spica_rx_dsp_acquire_estimation_semaphore(
     uint32_t die,
-    spica_link_status_t* link_status)
+    uint32_t channel,
+    e_spica_intf intf)
 {
     inphi_status_t status = INPHI_OK;
+    uint16_t data;
+    uint32_t counter;
 
-    // Clear bottom bits to make the next stuff easier
-    die = spica_package_get_base_die(die);
-
-    uint32_t num_dies = spica_package_get_num_dies(die);
-
-    // One entry per die
-    uint16_t reset_cfg[SPICA_MAX_DIES_IN_PACKAGE] = {0};
-
-    /* pre-set the status  */
-    INPHI_MEMSET(link_status, 0, sizeof(*link_status));
-
-    link_status->fw_lock = true;
-    for(uint32_t i = 0; i < num_dies; i++) 
+    if (SPICA_INTF_SRX == intf)
     {
-        // get the reset state of the interface blocks
-        reset_cfg[i] = SPICA_MMD30_RESET_CFG__READ(die+i);
-
-        // Top Level is the LOCKED bit on both dies
-        link_status->fw_lock &= (1 == SPICA_MCU_SP6_FW_STATUS__LOCKED__READ(die+i));
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
 
-    // ORX
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    if (SPICA_INTF_ORX == intf)
     {
-        uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_ORX)&1;
-        if (SPICA_MMD30_RESET_CFG__ORX_SR__GET(reset_cfg[i]))
+        // Wait until rsp is 0
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 0)
         {
-            break; //bust out, this block is in reset
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 0.\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        link_status->orx_pll_lock[channel]      = SPICA_ORX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-        link_status->orx_pll_fsm_state[channel] = SPICA_ORX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-        link_status->orx_fw_lock[channel]       = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-        link_status->orx_reset_cnt[channel]     = SPICA_ORX_FW_STATUS__RESET_COUNT__READ(die, channel);
-        link_status->orx_sdt[channel]           = SPICA_ORX_FW_STATUS__SDT__READ(die, channel);
-        link_status->orx_fsm_state[channel]     = SPICA_ORX_FW_STATES__FSM_STATE_TOP__READ(die, channel);
-    }
-
-    // OTX
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
-    {
-        uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_OTX)&1;
-        if (SPICA_MMD30_RESET_CFG__OTX_SR__GET(reset_cfg[i]))
+        
+        // Wait until ctrl is 0
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_ORX_ALG_CTRL__CTRL__READ(die, channel) != 0)
         {
-            break; //bust out, this block is in reset
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 0.\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        link_status->otx_pll_lock[channel]      = SPICA_OTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-        link_status->otx_pll_fsm_state[channel] = SPICA_OTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-        link_status->otx_fw_lock[channel]       = SPICA_OTX_FW_STATUS__LOCKED__READ(die, channel);
-        link_status->otx_reset_cnt[channel]     = SPICA_OTX_FW_STATUS__RESET_COUNT__READ(die, channel);
-        link_status->otx_fsm_state[channel]     = SPICA_OTX_FW_STATUS__STATE__READ(die, channel);
-    }
 
-#if !defined(INPHI_REMOVE_PMR)
-    if (spica_package_has_pmr(die))
-    {
-        // MRX
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_MRX)
+        // save the current en1...en4
+        en1 = SPICA_ORX_ALG_CTRL__ALG1_EN__READ(die, channel);
+        en2 = SPICA_ORX_ALG_CTRL__ALG2_EN__READ(die, channel);
+        en3 = SPICA_ORX_ALG_CTRL__ALG3_EN__READ(die, channel);
+        en4 = SPICA_ORX_ALG_CTRL__ALG4_EN__READ(die, channel);
+
+        // set all en0...en3 to 0
+        SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
+        SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
+        SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
+        SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
+        INPHI_MDELAY(1000);
+
+        // wait until all algs in f/w have finished
+        bool algs_running = true;
+        counter = 0;
+        while (algs_running)
         {
-            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_MRX)&1;
-            if (SPICA_MMD30_RESET_CFG__MRX_SR__GET(reset_cfg[i]))
+            uint16_t sts1 = SPICA_ORX_ALG_STATUS__ALG1_STATUS__READ(die, channel);
+            uint16_t sts2 = SPICA_ORX_ALG_STATUS__ALG2_STATUS__READ(die, channel);
+            uint16_t sts3 = SPICA_ORX_ALG_STATUS__ALG3_STATUS__READ(die, channel);
+            uint16_t sts4 = SPICA_ORX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
+
+            if ((sts1 == 0) && (sts2 == 0) && (sts3 == 0) && (sts4 == 0)) 
             {
-                break; //bust out, this block is in reset or powered down
+                algs_running = false;
+            }
+
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+                INPHI_NOTE("f/w failed waiting for DSP alg to stop running\n");
+                INPHI_NOTE("ALGn=%d,%d,%d,%d\n", sts1,sts2,sts3,sts4);
+                return INPHI_ERROR;
             }
-            link_status->hrx_pll_lock[channel]      = SPICA_MRX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->hrx_pll_fsm_state[channel] = SPICA_MRX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-            link_status->hrx_fw_lock[channel]       = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->hrx_reset_cnt[channel]     = SPICA_MRX_FW_STATUS__RESET_COUNT__READ(die, channel);
-            link_status->hrx_sdt[channel]           = SPICA_MRX_FW_STATUS__SDT__READ(die, channel);
-            link_status->hrx_fsm_state[channel]     = SPICA_MRX_FW_STATES__FSM_STATE_TOP__READ(die, channel);
         }
+        // if we use search engine set the ddsl bit to 1, lets set it to 1 to be safe
+        // set the ctrl = 1 and ddsl = 1 at the same time (it is important these to be 
+        // set at the same time otherwise f/w won't disable the dsl)
+        data = SPICA_ORX_ALG_CTRL__READ(die, channel);
+        data = SPICA_ORX_ALG_CTRL__CTRL__SET(data, 1);
+        data = SPICA_ORX_ALG_CTRL__DDSL__SET(data, 1);
+        SPICA_ORX_ALG_CTRL__WRITE(die, channel, data);
 
-        // MTX
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_MTX)
+        // wait until rsp is set to 1 by f/w
+        counter = 0;
+        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 1)
         {
-            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_MTX)&1;
-            if (SPICA_MMD30_RESET_CFG__SMTX_SR__GET(reset_cfg[i]))
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
             {
-                break; //bust out, this block is in reset
+                INPHI_NOTE("f/w failed to acquire semaphore\n");
+                return INPHI_ERROR;
             }
-            link_status->htx_pll_lock[channel]      = SPICA_SMTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->htx_pll_fsm_state[channel] = SPICA_SMTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-            link_status->htx_fw_lock[channel]       = SPICA_MTX_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->htx_reset_cnt[channel]     = SPICA_MTX_FW_STATUS__RESET_COUNT__READ(die, channel);
-            link_status->htx_fsm_state[channel]     = SPICA_MTX_FW_STATUS__STATE__READ(die, channel);
         }
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    if (spica_package_has_psr(die))
+#if !defined(INPHI_REMOVE_PMR)
+    else if (SPICA_INTF_MRX == intf)
     {
-        // SRX
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_SRX)
+        // Wait until rsp is 0
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 0)
         {
-            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_SRX)&1;
-            if (SPICA_MMD30_RESET_CFG__SRX_SR__GET(reset_cfg[i]))
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
             {
-                break; //bust out, this block is in reset
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 0.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
             }
-            // link_status->hrx_pll_lock[channel]      = SPICA_MRX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-            // link_status->hrx_pll_fsm_state[channel] = SPICA_MRX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-            // link_status->hrx_vco_lock[channel]      = SPICA_SRX_RXD_INTS__CTRL_LOCKDET_LOCK_FILTEREDS__READ(die, channel);
-            link_status->hrx_cdr_lock[channel]      = SPICA_SRX_RXD_INTS__CTRL_LOCKDET_LOCK_FILTEREDS__READ(die, channel);
-            link_status->hrx_fw_lock[channel]       = SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->hrx_reset_cnt[channel]     = SPICA_SRX_FW_STATUS__RESET_COUNT__READ(die, channel);
-            link_status->hrx_fsm_state[channel]     = SPICA_SRX_FW_STATUS__STATE__READ(die, channel);
-            link_status->hrx_sdt[channel]           = SPICA_SRX_CH_STATUS2__SDT__READ(die, channel);
         }
-
-        // STX
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_STX)
+        
+        // Wait until ctrl is 0
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_MRX_ALG_CTRL__CTRL__READ(die, channel) != 0)
         {
-            uint32_t i = spica_reg_channel_to_die(die, channel, SPICA_INTF_STX)&1;
-            if (SPICA_MMD30_RESET_CFG__SMTX_SR__GET(reset_cfg[i]))
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
             {
-                break; //bust out, this block is in reset
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 0.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
             }
-            link_status->htx_pll_lock[channel]      = SPICA_SMTX_PLL_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->htx_pll_fsm_state[channel] = SPICA_SMTX_PLL_FW_STATUS__PLL_FSM_STATE__READ(die, channel);
-            link_status->htx_fw_lock[channel]       = SPICA_STX_FW_STATUS__LOCKED__READ(die, channel);
-            link_status->htx_reset_cnt[channel]     = SPICA_STX_FW_STATUS__RESET_COUNT__READ(die, channel);
-            link_status->htx_fsm_state[channel]     = SPICA_STX_FW_STATUS__STATE__READ(die, channel);
         }
-    }
-#endif // defined(INPHI_REMOVE_PSR)
-    return status;
-}
-
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-/*
- * This method may be called to print the current link status
- * of the interfaces of the device.
- */
-inphi_status_t spica_link_status_print(
-    uint32_t die,
-    spica_link_status_t* link_status)
-{
-    inphi_status_t status = INPHI_OK;
-    e_spica_intf rx_intf = SPICA_INTF_MRX;
-    e_spica_intf tx_intf = SPICA_INTF_MTX;
-    
-    const spica_channels_t* line_ch;
-    const spica_channels_t* host_ch;
-
-    // get the number of channels on the line and host sides
-    line_ch = spica_channels(die, SPICA_INTF_POR);
-    if (spica_package_has_pmr(die))
-    {     
-        host_ch = spica_channels(die, SPICA_INTF_PMR);
-    }
-    else
-    {     
-        host_ch = spica_channels(die, SPICA_INTF_PSR);
-    }
 
-    INPHI_NOTE("Link Status for die 0x%08lu\n", die);
-    INPHI_NOTE("+---------------------------------------------------------------------------------+\n");
-    INPHI_NOTE("|  Top FW Lock    %s                                                               |\n", link_status->fw_lock ? "Y" : ".");
-    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
+        // save the current en1...en4
+        en1 = SPICA_MRX_ALG_CTRL__ALG1_EN__READ(die, channel);
+        en2 = SPICA_MRX_ALG_CTRL__ALG2_EN__READ(die, channel);
+        en3 = SPICA_MRX_ALG_CTRL__ALG3_EN__READ(die, channel);
+        en4 = SPICA_MRX_ALG_CTRL__ALG4_EN__READ(die, channel);
 
-    if (spica_package_has_pmr(die))
-    {
-        INPHI_NOTE("|  MTX                                   |  MRX                                   |\n");
-    }
-    if (spica_package_has_psr(die))
-    {
-        rx_intf = SPICA_INTF_SRX;
-        tx_intf = SPICA_INTF_STX;
-        INPHI_NOTE("|  STX                                   |  SRX                                   |\n");
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("|  Channel        1  2  3  4             |  Channel        1  2  3  4             |\n");
-        INPHI_NOTE("|                -----------             |                 ----------             |\n");    
-    }
-    else
-    {
-        INPHI_NOTE("|  Channel        1  2  3  4  5  6  7  8 |  Channel        1  2  3  4  5  6  7  8 |\n");
-        INPHI_NOTE("|                ----------------------- |                ----------------------- |\n");
-    }
-    // ------------------------------ SMTX/SMRX BLOCKS ---------------------------------------
+        // set all en0...en3 to 0
+        SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
+        SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
+        SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
+        SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
+        INPHI_MDELAY(1000);
 
-    INPHI_NOTE("|  Reg Instance  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
-    {
-        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, tx_intf);
-        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE("|  Reg Instance  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
-    {
-        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, rx_intf);
-        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE("|\n");
-    INPHI_NOTE("|  FW Lock      ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
-    {
-        INPHI_NOTE("  %s", link_status->htx_fw_lock[channel] ? "Y" : ".");
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
+        // wait until all algs in f/w have finished
+        bool algs_running = true;
+        counter = 0;
+        while (algs_running)
+        {
+            uint16_t sts1 = SPICA_MRX_ALG_STATUS__ALG1_STATUS__READ(die, channel);
+            uint16_t sts2 = SPICA_MRX_ALG_STATUS__ALG2_STATUS__READ(die, channel);
+            uint16_t sts3 = SPICA_MRX_ALG_STATUS__ALG3_STATUS__READ(die, channel);
+            uint16_t sts4 = SPICA_MRX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
 
-    INPHI_NOTE(" |  FW Lock      ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
-    {
-        INPHI_NOTE("  %s", link_status->hrx_fw_lock[channel] ? "Y" : ".");
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE(" |\n");
+            if ((sts1 == 0) && (sts2 == 0) && (sts3 == 0) && (sts4 == 0)) 
+            {
+                algs_running = false;
+            }
 
-    INPHI_NOTE("|  FSM State    ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
-    {
-        INPHI_NOTE(" %02x", link_status->htx_fsm_state[channel]);
-    }
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+                INPHI_NOTE("f/w failed waiting for DSP alg to stop running\n");
+                INPHI_NOTE("ALGn=%d,%d,%d,%d\n", sts1,sts2,sts3,sts4);
+                return INPHI_ERROR;
+            }
+        }
+        // if we use search engine set the ddsl bit to 1, lets set it to 1 to be safe
+        // set the ctrl = 1 and ddsl = 1 at the same time (it is important these to be 
+        // set at the same time otherwise f/w won't disable the dsl)
+        data = SPICA_MRX_ALG_CTRL__READ(die, channel);
+        data = SPICA_MRX_ALG_CTRL__CTRL__SET(data, 1);
+        data = SPICA_MRX_ALG_CTRL__DDSL__SET(data, 1);
+        SPICA_MRX_ALG_CTRL__WRITE(die, channel, data);
 
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE(" |  FSM State    ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
-    {
-        INPHI_NOTE(" %02x", link_status->hrx_fsm_state[channel]);
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
+        // wait until rsp is set to 1 by f/w
+        counter = 0;
+        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 1)
+        {
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+                INPHI_NOTE("f/w failed to acquire semaphore\n");
+                return INPHI_ERROR;
+            }
+        }
     }
-    INPHI_NOTE(" |\n");
+#endif // defined(INPHI_REMOVE_PMR)
 
-    INPHI_NOTE("|  PLL Lock     ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
-    {
-        INPHI_NOTE("  %s", link_status->htx_pll_lock[channel] ? "Y" : ".");
-    }
-    if (host_ch->num == 4)
+    return status;
+}
+
+inphi_status_t spica_rx_dsp_release_estimation_semaphore(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t counter = 0;
+
+    if (SPICA_INTF_SRX == intf)
     {
-        INPHI_NOTE("            ");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
 
-    if (spica_package_has_pmr(die))
+    if (SPICA_INTF_ORX == intf)
     {
-        INPHI_NOTE(" |  PLL Lock     ");
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        // Wait until rsp is 1
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 1)
         {
-            INPHI_NOTE("  %s", link_status->hrx_pll_lock[channel] ? "Y" : ".");
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 1.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        if (host_ch->num == 4)
+        
+        // Wait until ctrl is 1
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_ORX_ALG_CTRL__CTRL__READ(die, channel) != 1)
         {
-            INPHI_NOTE("            ");
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 1.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        INPHI_NOTE(" |\n");
+
+        // restore all en1...en4
+        SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
+        SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
+        SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
+        SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
+
+        // set ctrl to 0
+        SPICA_ORX_ALG_CTRL__CTRL__RMW(die, channel, 0);
+
+        // wait until rsp is set to 0 by f/w
+        counter = 0;
+        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 0)
+        {
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+                INPHI_NOTE("f/w failed to release semaphore\n");
+                return INPHI_ERROR;
+            }
+        }
+        // Set DDSL to 0, if it has been set to 1 when acquiring semaphore
+        SPICA_ORX_ALG_CTRL__DDSL__RMW(die, channel, 0);
     }
-    if (spica_package_has_psr(die))
+#if !defined(INPHI_REMOVE_PMR)
+    else if (SPICA_INTF_MRX == intf)
     {
-        INPHI_NOTE(" |  CDR Lock     ");
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        // Wait until rsp is 1
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 1)
         {
-            INPHI_NOTE("  %s", link_status->hrx_cdr_lock[channel] ? "Y" : ".");
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 1.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        if (host_ch->num == 4)
+        
+        // Wait until ctrl is 1
+        // Otherwise timeout and throw error
+        counter = 0;
+        while (SPICA_MRX_ALG_CTRL__CTRL__READ(die, channel) != 1)
         {
-            INPHI_NOTE("            ");
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 1.\n", spica_dbg_translate_intf(intf), channel);
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+                return INPHI_ERROR;
+            }
         }
-        INPHI_NOTE(" |\n");
-    }
 
-    INPHI_NOTE("|  PLL FSM State");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
-    {
-        INPHI_NOTE(" %02x", link_status->htx_pll_fsm_state[channel]);
-    }
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
+        // restore all en1...en4
+        SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
+        SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
+        SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
+        SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
 
-    if (spica_package_has_pmr(die))
-    {
-        INPHI_NOTE(" |  PLL FSM State");
-        SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
+        // set ctrl to 0
+        SPICA_MRX_ALG_CTRL__CTRL__RMW(die, channel, 0);
+
+        // wait until rsp is set to 0 by f/w
+        counter = 0;
+        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 0)
         {
-            INPHI_NOTE(" %02x", link_status->hrx_pll_fsm_state[channel]);
+            counter += SPICA_EVENT_WAIT(die, SPICA_EVENT_ALG, SPICA_RX_DSP_FW_POLL_MS);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
+            {
+                INPHI_NOTE("f/w failed to release semaphore\n");
+                return INPHI_ERROR;
+            }
         }
+        // Set DDSL to 0, if it has been set to 1 when acquiring semaphore
+        SPICA_MRX_ALG_CTRL__DDSL__RMW(die, channel, 0);
     }
-    if (host_ch->num == 4)
+#endif // defined(INPHI_REMOVE_PMR)
+
+    return status;
+}
+
+inphi_status_t spica_rx_dsp_snr_wait_for_done(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    uint32_t* snr_results)
+{
+    inphi_status_t status = INPHI_OK;
+    uint16_t data;
+    uint16_t sto_acc;
+
+    if (SPICA_INTF_SRX == intf)
     {
-        INPHI_NOTE("            ");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
-    INPHI_NOTE(" |\n");
- 
-    INPHI_NOTE("|  Reset Count  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, tx_intf)
+
+    if (SPICA_INTF_ORX == intf)
     {
-        INPHI_NOTE(" %02x", link_status->htx_reset_cnt[channel]);
+        uint16_t counter = 0;
+        while (0 == SPICA_ORX_CP_ALG_DONE_INT__SNR__READ(die, channel))
+        {
+            counter++;
+            INPHI_UDELAY(1);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            {
+                INPHI_NOTE(" SNR estimation algorithm has not completed\n");
+                return INPHI_ERROR;
+            }
+        }
+
+        data = SPICA_ORX_CP_SLC_RUN_CFG__DEFAULT;
+        data = SPICA_ORX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 0);
+        SPICA_ORX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+
+        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);  // clear run_alg
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0);    // always doing reads
+        // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0);
+        // always doing an access    
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1);
+
+        for (uint16_t slice = 0; slice < 128; slice++)
+        {
+            // read from storage
+            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 4);
+            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x88 + slice / 4);
+            SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+            INPHI_UDELAY(1);
+            data = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
+            uint32_t snr_data1 = ((uint32_t)data << 16);
+            data = SPICA_ORX_CP_STORAGE_DATA0__READ(die, channel);
+            uint32_t snr_data0 = data;
+            snr_results[slice] = ((snr_data0 + snr_data1) >> 8);
+        }
     }
-    if (host_ch->num == 4)
+#if !defined(INPHI_REMOVE_PMR)
+    else if (SPICA_INTF_MRX == intf)
     {
-        INPHI_NOTE("            ");
+        uint16_t counter = 0;
+        while (0 == SPICA_MRX_CP_ALG_DONE_INT__SNR__READ(die, channel))
+        {
+            counter++;
+            INPHI_UDELAY(1);
+            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            {
+                INPHI_NOTE(" SNR estimation algorithm has not completed\n");
+                return INPHI_ERROR;
+            }
+        }
+
+        data = SPICA_MRX_CP_SLC_RUN_CFG__DEFAULT;
+        data = SPICA_MRX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 0);
+        SPICA_MRX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+
+        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);  // clear run_alg
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0);    // always doing reads
+        // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0);
+        // always doing an access    
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1);
+
+        for (uint16_t slice = 0; slice < 128; slice++)
+        {
+            // read from storage
+            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 4);
+            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x88 + slice / 4);
+            SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+            INPHI_UDELAY(1);
+            data = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
+            uint32_t snr_data1 = ((uint32_t)data << 16);
+            data = SPICA_MRX_CP_STORAGE_DATA0__READ(die, channel);
+            uint32_t snr_data0 = data;
+            snr_results[slice] = ((snr_data0 + snr_data1) >> 8);
+        }
     }
+#endif // defined(INPHI_REMOVE_PMR)
+
+    return status;
+}
+        
+
+inphi_status_t spica_rx_dsp_snr_init_and_start(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    uint32_t step_size,
+    uint32_t duration,
+    uint32_t settle)
+{
+    inphi_status_t status = INPHI_OK;
+    uint16_t data;
 
-    INPHI_NOTE(" |  Reset Count  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
-    {
-        INPHI_NOTE(" %02x", link_status->hrx_reset_cnt[channel]);
-    }
-    if (host_ch->num == 4)
+    if (SPICA_INTF_SRX == intf)
     {
-        INPHI_NOTE("            ");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
-    INPHI_NOTE(" |\n");
 
-    INPHI_NOTE("|                                        ");
-    INPHI_NOTE("|  Signal Detect");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, rx_intf)
-    {
-        INPHI_NOTE("  %s", link_status->hrx_sdt[channel] ? "Y" : ".");
-    }
-    if (host_ch->num == 4)
+    if (SPICA_INTF_ORX == intf)
     {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE(" |\n");
+        data = SPICA_ORX_CP_SLC_RUN_CFG__DEFAULT;
+        data = SPICA_ORX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 1);
+        SPICA_ORX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
 
-    INPHI_NOTE("|                                        |                                        |\n");
-    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
-    INPHI_NOTE("|  ORX                                   |  OTX                                   |\n");
-    if (host_ch->num == 4)
-    {
-        INPHI_NOTE("|  Channel        1  2  3  4             |  Channel        1  2  3  4             |\n");
-        INPHI_NOTE("|                -----------             |                -----------             |\n");
-    }
-    else
-    {
-        INPHI_NOTE("|  Channel        1  2  3  4  5  6  7  8 |  Channel        1  2  3  4  5  6  7  8 |\n");
-        INPHI_NOTE("|                ----------------------- |                ----------------------- |\n");
-    }
-    
-    INPHI_NOTE("|  Reg Instance  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, SPICA_INTF_ORX);
-        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
+        data = SPICA_ORX_CP_SNR_CFG__DEFAULT;
+        data = SPICA_ORX_CP_SNR_CFG__STEP_SIZE__SET(data, step_size);
+        data = SPICA_ORX_CP_SNR_CFG__STORE_ADDR__SET(data, 0xa);
+        SPICA_ORX_CP_SNR_CFG__WRITE(die, channel, data);
 
-    INPHI_NOTE("|  Reg Instance  ");
-    
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
-    {
-        uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, SPICA_INTF_OTX);
-        INPHI_NOTE("%lu%1lu ", (die_inst >> 16), (die_inst & 0xffff));
+        // clear the snr alg 'done' interrupt bitfield
+        SPICA_ORX_CP_ALG_DONE_INT__WRITE(die, channel, 1 << 12);
+        SPICA_ORX_CP_SNR_RUN_CFG__DURATION__RMW(die, channel, duration);
+        SPICA_ORX_CP_SNR_RUN_CFG__SETTLE__RMW(die, channel, settle);
+        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);
+        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 1);
     }
-    if (line_ch->num == 4)
+#if !defined(INPHI_REMOVE_PMR)
+    else if (SPICA_INTF_MRX == intf)
     {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE("|\n");
+        data = SPICA_MRX_CP_SLC_RUN_CFG__DEFAULT;
+        data = SPICA_MRX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 1);
+        SPICA_MRX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
 
-    INPHI_NOTE("|  FW Lock      ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        INPHI_NOTE("  %s", link_status->orx_fw_lock[channel] ? "Y" : ".");
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
+        data = SPICA_MRX_CP_SNR_CFG__DEFAULT;
+        data = SPICA_MRX_CP_SNR_CFG__STEP_SIZE__SET(data, step_size);
+        data = SPICA_MRX_CP_SNR_CFG__STORE_ADDR__SET(data, 0xa);
+        SPICA_MRX_CP_SNR_CFG__WRITE(die, channel, data);
 
-    INPHI_NOTE(" |  FW Lock      ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
-    {
-        INPHI_NOTE("  %s", link_status->otx_fw_lock[channel] ? "Y" : ".");
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
+        // clear the snr alg 'done' interrupt bitfield
+        SPICA_MRX_CP_ALG_DONE_INT__WRITE(die, channel, 1 << 12);
+        SPICA_MRX_CP_SNR_RUN_CFG__DURATION__RMW(die, channel, duration);
+        SPICA_MRX_CP_SNR_RUN_CFG__SETTLE__RMW(die, channel, settle);
+        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);
+        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 1);
     }
-    INPHI_NOTE(" |\n");
+#endif // defined(INPHI_REMOVE_PMR)
 
-    INPHI_NOTE("|  FSM State    ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        INPHI_NOTE(" %02x", link_status->orx_fsm_state[channel]);
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
+    return status;
+}
 
-    INPHI_NOTE(" |  FSM State    ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
-    {
-        INPHI_NOTE(" %02x", link_status->otx_fsm_state[channel]);
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE(" |\n");
+/*
+ *  Returns 64 element array in this order:
+ *          M3 (16)
+ *          M1 (16)
+ *          P1 (16)
+ *          P3 (16)
+ */
+  inphi_status_t spica_rx_dsp_get_amp_all(
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t*    amp_locs)
+{
+    inphi_status_t status = INPHI_OK;
+    uint16_t sto_acc;
 
-    INPHI_NOTE("|  PLL Lock     ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        INPHI_NOTE("  %s", link_status->orx_pll_lock[channel] ? "Y" : ".");
-    }
-    if (line_ch->num == 4)
+    if (SPICA_INTF_SRX == intf)
     {
-        INPHI_NOTE("            ");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
 
-    INPHI_NOTE(" |  PLL Lock     ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    // // only update AMP levels once
+    // if (amp_lvls_init)
+    // {
+    //     return status;
+    // }
+
+    // INPHI_NOTE("Initializing SNR AMP levels\n");
+    // amp_lvls_init = true;
+
+    // Returns 16x4-element over all 16 slices for each of the 
+    // four PAM4 levels: [-3, -1, +1, +3] (in that order).
+    // INPHI_MEMSET(amp_locs, 0, 16*4*4); // this done by calling method
+
+    if (SPICA_INTF_ORX == intf)
     {
-        INPHI_NOTE("  %s", link_status->otx_pll_lock[channel] ? "Y" : ".");
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(   0,       0); // always doing reads
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 1); // always doing 12b accesses
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+     
+        for (uint16_t level = 0; level < 4; level++)
+        {
+            for (uint16_t slice = 0; slice < 16; slice++)
+            {
+                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0xa8 + level*2 + slice / 8);
+                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 8);
+                SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                INPHI_UDELAY(1);
+                amp_locs[level*16 + slice] = SPICA_ORX_CP_STORAGE_DATA0__READ(die, channel) / 8; //convert from u12.3 to u9.0
+            }
+        }
     }
-    if (line_ch->num == 4)
+#if !defined(INPHI_REMOVE_PMR)
+    else if (SPICA_INTF_MRX == intf)
     {
-        INPHI_NOTE("            ");
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(   0,       0); // always doing reads
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 1); // always doing 12b accesses
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+     
+        for (uint16_t level = 0; level < 4; level++)
+        {
+            for (uint16_t slice = 0; slice < 16; slice++)
+            {
+                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0xa8 + level*2 + slice / 8);
+                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 8);
+                SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                INPHI_UDELAY(1);
+                amp_locs[level*16 + slice] = SPICA_MRX_CP_STORAGE_DATA0__READ(die, channel) / 8; //convert from u12.3 to u9.0
+            }
+        }
     }
-    INPHI_NOTE(" |\n");
+#endif // defined(INPHI_REMOVE_PMR)
 
-    INPHI_NOTE("|  PLL FSM State");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        INPHI_NOTE(" %02x", link_status->orx_pll_fsm_state[channel]);
-    }
-    if (line_ch->num == 4)
-    {
-        INPHI_NOTE("            ");
+    return status;
+}
+
+//! Fold the SNR results of one step into the histogram, histo holds the
+//! num_slices slices from first_slice on
+//! @private
+static void spica_rx_dsp_hist_fill_step(
+    uint32_t        i,
+    uint32_t        step_val,
+    const uint32_t* snr_results,
+    const uint32_t* amp_locs,
+    uint32_t        first_slice,
+    uint32_t        num_slices,
+    uint32_t*       histo)
+{
+    for (uint32_t amp_idx = 0; amp_idx < 4; amp_idx++)
+    {
+        for (uint32_t th_idx = first_slice; th_idx < (first_slice + num_slices); th_idx++)
+        {
+            uint32_t cur_loc     = ((th_idx-first_slice)*SPICA_RX_DSP_HIST_BINS*4)+amp_locs[amp_idx*16 + th_idx];
+            uint32_t temp_idx    = th_idx + (amp_idx * 32);
+            uint32_t hump_offset = amp_idx*SPICA_RX_DSP_HIST_BINS; // each hump has one 256 entry bin
+            // here we get the 16 track and hold values, will calc the average later...
+            if (step_val == 0) 
+            {
+                histo[cur_loc+hump_offset] = (snr_results[temp_idx] + snr_results[temp_idx + 16]) / 2;
+                //INPHI_NOTE("histo[cur_loc]=[%d]=%d, \n", cur_loc, histo[cur_loc]);
+            }
+            else
+            {
+                histo[cur_loc-i+hump_offset] = snr_results[temp_idx + 16];
+                //INPHI_NOTE("histo[cur_loc-idx]=[%d-%d]=[%d]=%d, \n", cur_loc, idx, cur_loc-idx, histo[cur_loc-idx]);
+
+                histo[cur_loc+i+hump_offset] = snr_results[temp_idx];
+                //INPHI_NOTE("histo[cur_loc+idx]=[%d+%d]=[%d]=%d, \n", cur_loc, idx, cur_loc+idx, histo[cur_loc+idx]);
+            }
+        }
     }
+}
 
-    INPHI_NOTE(" |  PLL FSM State");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
-    {
-        INPHI_NOTE(" %02x", link_status->otx_pll_fsm_state[channel]);
+//! For NRZ only the -3 and +3 humps are valid, clear the -1 and +1 humps
+//! of the num_slices slices held by histo
+//! @private
+static void spica_rx_dsp_hist_clear_nrz(
+    uint32_t  num_slices,
+    uint32_t* histo)
+{
+    // For NRZ, here's a look at the layout of a slice in histo
+    // |---------|---------+---------|---------|
+    // |0     255|256   511|512   767|768  1023|
+    // |---------|---------+---------|---------|
+    // |    -3   |    -1   |   +1    |    +3   |
+    // |---------|---------+---------|---------| 
+    // So here we clear the garbage in the area -1 and +1
+    for (uint32_t th_idx = 0; th_idx < num_slices; th_idx++)
+    {
+        uint32_t start_idx = 256+(th_idx*SPICA_RX_DSP_HIST_BINS*4);
+        uint32_t end_idx   = 768+(th_idx*SPICA_RX_DSP_HIST_BINS*4);
+        for (uint32_t idx = start_idx; idx < end_idx; idx++)  
+        {
+            histo[idx] = 0;
+        }
+        // // mb: There is a problem in the RTL where it does not saturate the 
+        // // DAC code when applying the step_size.  We can get around this in 
+        // // software by ignoring results at the edges which are out-of-whack. 
+        // // I observed saturated values at 61..63, 125..127 so we clear them.
+        // histo[61+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
+        // histo[62+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
+        // histo[63+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
+        // histo[125+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
+        // histo[126+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
+        // histo[127+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
     }
-    if (line_ch->num == 4)
+}
+
+inphi_status_t spica_rx_dsp_hist_dsl(
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    bool         is_nrz,
+    uint32_t*    histo)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t steps[64];
+    uint32_t i;
+    uint32_t snr_results[128];
+    uint32_t amp_locs[16*4];
+
+    if (SPICA_INTF_SRX == intf)
     {
-        INPHI_NOTE("            ");
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
-    INPHI_NOTE(" |\n");
 
-    INPHI_NOTE("|  Reset Count  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
+    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
     {
-        INPHI_NOTE(" %02x", link_status->orx_reset_cnt[channel]);
+        return status;
     }
-    if (line_ch->num == 4)
+
+    INPHI_MEMSET(steps, 0, sizeof(steps)); 
+    INPHI_MEMSET(snr_results, 0, sizeof(snr_results));
+    INPHI_MEMSET(amp_locs, 0, sizeof(amp_locs));
+ 
+    for (i = 0; i < SPICA_RX_DSP_MAX_STEP; i++)
     {
-        INPHI_NOTE("            ");
+        uint32_t j = i * SPICA_RX_DSP_STEP_SIZE;
+        if (j >= SPICA_RX_DSP_MAX_STEP)
+        {
+            break;
+        }
+        steps[i] = j;
     }
+    uint32_t num_steps = i;
 
-    INPHI_NOTE(" |  Reset Count  ");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_OTX)
+    // uint8_t single_hist_length = 4 * (2*num_steps - 1);
+    // amp estimation once before running this not needed
+    // since the DSL is actually running in the background
+    // before this is called
+    // if (is_nrz)
+    // {
+    //     amp_locs[0] = num_steps-1;
+    //     for (i = 0; i < 3; i++)
+    //     {
+    //         amp_locs[i+1] = amp_locs[i] + (2 * num_steps - 1);
+    //     }
+    //     INPHI_NOTE("amp_locs[0] = %d\n", amp_locs[0]);
+    //     INPHI_NOTE("amp_locs[1] = %d\n", amp_locs[1]);
+    //     INPHI_NOTE("amp_locs[2] = %d\n", amp_locs[2]);
+    //     INPHI_NOTE("amp_locs[3] = %d\n", amp_locs[3]);
+    // }
+    // else //PAM
     {
-        INPHI_NOTE(" %02x", link_status->otx_reset_cnt[channel]);
+        // Fetch the amp locations for all humps/interleaves ie (16*4*32-bits)
+        // Note: This doesn't seem right for NRZ so only for PAM now!
+        status |= spica_rx_dsp_get_amp_all(die, channel, intf, amp_locs);
+        if (status != INPHI_OK)
+        {
+            return status;
+        }
+        // for PAM divide the values by 2 (ie from 512 bins to 256)
+        for (uint16_t level = 0; level < 4; level++)
+        {
+            for (uint16_t slice = 0; slice < 16; slice++)
+            {
+                amp_locs[level*16 + slice] >>= 1;
+            }
+        }
     }
-    if (line_ch->num == 4)
+    // for (uint16_t slice = 0; slice < 16; slice++)
+    // {
+    //     INPHI_NOTE("\nHist amp locs: i:%2d, ", slice);
+    //     for (uint16_t level = 0; level < 4; level++)
+    //     {
+    //         INPHI_NOTE("loc(%d):%3d, ", level, amp_locs[level*16 + slice]);
+    //     }
+    // }
+    // INPHI_NOTE("\n");
+    
+    
+    for (i = 0; i < SPICA_RX_DSP_MAX_STEP; i++)
     {
-        INPHI_NOTE("            ");
-    }
-    INPHI_NOTE(" |\n");
+        uint32_t step_val = steps[i];
+        if (i == num_steps)
+        {
+            break;
+        }
 
-    INPHI_NOTE("|  Signal Detect");
-    SPICA_FOR_CHANNEL_IN_CHANNELS(die, SPICA_INTF_ORX)
-    {
-        INPHI_NOTE("  %s", link_status->orx_sdt[channel] ? "Y" : ".");
+        // SNR results for -3 and +3 levels do not change based on nrz vs pam4
+        // The 128 return values are exactly the same in nrz and pam4 but all the ones for -1 and +1 will be garbage in nrz
+        // 6 slices * 4 levels/slice * 2 lo/hi per level (2 of the 4 levels will be garbage in NRZ)
+        spica_rx_dsp_snr_init_and_start(die, channel, intf, step_val, 
+                                             SPICA_RX_DSP_DURATION_16, 
+                                             SPICA_RX_DSP_SETTLE_11);
+        status = spica_rx_dsp_snr_wait_for_done(die, channel, intf, snr_results);  // 128 values (64 useful in NRZ)
+        
+        // snr_results is an array of 128 32-bit unsigned integers.
+        // index   0.. 15: interleave 0..15, level -3, +step_val
+        // index  16.. 31: interleave 0..15, level -3, -step_val
+        // index  32.. 47: interleave 0..15, level -1, +step_val
+        // index  48.. 63: interleave 0..15, level -1, -step_val
+        // index  64.. 79: interleave 0..15, level +1, +step_val
+        // index  80.. 95: interleave 0..15, level +1, -step_val
+        // index  96..111: interleave 0..15, level +3, +step_val
+        // index 112..127: interleave 0..15, level +3, -step_val
+        
+        // // Morrie: print out one slice, in order
+        // for (uint32_t temp_level = 0; temp_level < 4; temp_level++)
+        // {
+        //     if ((temp_level == 1) || (temp_level == 2)) continue;
+        //     INPHI_NOTE("%d,%d,%d,%d\n", 0, temp_level, -1*step_val, snr_results[temp_level*32+16+0]);
+        //     INPHI_NOTE("%d,%d,%d,%d\n", 0, temp_level,    step_val, snr_results[temp_level*32   +0]);
+        // }
+
+        spica_rx_dsp_hist_fill_step(i, step_val, snr_results, amp_locs, 0, SPICA_RX_DSP_HIST_TH_SLICES, histo);
     }
-    if (line_ch->num == 4)
+    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
     {
-        INPHI_NOTE("            ");
+        return status;
     }
-    INPHI_NOTE(" |                                        |\n");
-
-    INPHI_NOTE("|                                        |                                        |\n");
-    INPHI_NOTE("+----------------------------------------+----------------------------------------+\n");
-    INPHI_NOTE("Legend: Status Y=yes, .=no\n");
-    INPHI_NOTE("        Reg Instance jk, j=die, k=instance\n");
 
     return status;
 }
 
-/*
- * This method may be called to query then print the current link status
- * of the interfaces of the device.
- */
-inphi_status_t spica_link_status_query_print(
-    uint32_t die)
+inphi_status_t spica_rx_dsp_hist_get(
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t*    histo)
 {
     inphi_status_t status = INPHI_OK;
-    spica_link_status_t link_status;
-
-    status |= spica_link_status_query(die, &link_status);
-    status |= spica_link_status_print(die, &link_status);
-
-    // check to see if the FW is responsible
-    // spica_is_fw_running_ok(die);
-
-    return status;
-}
-
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+    bool    fw_lock;
+    bool    is_nrz = false;
 
-inphi_status_t spica_tx_man_config(
-    uint32_t            die,
-    uint32_t            channel,
-    e_spica_intf        intf,
-    e_spica_lut_mode    lut_mode,
-    bool                is_lut_unsigned,
-    bool                toggle_squelch,
-    int8_t              lut[256],
-    int16_t             coef[28])
-{
-    inphi_status_t status = INPHI_OK;
-    bool squelched = false;
-    uint16_t data = 0;
+    if (SPICA_INTF_SRX == intf)
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
+    }
 
-    // Set the API version in the spare registers
-    spica_init_api_version(die);
+    SPICA_LOCK(die);
 
-    //Check the rules
-    if((!lut) && (lut_mode != SPICA_LUT_7TAP_LIN))
+    if (SPICA_INTF_ORX == intf)
     {
-        INPHI_CRIT("ERROR: Must specify lut unless you're using 7TAP_LIN mode\n");
-        return INPHI_ERROR;
+        fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
+        is_nrz  = SPICA_ORX_RULES_0__SIGNALLING__READ(die, channel);
     }
-    if((lut_mode == SPICA_LUT_7TAP_LIN) || (lut_mode == SPICA_LUT_7TAP_LUT))
+    else 
     {
-        if((intf != SPICA_INTF_OTX) && (intf != SPICA_INTF_MTX))
+        // must be MRX
+        fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
+        is_nrz  = SPICA_MRX_RULES_0__SIGNALLING__READ(die, channel);
+    }
+    if (!fw_lock)
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_WARN("%s[Channel %lu]: NOT FW LOCKED!\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        status |= INPHI_ERROR;
+#if 0
+        // load a stripes pattern
+        for (uint16_t i = 0; i < 255; i += 2) 
         {
-            INPHI_CRIT("ERROR: Only OTX and MTX interfaces support 7TAP modes\n");
-            return INPHI_ERROR;
+            histo[i+0] = 0;
+            histo[i+1] = 1048575; // 2^20
         }
-        if(!coef)
+#endif
+    }
+    else 
+    {
+        status = spica_rx_dsp_hist_dsl(die, channel, intf, is_nrz, histo);
+        
+        if (is_nrz)
         {
-            INPHI_CRIT("ERROR: Must specify coef to program in 7TAP_LIN/LUT modes\n");
-            return INPHI_ERROR;
+            spica_rx_dsp_hist_clear_nrz(SPICA_RX_DSP_HIST_TH_SLICES, histo);
         }
     }
-    if(channel == SPICA_BROADCAST_CHANNEL)
+    // for (uint32_t idx = 0; idx < SPICA_RX_DSP_HIST_BINS*SPICA_RX_DSP_HIST_TH_SLICES; idx++)
+    // {
+    //     INPHI_NOTE("histo[%d]=%d\n", idx, histo[idx]);
+    // }
+    SPICA_UNLOCK(die);
+    
+    return status;
+}
+
+//! Enter a state of the estimation semaphore acquire
+//! @private
+static void spica_rx_dsp_hist_sem_enter(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t sem_state)
+{
+    ctx->sem_state = sem_state;
+    ctx->polls     = 0;
+#if defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+    ctx->sem_stamp = spica_timestamp_ms(ctx->die);
+#endif // defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+}
+
+//! Milli-seconds spent in the current state of the semaphore acquire
+//! @private
+static uint32_t spica_rx_dsp_hist_sem_elapsed(
+    spica_rx_dsp_hist_ctx_t* ctx)
+{
+#if defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+    return spica_timestamp_ms(ctx->die) - ctx->sem_stamp;
+#else
+    // No clock, a poll stands for the longest wait between two polls
+    return ctx->polls * SPICA_RX_DSP_FW_POLL_MS;
+#endif // defined(INPHI_HAS_TIMESTAMP) && (INPHI_HAS_TIMESTAMP==1)
+}
+
+//! Take the acquire of the estimation semaphore one poll further. Same
+//! sequence as spica_rx_dsp_acquire_estimation_semaphore() but every wait
+//! for the FW returns to the caller and is polled again by the next call.
+//! @private
+static inphi_status_t spica_rx_dsp_hist_sem_poll(
+    spica_rx_dsp_hist_ctx_t* ctx)
+{
+    uint32_t die          = ctx->die;
+    uint32_t channel      = ctx->channel;
+    e_spica_intf intf     = (e_spica_intf)ctx->intf;
+    uint16_t rsp;
+    uint16_t ctrl;
+    uint16_t sts;
+    uint16_t data;
+
+    ctx->polls++;
+
+    switch (ctx->sem_state)
     {
-        INPHI_CRIT("ERROR: Cannot write Tx LUT to broadcast channel\n");
-        return INPHI_ERROR;
-    }
+        case SPICA_RX_DSP_SEM_WAIT_IDLE:
+            // Wait until rsp and ctrl are 0, then stop the algorithms
+#if !defined(INPHI_REMOVE_PMR)
+            if (SPICA_INTF_MRX == intf)
+            {
+                rsp  = SPICA_MRX_ALG_STATUS__RSP__READ(die, channel);
+                ctrl = SPICA_MRX_ALG_CTRL__CTRL__READ(die, channel);
+                if ((rsp != 0) || (ctrl != 0))
+                {
+                    break;
+                }
+                en1 = SPICA_MRX_ALG_CTRL__ALG1_EN__READ(die, channel);
+                en2 = SPICA_MRX_ALG_CTRL__ALG2_EN__READ(die, channel);
+                en3 = SPICA_MRX_ALG_CTRL__ALG3_EN__READ(die, channel);
+                en4 = SPICA_MRX_ALG_CTRL__ALG4_EN__READ(die, channel);
+                SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
+                SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
+                SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
+                SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
+            }
+            else
+#endif // defined(INPHI_REMOVE_PMR)
+            {
+                rsp  = SPICA_ORX_ALG_STATUS__RSP__READ(die, channel);
+                ctrl = SPICA_ORX_ALG_CTRL__CTRL__READ(die, channel);
+                if ((rsp != 0) || (ctrl != 0))
+                {
+                    break;
+                }
+                en1 = SPICA_ORX_ALG_CTRL__ALG1_EN__READ(die, channel);
+                en2 = SPICA_ORX_ALG_CTRL__ALG2_EN__READ(die, channel);
+                en3 = SPICA_ORX_ALG_CTRL__ALG3_EN__READ(die, channel);
+                en4 = SPICA_ORX_ALG_CTRL__ALG4_EN__READ(die, channel);
+                SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
+                SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
+                SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
+                SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
+            }
+            spica_rx_dsp_hist_sem_enter(ctx, SPICA_RX_DSP_SEM_SETTLE);
+            return INPHI_OK;
+
+        case SPICA_RX_DSP_SEM_SETTLE:
+            if (spica_rx_dsp_hist_sem_elapsed(ctx) >= SPICA_RX_DSP_SEM_SETTLE_MS)
+            {
+                spica_rx_dsp_hist_sem_enter(ctx, SPICA_RX_DSP_SEM_WAIT_ALGS);
+            }
+            return INPHI_OK;
+
+        case SPICA_RX_DSP_SEM_WAIT_ALGS:
+            // Wait until all algs in f/w have finished, then set ctrl = 1
+            // and ddsl = 1 at the same time (otherwise f/w won't disable the dsl)
+#if !defined(INPHI_REMOVE_PMR)
+            if (SPICA_INTF_MRX == intf)
+            {
+                sts = SPICA_MRX_ALG_STATUS__ALG1_STATUS__READ(die, channel) |
+                      SPICA_MRX_ALG_STATUS__ALG2_STATUS__READ(die, channel) |
+                      SPICA_MRX_ALG_STATUS__ALG3_STATUS__READ(die, channel) |
+                      SPICA_MRX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
+                if (sts != 0)
+                {
+                    break;
+                }
+                data = SPICA_MRX_ALG_CTRL__READ(die, channel);
+                data = SPICA_MRX_ALG_CTRL__CTRL__SET(data, 1);
+                data = SPICA_MRX_ALG_CTRL__DDSL__SET(data, 1);
+                SPICA_MRX_ALG_CTRL__WRITE(die, channel, data);
+            }
+            else
+#endif // defined(INPHI_REMOVE_PMR)
+            {
+                sts = SPICA_ORX_ALG_STATUS__ALG1_STATUS__READ(die, channel) |
+                      SPICA_ORX_ALG_STATUS__ALG2_STATUS__READ(die, channel) |
+                      SPICA_ORX_ALG_STATUS__ALG3_STATUS__READ(die, channel) |
+                      SPICA_ORX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
+                if (sts != 0)
+                {
+                    break;
+                }
+                data = SPICA_ORX_ALG_CTRL__READ(die, channel);
+                data = SPICA_ORX_ALG_CTRL__CTRL__SET(data, 1);
+                data = SPICA_ORX_ALG_CTRL__DDSL__SET(data, 1);
+                SPICA_ORX_ALG_CTRL__WRITE(die, channel, data);
+            }
+            spica_rx_dsp_hist_sem_enter(ctx, SPICA_RX_DSP_SEM_WAIT_RSP);
+            return INPHI_OK;
 
-    //squelch if we need to
-    if(toggle_squelch)
-    {
-        if(intf == SPICA_INTF_OTX) 
-        {
-            squelched = SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
-            SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
-        }  
+        case SPICA_RX_DSP_SEM_WAIT_RSP:
+            // Wait until rsp is set to 1 by f/w
 #if !defined(INPHI_REMOVE_PMR)
-        else if (intf == SPICA_INTF_MTX)
-        {
-            squelched = SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
-            SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
-        }    
+            if (SPICA_INTF_MRX == intf)
+            {
+                rsp = SPICA_MRX_ALG_STATUS__RSP__READ(die, channel);
+            }
+            else
 #endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-        else if (intf == SPICA_INTF_STX)
-        {
-            squelched = SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__READ(die, channel);
-            SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 1);
-        }    
-#endif // defined(INPHI_REMOVE_PSR)
-        else
-        {
-            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
-        } 
+            {
+                rsp = SPICA_ORX_ALG_STATUS__RSP__READ(die, channel);
+            }
+            if (rsp != 1)
+            {
+                break;
+            }
+            spica_rx_dsp_hist_sem_enter(ctx, SPICA_RX_DSP_SEM_HELD);
+            return INPHI_OK;
+
+        default:
+            return INPHI_OK;
     }
 
-    //make sure the FW is past the Power-on state
-    int timeout = 1000;
-    if(intf == SPICA_INTF_OTX)
+    if (spica_rx_dsp_hist_sem_elapsed(ctx) > SPICA_RX_DSP_FW_TIME_OUT*SPICA_RX_DSP_FW_POLL_MS)
     {
-        data = SPICA_OTX_FW_STATUS__READ(die, channel);
-        while((SPICA_OTX_FW_STATUS__STATE__GET(data) < 7) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(1000);
-            data = SPICA_OTX_FW_STATUS__READ(die, channel);
-        }
+        INPHI_NOTE("f/w failed to acquire semaphore, step %lu\n", ctx->sem_state);
+        return INPHI_ERROR;
     }
+    return INPHI_OK;
+}
+
+//! Give the algorithms stopped by a semaphore acquire that did not
+//! complete their enables back
+//! @private
+static void spica_rx_dsp_hist_sem_restore(
+    spica_rx_dsp_hist_ctx_t* ctx)
+{
+    uint32_t die          = ctx->die;
+    uint32_t channel      = ctx->channel;
+
 #if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MTX)
-    {
-        data = SPICA_MTX_FW_STATUS__READ(die, channel);
-        while((SPICA_MTX_FW_STATUS__STATE__GET(data) < 7) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(1000);
-            data = SPICA_MTX_FW_STATUS__READ(die, channel);
-        }
-    }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_STX)
+    if (SPICA_INTF_MRX == (e_spica_intf)ctx->intf)
     {
-        data = SPICA_STX_FW_STATUS__READ(die, channel);
-        while((SPICA_STX_FW_STATUS__STATE__GET(data) < 8) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(1000);
-            data = SPICA_STX_FW_STATUS__READ(die, channel);
-        }
+        SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
+        SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
+        SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
+        SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
     }
-#endif // defined(INPHI_REMOVE_PSR)
     else
+#endif // defined(INPHI_REMOVE_PMR)
     {
-        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+        SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
+        SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
+        SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
+        SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
     }
- 
-    if(timeout <= 0)
+}
+
+//! Start a capture of the num_slices slices from first_slice on
+//! @private
+static inphi_status_t spica_rx_dsp_hist_start_slices(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t     first_slice,
+    uint32_t     num_slices,
+    uint32_t*    histo)
+{
+    inphi_status_t status = INPHI_OK;
+    bool fw_lock;
+
+    INPHI_MEMSET(ctx, 0, sizeof(*ctx));
+
+    if (SPICA_INTF_SRX == intf)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("Timed out waiting for FW to power-up %s ch %lu\n", spica_dbg_translate_intf(intf), channel);
-#else
-        INPHI_CRIT("Timed out waiting for FW to power-up intf %d ch %d\n", intf, channel);
-#endif
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
         return INPHI_ERROR;
     }
 
-    //make sure the FW isn't currently accessing the LUT
-    timeout = 100;
-    if(intf == SPICA_INTF_OTX) 
-    {
-        while(SPICA_OTX_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(10);
-        }
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MTX) 
+    SPICA_LOCK(die);
+
+    if (SPICA_INTF_ORX == intf)
     {
-        while(SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(10);
-        }
+        fw_lock     = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
+        ctx->is_nrz = SPICA_ORX_RULES_0__SIGNALLING__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_STX) 
+    else 
     {
-        while(SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__RBW__READ(die, channel) && (timeout > 0))
-        {
-            timeout -= 1;
-            INPHI_UDELAY(10);
-        }
+        // must be MRX
+        fw_lock     = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
+        ctx->is_nrz = SPICA_MRX_RULES_0__SIGNALLING__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PSR)
-    else
+    if (!fw_lock)
     {
-        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_WARN("%s[Channel %lu]: NOT FW LOCKED!\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        SPICA_UNLOCK(die);
+        return INPHI_ERROR;
     }
 
-    if(timeout <= 0)
+    ctx->die     = die;
+    ctx->channel = channel;
+    ctx->intf    = intf;
+    ctx->active  = true;
+    ctx->first_slice = first_slice;
+    ctx->num_slices  = num_slices;
+    ctx->num_steps = (SPICA_RX_DSP_MAX_STEP + SPICA_RX_DSP_STEP_SIZE - 1) / SPICA_RX_DSP_STEP_SIZE;
+
+    INPHI_MEMSET(histo, 0, SPICA_RX_DSP_HIST_BINS*4*num_slices*sizeof(uint32_t));
+
+    // The estimation semaphore is acquired by spica_rx_dsp_hist_resume()
+    spica_rx_dsp_hist_sem_enter(ctx, SPICA_RX_DSP_SEM_WAIT_IDLE);
+
+    SPICA_UNLOCK(die);
+
+    return status;
+}
+
+inphi_status_t spica_rx_dsp_hist_start(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t*    histo)
+{
+    return spica_rx_dsp_hist_start_slices(ctx, die, channel, intf,
+                                          0, SPICA_RX_DSP_HIST_TH_SLICES, histo);
+}
+
+inphi_status_t spica_rx_dsp_hist_start_slice(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t     die,
+    uint32_t     channel,
+    e_spica_intf intf,
+    uint32_t     slice,
+    uint32_t*    histo)
+{
+    if (slice >= SPICA_RX_DSP_HIST_TH_SLICES)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("ERROR: Timed out waiting for FW to stop writing to %s ch %lu LUT\n", spica_dbg_translate_intf(intf), channel);
-#else
-        INPHI_CRIT("ERROR: Timed out waiting for FW to stop writing to intf %d ch %d LUT\n", intf, channel);
-#endif
+        INPHI_MEMSET(ctx, 0, sizeof(*ctx));
         return INPHI_ERROR;
     }
+    return spica_rx_dsp_hist_start_slices(ctx, die, channel, intf, slice, 1, histo);
+}
 
-    //ok, we need to quickly write the LUT now since the FW isn't accessing it
+inphi_status_t spica_rx_dsp_hist_resume(
+    spica_rx_dsp_hist_ctx_t* ctx,
+    uint32_t*    histo,
+    bool*        done)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t die          = ctx->die;
+    uint32_t channel      = ctx->channel;
+    e_spica_intf intf     = (e_spica_intf)ctx->intf;
+    uint32_t step_val     = ctx->step * SPICA_RX_DSP_STEP_SIZE;
+    uint32_t snr_results[128];
+    bool     snr_done;
 
-    if(lut_mode != SPICA_LUT_7TAP_LIN)
+    *done = false;
+
+    if (!ctx->active)
     {
-        if(intf == SPICA_INTF_OTX) 
-        {
-            //write the big LUT
-            SPICA_OTX_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
-            data = SPICA_OTX_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
-            for(int i=0; i<256; i++)
-            {
-                SPICA_OTX_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
-                data = SPICA_OTX_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
-                SPICA_OTX_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
-            }
-            //set the RBW back to 0
-            SPICA_OTX_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
-        }
-#if !defined(INPHI_REMOVE_PMR)
-        else if (intf == SPICA_INTF_MTX)
-        {
-            //write the big LUT
-            SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
-            data = SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
-            for(int i=0; i<256; i++)
-            {
-                SPICA_SMTX_PMR_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
-                data = SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
-                SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
-            }
-            //set the RBW back to 0
-            SPICA_SMTX_PMR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
-        }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-        else if (intf == SPICA_INTF_STX)
-        {
-            //write the big LUT
-            SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__ADDR__RMW(die, channel, 0);
-            data = SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__RBW__SET(0, 1);
-            for(int i=0; i<256; i++)
-            {
-                SPICA_SMTX_PSR_TXD_DSP_LUT_WRITE__DATA__WRITE(die, channel, lut[i]);
-                data = SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__ADDR__SET(data, i);
-                SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, data);
-            }
-            //set the RBW back to 0
-            SPICA_SMTX_PSR_TXD_DSP_LUT_ACCESS__WRITE(die, channel, 0);
-        }
-#endif // defined(INPHI_REMOVE_PSR)
-        else 
-        {
-            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
-        }
-        //leave the RBW set while we do the COEFFs, this will prevent the FW from overwriting stuff
+        return INPHI_ERROR;
     }
 
-    //write the small LUT if needed
-    if(((intf == SPICA_INTF_OTX) || (intf == SPICA_INTF_MTX)) && (coef) &&
-            ((lut_mode == SPICA_LUT_7TAP_LIN) || (lut_mode == SPICA_LUT_7TAP_LUT)) )
-    {
-        if(intf == SPICA_INTF_OTX) 
-        {
-            data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__RBW__SET(0, 1);
-            for(int i=0; i<28; i++)
-            {
-                data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__ADDR__SET(data, i);
-                data = SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE_DATA__SET(data, coef[i]);
-                SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, data);
-            }
-            //set the RBW back to 0
-            SPICA_OTX_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, 0);
-        }
-#if !defined(INPHI_REMOVE_PMR)
-        else if (intf == SPICA_INTF_MTX)
+    SPICA_LOCK(die);
+
+    if (ctx->sem_state != SPICA_RX_DSP_SEM_HELD)
+    {
+        status |= spica_rx_dsp_hist_sem_poll(ctx);
+        if ((status == INPHI_OK) && (ctx->sem_state == SPICA_RX_DSP_SEM_HELD))
         {
-            data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__RBW__SET(0, 1);
-            for(int i=0; i<28; i++)
+            // Fetch the amp locations for all humps/interleaves, see spica_rx_dsp_hist_dsl
+            status |= spica_rx_dsp_get_amp_all(die, channel, intf, ctx->amp_locs);
+            for (uint16_t level = 0; level < 4; level++)
             {
-                data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__ADDR__SET(data, i);
-                data = SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE_DATA__SET(data, coef[i]);
-                SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, data);
+                for (uint16_t slice = 0; slice < 16; slice++)
+                {
+                    ctx->amp_locs[level*16 + slice] >>= 1;
+                }
             }
-            //set the RBW back to 0
-            SPICA_SMTX_PMR_TXD_DSP_COEFF_ACCESS__WRITE(die, channel, 0);
         }
-#endif // defined(INPHI_REMOVE_PMR)
-        else 
+        SPICA_UNLOCK(die);
+        if (status != INPHI_OK)
         {
-            INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+            spica_rx_dsp_hist_abort(ctx);
         }
+        return status;
     }
 
-    if(intf == SPICA_INTF_OTX) 
+    if (!ctx->step_running)
     {
-        //set the DSP mode in HW directly
-        data = SPICA_OTX_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
-        data = SPICA_OTX_TXD_DSP_CFG__MODE__SET(data, lut_mode);
-        SPICA_OTX_TXD_DSP_CFG__WRITE(die, channel, data);
-
-        //if the Tx was already unsquelched
-        if(toggle_squelch && !squelched)
-        {
-            SPICA_OTX_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
-        }
+        spica_rx_dsp_snr_init_and_start(die, channel, intf, step_val,
+                                             SPICA_RX_DSP_DURATION_16,
+                                             SPICA_RX_DSP_SETTLE_11);
+        ctx->step_running = true;
+        ctx->polls        = 0;
+        SPICA_UNLOCK(die);
+        return INPHI_OK;
     }
+
 #if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MTX)
+    if (SPICA_INTF_MRX == intf)
     {
-        //set the DSP mode in HW directly
-        data = SPICA_SMTX_PMR_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
-        data = SPICA_SMTX_PMR_TXD_DSP_CFG__MODE__SET(data, lut_mode);
-        SPICA_SMTX_PMR_TXD_DSP_CFG__WRITE(die, channel, data);
-
-        //if the Tx was already unsquelched
-        if(toggle_squelch && !squelched)
-        {
-            SPICA_SMTX_PMR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
-        }
+        snr_done = SPICA_MRX_CP_ALG_DONE_INT__SNR__READ(die, channel);
     }
+    else
 #endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_STX)
     {
-        //set the DSP mode in HW directly
-        data = SPICA_SMTX_PSR_TXD_DSP_CFG__IS_LUT_UNSIGNED__SET(0, is_lut_unsigned);
-        data = SPICA_SMTX_PSR_TXD_DSP_CFG__MODE__SET(data, lut_mode);
-        SPICA_SMTX_PSR_TXD_DSP_CFG__WRITE(die, channel, data);
+        snr_done = SPICA_ORX_CP_ALG_DONE_INT__SNR__READ(die, channel);
+    }
 
-        //if the Tx was already unsquelched
-        if(toggle_squelch && !squelched)
+    if (!snr_done)
+    {
+        ctx->polls++;
+        if (ctx->polls > SPICA_RX_DSP_FW_TIME_OUT)
         {
-            SPICA_SMTX_PSR_TXD_SQUELCH_EN_CFG__SQUELCH_EN__RMW(die, channel, 0);
+            INPHI_NOTE(" SNR estimation algorithm has not completed\n");
+            SPICA_UNLOCK(die);
+            spica_rx_dsp_hist_abort(ctx);
+            return INPHI_ERROR;
         }
+        SPICA_UNLOCK(die);
+        return INPHI_OK;
     }
-#endif // defined(INPHI_REMOVE_PSR)
-    else 
+
+    // Already done so this does not wait, it just reads the results back
+    status |= spica_rx_dsp_snr_wait_for_done(die, channel, intf, snr_results);
+    SPICA_UNLOCK(die);
+    if (status != INPHI_OK)
     {
-        INPHI_CRIT("ERROR: INTF %d not supported\n", intf);
+        spica_rx_dsp_hist_abort(ctx);
+        return status;
+    }
+
+    spica_rx_dsp_hist_fill_step(ctx->step, step_val, snr_results, ctx->amp_locs,
+                                ctx->first_slice, ctx->num_slices, histo);
+    ctx->step_running = false;
+    ctx->step++;
+
+    if (ctx->step == ctx->num_steps)
+    {
+        status |= spica_rx_dsp_hist_abort(ctx);
+        if (ctx->is_nrz)
+        {
+            spica_rx_dsp_hist_clear_nrz(ctx->num_slices, histo);
+        }
+        *done = (status == INPHI_OK);
     }
 
     return status;
 }
 
-inphi_status_t spica_clock_group_enable(uint32_t die, uint32_t channel, e_spica_intf intf, bool enable)
+inphi_status_t spica_rx_dsp_hist_abort(
+    spica_rx_dsp_hist_ctx_t* ctx)
 {
     inphi_status_t status = INPHI_OK;
-    bool update_done = false;
-    uint32_t base_die = spica_package_get_base_die(die);
-
-    // Communicate to FW to notify of desired clock group enable/disable
-    // Use overlays
-
-    uint32_t die_inst = spica_get_die_inst_from_pkg_ch(die, channel, intf);
-    die = base_die | ((die_inst >> 16) & 0xFF);// Must redefined die since we are writing to MCU reg
-    uint16_t inst = die_inst & 0xFF;
-
-    uint16_t data;
-    data = SPICA_CLOCK_GROUP_ENABLE_CFG__INTF__SET(0, intf);
-    data = SPICA_CLOCK_GROUP_ENABLE_CFG__CHANNEL__SET(data, inst);
-    data = SPICA_CLOCK_GROUP_ENABLE_CFG__ENABLE__SET(data, enable);
-    SPICA_CLOCK_GROUP_ENABLE_CFG__WRITE(die, data);
-
-    SPICA_GENERIC_ACK__CLK_GRP_EN_ACK__RMW(die, 0); // Clear the ACK
-    SPICA_GENERIC_REQ__CLK_GRP_EN_REQ__RMW(die, 1); // Set the REQ
 
-    int32_t attempts=30000; // 3 seconds
-    // Wait for FW to update rules
-    while(attempts > 0)
+    if (!ctx->active)
     {
-        update_done = SPICA_GENERIC_ACK__CLK_GRP_EN_ACK__READ(die); // Wait for ACK
-        if(update_done) 
-        {
-            break;
-        }
-        INPHI_UDELAY(100);
-        attempts -= 1;
+        return INPHI_OK;
     }
-    
 
-    if((status) || (attempts <= 0))
+    SPICA_LOCK(ctx->die);
+    if (ctx->sem_state >= SPICA_RX_DSP_SEM_WAIT_RSP)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to dis/en clock group...\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        status |= INPHI_ERROR;
+        // ctrl is set, the f/w grants the semaphore before it is released
+        status |= spica_rx_dsp_release_estimation_semaphore(ctx->die, ctx->channel, (e_spica_intf)ctx->intf);
     }
-    
+    else if (ctx->sem_state != SPICA_RX_DSP_SEM_WAIT_IDLE)
+    {
+        spica_rx_dsp_hist_sem_restore(ctx);
+    }
+    SPICA_UNLOCK(ctx->die);
+
+    ctx->active       = false;
+    ctx->step_running = false;
 
     return status;
 }
 
-// Enables or disables the squelch lock for the specified channel
-inphi_status_t spica_tx_squelch_lock(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    bool         squelch_lock)
+#if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
+double spica_rx_dsp_snr_read_db(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf)
 {
-    inphi_status_t status = INPHI_OK;
+    double snr_db = 0.0;
+    uint16_t snr_val;
 
-    if(intf == SPICA_INTF_OTX)
-    {
-        // Update the overlay rule
-        SPICA_OTX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
+    snr_val = spica_rx_dsp_snr_read_db_fixp(die, channel, intf); 
 
-        // Now notify FW that squelch_lock rule ready for update
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MTX)
+    snr_db = (double)snr_val / 1600.0;
+
+    return snr_db;
+}
+#endif // defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
+
+uint16_t spica_rx_dsp_snr_read_db_fixp(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf)
+{
+    uint16_t snr_val = 0;
+    bool fw_lock = false;
+
+    if (SPICA_INTF_SRX == intf)
     {
-        // Update the overlay rule
-        SPICA_MTX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return snr_val;
+    }
 
-        // Now notify FW that squelch_lock rule ready for update
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
+    if (intf == SPICA_INTF_ORX)
+    {
+         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_STX) 
+    else
     {
-        // Update the overlay rule
-        SPICA_STX_RULES_0__SQUELCH_LOCK__RMW(die, channel, squelch_lock);
-
-        // Now notify FW that squelch_lock rule ready for update
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_REQ__RMW(die, channel, 1); // Set the REQ
+         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PSR)
-    else 
+    if(!fw_lock)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
-        status |= INPHI_ERROR;
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA1\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return snr_val;
     }
 
-    bool update_done = false;
-    int32_t attempts=30000; // 3 seconds
-    // Wait for FW to update rules
-    while(attempts > 0)
+    if (intf == SPICA_INTF_ORX)
     {
-        
-        if(intf == SPICA_INTF_OTX)      update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_MTX) update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_STX) update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_SQUELCH_LOCK_ACK__READ(die, channel); // Wait for ACK
-
-        if(update_done) 
-        {
-            break;
-        }
-        INPHI_UDELAY(100);
-        attempts -= 1;
+        snr_val = SPICA_ORX_SNR_METRIC__VALUE__READ(die, channel);
     }
-    
-    if((status) || (attempts <= 0))
+    else if (intf == SPICA_INTF_MRX)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update squelch_lock...\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        status |= INPHI_ERROR;
+        snr_val = SPICA_MRX_SNR_METRIC__VALUE__READ(die, channel);
     }
-    return status;
+    else
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return snr_val; 
+    }
+
+    return snr_val;
 }
 
-// Toggle the invert status of a TX channel
-inphi_status_t spica_tx_invert_toggle(
-    uint32_t          die,
-    uint32_t          channel,
-    e_spica_intf      intf)
+inphi_status_t spica_rx_dsp_ltp_read_fixp(uint32_t die, uint32_t channel, e_spica_intf intf, uint16_t *ltp)
 {
-    inphi_status_t status = INPHI_OK;
-
-    if(intf == SPICA_INTF_OTX)
-    {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MTX)
+    if(!((intf == SPICA_INTF_ORX) || (intf == SPICA_INTF_MRX)))
     {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
+        INPHI_CRIT("only supported on ORX and MRX interfaces\n");
+        return INPHI_ERROR;
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_STX) 
+
+    *ltp = 0;
+
+    uint16_t data = 0;
+
+    if (intf == SPICA_INTF_ORX)
     {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
+        data = SPICA_ORX_LTP__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PSR)
     else 
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
-        status |= INPHI_ERROR;
+        data = SPICA_MRX_LTP__READ(die, channel);
     }
 
-    bool update_done = false;
-    int32_t attempts=30000; // 3 seconds
-    // Wait for FW to update rules
-    while(attempts > 0)
-    {
-        
-        if(intf == SPICA_INTF_OTX)      update_done = SPICA_OTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_MTX) update_done = SPICA_MTX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_STX) update_done = SPICA_STX_RULES_UPDATE__UPDATE_TX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-
-        if(update_done) 
-        {
-            break;
-        }
-        INPHI_UDELAY(100);
-        attempts -= 1;
-    }
-    
-    if((status) || (attempts <= 0))
+    if(0 == data)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update invert_chan...\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        status |= INPHI_ERROR;
+        //not available yet
+        return INPHI_ERROR;
     }
-    return status;
 
+    *ltp = data;
+    return INPHI_OK;
 }
 
-// Toggle the invert status of an RX channel
-inphi_status_t spica_rx_invert_toggle(
-    uint32_t          die,
-    uint32_t          channel,
-    e_spica_intf      intf)
+#if defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
+#if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT == 1)
+double spica_rx_dsp_ltp_format(uint16_t ltp)
+{
+    //handle special case
+    if(0xffff == ltp) {
+        return INFINITY; //defined in math.h as part of C99
+    }
+    return ltp/256.0;
+}
+#endif // defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
+#endif // defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT == 1)
+
+inphi_status_t spica_rx_dsp_vga1_query(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    uint16_t* vga1_gain)
 {
     inphi_status_t status = INPHI_OK;
+    uint16_t sto_acc;
+    bool fw_lock = false;
 
-    if(intf == SPICA_INTF_ORX)
+    if (SPICA_INTF_SRX == intf)
     {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return INPHI_ERROR;
     }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MRX)
+
+    if (intf == SPICA_INTF_ORX)
     {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
+         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PMR)
-#if !defined(INPHI_REMOVE_PSR)
-    else if (intf == SPICA_INTF_SRX) 
+    else
     {
-        // notify FW to toggle the invert_chan rule 
-        SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__RMW(die, channel, 0); // Clear the ACK
-        SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_REQ__RMW(die, channel, 1); // Set the REQ
+         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
     }
-#endif // defined(INPHI_REMOVE_PSR)
-    else 
+    if(!fw_lock)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Invalid intf\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)     
-        status |= INPHI_ERROR;
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA1\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        *vga1_gain = 0xffff;
+        return INPHI_ERROR;
     }
 
-    bool update_done = false;
-    int32_t attempts=30000; // 3 seconds
-    // Wait for FW to update rules
-    while(attempts > 0)
-    {
-        
-        if(intf == SPICA_INTF_ORX)      update_done = SPICA_ORX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_MRX) update_done = SPICA_MRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-        else if(intf == SPICA_INTF_SRX) update_done = SPICA_SRX_FW_CONTROL__UPDATE_RX_INVERT_CHAN_ACK__READ(die, channel); // Wait for ACK
-
-        if(update_done) 
-        {
-            break;
-        }
-        INPHI_UDELAY(100);
-        attempts -= 1;
-    }
-    
-    if((status) || (attempts <= 0))
+    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        INPHI_CRIT("%s ch%lu: Timed out waiting for FW to update invert_chan...\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-        status |= INPHI_ERROR;
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("%s Channel %lu failed acquiring semaphore.\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return status;
     }
-    return status;
-
-}
-
-// Query the temperature
-inphi_status_t spica_temperature_query(uint32_t die, int16_t* temperature)
-{
-    inphi_status_t status = INPHI_OK;
-	int16_t temp=-273;
 
-    if(SPICA_TMON_STATUS_1__IS_VALID__READ(die))
+    if (intf == SPICA_INTF_ORX)
     {
-        temp = SPICA_TMON_STATUS__READ(die);
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+
+        // VGA1 Gain
+        //"VGA1 Gain (V1G), 8b binary offset (i.e. 128 center):"
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0x131);
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc,     0); // ignored by H/W
+        SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+        *vga1_gain = (SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel) >> 8);
     }
-    else
+#if !defined(INPHI_REMOVE_PMR)
+    else if (intf == SPICA_INTF_MRX)
     {
-        INPHI_CRIT("Temperature not ready to read.\n");
-        status |= INPHI_ERROR;
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+
+        // VGA1 Gain
+        //"VGA1 Gain (V1G), 8b binary offset (i.e. 128 center):"
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0x131);
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc,     0); // ignored by H/W
+        SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+        *vga1_gain = (SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel) >> 8);
     }
+#endif // defined(INPHI_REMOVE_PMR)
 
-    *temperature = temp;
+    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
+    {
+        return status;
+    }
 
     return status;
 }
 
-/** @file spica_dsp.c
- ****************************************************************************
- *
- * @brief
- *     This module contains the high level DSP diagnostic methods
- *     implemented by the API.
- *
- ****************************************************************************
- * @author
- *    This file contains information that is proprietary and confidential to
- *    Inphi Corporation.
- *
- *    This file can be used under the terms of the Inphi Software License
- *    Agreement. You should have received a copy of the license with this file,
- *    if not please contact your Inphi support staff.
- *
- *    Copyright (C) 2006-2021 Inphi Corporation, Inc. All rights reserved.
- *
- *    API Version Number: 1.2.0.929
- ***************************************************************************/
-
-// needed to save the alg values in order to restore them
-static uint16_t en1;
-static uint16_t en2;
-static uint16_t en3;
-static uint16_t en4;
- 
-inphi_status_t spica_rx_dsp_acquire_estimation_semaphore(
+inphi_status_t spica_rx_dsp_vga2_query(
     uint32_t die,
     uint32_t channel,
-    e_spica_intf intf)
+    e_spica_intf intf,
+    int16_t vga2_gain[SPICA_RX_DSP_SLICES])
 {
     inphi_status_t status = INPHI_OK;
-    uint16_t data;
-    uint16_t counter;
+    uint16_t sto_acc;
+    bool fw_lock = false;
+    int16_t rdata = 0;
+    int i = 0;
 
     if (SPICA_INTF_SRX == intf)
     {
@@ -15224,203 +18393,109 @@ inphi_status_t spica_rx_dsp_acquire_estimation_semaphore(
         return INPHI_ERROR;
     }
 
-    if (SPICA_INTF_ORX == intf)
+    if (intf == SPICA_INTF_ORX)
+    {
+         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
+    }
+    else
+    {
+         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
+    }
+    if(!fw_lock)
     {
-        // Wait until rsp is 0
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 0)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 0.\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
-        
-        // Wait until ctrl is 0
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_ORX_ALG_CTRL__CTRL__READ(die, channel) != 0)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 0.\n", spica_dbg_translate_intf(intf), channel);
+        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA2\n", spica_dbg_translate_intf(intf), channel);
 #endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
+        *vga2_gain = 0xffff;
+        return INPHI_ERROR;
+    }
 
-        // save the current en1...en4
-        en1 = SPICA_ORX_ALG_CTRL__ALG1_EN__READ(die, channel);
-        en2 = SPICA_ORX_ALG_CTRL__ALG2_EN__READ(die, channel);
-        en3 = SPICA_ORX_ALG_CTRL__ALG3_EN__READ(die, channel);
-        en4 = SPICA_ORX_ALG_CTRL__ALG4_EN__READ(die, channel);
+    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
+    {
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        INPHI_CRIT("%s Channel %lu failed acquiring semaphore.\n", spica_dbg_translate_intf(intf), channel);
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
+        return status;
+    }
 
-        // set all en0...en3 to 0
-        SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
-        SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
-        SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
-        SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
-        INPHI_MDELAY(1000);
+    if (intf == SPICA_INTF_ORX)
+    {
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
 
-        // wait until all algs in f/w have finished
-        bool algs_running = true;
-        counter = 0;
-        while (algs_running)
+        // VGA2 Gain
+        //"VGA2 Gain (V2G), 8b binary offset (i.e. 128 center):"
+        for (i=0; i<SPICA_RX_DSP_SLICES; i++)
         {
-            uint16_t sts1 = SPICA_ORX_ALG_STATUS__ALG1_STATUS__READ(die, channel);
-            uint16_t sts2 = SPICA_ORX_ALG_STATUS__ALG2_STATUS__READ(die, channel);
-            uint16_t sts3 = SPICA_ORX_ALG_STATUS__ALG3_STATUS__READ(die, channel);
-            uint16_t sts4 = SPICA_ORX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
+            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0xbe + i/4);
+            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, i%4);
+            SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+            rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
 
-            if ((sts1 == 0) && (sts2 == 0) && (sts3 == 0) && (sts4 == 0)) 
-            {
-                algs_running = false;
-            }
+            rdata = rdata >> 8;            
 
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            if (rdata >= (1 << 7)) 
             {
-                INPHI_NOTE("f/w failed waiting for DSP alg to stop running\n");
-                INPHI_NOTE("ALGn=%d,%d,%d,%d\n", sts1,sts2,sts3,sts4);
-                return INPHI_ERROR;
+                rdata -= (1 << 8);
             }
-        }
-        // if we use search engine set the ddsl bit to 1, lets set it to 1 to be safe
-        // set the ctrl = 1 and ddsl = 1 at the same time (it is important these to be 
-        // set at the same time otherwise f/w won't disable the dsl)
-        data = SPICA_ORX_ALG_CTRL__READ(die, channel);
-        data = SPICA_ORX_ALG_CTRL__CTRL__SET(data, 1);
-        data = SPICA_ORX_ALG_CTRL__DDSL__SET(data, 1);
-        SPICA_ORX_ALG_CTRL__WRITE(die, channel, data);
 
-        // wait until rsp is set to 1 by f/w
-        counter = 0;
-        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 1)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-                INPHI_NOTE("f/w failed to acquire semaphore\n");
-                return INPHI_ERROR;
-            }
+            vga2_gain[i] = rdata + 128;
         }
     }
 #if !defined(INPHI_REMOVE_PMR)
-    else if (SPICA_INTF_MRX == intf)
+    else if (intf == SPICA_INTF_MRX)
     {
-        // Wait until rsp is 0
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 0)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 0.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
-        
-        // Wait until ctrl is 0
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_MRX_ALG_CTRL__CTRL__READ(die, channel) != 0)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 0.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
-
-        // save the current en1...en4
-        en1 = SPICA_MRX_ALG_CTRL__ALG1_EN__READ(die, channel);
-        en2 = SPICA_MRX_ALG_CTRL__ALG2_EN__READ(die, channel);
-        en3 = SPICA_MRX_ALG_CTRL__ALG3_EN__READ(die, channel);
-        en4 = SPICA_MRX_ALG_CTRL__ALG4_EN__READ(die, channel);
-
-        // set all en0...en3 to 0
-        SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, 0);
-        SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, 0);
-        SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, 0);
-        SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, 0);
-        INPHI_MDELAY(1000);
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
 
-        // wait until all algs in f/w have finished
-        bool algs_running = true;
-        counter = 0;
-        while (algs_running)
+        // VGA2 Gain
+        //"VGA2 Gain (V2G), 8b binary offset (i.e. 128 center):"
+        for (i=0; i<SPICA_RX_DSP_SLICES; i++)
         {
-            uint16_t sts1 = SPICA_MRX_ALG_STATUS__ALG1_STATUS__READ(die, channel);
-            uint16_t sts2 = SPICA_MRX_ALG_STATUS__ALG2_STATUS__READ(die, channel);
-            uint16_t sts3 = SPICA_MRX_ALG_STATUS__ALG3_STATUS__READ(die, channel);
-            uint16_t sts4 = SPICA_MRX_ALG_STATUS__ALG4_STATUS__READ(die, channel);
+            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0xbe + i/4);
+            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, i%4);
+            SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+            rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
 
-            if ((sts1 == 0) && (sts2 == 0) && (sts3 == 0) && (sts4 == 0)) 
-            {
-                algs_running = false;
-            }
+            rdata = rdata >> 8;            
 
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            if (rdata >= (1 << 7)) 
             {
-                INPHI_NOTE("f/w failed waiting for DSP alg to stop running\n");
-                INPHI_NOTE("ALGn=%d,%d,%d,%d\n", sts1,sts2,sts3,sts4);
-                return INPHI_ERROR;
+                rdata -= (1 << 8);
             }
-        }
-        // if we use search engine set the ddsl bit to 1, lets set it to 1 to be safe
-        // set the ctrl = 1 and ddsl = 1 at the same time (it is important these to be 
-        // set at the same time otherwise f/w won't disable the dsl)
-        data = SPICA_MRX_ALG_CTRL__READ(die, channel);
-        data = SPICA_MRX_ALG_CTRL__CTRL__SET(data, 1);
-        data = SPICA_MRX_ALG_CTRL__DDSL__SET(data, 1);
-        SPICA_MRX_ALG_CTRL__WRITE(die, channel, data);
 
-        // wait until rsp is set to 1 by f/w
-        counter = 0;
-        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 1)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-                INPHI_NOTE("f/w failed to acquire semaphore\n");
-                return INPHI_ERROR;
-            }
+            vga2_gain[i] = rdata + 128;
         }
+
     }
 #endif // defined(INPHI_REMOVE_PMR)
 
+    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
+    {
+        return status;
+    }
+
     return status;
 }
 
-inphi_status_t spica_rx_dsp_release_estimation_semaphore(
+inphi_status_t spica_rx_dsp_ffe_taps_query(
     uint32_t die,
     uint32_t channel,
-    e_spica_intf intf)
+    e_spica_intf intf,
+    int16_t ffe_taps[SPICA_RX_DSP_SLICES*SPICA_RX_DSP_NUM_FFE_TAPS])
 {
     inphi_status_t status = INPHI_OK;
-    uint32_t counter = 0;
+
+    int16_t rdata = 0;
+    uint16_t sto_acc;
+    int16_t ffe_prescale[SPICA_RX_DSP_SLICES*(SPICA_RX_DSP_NUM_FFE_TAPS-1)];
+    int i, j, k;
+    uint16_t constrained;
+    bool fw_lock = false;
 
     if (SPICA_INTF_SRX == intf)
     {
@@ -15430,1798 +18505,1658 @@ inphi_status_t spica_rx_dsp_release_estimation_semaphore(
         return INPHI_ERROR;
     }
 
-    if (SPICA_INTF_ORX == intf)
+    if (intf == SPICA_INTF_ORX)
+    {
+         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
+    }
+    else
+    {
+         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
+    }
+    if(!fw_lock)
     {
-        // Wait until rsp is 1
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 1)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
 #if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 1.\n", spica_dbg_translate_intf(intf), channel);
+        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query FFE Taps.\n", spica_dbg_translate_intf(intf), channel);
 #endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
-        
-        // Wait until ctrl is 1
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_ORX_ALG_CTRL__CTRL__READ(die, channel) != 1)
+        return INPHI_ERROR;
+    }
+
+    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
+    {
+        return status;
+    }
+
+    if(intf == SPICA_INTF_ORX)
+    {
+        constrained = SPICA_ORX_CP_FFE_CFG__CON__READ(die, channel);
+
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+
+        // "Choose FFE based on mode"
+        if (SPICA_ORX_CP_FFE_CFG__MODE__READ(die, channel))
+        {
+            // "9x FFE Independent, s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
+            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
+            {
+                // INPHI_NOTE("Reading interleave %d data\n", i);
+                for (j=0; j<3; j++)  // ID, i.e. row number within slice
+                {
+                    for (k=0; k<3; k++)  // IDX, i.e. accumulator within the row
+                    {
+                        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x030 + 3*i + j);
+                        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, k);
+                        SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                        rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
+
+                        if(j==1 && k==0 && constrained)
+                        {
+                            //# post1 handled specially
+                            rdata = rdata >> 7;
+                            if (rdata >= (1 << 8)) 
+                            {
+                                rdata -= (1 << 9);
+                            }
+                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + 2] + rdata;  // pre1 + post1 in constrained mode
+                        }
+                        else
+                        {
+                            rdata = rdata >> 9;
+                            if (rdata >= (1 << 6)) 
+                            {
+                                rdata -= (1 << 7);
+                            }
+                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = rdata;
+                        }
+                    }
+                }
+            }
+        }   
+        else
         {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            uint16_t ffe_ca[SPICA_RX_DSP_NUM_FFE_TAPS-1];
+            // "9x FFE Common (CA), s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
+            //  "Actual ranges: taps -3/+3/+4/+5/+6: -15...+15; taps -2/+2: -31...+31; taps -1/+1: -63...+63)"
+            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, 0);
+            for(i=0; i<9; i++)
             {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 1.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
-            }
-        }
-
-        // restore all en1...en4
-        SPICA_ORX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
-        SPICA_ORX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
-        SPICA_ORX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
-        SPICA_ORX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
-
-        // set ctrl to 0
-        SPICA_ORX_ALG_CTRL__CTRL__RMW(die, channel, 0);
+                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x120 + i);
+                SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
+                if (i==3 && constrained==1)
+                {  
+                    // post1 handled specially
+                    rdata = rdata >> 7;
+                    if (rdata >= (1 << 8)) 
+                    {
+                        rdata -= (1 << 9);
+                    }
+                    ffe_ca[i] = ffe_ca[2] + rdata;  // pre1 + post1 in constrained mode
+                }
+                else
+                {
+                    rdata = rdata >> 9;
 
-        // wait until rsp is set to 0 by f/w
-        counter = 0;
-        while (SPICA_ORX_ALG_STATUS__RSP__READ(die, channel) != 0)
-        {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+                    if (rdata >= (1 << 6)) 
+                    {
+                        rdata -= (1 << 7);
+                    }
+                    ffe_ca[i] = rdata;
+                }
+            }
+            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
             {
-                INPHI_NOTE("f/w failed to release semaphore\n");
-                return INPHI_ERROR;
+                for (j=0; j<(SPICA_RX_DSP_NUM_FFE_TAPS-1); j++) 
+                {
+                    ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j] = ffe_ca[j];
+                }
             }
         }
-        // Set DDSL to 0, if it has been set to 1 when acquiring semaphore
-        SPICA_ORX_ALG_CTRL__DDSL__RMW(die, channel, 0);
     }
 #if !defined(INPHI_REMOVE_PMR)
-    else if (SPICA_INTF_MRX == intf)
+    else if(intf == SPICA_INTF_MRX)
     {
-        // Wait until rsp is 1
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 1)
+        constrained = SPICA_MRX_CP_FFE_CFG__CON__READ(die, channel);
+
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // 24b accesses (sometimes ignored by H/W based on ID)
+        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+
+        // "Choose FFE based on mode"
+        if (SPICA_MRX_CP_FFE_CFG__MODE__READ(die, channel))
         {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            // "9x FFE Independent, s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
+            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
             {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_STATUS__RSP == 1.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
+                // INPHI_NOTE("Reading interleave %d data\n", i);
+                for (j=0; j<3; j++)  // ID, i.e. row number within slice
+                {
+                    for (k=0; k<3; k++)  // IDX, i.e. accumulator within the row
+                    {
+                        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x030 + 3*i + j);
+                        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, k);
+                        SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                        rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
+
+                        if(j==1 && k==0 && constrained)
+                        {
+                            //# post1 handled specially
+                            rdata = rdata >> 7;
+                            if (rdata >= (1 << 8)) 
+                            {
+                                rdata -= (1 << 9);
+                            }
+                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + 2] + rdata;  // pre1 + post1 in constrained mode
+                        }
+                        else
+                        {
+                            rdata = rdata >> 9;
+                            if (rdata >= (1 << 6)) 
+                            {
+                                rdata -= (1 << 7);
+                            }
+                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = rdata;
+                        }
+                    }
+                }
             }
-        }
-        
-        // Wait until ctrl is 1
-        // Otherwise timeout and throw error
-        counter = 0;
-        while (SPICA_MRX_ALG_CTRL__CTRL__READ(die, channel) != 1)
+        }   
+        else
         {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
+            uint16_t ffe_ca[SPICA_RX_DSP_NUM_FFE_TAPS-1];
+            // "9x FFE Common (CA), s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
+            //  "Actual ranges: taps -3/+3/+4/+5/+6: -15...+15; taps -2/+2: -31...+31; taps -1/+1: -63...+63)"
+            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, 0);
+            for(i=0; i<9; i++)
             {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                INPHI_CRIT("%s channel %lu: API timed out waiting for ALG_CTRL__CTRL == 1.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-                return INPHI_ERROR;
+                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x120 + i);
+                SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
+                rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
+                if (i==3 && constrained==1)
+                {  
+                    // post1 handled specially
+                    rdata = rdata >> 7;
+                    if (rdata >= (1 << 8)) 
+                    {
+                        rdata -= (1 << 9);
+                    }
+                    ffe_ca[i] = ffe_ca[2] + rdata;  // pre1 + post1 in constrained mode
+                }
+                else
+                {
+                    rdata = rdata >> 9;
+
+                    if (rdata >= (1 << 6)) 
+                    {
+                        rdata -= (1 << 7);
+                    }
+                    ffe_ca[i] = rdata;
+                }
+            }
+            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
+            {
+                for (j=0; j<(SPICA_RX_DSP_NUM_FFE_TAPS-1); j++) 
+                {
+                    ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j] = ffe_ca[j];
+                }
             }
         }
+    } 
+#endif // defined(INPHI_REMOVE_PMR)
 
-        // restore all en1...en4
-        SPICA_MRX_ALG_CTRL__ALG1_EN__RMW(die, channel, en1);
-        SPICA_MRX_ALG_CTRL__ALG2_EN__RMW(die, channel, en2);
-        SPICA_MRX_ALG_CTRL__ALG3_EN__RMW(die, channel, en3);
-        SPICA_MRX_ALG_CTRL__ALG4_EN__RMW(die, channel, en4);
+    // "Scale FFE"
+    for (i=0; i<SPICA_RX_DSP_SLICES; i++)
+    {
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 0] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 0]*1000 / 120.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 1] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 1]*1000 / 124.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 2] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 2]*1000 / 105.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 3] = 1000;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 4] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 3]*1000 / 105.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 5] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 4]*1000 / 124.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 6] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 5]*1000 / 120.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 7] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 6]*1000 / 120.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 8] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 7]*1000 / 120.0;
+        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 9] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 8]*1000 / 120.0;
+    }   
+ 
+    spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
+    if (status  != INPHI_OK)
+    {
+        return status;
+    }
 
-        // set ctrl to 0
-        SPICA_MRX_ALG_CTRL__CTRL__RMW(die, channel, 0);
+    return status;
 
-        // wait until rsp is set to 0 by f/w
-        counter = 0;
-        while (SPICA_MRX_ALG_STATUS__RSP__READ(die, channel) != 0)
+}
+
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS == 1)
+// Translate DSP FFE Tap indices into text
+const char* spica_rx_dsp_dbg_translate_ffe_tap_index(
+    e_spica_ffe_taps tap_index)
+{
+    switch(tap_index)
+    {
+        case SPICA_FFE_TAP_PRE_CURSOR_3:  return("FFE_TAP_PRE_CURSOR_3");
+        case SPICA_FFE_TAP_PRE_CURSOR_2:  return("FFE_TAP_PRE_CURSOR_2");
+        case SPICA_FFE_TAP_PRE_CURSOR_1:  return("FFE_TAP_PRE_CURSOR_1");
+        case SPICA_FFE_TAP_MAIN_CURSOR:   return("FFE_TAP_MAIN_CURSOR");
+        case SPICA_FFE_TAP_POST_CURSOR_1: return("FFE_TAP_POST_CURSOR_1");
+        case SPICA_FFE_TAP_POST_CURSOR_2: return("FFE_TAP_POST_CURSOR_2");
+        case SPICA_FFE_TAP_POST_CURSOR_3: return("FFE_TAP_POST_CURSOR_3");
+        case SPICA_FFE_TAP_POST_CURSOR_4: return("FFE_TAP_POST_CURSOR_4");
+        case SPICA_FFE_TAP_POST_CURSOR_5: return("FFE_TAP_POST_CURSOR_5");
+        case SPICA_FFE_TAP_POST_CURSOR_6: return("FFE_TAP_POST_CURSOR_6");
+        default: break;
+    }
+    return "Invalid FFE Tap Index";
+}
+
+inphi_status_t spica_rx_dsp_ffe_taps_print(
+    uint32_t die,
+    uint32_t channel,
+    e_spica_intf intf,
+    int16_t ffe_taps[SPICA_RX_DSP_SLICES*SPICA_RX_DSP_NUM_FFE_TAPS])
+{
+    inphi_status_t status = INPHI_OK;
+
+    uint16_t interleave;
+    uint16_t tap_index;
+    
+    INPHI_NOTE("\n");
+    INPHI_NOTE("%s Channel %lu: DSP FFE Tap Values\n", spica_dbg_translate_intf(intf), channel);
+    INPHI_NOTE("==================================\n");
+    
+    INPHI_NOTE("Interleave | PRE3 | PRE2 | PRE1 | MAIN | PST1 | PST2 | PST3 | PST4 | PST5 | PST6 |\n");
+    INPHI_NOTE("-----------+------+------+------+------+------+------+------+------+------+------+\n");
+    for (interleave = 0; interleave < 16; interleave++)
+    {
+        INPHI_NOTE("%4s%2d %4s|", "", interleave+1, "");
+        for (tap_index = 0; tap_index < 10; tap_index++)
         {
-            counter++;
-            INPHI_MDELAY(10);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-                INPHI_NOTE("f/w failed to release semaphore\n");
-                return INPHI_ERROR;
-            }
+           INPHI_NOTE("%6d|", (int16_t)ffe_taps[interleave*10+tap_index]);
         }
-        // Set DDSL to 0, if it has been set to 1 when acquiring semaphore
-        SPICA_MRX_ALG_CTRL__DDSL__RMW(die, channel, 0);
+        INPHI_NOTE("\n");
     }
-#endif // defined(INPHI_REMOVE_PMR)
 
     return status;
 }
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
 
-inphi_status_t spica_rx_dsp_snr_wait_for_done(
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
+#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
+
+/*
+ * Get the first few pulse response values from the FW info buffer.
+ */
+inphi_status_t spica_srx_pulse_resp_query(
     uint32_t die,
     uint32_t channel,
-    e_spica_intf intf,
-    uint32_t* snr_results)
+    int32_t* resp_values,
+    int32_t* len)
 {
     inphi_status_t status = INPHI_OK;
-    uint16_t data;
-    uint16_t sto_acc;
 
-    if (SPICA_INTF_SRX == intf)
+    SPICA_LOCK(die);
+
+    // Check the f/w lock status. If it's not locked don't attempt
+    // to query the f/w because it may timeout
+    bool locked = SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel);
+
+    if(!locked)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
+        *len = 0;
+        INPHI_CRIT("SRX not locked on channel %lu, cannot fetch pulse response\n", channel);
+        status = INPHI_ERROR;
+        goto done;
     }
 
-    if (SPICA_INTF_ORX == intf)
+    //pulse response
+    status |= spica_msg_srx_pulse_resp_request(die, channel, resp_values, *len);
+    if(status)
     {
-        uint16_t counter = 0;
-        while (0 == SPICA_ORX_CP_ALG_DONE_INT__SNR__READ(die, channel))
-        {
-            counter++;
-            INPHI_UDELAY(1);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-                INPHI_NOTE(" SNR estimation algorithm has not completed\n");
-                return INPHI_ERROR;
-            }
-        }
+        INPHI_CRIT("Failed waiting for the pulse response from the h/w\n");
+        goto done;
+    }
 
-        data = SPICA_ORX_CP_SLC_RUN_CFG__DEFAULT;
-        data = SPICA_ORX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 0);
-        SPICA_ORX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+done:
+    SPICA_UNLOCK(die);
 
-        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);  // clear run_alg
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0);    // always doing reads
-        // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0);
-        // always doing an access    
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1);
+    return status;
+}
 
-        for (uint16_t slice = 0; slice < 128; slice++)
+#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
+inphi_status_t spica_srx_pulse_resp_query_dump_range(uint32_t die, uint32_t start, uint32_t end)
+{
+    inphi_status_t status = INPHI_OK;
+    e_spica_package_type package = spica_package_get_type(die);
+
+    SPICA_LOCK(die);
+
+    INPHI_NOTE(
+        "+---------------------------------------------------------------+\n"
+        "| HRX Pulse Response                                            |\n"
+        "+---------+--------+--------+--------+--------+--------+--------+\n"
+        "| Channel |     -3 |     -2 |     -1 |      0 |      1 |      2 |\n"
+        "+---------+--------+--------+--------+--------+--------+--------+\n");
+
+    SPICA_FOR_CHANNEL_IN_CHANNELS(package, SPICA_INTF_SRX)
+    {
+        if(channel < start || channel > end)
         {
-            // read from storage
-            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 4);
-            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x88 + slice / 4);
-            SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-            INPHI_UDELAY(1);
-            data = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
-            uint32_t snr_data1 = ((uint32_t)data << 16);
-            data = SPICA_ORX_CP_STORAGE_DATA0__READ(die, channel);
-            uint32_t snr_data0 = data;
-            snr_results[slice] = ((snr_data0 + snr_data1) >> 8);
+            continue;
         }
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (SPICA_INTF_MRX == intf)
-    {
-        uint16_t counter = 0;
-        while (0 == SPICA_MRX_CP_ALG_DONE_INT__SNR__READ(die, channel))
+        //Grab pulse response for Enabled channels only
+        if(!SPICA_SRX_RULES_0__CHANNEL_ENABLE__READ(die, channel))
         {
-            counter++;
-            INPHI_UDELAY(1);
-            if (counter > SPICA_RX_DSP_FW_TIME_OUT)
-            {
-                INPHI_NOTE(" SNR estimation algorithm has not completed\n");
-                return INPHI_ERROR;
-            }
+            continue;
         }
 
-        data = SPICA_MRX_CP_SLC_RUN_CFG__DEFAULT;
-        data = SPICA_MRX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 0);
-        SPICA_MRX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+        INPHI_NOTE("| %7lu |", channel);
 
-        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);  // clear run_alg
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0);    // always doing reads
-        // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0);
-        // always doing an access    
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1);
+        int32_t resp[6];
+        int32_t len = sizeof(resp)/sizeof(resp[0]);
+        status |= spica_srx_pulse_resp_query(die, channel, resp, &len);
+        if(INPHI_OK != status)
+            goto done;
 
-        for (uint16_t slice = 0; slice < 128; slice++)
+        for(int32_t i=0; i<len; i++)
         {
-            // read from storage
-            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 4);
-            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x88 + slice / 4);
-            SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-            INPHI_UDELAY(1);
-            data = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
-            uint32_t snr_data1 = ((uint32_t)data << 16);
-            data = SPICA_MRX_CP_STORAGE_DATA0__READ(die, channel);
-            uint32_t snr_data0 = data;
-            snr_results[slice] = ((snr_data0 + snr_data1) >> 8);
+            INPHI_NOTE("%8lu|", resp[i]);
         }
+        INPHI_NOTE("\n");
     }
-#endif // defined(INPHI_REMOVE_PMR)
+
+    INPHI_NOTE("+---------+--------+--------+--------+--------+--------+--------+\n");
+
+done:
+    SPICA_UNLOCK(die);
 
     return status;
 }
-        
 
-inphi_status_t spica_rx_dsp_snr_init_and_start(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    uint32_t step_size,
-    uint32_t duration,
-    uint32_t settle)
+inphi_status_t spica_srx_pulse_resp_query_dump(uint32_t die)
 {
-    inphi_status_t status = INPHI_OK;
-    uint16_t data;
+    return spica_srx_pulse_resp_query_dump_range(die, 0, 0xff);
+}
 
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
+#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
+/** @file mcu.c
+ ****************************************************************************
+ *
+ * @brief
+ *     This module contains the implementation of the interface to the
+ *     embedded MCU.
+ *
+ ****************************************************************************
+ * @author
+ *    This file contains information that is proprietary and confidential to
+ *    Inphi Corporation.
+ *
+ *    This file can be used under the terms of the Inphi Software License
+ *    Agreement. You should have received a copy of the license with this file,
+ *    if not please contact your Inphi support staff.
+ *
+ *    Copyright (C) 2006-2021 Inphi Corporation, Inc. All rights reserved.
+ *
+ *    API Version Number: 1.2.0.929
+ ***************************************************************************/
 
-    if (SPICA_INTF_ORX == intf)
-    {
-        data = SPICA_ORX_CP_SLC_RUN_CFG__DEFAULT;
-        data = SPICA_ORX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 1);
-        SPICA_ORX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+#if defined(INPHI_HAS_FILESYSTEM)
+#include <string.h> // String methods for progrmaming ucode from disk
+#include <stdio.h>  // File IO methods for programming ucode from disk
+#endif // INPHI_HAS_FILESYSTEM
 
-        data = SPICA_ORX_CP_SNR_CFG__DEFAULT;
-        data = SPICA_ORX_CP_SNR_CFG__STEP_SIZE__SET(data, step_size);
-        data = SPICA_ORX_CP_SNR_CFG__STORE_ADDR__SET(data, 0xa);
-        SPICA_ORX_CP_SNR_CFG__WRITE(die, channel, data);
+/** Max debug buffer length for query_print */
+#define SPICA_MCU_DEBUG_BUFFER_MAX_LENGTH 2048
 
-        // clear the snr alg 'done' interrupt bitfield
-        SPICA_ORX_CP_ALG_DONE_INT__WRITE(die, channel, 1 << 12);
-        SPICA_ORX_CP_SNR_RUN_CFG__DURATION__RMW(die, channel, duration);
-        SPICA_ORX_CP_SNR_RUN_CFG__SETTLE__RMW(die, channel, settle);
-        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);
-        SPICA_ORX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 1);
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (SPICA_INTF_MRX == intf)
+/**
+ * Simple function to decode the top bytes of the BOOTVER register
+ * 
+ * These are the valid firmware modes:
+ *
+ *   0xBCDD (boot upgrade/direct download)
+ *   0xACC0 (Application code)
+ * 
+ * @param bootver [I] - BOOTVER >> 16
+ * 
+ * @return mode the FW is running in
+ *
+ * @private
+ */
+e_spica_fw_mode spica_mcu_decode_bootver(
+    uint32_t bootver)
+{
+    if(bootver == 0xACC0)
     {
-        data = SPICA_MRX_CP_SLC_RUN_CFG__DEFAULT;
-        data = SPICA_MRX_CP_SLC_RUN_CFG__MANUAL_CEN__SET(data, 1);
-        SPICA_MRX_CP_SLC_RUN_CFG__WRITE(die, channel, data);
+        return SPICA_FW_MODE_APPLICATION;
+    }
+    return SPICA_FW_MODE_UNKNOWN;
+}
 
-        data = SPICA_MRX_CP_SNR_CFG__DEFAULT;
-        data = SPICA_MRX_CP_SNR_CFG__STEP_SIZE__SET(data, step_size);
-        data = SPICA_MRX_CP_SNR_CFG__STORE_ADDR__SET(data, 0xa);
-        SPICA_MRX_CP_SNR_CFG__WRITE(die, channel, data);
+/**
+ * Number of dies whose FW state is cached for messaging
+ *
+ * @private
+ */
+#define SPICA_FW_CACHE_DIES SPICA_MAX_DIES_IN_PACKAGE
 
-        // clear the snr alg 'done' interrupt bitfield
-        SPICA_MRX_CP_ALG_DONE_INT__WRITE(die, channel, 1 << 12);
-        SPICA_MRX_CP_SNR_RUN_CFG__DURATION__RMW(die, channel, duration);
-        SPICA_MRX_CP_SNR_RUN_CFG__SETTLE__RMW(die, channel, settle);
-        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 0);
-        SPICA_MRX_CP_SNR_RUN_CFG__RUN_ALG__RMW(die, channel, 1);
+/**
+ * FW state of a die used by every message, read from the FW once and kept
+ * until the MCU is reset or a message fails.
+ *
+ * @private
+ */
+typedef struct {
+    /** Die the entry belongs to */
+    uint32_t die;
+    /** The entry is assigned to die */
+    bool in_use;
+    /** The FW was seen in application mode */
+    bool app_mode;
+    /** The msg2 buffer descriptors below were read from the FW */
+    bool msg2_valid;
+    /** Address of each msg2 buffer struct in the FW, API2FW then FW2API */
+    uint32_t msg2_self_addr[2];
+    /** length of each msg2 buffer */
+    uint32_t msg2_length[2];
+} spica_fw_cache_t;
+
+static spica_fw_cache_t g_spica_fw_cache[SPICA_FW_CACHE_DIES];
+static uint32_t g_spica_fw_cache_next = 0;
+
+/**
+ * Look up the cached FW state of a die
+ *
+ * @param add [I] - Assign an entry to the die if it has none, replacing the oldest
+ *
+ * @return the cache entry, NULL if the die has none and add is false
+ *
+ * @private
+ */
+static spica_fw_cache_t* spica_fw_cache_find(uint32_t die, bool add)
+{
+    spica_fw_cache_t* entry;
+
+    for(uint32_t i = 0; i < SPICA_FW_CACHE_DIES; i++)
+    {
+        if(g_spica_fw_cache[i].in_use && (g_spica_fw_cache[i].die == die))
+        {
+            return &g_spica_fw_cache[i];
+        }
     }
-#endif // defined(INPHI_REMOVE_PMR)
+    if(!add) return NULL;
 
-    return status;
+    entry = &g_spica_fw_cache[g_spica_fw_cache_next];
+    g_spica_fw_cache_next = (g_spica_fw_cache_next + 1) % SPICA_FW_CACHE_DIES;
+    INPHI_MEMSET(entry, 0, sizeof(*entry));
+    entry->die = die;
+    entry->in_use = true;
+    return entry;
 }
 
-/*
- *  Returns 64 element array in this order:
- *          M3 (16)
- *          M1 (16)
- *          P1 (16)
- *          P3 (16)
- */
-  inphi_status_t spica_rx_dsp_get_amp_all(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    uint32_t*    amp_locs)
+void spica_mcu_msg2_cache_invalidate(
+    uint32_t die)
 {
-    inphi_status_t status = INPHI_OK;
-    uint16_t sto_acc;
+    spica_fw_cache_t* entry = spica_fw_cache_find(die, false);
 
-    if (SPICA_INTF_SRX == intf)
+    if(entry)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
+        entry->app_mode = false;
+        entry->msg2_valid = false;
     }
+}
 
-    // // only update AMP levels once
-    // if (amp_lvls_init)
-    // {
-    //     return status;
-    // }
-
-    // INPHI_NOTE("Initializing SNR AMP levels\n");
-    // amp_lvls_init = true;
+/**
+ * This method is used to get the fw mode
+ */
+inphi_status_t spica_mcu_fw_mode_query(
+    uint32_t       die,
+    e_spica_fw_mode* mode)
+{
+    inphi_status_t status = INPHI_OK;
 
-    // Returns 16x4-element over all 16 slices for each of the 
-    // four PAM4 levels: [-3, -1, +1, +3] (in that order).
-    // INPHI_MEMSET(amp_locs, 0, 16*4*4); // this done by calling method
+    uint16_t bootver = 0;
+    bootver = SPICA_MCU_FW_MODE__READ(die);
+    *mode = spica_mcu_decode_bootver(SPICA_MCU_FW_MODE__FW_MODE__GET(bootver));
 
-    if (SPICA_INTF_ORX == intf)
+    // The msg2 buffers only exist while the application FW runs
+    if(*mode == SPICA_FW_MODE_APPLICATION)
     {
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(   0,       0); // always doing reads
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 1); // always doing 12b accesses
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
-     
-        for (uint16_t level = 0; level < 4; level++)
-        {
-            for (uint16_t slice = 0; slice < 16; slice++)
-            {
-                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0xa8 + level*2 + slice / 8);
-                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 8);
-                SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                INPHI_UDELAY(1);
-                amp_locs[level*16 + slice] = SPICA_ORX_CP_STORAGE_DATA0__READ(die, channel) / 8; //convert from u12.3 to u9.0
-            }
-        }
+        spica_fw_cache_find(die, true)->app_mode = true;
     }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (SPICA_INTF_MRX == intf)
+    else
     {
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(   0,       0); // always doing reads
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 1); // always doing 12b accesses
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
-     
-        for (uint16_t level = 0; level < 4; level++)
-        {
-            for (uint16_t slice = 0; slice < 16; slice++)
-            {
-                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0xa8 + level*2 + slice / 8);
-                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, slice % 8);
-                SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                INPHI_UDELAY(1);
-                amp_locs[level*16 + slice] = SPICA_MRX_CP_STORAGE_DATA0__READ(die, channel) / 8; //convert from u12.3 to u9.0
-            }
-        }
+        spica_mcu_msg2_cache_invalidate(die);
     }
-#endif // defined(INPHI_REMOVE_PMR)
 
     return status;
 }
 
-inphi_status_t spica_rx_dsp_hist_dsl(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    bool         is_nrz,
-    uint32_t*    histo)
+/**
+ * Same as spica_mcu_fw_mode_query, without reading the FW mode again once the
+ * FW is known to run the application. Used before every message; the cache is
+ * dropped when the API resets the MCU or a message fails.
+ *
+ * @private
+ */
+static inphi_status_t spica_mcu_fw_mode_query_cached(
+    uint32_t       die,
+    e_spica_fw_mode* mode)
 {
-    inphi_status_t status = INPHI_OK;
-    uint32_t steps[64];
-    uint32_t i;
-    uint32_t snr_results[128];
-    uint32_t amp_locs[16*4];
+    spica_fw_cache_t* entry = spica_fw_cache_find(die, false);
 
-    if (SPICA_INTF_SRX == intf)
+    if(entry && entry->app_mode)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
+        *mode = SPICA_FW_MODE_APPLICATION;
+        return INPHI_OK;
     }
+    return spica_mcu_fw_mode_query(die, mode);
+}
 
-    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-        return status;
-    }
+/*
+ * This method blocks until the MCU is in application mode or
+ * the until the timeout expires.
+ */
+inphi_status_t spica_mcu_block_application_mode(
+    uint32_t die,
+    int      timeout_in_ms)
+{
+    inphi_status_t status = INPHI_OK;
+    e_spica_fw_mode fw_mode = SPICA_FW_MODE_UNKNOWN;
+    int i = 0;
 
-    INPHI_MEMSET(steps, 0, sizeof(steps)); 
-    INPHI_MEMSET(snr_results, 0, sizeof(snr_results));
-    INPHI_MEMSET(amp_locs, 0, sizeof(amp_locs));
- 
-    for (i = 0; i < SPICA_RX_DSP_MAX_STEP; i++)
-    {
-        uint32_t j = i * SPICA_RX_DSP_STEP_SIZE;
-        if (j >= SPICA_RX_DSP_MAX_STEP)
-        {
-            break;
-        }
-        steps[i] = j;
+    if(timeout_in_ms < 0) {
+        INPHI_CRIT("timeout needs to be >= 0\n");
+        return INPHI_ERROR;
     }
-    uint32_t num_steps = i;
 
-    // uint8_t single_hist_length = 4 * (2*num_steps - 1);
-    // amp estimation once before running this not needed
-    // since the DSL is actually running in the background
-    // before this is called
-    // if (is_nrz)
-    // {
-    //     amp_locs[0] = num_steps-1;
-    //     for (i = 0; i < 3; i++)
-    //     {
-    //         amp_locs[i+1] = amp_locs[i] + (2 * num_steps - 1);
-    //     }
-    //     INPHI_NOTE("amp_locs[0] = %d\n", amp_locs[0]);
-    //     INPHI_NOTE("amp_locs[1] = %d\n", amp_locs[1]);
-    //     INPHI_NOTE("amp_locs[2] = %d\n", amp_locs[2]);
-    //     INPHI_NOTE("amp_locs[3] = %d\n", amp_locs[3]);
-    // }
-    // else //PAM
+    SPICA_LOCK(die);
+
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_APP_MODE);
+
+    // The FW is (re)starting, nothing cached about it holds
+    spica_mcu_msg2_cache_invalidate(die);
+
+    // Turn on the PC trace
+    SPICA_MCU_GEN_CFG__PDEBUG_EN__RMW(die, 1);
+
+    for(i = 0; i <= timeout_in_ms; i++)
     {
-        // Fetch the amp locations for all humps/interleaves ie (16*4*32-bits)
-        // Note: This doesn't seem right for NRZ so only for PAM now!
-        status |= spica_rx_dsp_get_amp_all(die, channel, intf, amp_locs);
-        if (status != INPHI_OK)
-        {
-            return status;
-        }
-        // for PAM divide the values by 2 (ie from 512 bins to 256)
-        for (uint16_t level = 0; level < 4; level++)
+        status |= spica_mcu_fw_mode_query(die, &fw_mode);
+        if(status != INPHI_OK) return status;
+        
+        if (fw_mode == SPICA_FW_MODE_APPLICATION)
         {
-            for (uint16_t slice = 0; slice < 16; slice++)
-            {
-                amp_locs[level*16 + slice] >>= 1;
-            }
+            /* we can proceed now that the FW is in application mode */
+            break;
         }
-    }
-    // for (uint16_t slice = 0; slice < 16; slice++)
-    // {
-    //     INPHI_NOTE("\nHist amp locs: i:%2d, ", slice);
-    //     for (uint16_t level = 0; level < 4; level++)
-    //     {
-    //         INPHI_NOTE("loc(%d):%3d, ", level, amp_locs[level*16 + slice]);
-    //     }
-    // }
-    // INPHI_NOTE("\n");
-    
-    
-    for (i = 0; i < SPICA_RX_DSP_MAX_STEP; i++)
-    {
-        uint32_t step_val = steps[i];
-        if (i == num_steps)
+        else if(0 == fw_mode)
         {
-            break;
+            /* Still waiting for application f/w to start */
+            INPHI_MDELAY(1);
+            continue;
         }
-
-        // SNR results for -3 and +3 levels do not change based on nrz vs pam4
-        // The 128 return values are exactly the same in nrz and pam4 but all the ones for -1 and +1 will be garbage in nrz
-        // 6 slices * 4 levels/slice * 2 lo/hi per level (2 of the 4 levels will be garbage in NRZ)
-        spica_rx_dsp_snr_init_and_start(die, channel, intf, step_val, 
-                                             SPICA_RX_DSP_DURATION_16, 
-                                             SPICA_RX_DSP_SETTLE_11);
-        status = spica_rx_dsp_snr_wait_for_done(die, channel, intf, snr_results);  // 128 values (64 useful in NRZ)
-        
-        // snr_results is an array of 128 32-bit unsigned integers.
-        // index   0.. 15: interleave 0..15, level -3, +step_val
-        // index  16.. 31: interleave 0..15, level -3, -step_val
-        // index  32.. 47: interleave 0..15, level -1, +step_val
-        // index  48.. 63: interleave 0..15, level -1, -step_val
-        // index  64.. 79: interleave 0..15, level +1, +step_val
-        // index  80.. 95: interleave 0..15, level +1, -step_val
-        // index  96..111: interleave 0..15, level +3, +step_val
-        // index 112..127: interleave 0..15, level +3, -step_val
-        
-        // // Morrie: print out one slice, in order
-        // for (uint32_t temp_level = 0; temp_level < 4; temp_level++)
-        // {
-        //     if ((temp_level == 1) || (temp_level == 2)) continue;
-        //     INPHI_NOTE("%d,%d,%d,%d\n", 0, temp_level, -1*step_val, snr_results[temp_level*32+16+0]);
-        //     INPHI_NOTE("%d,%d,%d,%d\n", 0, temp_level,    step_val, snr_results[temp_level*32   +0]);
-        // }
-
-        for (uint32_t amp_idx = 0; amp_idx < 4; amp_idx++)
+        else
         {
-            for (uint32_t th_idx = 0; th_idx < SPICA_RX_DSP_HIST_TH_SLICES; th_idx++)
-            {
-                uint32_t cur_loc     = (th_idx*SPICA_RX_DSP_HIST_BINS*4)+amp_locs[amp_idx*16 + th_idx];
-                uint32_t temp_idx    = th_idx + (amp_idx * 32);
-                uint32_t hump_offset = amp_idx*SPICA_RX_DSP_HIST_BINS; // each hump has one 256 entry bin
-                // here we get the 16 track and hold values, will calc the average later...
-                if (step_val == 0) 
-                {
-                    histo[cur_loc+hump_offset] = (snr_results[temp_idx] + snr_results[temp_idx + 16]) / 2;
-                    //INPHI_NOTE("histo[cur_loc]=[%d]=%d, \n", cur_loc, histo[cur_loc]);
-                }
-                else
-                {
-                    histo[cur_loc-i+hump_offset] = snr_results[temp_idx + 16];
-                    //INPHI_NOTE("histo[cur_loc-idx]=[%d-%d]=[%d]=%d, \n", cur_loc, idx, cur_loc-idx, histo[cur_loc-idx]);
-
-                    histo[cur_loc+i+hump_offset] = snr_results[temp_idx];
-                    //INPHI_NOTE("histo[cur_loc+idx]=[%d+%d]=[%d]=%d, \n", cur_loc, idx, cur_loc+idx, histo[cur_loc+idx]);
-                }
-            }
+            INPHI_CRIT("Invalid FW mode: 0x%x\n", fw_mode);
+            goto error;
         }
     }
-    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
+    if((i >= timeout_in_ms) && (fw_mode != SPICA_FW_MODE_APPLICATION))
     {
-        return status;
+        INPHI_CRIT("Timed-out waiting for MCU to run Application code, timeout=%d (ms)\n", timeout_in_ms);
+        goto error;
     }
+    goto done;
+error:
+    status |= INPHI_ERROR;
+done:
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_APP_MODE);
+    SPICA_UNLOCK(die);
 
     return status;
 }
 
-inphi_status_t spica_rx_dsp_hist_get(
-    uint32_t     die,
-    uint32_t     channel,
-    e_spica_intf intf,
-    uint32_t*    histo)
+/**
+ * Read from the memory through the inbound PIF interface
+ */
+inphi_status_t spica_mcu_pif_read(
+    uint32_t  die,
+    uint32_t  addr,
+    uint32_t* buffer,
+    uint32_t  num_words)
 {
-    inphi_status_t status = INPHI_OK;
-    bool    fw_lock;
-    bool    is_nrz = false;
-
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
+#if defined(INPHI_GUI)
+    // If we're running in the GUI use the optimized
+    // Inbound PIF methods for better performance.
+    extern inphi_status_t inphi_gui_mcu_pif_read(
+        uint32_t        die,
+        uint32_t        addr,
+        const uint32_t* buffer,
+        uint32_t        num_words);
+    return inphi_gui_mcu_pif_read(die, addr, buffer, num_words);
+#endif
 
+    inphi_status_t status = INPHI_OK;
+    uint16_t temp = 0;
+    uint16_t cfg = 0;
+    uint16_t i;
+    int guard = 1000;
     SPICA_LOCK(die);
 
-    if (SPICA_INTF_ORX == intf)
+    while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && (guard > 0))
     {
-        fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-        is_nrz  = SPICA_ORX_RULES_0__SIGNALLING__READ(die, channel);
+        guard--;
+        continue;
     }
-    else 
+
+    if(guard <= 0)
     {
-        // must be MRX
-        fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-        is_nrz  = SPICA_MRX_RULES_0__SIGNALLING__READ(die, channel);
+        INPHI_CRIT("Memory access failure on die %lu\n", die);
+        status |= INPHI_ERROR;
+        goto exit;
     }
-    if (!fw_lock)
+    
+    cfg = SPICA_MCU_INBPIF_CFG0__READ(die);
+    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 1);
+    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 3);
+    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
+
+    //setup the controller, do NOT change the order of these accesses
+    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
+    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 1);
+    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 2); //32b at a time
+    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
+
+    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
+    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
+
+    for(i = 0; i < num_words; ++i)
     {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_WARN("%s[Channel %lu]: NOT FW LOCKED!\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        status |= INPHI_ERROR;
-#if 0
-        // load a stripes pattern
-        for (uint16_t i = 0; i < 255; i += 2) 
+        guard = 1000;
+#if (!defined(INPHI_HAS_INBPIF_READ_POLLING)) || \
+    (defined(INPHI_HAS_INBPIF_READ_POLLING) && (INPHI_HAS_INBPIF_READ_POLLING == 1))
+        while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && guard > 0)
         {
-            histo[i+0] = 0;
-            histo[i+1] = 1048575; // 2^20
+            guard--;
+            continue;
         }
-#endif
-    }
-    else 
-    {
-        status = spica_rx_dsp_hist_dsl(die, channel, intf, is_nrz, histo);
-        
-        if (is_nrz)
+            
+        if(guard <= 0)
         {
-            // For NRZ, here's a look at the layout of a slice in histo
-            // |---------|---------+---------|---------|
-            // |0     255|256   511|512   767|768  1023|
-            // |---------|---------+---------|---------|
-            // |    -3   |    -1   |   +1    |    +3   |
-            // |---------|---------+---------|---------| 
-            // So here we clear the garbage in the area -1 and +1
-            for (uint32_t th_idx = 0; th_idx < SPICA_RX_DSP_HIST_TH_SLICES; th_idx++)
-            {
-                uint32_t start_idx = 256+(th_idx*SPICA_RX_DSP_HIST_BINS*4);
-                uint32_t end_idx   = 768+(th_idx*SPICA_RX_DSP_HIST_BINS*4);
-                for (uint32_t idx = start_idx; idx < end_idx; idx++)  
-                {
-                    histo[idx] = 0;
-                }
-                // // mb: There is a problem in the RTL where it does not saturate the 
-                // // DAC code when applying the step_size.  We can get around this in 
-                // // software by ignoring results at the edges which are out-of-whack. 
-                // // I observed saturated values at 61..63, 125..127 so we clear them.
-                // histo[61+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
-                // histo[62+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
-                // histo[63+(th_idx*SPICA_RX_DSP_HIST_BINS)]  = 0;
-                // histo[125+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
-                // histo[126+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
-                // histo[127+(th_idx*SPICA_RX_DSP_HIST_BINS)] = 0;
-            }
+            INPHI_CRIT("Memory access failure on die %lu\n", die);
+            status |= INPHI_ERROR;
         }
-    }
-    // for (uint32_t idx = 0; idx < SPICA_RX_DSP_HIST_BINS*SPICA_RX_DSP_HIST_TH_SLICES; idx++)
-    // {
-    //     INPHI_NOTE("histo[%d]=%d\n", idx, histo[idx]);
-    // }
-    SPICA_UNLOCK(die);
+#endif
     
-    return status;
-}
-
-#if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
-double spica_rx_dsp_snr_read_db(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf)
-{
-    double snr_db = 0.0;
-    uint16_t snr_val;
+        temp = SPICA_MCU_INBPIF_RDATA__READ(die);
+        buffer[i] = (uint32_t)temp;
+        temp = SPICA_MCU_INBPIF_RDATA__READ(die);
+        buffer[i] |= (uint32_t)temp << 16;
+        if(status) goto exit;
+    }
 
-    snr_val = spica_rx_dsp_snr_read_db_fixp(die, channel, intf); 
+exit:
+    //disable the read enable so that we can do register dumps once more
+    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
+    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
+    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
 
-    snr_db = (double)snr_val / 1600.0;
+    SPICA_UNLOCK(die);
 
-    return snr_db;
+    return status;
 }
-#endif // defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
 
-uint16_t spica_rx_dsp_snr_read_db_fixp(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf)
-{
-    uint16_t snr_val = 0;
-    bool fw_lock = false;
+/**
+ * Top bits of the MCU DRAM address space
+ * @private
+ */
+#define SPICA_MCU_DRAM_ADDR_MSW 0x5ff8
 
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return snr_val;
-    }
+#if defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+/**
+ * Inbound PIF data handed to spica_reg_set_burst() at a time,
+ * in 16 bit halves of the words
+ * @private
+ */
+#define SPICA_MCU_PIF_BURST_SIZE 64
 
-    if (intf == SPICA_INTF_ORX)
-    {
-         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    else
-    {
-         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    if(!fw_lock)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA1\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return snr_val;
-    }
+// Stream words into the inbound PIF data register, burst mode must be on
+static inphi_status_t spica_mcu_pif_write_burst(
+    uint32_t        die,
+    const uint32_t* buffer,
+    uint32_t        num_words)
+{
+    inphi_status_t status = INPHI_OK;
+    uint16_t burst[SPICA_MCU_PIF_BURST_SIZE];
+    uint32_t n = 0;
 
-    if (intf == SPICA_INTF_ORX)
-    {
-        snr_val = SPICA_ORX_SNR_METRIC__VALUE__READ(die, channel);
-    }
-    else if (intf == SPICA_INTF_MRX)
+    for(uint32_t i = 0; i < num_words; ++i)
     {
-        snr_val = SPICA_MRX_SNR_METRIC__VALUE__READ(die, channel);
-    }
-    else
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return snr_val; 
+        burst[n++] = (uint16_t)buffer[i];
+        burst[n++] = (uint16_t)(buffer[i]>>16);
+        if((n == SPICA_MCU_PIF_BURST_SIZE) || (i == num_words - 1))
+        {
+            status |= spica_reg_set_burst(die, SPICA_MCU_INBPIF_WDATA0__ADDRESS, burst, n);
+            if(status) break;
+            n = 0;
+        }
     }
 
-    return snr_val;
+    return status;
 }
+#endif // defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
 
-inphi_status_t spica_rx_dsp_ltp_read_fixp(uint32_t die, uint32_t channel, e_spica_intf intf, uint16_t *ltp)
+/**
+ * Write to the memory through the inbound PIF interface
+ */
+inphi_status_t spica_mcu_pif_write(
+    uint32_t        die,
+    uint32_t        addr,
+    const uint32_t* buffer,
+    uint32_t        num_words)
 {
-    if(!((intf == SPICA_INTF_ORX) || (intf == SPICA_INTF_MRX)))
-    {
-        INPHI_CRIT("only supported on ORX and MRX interfaces\n");
-        return INPHI_ERROR;
-    }
+#if defined(INPHI_GUI)
+    // If we're running in the GUI use the optimized
+    // Inbound PIF methods for better performance.
+    extern inphi_status_t inphi_gui_mcu_pif_write(
+        uint32_t        die,
+        uint32_t        addr,
+        const uint32_t* buffer,
+        uint32_t        num_words);
+    return inphi_gui_mcu_pif_write(die, addr, buffer, num_words);
+#endif
 
-    *ltp = 0;
+    inphi_status_t status = INPHI_OK;
+    uint16_t cfg = 0;
+    int guard = 1000;
 
-    uint16_t data = 0;
+    SPICA_LOCK(die);
 
-    if (intf == SPICA_INTF_ORX)
+    while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && (guard > 0))
     {
-        data = SPICA_ORX_LTP__READ(die, channel);
+        guard--;
+        continue;
     }
-    else 
+    
+    if(guard <= 0)
     {
-        data = SPICA_MRX_LTP__READ(die, channel);
+        INPHI_CRIT("Memory access failure on die %lu\n", die);
+        status |= INPHI_ERROR;
+        goto exit;
     }
+    
+    cfg = SPICA_MCU_INBPIF_CFG0__READ(die);
+    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 0x81);
+    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 0x3);
+    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
 
-    if(0 == data)
+    //setup the controller, do NOT change the order of these accesses
+    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
+    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
+    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 4); //32b at a time
+    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
+
+    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
+    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
+    
+    // Turn on burst mode in case the end user supports it
+    SPICA_MCU_MDIO_CFG__WRITE(die, 1);
+    
+#if defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+    status |= spica_mcu_pif_write_burst(die, buffer, num_words);
+#else
+    for(uint16_t i = 0; i < num_words; ++i)
     {
-        //not available yet
-        return INPHI_ERROR;
+        //while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die))
+        //    continue;
+    
+        //INPHI_NOTE("%08x\n", buffer[i]);
+        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)buffer[i]);
+        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)(buffer[i]>>16));
+        if(status) goto exit;
     }
+#endif
+    
 
-    *ltp = data;
-    return INPHI_OK;
-}
+exit:
+    // Disable burst mode after the download has finished
+    SPICA_MCU_MDIO_CFG__WRITE(die, 0);
 
-#if defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
-#if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT == 1)
-double spica_rx_dsp_ltp_format(uint16_t ltp)
-{
-    //handle special case
-    if(0xffff == ltp) {
-        return INFINITY; //defined in math.h as part of C99
-    }
-    return ltp/256.0;
+    SPICA_UNLOCK(die);
+
+    return status;
 }
-#endif // defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
-#endif // defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT == 1)
 
-inphi_status_t spica_rx_dsp_vga1_query(
+// Write to the memory through the inbound PIF interface
+inphi_status_t spica_mcu_pif_write_bcast(
     uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    uint16_t* vga1_gain)
+    uint32_t addr,
+    const uint32_t* buffer,
+    uint32_t num_words)
 {
     inphi_status_t status = INPHI_OK;
-    uint16_t sto_acc;
-    bool fw_lock = false;
-
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
+    uint16_t cfg = 0;
 
-    if (intf == SPICA_INTF_ORX)
-    {
-         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    else
-    {
-         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    if(!fw_lock)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA1\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        *vga1_gain = 0xffff;
-        return INPHI_ERROR;
-    }
+    SPICA_LOCK(die);
 
-    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu failed acquiring semaphore.\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return status;
-    }
+    cfg = 0;
+    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 0x81);
+    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 0x3);
+    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
 
-    if (intf == SPICA_INTF_ORX)
-    {
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+    //setup the controller, do NOT change the order of these accesses
+    cfg = 0;
+    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
+    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 4); //32b at a time
+    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
 
-        // VGA1 Gain
-        //"VGA1 Gain (V1G), 8b binary offset (i.e. 128 center):"
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0x131);
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc,     0); // ignored by H/W
-        SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-        *vga1_gain = (SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel) >> 8);
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MRX)
+    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
+    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
+    
+    // Turn on burst mode in case the end user supports it
+    SPICA_MCU_MDIO_CFG__WRITE(die, 1);
+    
+#if defined(INPHI_HAS_REG_BURST_WRITE) && (INPHI_HAS_REG_BURST_WRITE==1)
+    status |= spica_mcu_pif_write_burst(die, buffer, num_words);
+#else
+    for(uint16_t i = 0; i < num_words; ++i)
     {
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
-
-        // VGA1 Gain
-        //"VGA1 Gain (V1G), 8b binary offset (i.e. 128 center):"
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0x131);
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc,     0); // ignored by H/W
-        SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-        *vga1_gain = (SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel) >> 8);
+        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)buffer[i]);
+        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)(buffer[i]>>16));
     }
-#endif // defined(INPHI_REMOVE_PMR)
+#endif
+    
+    // Disable burst mode after the download has finished
+    SPICA_MCU_MDIO_CFG__WRITE(die, 0);
 
-    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-        return status;
-    }
+    SPICA_UNLOCK(die);
 
     return status;
 }
 
-inphi_status_t spica_rx_dsp_vga2_query(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    int16_t vga2_gain[SPICA_RX_DSP_SLICES])
+#if defined(INPHI_HAS_DIRECT_DOWNLOAD)
+//include the app image, will not be compiled in without the proper defines
+
+/* Reset the MCU and clear the IRAM/DRAM ahead of a direct download
+ */
+static inphi_status_t spica_mcu_direct_download_prepare(
+    uint32_t die)
 {
-    inphi_status_t status = INPHI_OK;
-    uint16_t sto_acc;
-    bool fw_lock = false;
-    int16_t rdata = 0;
-    int i = 0;
+    SPICA_LOCK(die);
 
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_RAM_INIT);
 
-    if (intf == SPICA_INTF_ORX)
-    {
-         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    else
-    {
-         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    if(!fw_lock)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query VGA2\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        *vga2_gain = 0xffff;
-        return INPHI_ERROR;
-    }
+    // Ensure everything is reset to a known state on each F/W download.
+    // The "hard" reset in from the pin and "soft" reset from the MMD08_PMA_CONTROL 
+    // register are logically "ORed" together so the MMD08 reset should be the 
+    // equivalent to toggling the reset pin.
+    SPICA_MMD08_PMA_CONTROL__WRITE(die, 0x8000);
+    INPHI_MDELAY(1);
 
-    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu failed acquiring semaphore.\n", spica_dbg_translate_intf(intf), channel);
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return status;
-    }
+    // hit the runstall to stall the MCU when programming the f/w
+    // this will get reset when using reset_into_mode
+    SPICA_MCU_GEN_CFG__WRITE(die, 0x1001);
 
-    if (intf == SPICA_INTF_ORX)
-    {
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+    // Clear the FIRMWARE version when downloading
+    // so we can verify the app code restarts properly.
+    SPICA_MCU_FIRMWARE_REV0_OVL__WRITE(die, 0);
+    SPICA_MCU_FIRMWARE_REV1_OVL__WRITE(die, 0);
 
-        // VGA2 Gain
-        //"VGA2 Gain (V2G), 8b binary offset (i.e. 128 center):"
-        for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-        {
-            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0xbe + i/4);
-            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, i%4);
-            SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-            rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
+    // If we're currently in application mode then
+    // make sure we clear the FW_MODE register so that
+    // we don't hit a race condition when we restart
+    // the firmware.
+    SPICA_MCU_FW_MODE__WRITE(die, 0xACDD);
 
-            rdata = rdata >> 8;            
+    // Zero initialize the IRAM and DRAM memories
+    // to ensure ECC bits are properly initialized
+    SPICA_MCU_DRAM_INIT_CFG__WRITE(die, 0x1fff);
+    SPICA_MCU_IRAM_INIT_CFG__WRITE(die, 0x8000);
+    // IRAM/DRAM memory will be initialized on a 0 to 1 transition 
+    SPICA_MCU_GEN_CFG__INIT_IRAM__WRITE(die, 0);
+    SPICA_MCU_GEN_CFG__INIT_DRAM__WRITE(die, 0);
+    SPICA_MCU_GEN_CFG__INIT_IRAM__WRITE(die, 1);
+    SPICA_MCU_GEN_CFG__INIT_DRAM__WRITE(die, 1);
 
-            if (rdata >= (1 << 7)) 
-            {
-                rdata -= (1 << 8);
-            }
+    // Wait for the init operation to finish
+    INPHI_MDELAY(2);
 
-            vga2_gain[i] = rdata + 128;
-        }
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if (intf == SPICA_INTF_MRX)
-    {
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // always doing 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_RAM_INIT);
 
-        // VGA2 Gain
-        //"VGA2 Gain (V2G), 8b binary offset (i.e. 128 center):"
-        for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-        {
-            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET (sto_acc, 0xbe + i/4);
-            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, i%4);
-            SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-            rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
+    SPICA_UNLOCK(die);
+
+    return INPHI_OK;
+}
+
+/**
+ * Words read back at a time when verifying a direct download
+ * @private
+ */
+#define SPICA_MCU_VERIFY_CHUNK_WORDS 64
+
+/* Read back part of a programmed block with multi-word PIF reads and
+ * compare it against the image, block is the index of the block in
+ * the image and first the offset of expected[0] in the block.
+ */
+static inphi_status_t spica_mcu_direct_download_verify(
+    uint32_t        die,
+    uint32_t        block,
+    uint32_t        block_addr,
+    uint32_t        first,
+    const uint32_t* expected,
+    uint32_t        num_words)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t data[SPICA_MCU_VERIFY_CHUNK_WORDS];
+
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_VERIFY);
 
-            rdata = rdata >> 8;            
+    for(uint32_t i = 0; i < num_words; i += SPICA_MCU_VERIFY_CHUNK_WORDS)
+    {
+        uint32_t n = num_words - i;
+        if(n > SPICA_MCU_VERIFY_CHUNK_WORDS)
+        {
+            n = SPICA_MCU_VERIFY_CHUNK_WORDS;
+        }
 
-            if (rdata >= (1 << 7)) 
+        status |= spica_mcu_pif_read(die, block_addr + (first + i)*4, data, n);
+        if(status != INPHI_OK)
+        {
+            INPHI_CRIT("Block %lu: read back failed at offset %lu\n", block, first + i);
+            goto exit;
+        }
+
+        for(uint32_t j = 0; j < n; j++)
+        {
+            if(data[j] != expected[i + j])
             {
-                rdata -= (1 << 8);
+                INPHI_CRIT("Block %lu at 0x%08lx: word %lu does not match (programmed=0x%08lx, read=0x%08lx)!\n",
+                           block, block_addr, first + i + j, expected[i + j], data[j]);
+                status |= INPHI_ERROR;
+                goto exit;
             }
-
-            vga2_gain[i] = rdata + 128;
         }
-
     }
-#endif // defined(INPHI_REMOVE_PMR)
 
-    status |= spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-        return status;
-    }
+exit:
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_VERIFY);
 
     return status;
 }
 
-inphi_status_t spica_rx_dsp_ffe_taps_query(
-    uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    int16_t ffe_taps[SPICA_RX_DSP_SLICES*SPICA_RX_DSP_NUM_FFE_TAPS])
+/* Program the app fw directly from the API
+ */
+inphi_status_t spica_mcu_direct_download_image_impl(
+    uint32_t        die,
+    const uint32_t* image,
+    uint32_t        image_length,
+    bool            verify,
+    inphi_status_t (*pif_write)(uint32_t, uint32_t, const uint32_t*, uint32_t))
 {
+    uint32_t offset = 0;
+    uint32_t block = 0;
     inphi_status_t status = INPHI_OK;
 
-    int16_t rdata = 0;
-    uint16_t sto_acc;
-    int16_t ffe_prescale[SPICA_RX_DSP_SLICES*(SPICA_RX_DSP_NUM_FFE_TAPS-1)];
-    int i, j, k;
-    uint16_t constrained;
-    bool fw_lock = false;
-
-    if (SPICA_INTF_SRX == intf)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("Invalid interface %s\n", spica_dbg_translate_intf(intf));
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
-
-    if (intf == SPICA_INTF_ORX)
-    {
-         fw_lock = SPICA_ORX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    else
-    {
-         fw_lock = SPICA_MRX_FW_STATUS__LOCKED__READ(die, channel);
-    }
-    if(!fw_lock)
-    {
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        INPHI_CRIT("%s Channel %lu FW not locked. Cannot query FFE Taps.\n", spica_dbg_translate_intf(intf), channel);
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1) 
-        return INPHI_ERROR;
-    }
-
-    status |= spica_rx_dsp_acquire_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
+    status |= spica_mcu_direct_download_prepare(die);
+    if(status != INPHI_OK)
     {
         return status;
     }
 
-    if(intf == SPICA_INTF_ORX)
-    {
-        constrained = SPICA_ORX_CP_FFE_CFG__CON__READ(die, channel);
-
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
-
-        // "Choose FFE based on mode"
-        if (SPICA_ORX_CP_FFE_CFG__MODE__READ(die, channel))
-        {
-            // "9x FFE Independent, s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
-            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-            {
-                // INPHI_NOTE("Reading interleave %d data\n", i);
-                for (j=0; j<3; j++)  // ID, i.e. row number within slice
-                {
-                    for (k=0; k<3; k++)  // IDX, i.e. accumulator within the row
-                    {
-                        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x030 + 3*i + j);
-                        sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, k);
-                        SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                        rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
-
-                        if(j==1 && k==0 && constrained)
-                        {
-                            //# post1 handled specially
-                            rdata = rdata >> 7;
-                            if (rdata >= (1 << 8)) 
-                            {
-                                rdata -= (1 << 9);
-                            }
-                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + 2] + rdata;  // pre1 + post1 in constrained mode
-                        }
-                        else
-                        {
-                            rdata = rdata >> 9;
-                            if (rdata >= (1 << 6)) 
-                            {
-                                rdata -= (1 << 7);
-                            }
-                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = rdata;
-                        }
-                    }
-                }
-            }
-        }   
-        else
-        {
-            uint16_t ffe_ca[SPICA_RX_DSP_NUM_FFE_TAPS-1];
-            // "9x FFE Common (CA), s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
-            //  "Actual ranges: taps -3/+3/+4/+5/+6: -15...+15; taps -2/+2: -31...+31; taps -1/+1: -63...+63)"
-            sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, 0);
-            for(i=0; i<9; i++)
-            {
-                sto_acc = SPICA_ORX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x120 + i);
-                SPICA_ORX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                rdata = SPICA_ORX_CP_STORAGE_DATA1__READ(die, channel);
-                if (i==3 && constrained==1)
-                {  
-                    // post1 handled specially
-                    rdata = rdata >> 7;
-                    if (rdata >= (1 << 8)) 
-                    {
-                        rdata -= (1 << 9);
-                    }
-                    ffe_ca[i] = ffe_ca[2] + rdata;  // pre1 + post1 in constrained mode
-                }
-                else
-                {
-                    rdata = rdata >> 9;
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
-                    if (rdata >= (1 << 6)) 
-                    {
-                        rdata -= (1 << 7);
-                    }
-                    ffe_ca[i] = rdata;
-                }
-            }
-            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-            {
-                for (j=0; j<(SPICA_RX_DSP_NUM_FFE_TAPS-1); j++) 
-                {
-                    ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j] = ffe_ca[j];
-                }
-            }
-        }
-    }
-#if !defined(INPHI_REMOVE_PMR)
-    else if(intf == SPICA_INTF_MRX)
+    //step through every block in the image...
+    while(offset < image_length)
     {
-        constrained = SPICA_MRX_CP_FFE_CFG__CON__READ(die, channel);
-
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__RBW__SET(0, 0); // always doing reads
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__FORMAT__SET(sto_acc, 0); // 24b accesses (sometimes ignored by H/W based on ID)
-        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ACCESS__SET(sto_acc, 1); // always doing an access
-
-        // "Choose FFE based on mode"
-        if (SPICA_MRX_CP_FFE_CFG__MODE__READ(die, channel))
-        {
-            // "9x FFE Independent, s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
-            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-            {
-                // INPHI_NOTE("Reading interleave %d data\n", i);
-                for (j=0; j<3; j++)  // ID, i.e. row number within slice
-                {
-                    for (k=0; k<3; k++)  // IDX, i.e. accumulator within the row
-                    {
-                        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x030 + 3*i + j);
-                        sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, k);
-                        SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                        rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
+        //...grabbing the block header...
 
-                        if(j==1 && k==0 && constrained)
-                        {
-                            //# post1 handled specially
-                            rdata = rdata >> 7;
-                            if (rdata >= (1 << 8)) 
-                            {
-                                rdata -= (1 << 9);
-                            }
-                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + 2] + rdata;  // pre1 + post1 in constrained mode
-                        }
-                        else
-                        {
-                            rdata = rdata >> 9;
-                            if (rdata >= (1 << 6)) 
-                            {
-                                rdata -= (1 << 7);
-                            }
-                            ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j*3 + k] = rdata;
-                        }
-                    }
-                }
-            }
-        }   
-        else
+        //addr in spica mem where the block needs to go
+        uint32_t block_addr = image[offset++];
+        //block size in 32b words
+        uint32_t num_32b_words = image[offset++];
+        
+        if(num_32b_words == 0)
         {
-            uint16_t ffe_ca[SPICA_RX_DSP_NUM_FFE_TAPS-1];
-            // "9x FFE Common (CA), s32.25, DACs are s8.0 sign-magnitude MSB=0 is positive (i.e. -127...+127)"
-            //  "Actual ranges: taps -3/+3/+4/+5/+6: -15...+15; taps -2/+2: -31...+31; taps -1/+1: -63...+63)"
-            sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__IDX__SET(sto_acc, 0);
-            for(i=0; i<9; i++)
-            {
-                sto_acc = SPICA_MRX_CP_STORAGE_ACCESS__ID__SET(sto_acc, 0x120 + i);
-                SPICA_MRX_CP_STORAGE_ACCESS__WRITE(die, channel, sto_acc);
-                rdata = SPICA_MRX_CP_STORAGE_DATA1__READ(die, channel);
-                if (i==3 && constrained==1)
-                {  
-                    // post1 handled specially
-                    rdata = rdata >> 7;
-                    if (rdata >= (1 << 8)) 
-                    {
-                        rdata -= (1 << 9);
-                    }
-                    ffe_ca[i] = ffe_ca[2] + rdata;  // pre1 + post1 in constrained mode
-                }
-                else
-                {
-                    rdata = rdata >> 9;
-
-                    if (rdata >= (1 << 6)) 
-                    {
-                        rdata -= (1 << 7);
-                    }
-                    ffe_ca[i] = rdata;
-                }
-            }
-            for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-            {
-                for (j=0; j<(SPICA_RX_DSP_NUM_FFE_TAPS-1); j++) 
-                {
-                    ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS-1) + j] = ffe_ca[j];
-                }
-            }
+            INPHI_NOTE("\n");
+            INPHI_CRIT("Malformed image. offset=%lu num_words=%lu\n", offset, num_32b_words);
+            status |= INPHI_ERROR;
+            goto exit;
+        }
+
+        //memory_set requires length in number of 32b words (num of indexes) instead of in bytes
+        status |= pif_write(die, block_addr, image+offset, num_32b_words);
+        if(status != INPHI_OK) goto exit;
+
+        // verify the block if requested to do so...
+        if (verify)
+        {
+            status |= spica_mcu_direct_download_verify(die, block, block_addr, 0, image+offset, num_32b_words);
+            if(status != INPHI_OK) goto exit;
         }
-    } 
-#endif // defined(INPHI_REMOVE_PMR)
 
-    // "Scale FFE"
-    for (i=0; i<SPICA_RX_DSP_SLICES; i++)
-    {
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 0] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 0]*1000 / 120.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 1] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 1]*1000 / 124.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 2] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 2]*1000 / 105.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 3] = 1000;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 4] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 3]*1000 / 105.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 5] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 4]*1000 / 124.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 6] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 5]*1000 / 120.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 7] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 6]*1000 / 120.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 8] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 7]*1000 / 120.0;
-        ffe_taps[i*SPICA_RX_DSP_NUM_FFE_TAPS + 9] = ffe_prescale[i*(SPICA_RX_DSP_NUM_FFE_TAPS - 1) + 8]*1000 / 120.0;
-    }   
- 
-    spica_rx_dsp_release_estimation_semaphore(die, channel, intf);
-    if (status  != INPHI_OK)
-    {
-        return status;
+        offset += num_32b_words;
+        block++;
     }
 
-    return status;
+exit:
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
+    return status;
 }
 
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS == 1)
-// Translate DSP FFE Tap indices into text
-const char* spica_rx_dsp_dbg_translate_ffe_tap_index(
-    e_spica_ffe_taps tap_index)
+// Program the app fw directly from the API without an EEPROM
+inphi_status_t spica_mcu_direct_download_image(
+    uint32_t die,
+    const uint32_t* image,
+    uint32_t image_length,
+    bool verify)
 {
-    switch(tap_index)
-    {
-        case SPICA_FFE_TAP_PRE_CURSOR_3:  return("FFE_TAP_PRE_CURSOR_3");
-        case SPICA_FFE_TAP_PRE_CURSOR_2:  return("FFE_TAP_PRE_CURSOR_2");
-        case SPICA_FFE_TAP_PRE_CURSOR_1:  return("FFE_TAP_PRE_CURSOR_1");
-        case SPICA_FFE_TAP_MAIN_CURSOR:   return("FFE_TAP_MAIN_CURSOR");
-        case SPICA_FFE_TAP_POST_CURSOR_1: return("FFE_TAP_POST_CURSOR_1");
-        case SPICA_FFE_TAP_POST_CURSOR_2: return("FFE_TAP_POST_CURSOR_2");
-        case SPICA_FFE_TAP_POST_CURSOR_3: return("FFE_TAP_POST_CURSOR_3");
-        case SPICA_FFE_TAP_POST_CURSOR_4: return("FFE_TAP_POST_CURSOR_4");
-        case SPICA_FFE_TAP_POST_CURSOR_5: return("FFE_TAP_POST_CURSOR_5");
-        case SPICA_FFE_TAP_POST_CURSOR_6: return("FFE_TAP_POST_CURSOR_6");
-        default: break;
-    }
-    return "Invalid FFE Tap Index";
+    return spica_mcu_direct_download_image_impl(die, image, image_length, verify, spica_mcu_pif_write);
 }
 
-inphi_status_t spica_rx_dsp_ffe_taps_print(
+// Program the app fw directly from the API without an EEPROM via broadcast
+inphi_status_t spica_mcu_direct_download_image_bcast(
     uint32_t die,
-    uint32_t channel,
-    e_spica_intf intf,
-    int16_t ffe_taps[SPICA_RX_DSP_SLICES*SPICA_RX_DSP_NUM_FFE_TAPS])
+    inphi_status_t (*get_firmware)(const uint32_t** ptr, uint32_t* length))
 {
-    inphi_status_t status = INPHI_OK;
+    const uint32_t* image_ptr = NULL;
+    uint32_t        image_len = 0;
 
-    uint16_t interleave;
-    uint16_t tap_index;
-    
-    INPHI_NOTE("\n");
-    INPHI_NOTE("%s Channel %lu: DSP FFE Tap Values\n", spica_dbg_translate_intf(intf), channel);
-    INPHI_NOTE("==================================\n");
-    
-    INPHI_NOTE("Interleave | PRE3 | PRE2 | PRE1 | MAIN | PST1 | PST2 | PST3 | PST4 | PST5 | PST6 |\n");
-    INPHI_NOTE("-----------+------+------+------+------+------+------+------+------+------+------+\n");
-    for (interleave = 0; interleave < 16; interleave++)
-    {
-        INPHI_NOTE("%4s%2d %4s|", "", interleave+1, "");
-        for (tap_index = 0; tap_index < 10; tap_index++)
-        {
-           INPHI_NOTE("%6d|", (int16_t)ffe_taps[interleave*10+tap_index]);
-        }
-        INPHI_NOTE("\n");
-    }
+    inphi_status_t status = get_firmware(&image_ptr, &image_len);
+    status |= spica_mcu_direct_download_image_impl(die, image_ptr, image_len, false, spica_mcu_pif_write_bcast);
 
     return status;
 }
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
-
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && (INPHI_HAS_DIAGNOSTIC_DUMPS==1)
-#endif // defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
 
-/*
- * Get the first few pulse response values from the FW info buffer.
- */
-inphi_status_t spica_srx_pulse_resp_query(
+// This is a wrapper method for testing broadcasting a particular
+// firmware image to multiple IPs.
+inphi_status_t spica_mcu_direct_download_image_bcast_buffer(
     uint32_t die,
-    uint32_t channel,
-    int32_t* resp_values,
-    int32_t* len)
+    const uint32_t* image_ptr,
+    uint32_t length)
 {
-    inphi_status_t status = INPHI_OK;
+    return spica_mcu_direct_download_image_impl(die, image_ptr, length, false, spica_mcu_pif_write_bcast);
+}
 
-    SPICA_LOCK(die);
+/**
+ * Compressed image format, see spica_mcu_download_firmware_lz()
+ * @private
+ */
+#define SPICA_LZ_MAGIC          0x5a4c5053  // "SPLZ"
+#define SPICA_LZ_MAGIC_CRC      0x435a5053  // "SPZC", a CRC-32 word follows every block
+#define SPICA_LZ_WINDOW_SIZE    4096
+#define SPICA_LZ_MIN_MATCH      3
+#define SPICA_LZ_CHUNK_WORDS    64
 
-    // Check the f/w lock status. If it's not locked don't attempt
-    // to query the f/w because it may timeout
-    bool locked = SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel);
+/**
+ * Decoder state of a compressed image being streamed
+ * @private
+ */
+typedef struct
+{
+    const uint8_t* src;
+    uint32_t       src_length;
+    uint32_t       src_pos;
+    uint32_t       flags;       // token flags, a sentinel bit above the unread ones
+    uint32_t       match_dist;  // distance back into the window of the match being copied
+    uint32_t       match_left;  // bytes of the match still to copy
+    uint32_t       win_pos;
+} spica_lz_stream_t;
 
-    if(!locked)
-    {
-        *len = 0;
-        INPHI_CRIT("SRX not locked on channel %lu, cannot fetch pulse response\n", channel);
-        status = INPHI_ERROR;
-        goto done;
-    }
+// History of the last bytes decoded, shared by all dies (downloads run one at a time)
+static uint8_t spica_lz_window[SPICA_LZ_WINDOW_SIZE];
 
-    //pulse response
-    status |= spica_msg_srx_pulse_resp_request(die, channel, resp_values, *len);
-    if(status)
+// Get the next decompressed byte, false at the end of the input or on a corrupt input
+static bool spica_lz_get_byte(
+    spica_lz_stream_t* lz,
+    uint8_t*           byte)
+{
+    if(lz->match_left == 0)
     {
-        INPHI_CRIT("Failed waiting for the pulse response from the h/w\n");
-        goto done;
+        if(lz->flags <= 1)
+        {
+            if(lz->src_pos >= lz->src_length)
+            {
+                return false;
+            }
+            lz->flags = 0x100 | lz->src[lz->src_pos++];
+        }
+
+        if(lz->flags & 1)
+        {
+            // literal
+            if(lz->src_pos >= lz->src_length)
+            {
+                return false;
+            }
+            *byte = lz->src[lz->src_pos++];
+            lz->flags >>= 1;
+            spica_lz_window[lz->win_pos] = *byte;
+            lz->win_pos = (lz->win_pos + 1) & (SPICA_LZ_WINDOW_SIZE - 1);
+            return true;
+        }
+
+        // match: 12 bit distance - 1, 4 bit length - SPICA_LZ_MIN_MATCH
+        if(lz->src_pos + 2 > lz->src_length)
+        {
+            return false;
+        }
+        uint32_t token = lz->src[lz->src_pos] | ((uint32_t)lz->src[lz->src_pos + 1] << 8);
+        lz->src_pos += 2;
+        lz->flags >>= 1;
+        lz->match_dist = (token & 0xfff) + 1;
+        lz->match_left = (token >> 12) + SPICA_LZ_MIN_MATCH;
     }
 
-done:
-    SPICA_UNLOCK(die);
+    *byte = spica_lz_window[(lz->win_pos - lz->match_dist) & (SPICA_LZ_WINDOW_SIZE - 1)];
+    lz->match_left--;
+    spica_lz_window[lz->win_pos] = *byte;
+    lz->win_pos = (lz->win_pos + 1) & (SPICA_LZ_WINDOW_SIZE - 1);
+    return true;
+}
 
-    return status;
+// Get the next decompressed 32 bit word, stored little endian
+static bool spica_lz_get_word(
+    spica_lz_stream_t* lz,
+    uint32_t*          word)
+{
+    uint8_t byte;
+
+    *word = 0;
+    for(uint32_t i = 0; i < 32; i += 8)
+    {
+        if(!spica_lz_get_byte(lz, &byte))
+        {
+            return false;
+        }
+        *word |= (uint32_t)byte << i;
+    }
+    return true;
 }
 
-#if defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
-inphi_status_t spica_srx_pulse_resp_query_dump_range(uint32_t die, uint32_t start, uint32_t end)
+/* Program a compressed app fw image directly from the API, decompressing
+ * it a chunk at a time into pif_write
+ */
+inphi_status_t spica_mcu_direct_download_image_lz_impl(
+    uint32_t       die,
+    const uint8_t* lz_image,
+    uint32_t       lz_length,
+    bool           verify,
+    inphi_status_t (*pif_write)(uint32_t, uint32_t, const uint32_t*, uint32_t))
 {
     inphi_status_t status = INPHI_OK;
-    e_spica_package_type package = spica_package_get_type(die);
+    spica_lz_stream_t lz;
+    uint32_t chunk[SPICA_LZ_CHUNK_WORDS];
+    uint32_t magic;
+    uint32_t image_length;
+    uint32_t offset = 0;
+    uint32_t block = 0;
 
-    SPICA_LOCK(die);
+    // The header is stored uncompressed, magic then the image length in 32b words
+    if((lz_image == NULL) || (lz_length < 8))
+    {
+        INPHI_CRIT("Not a compressed image\n");
+        return INPHI_ERROR;
+    }
+    magic = lz_image[0] | ((uint32_t)lz_image[1] << 8) | ((uint32_t)lz_image[2] << 16) | ((uint32_t)lz_image[3] << 24);
+    if((magic != SPICA_LZ_MAGIC) && (magic != SPICA_LZ_MAGIC_CRC))
+    {
+        INPHI_CRIT("Not a compressed image\n");
+        return INPHI_ERROR;
+    }
+    image_length = lz_image[4] | ((uint32_t)lz_image[5] << 8) | ((uint32_t)lz_image[6] << 16) | ((uint32_t)lz_image[7] << 24);
 
-    INPHI_NOTE(
-        "+---------------------------------------------------------------+\n"
-        "| HRX Pulse Response                                            |\n"
-        "+---------+--------+--------+--------+--------+--------+--------+\n"
-        "| Channel |     -3 |     -2 |     -1 |      0 |      1 |      2 |\n"
-        "+---------+--------+--------+--------+--------+--------+--------+\n");
+    INPHI_MEMSET(&lz, 0, sizeof(lz));
+    lz.src        = lz_image + 8;
+    lz.src_length = lz_length - 8;
 
-    SPICA_FOR_CHANNEL_IN_CHANNELS(package, SPICA_INTF_SRX)
+    status |= spica_mcu_direct_download_prepare(die);
+    if(status != INPHI_OK)
     {
-        if(channel < start || channel > end)
-        {
-            continue;
-        }
-        //Grab pulse response for Enabled channels only
-        if(!SPICA_SRX_RULES_0__CHANNEL_ENABLE__READ(die, channel))
-        {
-            continue;
-        }
+        return status;
+    }
 
-        INPHI_NOTE("| %7lu |", channel);
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
-        int32_t resp[6];
-        int32_t len = sizeof(resp)/sizeof(resp[0]);
-        status |= spica_srx_pulse_resp_query(die, channel, resp, &len);
-        if(INPHI_OK != status)
-            goto done;
+    //step through every block in the image...
+    while(offset < image_length)
+    {
+        uint32_t block_addr;
+        uint32_t num_32b_words;
+        uint32_t block_offset = 0;
+        uint32_t crc = 0;
 
-        for(int32_t i=0; i<len; i++)
+        if(!spica_lz_get_word(&lz, &block_addr) || !spica_lz_get_word(&lz, &num_32b_words) ||
+           (num_32b_words == 0) || (image_length - offset < 2) ||
+           (num_32b_words > image_length - offset - 2))
         {
-            INPHI_NOTE("%8lu|", resp[i]);
+            INPHI_CRIT("Malformed image. offset=%lu\n", offset);
+            status |= INPHI_ERROR;
+            goto exit;
         }
-        INPHI_NOTE("\n");
-    }
+        offset += 2;
 
-    INPHI_NOTE("+---------+--------+--------+--------+--------+--------+--------+\n");
+        //...and handing it to pif_write as it is decompressed
+        while(num_32b_words > 0)
+        {
+            uint32_t n = (num_32b_words < SPICA_LZ_CHUNK_WORDS) ? num_32b_words : SPICA_LZ_CHUNK_WORDS;
 
-done:
-    SPICA_UNLOCK(die);
+            for(uint32_t i = 0; i < n; i++)
+            {
+                if(!spica_lz_get_word(&lz, &chunk[i]))
+                {
+                    INPHI_CRIT("Truncated image. offset=%lu\n", offset + i);
+                    status |= INPHI_ERROR;
+                    goto exit;
+                }
+            }
 
-    return status;
-}
+#if defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+            // Takes a few cycles per word on the host CRC unit, next to the bus time
+            if(magic == SPICA_LZ_MAGIC_CRC)
+            {
+                crc = spica_crc32(crc, chunk, n);
+            }
+#endif
 
-inphi_status_t spica_srx_pulse_resp_query_dump(uint32_t die)
-{
-    return spica_srx_pulse_resp_query_dump_range(die, 0, 0xff);
-}
+            status |= pif_write(die, block_addr + block_offset*4, chunk, n);
+            if(status != INPHI_OK) goto exit;
 
-#endif //defined(INPHI_HAS_DIAGNOSTIC_DUMPS) && INPHI_HAS_DIAGNOSTIC_DUMPS == 1
-/** @file mcu.c
- ****************************************************************************
- *
- * @brief
- *     This module contains the implementation of the interface to the
- *     embedded MCU.
- *
- ****************************************************************************
- * @author
- *    This file contains information that is proprietary and confidential to
- *    Inphi Corporation.
- *
- *    This file can be used under the terms of the Inphi Software License
- *    Agreement. You should have received a copy of the license with this file,
- *    if not please contact your Inphi support staff.
- *
- *    Copyright (C) 2006-2021 Inphi Corporation, Inc. All rights reserved.
- *
- *    API Version Number: 1.2.0.929
- ***************************************************************************/
+            // verify the chunk if requested to do so...
+            if (verify)
+            {
+                status |= spica_mcu_direct_download_verify(die, block, block_addr, block_offset, chunk, n);
+                if(status != INPHI_OK) goto exit;
+            }
+
+            block_offset  += n;
+            num_32b_words -= n;
+            offset        += n;
+        }
+
+        // ...then checking what was sent against the CRC-32 from the build
+        if(magic == SPICA_LZ_MAGIC_CRC)
+        {
+            uint32_t expected_crc;
+
+            if(!spica_lz_get_word(&lz, &expected_crc))
+            {
+                INPHI_CRIT("Truncated image. offset=%lu\n", offset);
+                status |= INPHI_ERROR;
+                goto exit;
+            }
+#if defined(INPHI_HAS_HW_CRC32) && (INPHI_HAS_HW_CRC32==1)
+            if(crc != expected_crc)
+            {
+                INPHI_CRIT("Block %lu at 0x%08lx: CRC-32 mismatch (expected=0x%08lx, calculated=0x%08lx)\n",
+                           block, block_addr, expected_crc, crc);
+                status |= INPHI_ERROR;
+                goto exit;
+            }
+#endif
+        }
+        block++;
+    }
 
-#if defined(INPHI_HAS_FILESYSTEM)
-#include <string.h> // String methods for progrmaming ucode from disk
-#include <stdio.h>  // File IO methods for programming ucode from disk
-#endif // INPHI_HAS_FILESYSTEM
+exit:
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
-/** Max debug buffer length for query_print */
-#define SPICA_MCU_DEBUG_BUFFER_MAX_LENGTH 2048
+    return status;
+}
 
-/**
- * Simple function to decode the top bytes of the BOOTVER register
- * 
- * These are the valid firmware modes:
- *
- *   0xBCDD (boot upgrade/direct download)
- *   0xACC0 (Application code)
- * 
- * @param bootver [I] - BOOTVER >> 16
- * 
- * @return mode the FW is running in
- *
- * @private
- */
-e_spica_fw_mode spica_mcu_decode_bootver(
-    uint32_t bootver)
+// Jump into the application image just programmed
+static void spica_mcu_release_application(
+    uint32_t die)
 {
-    if(bootver == 0xACC0)
-    {
-        return SPICA_FW_MODE_APPLICATION;
-    }
-    return SPICA_FW_MODE_UNKNOWN;
+    // Switch to the application bank
+    SPICA_MCU_GEN_CFG__STATVECTOR_SEL__RMW(die, 0x1);
+
+    // Reset the MCU
+    SPICA_MCU_RESET__PROCRST__RMW(die, 0x1);
+    spica_mcu_msg2_cache_invalidate(die);
+
+    // Now bring it out of runstall
+    SPICA_MCU_GEN_CFG__RUNSTALL__RMW(die, 0x0);
 }
 
-/**
- * This method is used to get the fw mode
- */
-inphi_status_t spica_mcu_fw_mode_query(
-    uint32_t       die,
-    e_spica_fw_mode* mode)
+static inphi_status_t spica_mcu_start_application(
+    uint32_t die)
 {
     inphi_status_t status = INPHI_OK;
 
-    uint16_t bootver = 0;
-    bootver = SPICA_MCU_FW_MODE__READ(die);
-    *mode = spica_mcu_decode_bootver(SPICA_MCU_FW_MODE__FW_MODE__GET(bootver));
+    SPICA_LOCK(die);
+
+    spica_mcu_release_application(die);
+
+    // Finally wait for it to jump into application mode
+    status |= spica_mcu_block_application_mode(die, 2000);
+
+    SPICA_UNLOCK(die);
 
     return status;
 }
 
-/*
- * This method blocks until the MCU is in application mode or
- * the until the timeout expires.
- */
-inphi_status_t spica_mcu_block_application_mode(
-    uint32_t die,
-    int      timeout_in_ms)
+// Program a compressed app fw image and jump into it
+inphi_status_t spica_mcu_download_firmware_lz(
+    uint32_t       die,
+    const uint8_t* lz_image,
+    uint32_t       lz_length,
+    bool           verify)
 {
     inphi_status_t status = INPHI_OK;
-    e_spica_fw_mode fw_mode = SPICA_FW_MODE_UNKNOWN;
-    int i = 0;
-
-    if(timeout_in_ms < 0) {
-        INPHI_CRIT("timeout needs to be >= 0\n");
-        return INPHI_ERROR;
-    }
 
-    SPICA_LOCK(die);
+    // take part out of global reset
+    SPICA_MMD30_RESET_CFG__WRITE(die, 0x0);
 
-    // Turn on the PC trace
-    SPICA_MCU_GEN_CFG__PDEBUG_EN__RMW(die, 1);
+    status |= spica_mcu_direct_download_image_lz_impl(die, lz_image, lz_length, verify, spica_mcu_pif_write);
 
-    for(i = 0; i <= timeout_in_ms; i++)
-    {
-        status |= spica_mcu_fw_mode_query(die, &fw_mode);
-        if(status != INPHI_OK) return status;
-        
-        if (fw_mode == SPICA_FW_MODE_APPLICATION)
-        {
-            /* we can proceed now that the FW is in application mode */
-            break;
-        }
-        else if(0 == fw_mode)
-        {
-            /* Still waiting for application f/w to start */
-            INPHI_MDELAY(1);
-            continue;
-        }
-        else
-        {
-            INPHI_CRIT("Invalid FW mode: 0x%x\n", fw_mode);
-            goto error;
-        }
-    }
-    if((i >= timeout_in_ms) && (fw_mode != SPICA_FW_MODE_APPLICATION))
+    if(status == INPHI_OK)
     {
-        INPHI_CRIT("Timed-out waiting for MCU to run Application code, timeout=%d (ms)\n", timeout_in_ms);
-        goto error;
+        status |= spica_mcu_start_application(die);
     }
-    goto done;
-error:
-    status |= INPHI_ERROR;
-done:
-    SPICA_UNLOCK(die);
 
     return status;
 }
 
 /**
- * Read from the memory through the inbound PIF interface
+ * Words read at a time from a firmware source, two chunks are in RAM
+ * @private
  */
-inphi_status_t spica_mcu_pif_read(
-    uint32_t  die,
-    uint32_t  addr,
-    uint32_t* buffer,
-    uint32_t  num_words)
+#define SPICA_MCU_SOURCE_CHUNK_WORDS 32
+
+/* Request the chunk at offset from a firmware source */
+static inphi_status_t spica_mcu_source_start(
+    const spica_fw_source_t* source,
+    uint32_t                 offset,
+    uint32_t*                buf,
+    uint32_t                 image_length,
+    uint32_t*                num_words)
 {
-#if defined(INPHI_GUI)
-    // If we're running in the GUI use the optimized
-    // Inbound PIF methods for better performance.
-    extern inphi_status_t inphi_gui_mcu_pif_read(
-        uint32_t        die,
-        uint32_t        addr,
-        const uint32_t* buffer,
-        uint32_t        num_words);
-    return inphi_gui_mcu_pif_read(die, addr, buffer, num_words);
-#endif
+    *num_words = image_length - offset;
+    if(*num_words > SPICA_MCU_SOURCE_CHUNK_WORDS)
+    {
+        *num_words = SPICA_MCU_SOURCE_CHUNK_WORDS;
+    }
+
+    return source->read_start(offset, buf, *num_words, source->user_data);
+}
 
+/* Program an app fw image read from a source, the next chunk is
+ * requested before the current one is written
+ */
+static inphi_status_t spica_mcu_direct_download_image_source_impl(
+    uint32_t                 die,
+    const spica_fw_source_t* source,
+    uint32_t                 image_length,
+    bool                     verify)
+{
     inphi_status_t status = INPHI_OK;
-    uint16_t temp = 0;
-    uint16_t cfg = 0;
-    uint16_t i;
-    int guard = 1000;
-    SPICA_LOCK(die);
+    uint32_t chunk[2][SPICA_MCU_SOURCE_CHUNK_WORDS];
+    uint32_t cur = 0;
+    uint32_t n = 0;
+    uint32_t next_n = 0;
+    uint32_t fetched = 0;
+    uint32_t offset = 0;
+    bool     in_flight = false;
+    // Block being programmed, header words first
+    uint32_t hdr_words = 2;
+    uint32_t block = 0;
+    uint32_t block_addr = 0;
+    uint32_t block_words = 0;
+    uint32_t block_offset = 0;
 
-    while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && (guard > 0))
+    if((source == NULL) || (source->read_start == NULL) || (image_length == 0))
     {
-        guard--;
-        continue;
+        INPHI_CRIT("ERROR: No image source\n");
+        return INPHI_ERROR;
     }
 
-    if(guard <= 0)
+    status |= spica_mcu_direct_download_prepare(die);
+    if(status != INPHI_OK)
     {
-        INPHI_CRIT("Memory access failure on die %lu\n", die);
-        status |= INPHI_ERROR;
-        goto exit;
+        return status;
     }
-    
-    cfg = SPICA_MCU_INBPIF_CFG0__READ(die);
-    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 1);
-    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 3);
-    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
 
-    //setup the controller, do NOT change the order of these accesses
-    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
-    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 1);
-    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 2); //32b at a time
-    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
+    SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
-    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
-    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
+    status |= spica_mcu_source_start(source, 0, chunk[0], image_length, &next_n);
+    in_flight = true;
+    fetched = next_n;
 
-    for(i = 0; i < num_words; ++i)
+    while((status == INPHI_OK) && (offset < image_length))
     {
-        guard = 1000;
-#if (!defined(INPHI_HAS_INBPIF_READ_POLLING)) || \
-    (defined(INPHI_HAS_INBPIF_READ_POLLING) && (INPHI_HAS_INBPIF_READ_POLLING == 1))
-        while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && guard > 0)
+        const uint32_t* words = chunk[cur];
+        uint32_t i = 0;
+
+        // Wait for the chunk in flight...
+        if(source->read_wait)
         {
-            guard--;
-            continue;
+            status |= source->read_wait(source->user_data);
         }
-            
-        if(guard <= 0)
+        in_flight = false;
+        n = next_n;
+
+        // ...and request the next one so it loads while this one is written
+        if((status == INPHI_OK) && (fetched < image_length))
         {
-            INPHI_CRIT("Memory access failure on die %lu\n", die);
-            status |= INPHI_ERROR;
+            status |= spica_mcu_source_start(source, fetched, chunk[cur ^ 1], image_length, &next_n);
+            in_flight = true;
+            fetched += next_n;
+        }
+        if(status != INPHI_OK)
+        {
+            INPHI_CRIT("Image source failed at offset %lu\n", offset);
+            goto exit;
         }
-#endif
-    
-        temp = SPICA_MCU_INBPIF_RDATA__READ(die);
-        buffer[i] = (uint32_t)temp;
-        temp = SPICA_MCU_INBPIF_RDATA__READ(die);
-        buffer[i] |= (uint32_t)temp << 16;
-        if(status) goto exit;
-    }
-
-exit:
-    //disable the read enable so that we can do register dumps once more
-    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
-    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
-    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
-
-    SPICA_UNLOCK(die);
 
-    return status;
-}
+        while(i < n)
+        {
+            uint32_t run;
 
-/**
- * Top bits of the MCU DRAM address space
- * @private
- */
-#define SPICA_MCU_DRAM_ADDR_MSW 0x5ff8
+            //grab the block header...
+            if(hdr_words == 2)
+            {
+                block_addr = words[i++];
+                hdr_words--;
+                continue;
+            }
+            if(hdr_words == 1)
+            {
+                block_words = words[i++];
+                hdr_words--;
+                block_offset = 0;
+                if((block_words == 0) || (block_words > image_length - (offset + i)))
+                {
+                    INPHI_CRIT("Malformed image. offset=%lu num_words=%lu\n", offset + i, block_words);
+                    status |= INPHI_ERROR;
+                    goto exit;
+                }
+                continue;
+            }
 
-/**
- * Write to the memory through the inbound PIF interface
- */
-inphi_status_t spica_mcu_pif_write(
-    uint32_t        die,
-    uint32_t        addr,
-    const uint32_t* buffer,
-    uint32_t        num_words)
-{
-#if defined(INPHI_GUI)
-    // If we're running in the GUI use the optimized
-    // Inbound PIF methods for better performance.
-    extern inphi_status_t inphi_gui_mcu_pif_write(
-        uint32_t        die,
-        uint32_t        addr,
-        const uint32_t* buffer,
-        uint32_t        num_words);
-    return inphi_gui_mcu_pif_write(die, addr, buffer, num_words);
-#endif
+            //...then write the part of the block held by this chunk
+            run = block_words - block_offset;
+            if(run > n - i)
+            {
+                run = n - i;
+            }
 
-    inphi_status_t status = INPHI_OK;
-    uint16_t cfg = 0;
-    uint16_t i;
-    int guard = 1000;
+            status |= spica_mcu_pif_write(die, block_addr + block_offset*4, &words[i], run);
+            if(status != INPHI_OK) goto exit;
 
-    SPICA_LOCK(die);
+            if (verify)
+            {
+                status |= spica_mcu_direct_download_verify(die, block, block_addr, block_offset, &words[i], run);
+                if(status != INPHI_OK) goto exit;
+            }
 
-    while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die) && (guard > 0))
-    {
-        guard--;
-        continue;
-    }
-    
-    if(guard <= 0)
-    {
-        INPHI_CRIT("Memory access failure on die %lu\n", die);
-        status |= INPHI_ERROR;
-        goto exit;
-    }
-    
-    cfg = SPICA_MCU_INBPIF_CFG0__READ(die);
-    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 0x81);
-    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 0x3);
-    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
+            block_offset += run;
+            i += run;
+            if(block_offset == block_words)
+            {
+                hdr_words = 2;
+                block++;
+            }
+        }
 
-    //setup the controller, do NOT change the order of these accesses
-    cfg = SPICA_MCU_INBPIF_CFG1__READ(die);
-    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
-    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 4); //32b at a time
-    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
+        offset += n;
+        cur ^= 1;
+    }
 
-    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
-    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
-    
-    // Turn on burst mode in case the end user supports it
-    SPICA_MCU_MDIO_CFG__WRITE(die, 1);
-    
-    for(i = 0; i < num_words; ++i)
+    if((status == INPHI_OK) && (hdr_words != 2))
     {
-        //while(SPICA_MCU_INBPIF_RSTATUS1__RD_PENDING__READ(die))
-        //    continue;
-    
-        //INPHI_NOTE("%08x\n", buffer[i]);
-        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)buffer[i]);
-        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)(buffer[i]>>16));
-        if(status) goto exit;
+        INPHI_CRIT("Truncated image. block=%lu\n", block);
+        status |= INPHI_ERROR;
     }
-    
 
 exit:
-    // Disable burst mode after the download has finished
-    SPICA_MCU_MDIO_CFG__WRITE(die, 0);
+    // Never return with a read still landing in chunk[]
+    if(in_flight && source->read_wait)
+    {
+        source->read_wait(source->user_data);
+    }
 
-    SPICA_UNLOCK(die);
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_DOWNLOAD);
 
     return status;
 }
 
-// Write to the memory through the inbound PIF interface
-inphi_status_t spica_mcu_pif_write_bcast(
-    uint32_t die,
-    uint32_t addr,
-    const uint32_t* buffer,
-    uint32_t num_words)
+// Program an app fw image read from a source and jump into it
+inphi_status_t spica_mcu_download_firmware_from_source(
+    uint32_t                 die,
+    const spica_fw_source_t* source,
+    uint32_t                 image_length,
+    bool                     verify)
 {
     inphi_status_t status = INPHI_OK;
-    uint16_t cfg = 0;
-    uint16_t i;
-
-    SPICA_LOCK(die);
 
-    cfg = 0;
-    cfg = SPICA_MCU_INBPIF_CFG0__CNTL__SET(cfg, 0x81);
-    cfg = SPICA_MCU_INBPIF_CFG0__PRIORITY__SET(cfg, 0x3);
-    SPICA_MCU_INBPIF_CFG0__WRITE(die, cfg);
+    // take part out of global reset
+    SPICA_MMD30_RESET_CFG__WRITE(die, 0x0);
 
-    //setup the controller, do NOT change the order of these accesses
-    cfg = 0;
-    cfg = SPICA_MCU_INBPIF_CFG1__RDENA__SET(cfg, 0);
-    cfg = SPICA_MCU_INBPIF_CFG1__STRIDE__SET(cfg, 4); //32b at a time
-    SPICA_MCU_INBPIF_CFG1__WRITE(die, cfg);
+    status |= spica_mcu_direct_download_image_source_impl(die, source, image_length, verify);
 
-    SPICA_MCU_INBPIF_ADDR0__WRITE(die, addr & 0xffff);
-    SPICA_MCU_INBPIF_ADDR1__WRITE(die, (addr >> 16) & 0xffff);
-    
-    // Turn on burst mode in case the end user supports it
-    SPICA_MCU_MDIO_CFG__WRITE(die, 1);
-    
-    for(i = 0; i < num_words; ++i)
+    if(status == INPHI_OK)
     {
-        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)buffer[i]);
-        SPICA_MCU_INBPIF_WDATA0__WRITE(die, (uint16_t)(buffer[i]>>16));
+        status |= spica_mcu_start_application(die);
     }
-    
-    // Disable burst mode after the download has finished
-    SPICA_MCU_MDIO_CFG__WRITE(die, 0);
-
-    SPICA_UNLOCK(die);
 
     return status;
 }
 
-#if defined(INPHI_HAS_DIRECT_DOWNLOAD)
-//include the app image, will not be compiled in without the proper defines
-
-/* Program the app fw directly from the API
- */
-inphi_status_t spica_mcu_direct_download_image_impl(
-    uint32_t        die,
+// Program the same app fw into several dies, broadcasting the blocks
+inphi_status_t spica_mcu_download_firmware_multi(
+    const uint32_t* dies,
+    uint32_t        num_dies,
+    const uint32_t* bcast_dies,
+    uint32_t        num_bcast,
     const uint32_t* image,
     uint32_t        image_length,
-    bool            verify,
-    inphi_status_t (*pif_write)(uint32_t, uint32_t, const uint32_t*, uint32_t))
+    bool            verify)
 {
-    uint32_t offset = 0;
     inphi_status_t status = INPHI_OK;
-    
-    SPICA_LOCK(die);
-
-    // Ensure everything is reset to a known state on each F/W download.
-    // The "hard" reset in from the pin and "soft" reset from the MMD08_PMA_CONTROL 
-    // register are logically "ORed" together so the MMD08 reset should be the 
-    // equivalent to toggling the reset pin.
-    SPICA_MMD08_PMA_CONTROL__WRITE(die, 0x8000);
-    INPHI_MDELAY(1);
-
-    // hit the runstall to stall the MCU when programming the f/w
-    // this will get reset when using reset_into_mode
-    SPICA_MCU_GEN_CFG__WRITE(die, 0x1001);
-
-    // Clear the FIRMWARE version when downloading
-    // so we can verify the app code restarts properly.
-    SPICA_MCU_FIRMWARE_REV0_OVL__WRITE(die, 0);
-    SPICA_MCU_FIRMWARE_REV1_OVL__WRITE(die, 0);
+    uint32_t locked = 0;
+    uint32_t offset = 0;
+    uint32_t block = 0;
+    uint32_t d;
 
-    // If we're currently in application mode then
-    // make sure we clear the FW_MODE register so that
-    // we don't hit a race condition when we restart
-    // the firmware.
-    SPICA_MCU_FW_MODE__WRITE(die, 0xACDD);
+    if((dies == NULL) || (num_dies == 0) || (image == NULL) || (bcast_dies == NULL && num_bcast != 0))
+    {
+        INPHI_CRIT("Invalid parameters\n");
+        return INPHI_ERROR;
+    }
 
-    // Zero initialize the IRAM and DRAM memories
-    // to ensure ECC bits are properly initialized
-    SPICA_MCU_DRAM_INIT_CFG__WRITE(die, 0x1fff);
-    SPICA_MCU_IRAM_INIT_CFG__WRITE(die, 0x8000);
-    // IRAM/DRAM memory will be initialized on a 0 to 1 transition 
-    SPICA_MCU_GEN_CFG__INIT_IRAM__WRITE(die, 0);
-    SPICA_MCU_GEN_CFG__INIT_DRAM__WRITE(die, 0);
-    SPICA_MCU_GEN_CFG__INIT_IRAM__WRITE(die, 1);
-    SPICA_MCU_GEN_CFG__INIT_DRAM__WRITE(die, 1);
+    // Hold every die for the whole download
+    for(locked = 0; locked < num_dies; locked++)
+    {
+        if(spica_lock(dies[locked]) != INPHI_OK)
+        {
+            status |= INPHI_ERROR;
+            goto exit;
+        }
+    }
 
-    // Wait for the init operation to finish
-    INPHI_MDELAY(2);
+    for(d = 0; d < num_dies; d++)
+    {
+        status |= spica_mcu_direct_download_prepare(dies[d]);
+    }
+    if(status != INPHI_OK) goto exit;
 
-    SPICA_UNLOCK(die);
+    SPICA_BOOT_ENTER(dies[0], SPICA_BOOT_PHASE_DOWNLOAD);
 
-    //step through every block in the image...
+    //step through every block in the image once for all dies
     while(offset < image_length)
     {
-        //...grabbing the block header...
-
-        //addr in spica mem where the block needs to go
         uint32_t block_addr = image[offset++];
-        //block size in 32b words
         uint32_t num_32b_words = image[offset++];
-        
+
         if(num_32b_words == 0)
         {
-            INPHI_NOTE("\n");
             INPHI_CRIT("Malformed image. offset=%lu num_words=%lu\n", offset, num_32b_words);
             status |= INPHI_ERROR;
             goto exit;
         }
 
-        //memory_set requires length in number of 32b words (num of indexes) instead of in bytes
-        status |= pif_write(die, block_addr, image+offset, num_32b_words);
+        if(num_bcast > 0)
+        {
+            for(d = 0; d < num_bcast; d++)
+            {
+                status |= spica_mcu_pif_write_bcast(bcast_dies[d], block_addr, image+offset, num_32b_words);
+            }
+        }
+        else
+        {
+            for(d = 0; d < num_dies; d++)
+            {
+                status |= spica_mcu_pif_write(dies[d], block_addr, image+offset, num_32b_words);
+            }
+        }
         if(status != INPHI_OK) goto exit;
 
-        // verify the block if requested to do so...
-        if (verify)
+        // Reads are per die, one die after the other
+        if(verify)
         {
-            for(uint32_t i = 0; i < num_32b_words; i+=1)
+            for(d = 0; d < num_dies; d++)
             {
-                uint32_t data[1] = {0};
-                uint32_t addr = block_addr + (i*4);
-                spica_mcu_pif_read(die, addr, data, 1);
-                
-                if(data[0] != image[offset + i])
+                status |= spica_mcu_direct_download_verify(dies[d], block, block_addr, 0, image+offset, num_32b_words);
+                if(status != INPHI_OK)
                 {
-                    INPHI_NOTE("Data at address %lu does not match (programmed=%lu, read=%lu)!\n", addr, image[offset+i], data[0]);
-                    status = INPHI_ERROR;
+                    INPHI_CRIT("Verify failed on die %lu\n", dies[d]);
                     goto exit;
                 }
             }
         }
 
         offset += num_32b_words;
+        block++;
     }
+    SPICA_BOOT_EXIT(dies[0], SPICA_BOOT_PHASE_DOWNLOAD);
 
-exit:
-
-    return status;
-}
-
-// Program the app fw directly from the API without an EEPROM
-inphi_status_t spica_mcu_direct_download_image(
-    uint32_t die,
-    const uint32_t* image,
-    uint32_t image_length,
-    bool verify)
-{
-    return spica_mcu_direct_download_image_impl(die, image, image_length, verify, spica_mcu_pif_write);
-}
-
-// Program the app fw directly from the API without an EEPROM via broadcast
-inphi_status_t spica_mcu_direct_download_image_bcast(
-    uint32_t die,
-    inphi_status_t (*get_firmware)(const uint32_t** ptr, uint32_t* length))
-{
-    const uint32_t* image_ptr = NULL;
-    uint32_t        image_len = 0;
+    // Let every MCU boot before waiting on the first one
+    for(d = 0; d < num_dies; d++)
+    {
+        spica_mcu_release_application(dies[d]);
+    }
+    for(d = 0; d < num_dies; d++)
+    {
+        if(spica_mcu_block_application_mode(dies[d], 2000) != INPHI_OK)
+        {
+            INPHI_CRIT("Die %lu did not reach application mode\n", dies[d]);
+            status |= INPHI_ERROR;
+        }
+    }
 
-    inphi_status_t status = get_firmware(&image_ptr, &image_len);
-    status |= spica_mcu_direct_download_image_impl(die, image_ptr, image_len, false, spica_mcu_pif_write_bcast);
+exit:
+    for(d = 0; d < locked; d++)
+    {
+        spica_unlock(dies[d]);
+    }
 
     return status;
 }
 
-// This is a wrapper method for testing broadcasting a particular
-// firmware image to multiple IPs.
-inphi_status_t spica_mcu_direct_download_image_bcast_buffer(
-    uint32_t die,
-    const uint32_t* image_ptr,
-    uint32_t length)
-{
-    return spica_mcu_direct_download_image_impl(die, image_ptr, length, false, spica_mcu_pif_write_bcast);
-}
-
 #if defined(INPHI_HAS_INLINE_APP_FW) && (INPHI_HAS_INLINE_APP_FW == 1)
 // This is a wrapper method, mostly for python testing to broadcast
 // the inlined f/w image to multiple ASICs
@@ -17415,6 +20350,7 @@ inphi_status_t spica_mcu_download_firmware(
 
         // Reset the MCU
         SPICA_MCU_RESET__PROCRST__RMW(die, 0x1);
+        spica_mcu_msg2_cache_invalidate(die);
 
         // Now bring it out of runstall
         SPICA_MCU_GEN_CFG__RUNSTALL__RMW(die, 0x0);
@@ -17496,6 +20432,7 @@ inphi_status_t spica_mcu_download_bootloader(
 
                 // Reset the MCU
                 SPICA_MCU_RESET__PROCRST__RMW(pdie, 0x1);
+                spica_mcu_msg2_cache_invalidate(pdie);
 
                 // Now bring it out of runstall
                 SPICA_MCU_GEN_CFG__RUNSTALL__RMW(pdie, 0x0);
@@ -17509,8 +20446,126 @@ inphi_status_t spica_mcu_download_bootloader(
     SPICA_UNLOCK(die);
     INPHI_NOTE("Done!\n");
 
-    return status;
+    return status;
+}
+
+#if defined(INPHI_HAS_SHARED_EEPROM) && (INPHI_HAS_SHARED_EEPROM==1)
+/* Give the SPI bus to a die and run its bootloader */
+static void spica_mcu_shared_boot_release(
+    uint32_t die)
+{
+    SPICA_MCU_RESET__SPIRST__RMW(die, 0);
+    spica_mcu_release_application(die);
+}
+
+// Program the bootloader into every die sharing the EEPROM and start the first
+inphi_status_t spica_mcu_shared_boot_start(
+    spica_shared_boot_ctx_t* ctx,
+    const uint32_t*          dies,
+    uint32_t                 num_dies)
+{
+    inphi_status_t status = INPHI_OK;
+    const uint32_t* ptr = NULL;
+    uint32_t length = 0;
+
+    if(!ctx || !dies || (num_dies == 0) || (num_dies > SPICA_SHARED_BOOT_MAX_DIES))
+    {
+        INPHI_CRIT("ERROR: Invalid shared EEPROM boot request\n");
+        return INPHI_ERROR;
+    }
+
+    INPHI_MEMSET(ctx, 0, sizeof(*ctx));
+    INPHI_MEMCPY(ctx->dies, dies, num_dies * sizeof(uint32_t));
+    ctx->num_dies = num_dies;
+
+    status |= spica_mcu_get_inline_bootloader(&ptr, &length);
+    if(status != INPHI_OK)
+    {
+        return status;
+    }
+
+    // All dies wait as SPI slaves, with the bootloader loaded, until their turn
+    for(uint32_t d = 0; d < num_dies; d++)
+    {
+        status |= spica_mcu_direct_download_image(dies[d], ptr, length, false);
+        SPICA_MCU_RESET__SPIRST__RMW(dies[d], 1);
+        if(status != INPHI_OK)
+        {
+            INPHI_CRIT("Bootloader download failed on die %lu\n", dies[d]);
+            return status;
+        }
+    }
+
+    SPICA_BOOT_ENTER(dies[0], SPICA_BOOT_PHASE_BOOTLOADER);
+    spica_mcu_shared_boot_release(dies[0]);
+
+    return status;
+}
+
+// Poll the die on the SPI bus and hand the bus over once it booted
+inphi_status_t spica_mcu_shared_boot_resume(
+    spica_shared_boot_ctx_t* ctx,
+    bool*                    done)
+{
+    uint32_t die;
+    uint16_t reg_data;
+
+    *done = false;
+
+    if(!ctx || (ctx->num_dies == 0) || (ctx->num_dies > SPICA_SHARED_BOOT_MAX_DIES))
+    {
+        return INPHI_ERROR;
+    }
+    if(ctx->current >= ctx->num_dies)
+    {
+        *done = true;
+        return INPHI_OK;
+    }
+
+    die = ctx->dies[ctx->current];
+    ctx->elapsed++;
+
+    // The dies load the same image, skip most of the time the last one took
+    if(ctx->elapsed < (ctx->expected - ctx->expected/4))
+    {
+        return INPHI_OK;
+    }
+
+    reg_data = SPICA_MCU_FW_MODE__READ(die);
+    if(SPICA_MCU_FW_MODE__FW_MODE__GET(reg_data) != 0xACC0)
+    {
+        if(ctx->elapsed > SPICA_INIT_RESUME_POLLS)
+        {
+            INPHI_CRIT("Die %lu did not boot from the EEPROM\n", die);
+            SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_BOOTLOADER);
+            return INPHI_ERROR;
+        }
+        return INPHI_OK;
+    }
+
+    // Off the bus before the next die becomes SPI master
+    SPICA_MCU_RESET__SPIRST__RMW(die, 1);
+    SPICA_BOOT_EXIT(die, SPICA_BOOT_PHASE_BOOTLOADER);
+
+    ctx->latency[ctx->current] = ctx->elapsed;
+    ctx->expected = ctx->elapsed;
+    ctx->elapsed = 0;
+    ctx->current++;
+
+    if(ctx->current < ctx->num_dies)
+    {
+        die = ctx->dies[ctx->current];
+        SPICA_BOOT_ENTER(die, SPICA_BOOT_PHASE_BOOTLOADER);
+        spica_mcu_shared_boot_release(die);
+    }
+    else
+    {
+        *done = true;
+    }
+
+    return INPHI_OK;
 }
+#endif // defined(INPHI_HAS_SHARED_EEPROM) && (INPHI_HAS_SHARED_EEPROM==1)
 #endif //defined(INPHI_HAS_INLINE_BOOTLOADER_FW) && (INPHI_HAS_INLINE_BOOTLOADER_FW == 1)
 
 #endif // defined(INPHI_HAS_DIRECT_DOWNLOAD)
@@ -17717,6 +20772,7 @@ inphi_status_t spica_mcu_download_firmware_from_file(
 
             // Reset the MCU
             SPICA_MCU_RESET__PROCRST__RMW(pdie, 0x1);
+            spica_mcu_msg2_cache_invalidate(pdie);
 
             // Now bring it out of runstall
             SPICA_MCU_GEN_CFG__RUNSTALL__RMW(pdie, 0x0);
@@ -17860,6 +20916,7 @@ inphi_status_t spica_mcu_reset_into_mode(
     }
     
     SPICA_MCU_RESET__PROCRST__RMW(die, 1);    // Reset the MCU
+    spica_mcu_msg2_cache_invalidate(die);
     SPICA_MCU_GEN_CFG__RUNSTALL__RMW(die, 0); // Clear any runstall
 
     // Wait for the firmware to startup
@@ -18787,10 +21844,9 @@ inphi_status_t spica_mcu_wait_mbox(
     inphi_status_t status = INPHI_OK;
     int16_t mbox_avail = 0;
     uint16_t data = 0;
-    int32_t max_iterations;
+    uint32_t waited = 0;
 
-    max_iterations = timeout / SPICA_MCU_MBOX_ITER_DELAY;
-    if (max_iterations == 0) max_iterations = 1;
+    if (timeout < SPICA_MCU_MBOX_ITER_DELAY) timeout = SPICA_MCU_MBOX_ITER_DELAY;
 
     /* Wait for space in the mailbox queue to the MCU. */
     while(mbox_avail <= 0)
@@ -18812,11 +21868,11 @@ inphi_status_t spica_mcu_wait_mbox(
 
         if(mbox_avail <= 0)
         {
-            INPHI_MDELAY(SPICA_MCU_MBOX_ITER_DELAY);
-            max_iterations -= 1;
+            // Woken early by the DSP interrupt when the mailbox moves
+            waited += SPICA_EVENT_WAIT(die, SPICA_EVENT_MBOX, SPICA_MCU_MBOX_ITER_DELAY);
 
             // INPHI_NOTE(".");
-            if(max_iterations <= 0)
+            if(waited >= timeout)
             {
                 INPHI_CRIT("Timed out waiting for MCU to clear mailbox\n");
                 return INPHI_ERROR;
@@ -18883,7 +21939,7 @@ inphi_status_t spica_msg_send(
     uint16_t txmbox_avail = 0;
 
     /* First ensure the MCU is in a mode where it an receive messages */
-    status |= spica_mcu_fw_mode_query(die, &mode);
+    status |= spica_mcu_fw_mode_query_cached(die, &mode);
     if(status || (mode == SPICA_FW_MODE_UNKNOWN))
     {
         INPHI_CRIT("Not in application or upgrade mode, MCU can't handle messages\n");
@@ -18909,6 +21965,7 @@ inphi_status_t spica_msg_send(
     if(timeout <= 0)
     {
         INPHI_CRIT("Timeout clearing TX MBOX\n");
+        spica_mcu_msg2_cache_invalidate(die);
         return INPHI_ERROR;
     }
 
@@ -18934,6 +21991,7 @@ inphi_status_t spica_msg_send(
     {
         INPHI_CRIT("Could not send header\n");
         spica_clear_rx_mbox(die);
+        spica_mcu_msg2_cache_invalidate(die);
         SPICA_UNLOCK(die);
         return status;
     }
@@ -18957,6 +22015,7 @@ inphi_status_t spica_msg_send(
     {
         INPHI_CRIT("Could not send payload\n");
         spica_clear_rx_mbox(die);
+        spica_mcu_msg2_cache_invalidate(die);
     }
 
     SPICA_UNLOCK(die);
@@ -19125,8 +22184,12 @@ typedef enum {
  * Doesn't need the FW to be running at the time of the query, but since the address is set by the app
  * FW, it had to run at some point.
  *
+ * The addresses and lengths of both buffers are read from the FW the first time and cached per die,
+ * afterwards only the wr_idx/rd_idx words of the idx buffer are read. The indexes of the other buffer
+ * are left at 0.
+ *
  * @param msg_buffer [IO] - one index per e_spica_msg2_buffer_idx, one for API2FW and another for FW2API
- *                          msg_buffer must be zero-initialized prior to the first time this method is called.
+ * @param idx        [I]  - The buffer whose indexes are needed
  *
  * @since 0.1
  *
@@ -19134,37 +22197,57 @@ typedef enum {
  */
 static inphi_status_t spica_msg2_buffer_query(
         uint32_t die,
-        spica_msg2_buffer msg_buffer[2])
+        spica_msg2_buffer msg_buffer[2],
+        e_spica_msg2_buffer_idx idx)
 {
     inphi_status_t status = INPHI_OK;
     uint32_t pif_buf[3];
     uint32_t pif_buf_len = sizeof(pif_buf)/sizeof(*pif_buf);
+    spica_fw_cache_t* entry;
 
     if(!msg_buffer) return INPHI_ERROR;
 
-    uint32_t buff_addr = msg_buffer[0].self_addr;
-    if(((buff_addr>>16) != SPICA_MCU_DRAM_ADDR_MSW) || ((buff_addr&0xffff) == 0)) {
+    entry = spica_fw_cache_find(die, true);
+    if(!entry->msg2_valid)
+    {
         // Grab the buffer address
-        buff_addr = (SPICA_MCU_DRAM_ADDR_MSW<<16) | SPICA_MCU_SP12_MSG2_BUFF_ADDR__READ(die);
+        uint32_t buff_addr = (SPICA_MCU_DRAM_ADDR_MSW<<16) | SPICA_MCU_SP12_MSG2_BUFF_ADDR__READ(die);
         if(buff_addr == (SPICA_MCU_DRAM_ADDR_MSW<<16)) return INPHI_ERROR;
+
+        //get the first index API2FW
+        status |= spica_mcu_pif_read(die, buff_addr, pif_buf, pif_buf_len);
+        entry->msg2_self_addr[SPICA_MSG2_BUF_API2FW] = buff_addr;
+        entry->msg2_length[SPICA_MSG2_BUF_API2FW] = pif_buf[0];
+        uint32_t msg_buffer_size = (3+pif_buf[0])*sizeof(uint32_t);
+
+        //get the second index FW2API
+        status |= spica_mcu_pif_read(die, buff_addr+msg_buffer_size, pif_buf, pif_buf_len);
+        entry->msg2_self_addr[SPICA_MSG2_BUF_FW2API] = buff_addr+msg_buffer_size;
+        entry->msg2_length[SPICA_MSG2_BUF_FW2API] = pif_buf[0];
+        if(status) return status;
+
+        entry->msg2_valid = true;
     }
 
-    //get the first index API2FW
-    status |= spica_mcu_pif_read(die, buff_addr, pif_buf, pif_buf_len);
-    msg_buffer[SPICA_MSG2_BUF_API2FW].self_addr = buff_addr;
-    msg_buffer[SPICA_MSG2_BUF_API2FW].length = pif_buf[0];
-    msg_buffer[SPICA_MSG2_BUF_API2FW].wr_idx = pif_buf[1];
-    msg_buffer[SPICA_MSG2_BUF_API2FW].rd_idx = pif_buf[2];
-    msg_buffer[SPICA_MSG2_BUF_API2FW].buffer_addr = buff_addr+3*sizeof(uint32_t);
-    uint32_t msg_buffer_size = (3+msg_buffer[SPICA_MSG2_BUF_API2FW].length)*sizeof(uint32_t);
+    for(int i = 0; i < SPICA_MSG2_BUF_END; i++)
+    {
+        msg_buffer[i].self_addr = entry->msg2_self_addr[i];
+        msg_buffer[i].length = entry->msg2_length[i];
+        msg_buffer[i].wr_idx = 0;
+        msg_buffer[i].rd_idx = 0;
+        msg_buffer[i].buffer_addr = entry->msg2_self_addr[i]+3*sizeof(uint32_t);
+    }
 
-    //get the second index FW2API
-    status |= spica_mcu_pif_read(die, buff_addr+msg_buffer_size, pif_buf, pif_buf_len);
-    msg_buffer[SPICA_MSG2_BUF_FW2API].self_addr = buff_addr+msg_buffer_size;
-    msg_buffer[SPICA_MSG2_BUF_FW2API].length = pif_buf[0];
-    msg_buffer[SPICA_MSG2_BUF_FW2API].wr_idx = pif_buf[1];
-    msg_buffer[SPICA_MSG2_BUF_FW2API].rd_idx = pif_buf[2];
-    msg_buffer[SPICA_MSG2_BUF_FW2API].buffer_addr = buff_addr+msg_buffer_size+3*sizeof(uint32_t);
+    //get the wr_idx/rd_idx of the buffer in use
+    status |= spica_mcu_pif_read(die, entry->msg2_self_addr[idx]+sizeof(uint32_t), pif_buf, 2);
+    if(status)
+    {
+        //the FW may have been restarted under us, check it again next time
+        spica_mcu_msg2_cache_invalidate(die);
+        return status;
+    }
+    msg_buffer[idx].wr_idx = pif_buf[0];
+    msg_buffer[idx].rd_idx = pif_buf[1];
 
 #if 0 // debug
     INPHI_NOTE("msg_buffer\n");
@@ -19314,13 +22397,12 @@ static inphi_status_t spica_msg2_wait_and_lock(
         uint32_t timeout)
 {
     inphi_status_t status = INPHI_OK;
-    int32_t max_iterations;
+    uint32_t waited = 0;
 
-    max_iterations = timeout / SPICA_MCU_MBOX_ITER_DELAY;
-    if (max_iterations == 0) max_iterations = 1;
+    if (timeout < SPICA_MCU_MBOX_ITER_DELAY) timeout = SPICA_MCU_MBOX_ITER_DELAY;
 
     // grab the buffers without locking, which is fine as we're in read-only mode
-    status |= spica_msg2_buffer_query(die, msg_buffers);
+    status |= spica_msg2_buffer_query(die, msg_buffers, idx);
     if(status) return status;
 
     // INPHI_NOTE("msg buf avail = %d, msg len = %d\n", spica_msg2_num_avail(msg_buffers, idx),  msg_length);
@@ -19328,35 +22410,33 @@ static inphi_status_t spica_msg2_wait_and_lock(
     // wait until we have room
     while(spica_msg2_num_avail(msg_buffers, idx) < msg_length)
     {
-        max_iterations -= 1;
-        if(max_iterations <= 0)
+        if(waited >= timeout)
         {
             INPHI_CRIT("Timed out waiting for MCU to clear/fill msg2 buffer\n");
             return INPHI_ERROR;
         }
-        INPHI_MDELAY(SPICA_MCU_MBOX_ITER_DELAY);
+        waited += SPICA_EVENT_WAIT(die, SPICA_EVENT_MBOX, SPICA_MCU_MBOX_ITER_DELAY);
 
         //update the buffer info
-        status |= spica_msg2_buffer_query(die, msg_buffers);
+        status |= spica_msg2_buffer_query(die, msg_buffers, idx);
         if(status) return INPHI_ERROR;
     }
 
     //now we know for sure that a message is waiting and it's the right length
     // lock the queue which will allow us to pull the whole message out and erase the queue
     while(!spica_msg2_lock(die)) {
-        max_iterations -= 1;
-        if(max_iterations <= 0)
+        if(waited >= timeout)
         {
             INPHI_CRIT("Timed out waiting for MCU to release msg2 lock\n");
             return INPHI_ERROR;
         }
-        INPHI_MDELAY(SPICA_MCU_MBOX_ITER_DELAY);
+        waited += SPICA_EVENT_WAIT(die, SPICA_EVENT_MBOX, SPICA_MCU_MBOX_ITER_DELAY);
     }
 
     // ********** START MSG2 LOCKED *************
 
     //after lock we must update the buffer info one last time in case the FW modified it
-    status |= spica_msg2_buffer_query(die, msg_buffers);
+    status |= spica_msg2_buffer_query(die, msg_buffers, idx);
     if(status) spica_msg2_unlock(die);
 
     return status;
@@ -19372,6 +22452,8 @@ static inphi_status_t spica_msg2_wait_and_lock(
  *                             Use NULL if not sending a payload.
  * @param payload_length [I] - The num of elements in the payload (units are 32 bit words).
  *                             Use 0 if not sending a payload.
+ * @param timeout        [I] - Max amount of ms to wait for room in the API2FW buffer, not very accurate.
+ * @param discard        [I] - Discard the responses still in the FW2API buffer.
  *
  * @return INPHI_OK on success, INPHI_ERROR on failure.
  *
@@ -19379,12 +22461,14 @@ static inphi_status_t spica_msg2_wait_and_lock(
  *
  * @private
  */
-static inphi_status_t spica_msg2_push_message(
+static inphi_status_t spica_msg2_push_message_ext(
     uint32_t die,
     uint8_t msg_id,
     e_spica_mcu_msg_type msg_type,
     const uint32_t *payload,
-    uint16_t payload_length)
+    uint16_t payload_length,
+    uint32_t timeout,
+    bool discard)
 {
     inphi_status_t status = INPHI_OK;
     e_spica_fw_mode mode;
@@ -19408,7 +22492,7 @@ static inphi_status_t spica_msg2_push_message(
     }
 
     /* First ensure the MCU is in a mode where it an receive messages */
-    status |= spica_mcu_fw_mode_query(die, &mode);
+    status |= spica_mcu_fw_mode_query_cached(die, &mode);
     if(status || (mode != SPICA_FW_MODE_APPLICATION))
     {
         INPHI_CRIT("Not in application mode, MCU can't handle PIF messages\n");
@@ -19422,23 +22506,27 @@ static inphi_status_t spica_msg2_push_message(
     INPHI_MEMSET(msg_buffers, 0, sizeof(msg_buffers));
 
     //we don't need to capture the buffer; wait_and_lock will do that for us
-    /*status |= spica_msg2_buffer_query(die, msg_buffers);*/
+    /*status |= spica_msg2_buffer_query(die, msg_buffers, SPICA_MSG2_BUF_API2FW);*/
     /*if(status) goto exit;*/
 
     //wait for the API2FW buffer to clear
-    status |= spica_msg2_wait_and_lock(die, msg_buffers, SPICA_MSG2_BUF_API2FW, msg_length, SPICA_MCU_MBOX_MAX_TIMEOUT);
+    status |= spica_msg2_wait_and_lock(die, msg_buffers, SPICA_MSG2_BUF_API2FW, msg_length, timeout);
     if(status) goto exit;
 
     // ********** START MSG2 LOCKED *************
 
     /* If there are any unprocessed entries in the TX mailbox
      * we need to discard them to avoid synchronization issues.
+     * Asynchronous requests keep them, their responses are matched by ID.
      */
-    //blow away the wr_idx/rd_idx on the FW2API buffer, effectively erasing the TX buffer
-    pif_buf[0] = 0;
-    pif_buf[1] = 0;
-    status |= spica_mcu_pif_write(die, msg_buffers[SPICA_MSG2_BUF_FW2API].self_addr+sizeof(uint32_t), pif_buf, 2);
-    if(status) goto msg2_unlock;
+    if(discard)
+    {
+        //blow away the wr_idx/rd_idx on the FW2API buffer, effectively erasing the TX buffer
+        pif_buf[0] = 0;
+        pif_buf[1] = 0;
+        status |= spica_mcu_pif_write(die, msg_buffers[SPICA_MSG2_BUF_FW2API].self_addr+sizeof(uint32_t), pif_buf, 2);
+        if(status) goto msg2_unlock;
+    }
 
     //generate the header
     pif_buf[0] = spica_mcu_msg_type(msg_type, msg_id, msg_length);
@@ -19476,9 +22564,30 @@ msg2_unlock:
 exit:
     SPICA_UNLOCK(die);
 
+    //a failed message may mean the FW went away, check its mode again next time
+    if(status) spica_mcu_msg2_cache_invalidate(die);
+
     return status;
 }
 
+/**
+ * Sends a message to the MCU and discards the responses not pulled yet, see spica_msg2_push_message_ext.
+ *
+ * @since 0.1
+ *
+ * @private
+ */
+static inphi_status_t spica_msg2_push_message(
+    uint32_t die,
+    uint8_t msg_id,
+    e_spica_mcu_msg_type msg_type,
+    const uint32_t *payload,
+    uint16_t payload_length)
+{
+    return spica_msg2_push_message_ext(die, msg_id, msg_type, payload, payload_length,
+                                       SPICA_MCU_MBOX_MAX_TIMEOUT, true);
+}
+
 /**
  * Pulls a message header (not data) from the MCU via the new PIF interface.
  *
@@ -19523,7 +22632,7 @@ static inphi_status_t spica_msg2_pull_message(
     uint32_t cksum = 0;
 
     /* First ensure the MCU is in a mode where it an receive messages */
-    status |= spica_mcu_fw_mode_query(die, &mode);
+    status |= spica_mcu_fw_mode_query_cached(die, &mode);
     if(status || (mode != SPICA_FW_MODE_APPLICATION))
     {
         INPHI_CRIT("Not in application mode, MCU can't handle PIF messages\n");
@@ -19549,7 +22658,7 @@ static inphi_status_t spica_msg2_pull_message(
     else {
         //if we're already locked then it means this fn is running in a loop
         //check if there is a message, if not, then don't block
-        status |= spica_msg2_buffer_query(die, msg_buffers);
+        status |= spica_msg2_buffer_query(die, msg_buffers, SPICA_MSG2_BUF_FW2API);
         if(status) goto exit;
 
         if(spica_msg2_num_avail(msg_buffers, SPICA_MSG2_BUF_FW2API) == 0) {
@@ -19636,6 +22745,9 @@ msg2_unlock:
 exit:
     SPICA_UNLOCK(die);
 
+    //a failed message may mean the FW went away, check its mode again next time
+    if(status) spica_mcu_msg2_cache_invalidate(die);
+
     return status;
 }
 
@@ -19895,132 +23007,481 @@ msg2_error:
     resp[1] = 0;
     status |= spica_mcu_pif_write(die, msg_buffers[SPICA_MSG2_BUF_FW2API].self_addr+sizeof(uint32_t), resp, 2);
 
-    //update our state to say we have an error and we can't use this method again
-    state = FSPG_ERROR;
+    //update our state to say we have an error and we can't use this method again
+    state = FSPG_ERROR;
+
+msg2_unlock:
+    // ********** END MSG2 LOCKED *************
+    spica_msg2_unlock(die);
+
+    //update the state
+    stats->_state = state;
+
+exit:
+    SPICA_UNLOCK(die);
+
+    if(status)
+    {
+        ret = status;
+    }
+    return ret;
+}
+#endif //ifndef INPHI_DONT_USE_STDLIB
+
+/*
+ * Clear the internal FEC stats poller
+ */
+inphi_status_t spica_mcu_fec_stats_poller_clear(
+    uint32_t   die,
+    e_spica_intf intf
+    )
+{
+    inphi_status_t status = INPHI_OK;
+    uint8_t req_id;
+    uint32_t payload[3];
+
+    payload[0] = (intf&0xffff);
+
+    /* Send the request to the MCU */
+    req_id = spica_mcu_msg_id();
+    status |= spica_msg2_push_message(die, req_id, SPICA_MCU_MSG_FEC_STATS_CLEAR, payload, 1);
+    if(status != INPHI_OK)
+    {
+        INPHI_CRIT("Failed sending request to f/w\n");
+        return status;
+    }
+
+    //no response needed from FW
+    return status;
+}
+
+/**
+ * Get the SRX pulse resp
+ */
+inphi_status_t spica_msg_srx_pulse_resp_request(
+    uint32_t die,
+    uint32_t channel,
+    int32_t *resp_values,
+    uint32_t len)
+{
+    inphi_status_t status = INPHI_OK;
+    uint8_t req_id;
+    uint32_t payload[3];
+
+    uint8_t resp_id;
+    e_spica_mcu_msg_type resp_type;
+    uint16_t resp_len;
+
+    SPICA_LOCK(die);
+
+    if(len < 2) {
+        INPHI_CRIT("Pulse resp len must be > 2: len = %lu\n", len);
+        status |= INPHI_ERROR;
+        goto done;
+    }
+
+    req_id = spica_mcu_msg_id();
+
+    //convert to a FW channel and the correct die for this channel
+    //INPHI_NOTE("BEFORE spica_rebase_channel_intf:ch:%d\n", channel);
+    //INPHI_NOTE("BEFORE spica_rebase_channel_intf:die:%d\n", die);
+    status |= spica_rebase_channel_by_intf(&die, &channel, SPICA_INTF_SRX);
+    // Map offset multiplier to FW channel
+    // Specific for SRX INTF
+    // OFFSET MULT: 0  1  4  5  8  9  12  13
+    // FW CHANNEL : 0  1  3  4  6  7  9   10
+    channel -= (channel)/4; 
+    //INPHI_NOTE("AFTER spica_rebase_channel_intf:ch:%d\n", channel);
+    //INPHI_NOTE("AFTER spica_rebase_channel_intf:die:%d\n", die);
+    if(status) goto done;
+
+    //payload is
+    // 0: channel 31:16   intf 15:0
+    // 1: num of taps
+    payload[0] = ((channel&0xffff)<<16) | (SPICA_INTF_SRX&0xffff);
+    payload[1] = len;
+
+    status |= spica_msg2_push_message(die, req_id, SPICA_MCU_MSG_SRX_PULSE_REQUEST, payload, 2);
+    if(status)
+    {
+        INPHI_CRIT("Failed sending the info request for the histogram data to the h/w\n");
+        goto done;
+    }
+
+    //get the data from the FW, wait forever for it to come in...
+    //resp is {status, value0, ...}
+    /* Wait for the response from the MCU */
+    status |= spica_msg2_pull_message(die, (uint32_t*)resp_values, len, 2000, &resp_id, &resp_type, &resp_len);
+
+    if((status != INPHI_OK) || (req_id != resp_id))
+    {
+        INPHI_CRIT("Unexpected response from the f/w, req_id = %d, resp_id = %d\n",
+                   req_id, resp_id);
+        status |= INPHI_ERROR;
+        goto done;
+    }
+
+    //we use the len to figure out whether there was an error or not
+    if((resp_len != len) || (resp_type != SPICA_MCU_MSG_SRX_PULSE_RESPONSE))
+    {
+        INPHI_CRIT("FW failed getting pulse resp. l%d t%d\n", resp_len, resp_type);
+        status |= INPHI_ERROR;
+        goto done;
+    }
+
+done:
+    SPICA_UNLOCK(die);
+
+    return status;
+}
+
+/*
+ * Max amount of ms an asynchronous request waits for room in the API2FW buffer
+ * or for the msg2 lock before giving up, the caller retries later
+ */
+#define SPICA_MSG2_ASYNC_POST_TIMEOUT (2*SPICA_MCU_MBOX_ITER_DELAY)
+
+/* Words of a response not kept by the request, read for the checksum only */
+#define SPICA_MSG2_ASYNC_SKIP_WORDS 8
+
+void spica_msg2_async_init(
+    spica_msg2_async_t* async,
+    uint32_t            die)
+{
+    INPHI_MEMSET(async, 0, sizeof(*async));
+    async->die = die;
+}
+
+/**
+ * Push a request and track it until its response arrives.
+ *
+ * @param resp_type [I] - The message type of the response
+ * @param resp      [O] - Where the response payload goes
+ * @param resp_min  [I] - Least payload words of a valid response
+ * @param resp_max  [I] - Payload words resp can hold, the rest of a longer response is dropped
+ *
+ * @since 1.2.0.929
+ *
+ * @private
+ */
+static inphi_status_t spica_msg2_async_post(
+    spica_msg2_async_t*         async,
+    e_spica_mcu_msg_type        msg_type,
+    const uint32_t*             payload,
+    uint16_t                    payload_length,
+    e_spica_mcu_msg_type        resp_type,
+    uint32_t*                   resp,
+    uint16_t                    resp_min,
+    uint16_t                    resp_max,
+    spica_msg2_async_callback_t callback,
+    void*                       user_data)
+{
+    inphi_status_t status = INPHI_OK;
+    spica_msg2_async_req_t* req = NULL;
+    uint8_t msg_id;
+    bool unique;
+
+    for(int i = 0; i < SPICA_MSG2_ASYNC_MAX_REQS; i++)
+    {
+        if(!async->reqs[i].in_use)
+        {
+            req = &async->reqs[i];
+            break;
+        }
+    }
+    if(!req)
+    {
+        INPHI_CRIT("Too many msg2 requests in flight\n");
+        return INPHI_ERROR;
+    }
+
+    //the responses are matched by ID, skip the IDs still in flight
+    do
+    {
+        msg_id = spica_mcu_msg_id();
+        unique = true;
+        for(int i = 0; i < SPICA_MSG2_ASYNC_MAX_REQS; i++)
+        {
+            if(async->reqs[i].in_use && (async->reqs[i].msg_id == msg_id))
+            {
+                unique = false;
+            }
+        }
+    } while(!unique);
+
+    //with nothing in flight the responses left over are stale, drop them like a synchronous push
+    status |= spica_msg2_push_message_ext(async->die, msg_id, msg_type, payload, payload_length,
+                                          SPICA_MSG2_ASYNC_POST_TIMEOUT, (async->num_in_flight == 0));
+    if(status) return status;
+
+    INPHI_MEMSET(req, 0, sizeof(*req));
+    req->in_use    = true;
+    req->msg_id    = msg_id;
+    req->resp_type = (uint8_t)resp_type;
+    req->resp      = resp;
+    req->resp_min  = resp_min;
+    req->resp_max  = resp_max;
+    req->polls     = SPICA_MSG2_ASYNC_POLLS;
+    req->callback  = callback;
+    req->user_data = user_data;
+    async->num_in_flight += 1;
+
+    return status;
+}
+
+/**
+ * Read the responses waiting in the FW2API buffer into their requests, then empty the buffer.
+ * Does not wait if the FW holds the buffer.
+ *
+ * @since 1.2.0.929
+ *
+ * @private
+ */
+static inphi_status_t spica_msg2_async_pull(
+    spica_msg2_async_t* async)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t die = async->die;
+    spica_msg2_buffer msg_buffers[2];
+    spica_msg2_buffer *buf = &msg_buffers[SPICA_MSG2_BUF_FW2API];
+    uint32_t skip[SPICA_MSG2_ASYNC_SKIP_WORDS];
+    uint32_t hdr;
+    uint32_t cksum;
+    uint32_t rd_addr;
+    uint32_t rd_idx;
+    uint16_t total_len;
+    uint16_t msg_len;
+    uint16_t keep;
+    uint16_t n;
+    uint8_t msg_id;
+    uint8_t msg_type;
+
+    SPICA_LOCK(die);
+
+    //look without locking first, most calls find nothing
+    INPHI_MEMSET(msg_buffers, 0, sizeof(msg_buffers));
+    status |= spica_msg2_buffer_query(die, msg_buffers, SPICA_MSG2_BUF_FW2API);
+    if(status || (spica_msg2_num_avail(msg_buffers, SPICA_MSG2_BUF_FW2API) < 2)) goto exit;
+
+    status |= spica_msg2_wait_and_lock(die, msg_buffers, SPICA_MSG2_BUF_FW2API, 2, SPICA_MCU_MBOX_ITER_DELAY);
+    if(status)
+    {
+        //FW holds the buffer, try again next time
+        status = INPHI_OK;
+        goto exit;
+    }
+
+    // ********** START MSG2 LOCKED *************
+
+    for(rd_idx = buf->rd_idx; (buf->wr_idx - rd_idx) >= 2; rd_idx += total_len)
+    {
+        spica_msg2_async_req_t* req = NULL;
+
+        rd_addr = buf->buffer_addr + rd_idx*sizeof(uint32_t);
+        status |= spica_mcu_pif_read(die, rd_addr, &hdr, 1);
+        if(status) break;
+        rd_addr += sizeof(uint32_t);
+
+        msg_id    = (hdr>>24) & 0xff;
+        msg_type  = (hdr>>16) & 0xff;
+        total_len = (hdr & 0xffff);
+        if((total_len < 2) || (total_len > (buf->wr_idx - rd_idx)))
+        {
+            INPHI_CRIT("partial msg2 of type %d\n", msg_type);
+            status |= INPHI_ERROR;
+            break;
+        }
+        msg_len = total_len - 2;
+
+        for(int i = 0; i < SPICA_MSG2_ASYNC_MAX_REQS; i++)
+        {
+            if(async->reqs[i].in_use && !async->reqs[i].done && (async->reqs[i].msg_id == msg_id))
+            {
+                req = &async->reqs[i];
+                break;
+            }
+        }
+        if(!req)
+        {
+            //not ours (or already timed out), skip it
+            continue;
+        }
+
+        req->done = true;
+        req->resp_len = msg_len;
+        if((msg_type != req->resp_type) || (msg_len < req->resp_min))
+        {
+            INPHI_CRIT("Unexpected response id %d type %d len %d\n", msg_id, msg_type, msg_len);
+            req->status = INPHI_ERROR;
+            continue;
+        }
+
+        cksum = spica_msg2_checksum(&hdr, sizeof(hdr), 0);
+
+        //the payload resp can hold, then the rest for the checksum only
+        keep = (msg_len < req->resp_max) ? msg_len : req->resp_max;
+        req->status |= spica_mcu_pif_read(die, rd_addr, req->resp, keep);
+        cksum = spica_msg2_checksum(req->resp, keep*sizeof(uint32_t), cksum);
+        rd_addr += keep*sizeof(uint32_t);
+        for(uint16_t left = msg_len - keep; (left > 0) && !req->status; left -= n)
+        {
+            n = (left < SPICA_MSG2_ASYNC_SKIP_WORDS) ? left : SPICA_MSG2_ASYNC_SKIP_WORDS;
+            req->status |= spica_mcu_pif_read(die, rd_addr, skip, n);
+            cksum = spica_msg2_checksum(skip, n*sizeof(uint32_t), cksum);
+            rd_addr += n*sizeof(uint32_t);
+        }
+
+        req->status |= spica_mcu_pif_read(die, rd_addr, &hdr, 1);
+        if(!req->status && (cksum != hdr))
+        {
+            INPHI_CRIT("msg_type %d calc cksum %lu != read cksum %lu\n", msg_type, cksum, hdr);
+            req->status = INPHI_ERROR;
+        }
+    }
+
+    //every response has been taken (or can't be trusted), update the rd/wr_idx, which will erase them
+    skip[0] = 0;
+    skip[1] = 0;
+    status |= spica_mcu_pif_write(die, buf->self_addr+sizeof(uint32_t), skip, 2);
 
-msg2_unlock:
     // ********** END MSG2 LOCKED *************
     spica_msg2_unlock(die);
 
-    //update the state
-    stats->_state = state;
-
 exit:
     SPICA_UNLOCK(die);
 
-    if(status)
-    {
-        ret = status;
-    }
-    return ret;
+    return status;
 }
-#endif //ifndef INPHI_DONT_USE_STDLIB
 
-/*
- * Clear the internal FEC stats poller
- */
-inphi_status_t spica_mcu_fec_stats_poller_clear(
-    uint32_t   die,
-    e_spica_intf intf
-    )
+inphi_status_t spica_msg2_async_service(
+    spica_msg2_async_t* async)
 {
     inphi_status_t status = INPHI_OK;
-    uint8_t req_id;
-    uint32_t payload[3];
+    e_spica_fw_mode mode;
+    bool lost = false;
 
-    payload[0] = (intf&0xffff);
+    if(async->num_in_flight == 0) return INPHI_OK;
 
-    /* Send the request to the MCU */
-    req_id = spica_mcu_msg_id();
-    status |= spica_msg2_push_message(die, req_id, SPICA_MCU_MSG_FEC_STATS_CLEAR, payload, 1);
-    if(status != INPHI_OK)
+    //the requests die with the FW
+    status |= spica_mcu_fw_mode_query_cached(async->die, &mode);
+    if(status || (mode != SPICA_FW_MODE_APPLICATION))
     {
-        INPHI_CRIT("Failed sending request to f/w\n");
-        return status;
+        INPHI_CRIT("Not in application mode, msg2 requests dropped\n");
+        lost = true;
+    }
+    else
+    {
+        status |= spica_msg2_async_pull(async);
     }
 
-    //no response needed from FW
-    return status;
-}
+    for(int i = 0; i < SPICA_MSG2_ASYNC_MAX_REQS; i++)
+    {
+        spica_msg2_async_req_t* req = &async->reqs[i];
 
-/**
- * Get the SRX pulse resp
- */
-inphi_status_t spica_msg_srx_pulse_resp_request(
-    uint32_t die,
-    uint32_t channel,
-    int32_t *resp_values,
-    uint32_t len)
-{
-    inphi_status_t status = INPHI_OK;
-    uint8_t req_id;
-    uint32_t payload[3];
+        if(!req->in_use || req->done) continue;
 
-    uint8_t resp_id;
-    e_spica_mcu_msg_type resp_type;
-    uint16_t resp_len;
+        req->polls -= 1;
+        if(lost || (req->polls == 0))
+        {
+            req->done = true;
+            req->status = INPHI_ERROR;
+            //the FW may have gone away, check its mode again next time
+            spica_mcu_msg2_cache_invalidate(async->die);
+        }
+    }
 
-    SPICA_LOCK(die);
+    //callbacks last, they may queue new requests
+    for(int i = 0; i < SPICA_MSG2_ASYNC_MAX_REQS; i++)
+    {
+        spica_msg2_async_req_t* req = &async->reqs[i];
 
-    if(len < 2) {
-        INPHI_CRIT("Pulse resp len must be > 2: len = %lu\n", len);
-        status |= INPHI_ERROR;
-        goto done;
-    }
+        if(!req->in_use || !req->done) continue;
 
-    req_id = spica_mcu_msg_id();
+        req->in_use = false;
+        async->num_in_flight -= 1;
+        if(req->callback)
+        {
+            req->callback(async->die, req->msg_id, req->status, req->resp_len, req->user_data);
+        }
+    }
 
-    //convert to a FW channel and the correct die for this channel
-    //INPHI_NOTE("BEFORE spica_rebase_channel_intf:ch:%d\n", channel);
-    //INPHI_NOTE("BEFORE spica_rebase_channel_intf:die:%d\n", die);
-    status |= spica_rebase_channel_by_intf(&die, &channel, SPICA_INTF_SRX);
-    // Map offset multiplier to FW channel
-    // Specific for SRX INTF
-    // OFFSET MULT: 0  1  4  5  8  9  12  13
-    // FW CHANNEL : 0  1  3  4  6  7  9   10
-    channel -= (channel)/4; 
-    //INPHI_NOTE("AFTER spica_rebase_channel_intf:ch:%d\n", channel);
-    //INPHI_NOTE("AFTER spica_rebase_channel_intf:die:%d\n", die);
-    if(status) goto done;
+    return status;
+}
 
-    //payload is
-    // 0: channel 31:16   intf 15:0
-    // 1: num of taps
-    payload[0] = ((channel&0xffff)<<16) | (SPICA_INTF_SRX&0xffff);
-    payload[1] = len;
+inphi_status_t spica_fec_stats_poller_request_async(
+    spica_msg2_async_t*         async,
+    e_spica_intf                intf,
+    bool                        clear_on_read,
+    spica_fec_stats_cp_block_t* stats,
+    spica_msg2_async_callback_t callback,
+    void*                       user_data)
+{
+    const uint16_t exp_len = offsetof(spica_fec_stats_cp_block_t, _state)/sizeof(uint32_t);
+    uint32_t payload[2];
 
-    status |= spica_msg2_push_message(die, req_id, SPICA_MCU_MSG_SRX_PULSE_REQUEST, payload, 2);
-    if(status)
+    if (SPICA_INTF_IG_FEC != intf)
     {
-        INPHI_CRIT("Failed sending the info request for the histogram data to the h/w\n");
-        goto done;
+        INPHI_CRIT("Interface must be INTF_IG_FEC\n");
+        return INPHI_ERROR;
     }
 
-    //get the data from the FW, wait forever for it to come in...
-    //resp is {status, value0, ...}
-    /* Wait for the response from the MCU */
-    status |= spica_msg2_pull_message(die, (uint32_t*)resp_values, len, 2000, &resp_id, &resp_type, &resp_len);
+    spica_fec_stats_poller_ins_NaNs(stats);
+    stats->_state = 0;
+    stats->poll_count = 0;
 
-    if((status != INPHI_OK) || (req_id != resp_id))
+    payload[0] = (intf&0xffff);
+    payload[1] = (intf&0xffff);
+
+    // >= exp_len so that the FW can grow the structure, see spica_mcu_fec_stats_poller_get
+    return spica_msg2_async_post(async,
+                                 clear_on_read ? SPICA_MCU_MSG_FEC_STATS_GET_AND_CLEAR : SPICA_MCU_MSG_FEC_STATS_GET,
+                                 payload, clear_on_read ? 2 : 1,
+                                 SPICA_MCU_MSG_FEC_STATS_RET, (uint32_t*)stats, exp_len, exp_len,
+                                 callback, user_data);
+}
+
+inphi_status_t spica_srx_pulse_resp_query_async(
+    spica_msg2_async_t*         async,
+    uint32_t                    channel,
+    int32_t*                    resp_values,
+    uint32_t                    len,
+    spica_msg2_async_callback_t callback,
+    void*                       user_data)
+{
+    inphi_status_t status = INPHI_OK;
+    uint32_t die = async->die;
+    uint32_t payload[2];
+
+    if((len < 2) || (len > 0xffff)) {
+        INPHI_CRIT("Pulse resp len must be > 2: len = %lu\n", len);
+        return INPHI_ERROR;
+    }
+
+    if(!SPICA_SRX_FW_STATUS__LOCKED__READ(die, channel))
     {
-        INPHI_CRIT("Unexpected response from the f/w, req_id = %d, resp_id = %d\n",
-                   req_id, resp_id);
-        status |= INPHI_ERROR;
-        goto done;
+        INPHI_CRIT("SRX not locked on channel %lu, cannot fetch pulse response\n", channel);
+        return INPHI_ERROR;
     }
 
-    //we use the len to figure out whether there was an error or not
-    if((resp_len != len) || (resp_type != SPICA_MCU_MSG_SRX_PULSE_RESPONSE))
+    //convert to a FW channel, see spica_msg_srx_pulse_resp_request
+    status |= spica_rebase_channel_by_intf(&die, &channel, SPICA_INTF_SRX);
+    if(status) return status;
+    if(die != async->die)
     {
-        INPHI_CRIT("FW failed getting pulse resp. l%d t%d\n", resp_len, resp_type);
-        status |= INPHI_ERROR;
-        goto done;
+        INPHI_CRIT("SRX channel is not on die %lu\n", async->die);
+        return INPHI_ERROR;
     }
+    channel -= (channel)/4;
 
-done:
-    SPICA_UNLOCK(die);
+    //payload is
+    // 0: channel 31:16   intf 15:0
+    // 1: num of taps
+    payload[0] = ((channel&0xffff)<<16) | (SPICA_INTF_SRX&0xffff);
+    payload[1] = len;
 
-    return status;
+    return spica_msg2_async_post(async, SPICA_MCU_MSG_SRX_PULSE_REQUEST, payload, 2,
+                                 SPICA_MCU_MSG_SRX_PULSE_RESPONSE, (uint32_t*)resp_values, (uint16_t)len, (uint16_t)len,
+                                 callback, user_data);
 }
 #endif // defined(INPHI_REMOVE_MESSAGING)
 
@@ -20269,8 +23730,10 @@ inphi_status_t spica_spi_poll_rx_fifo(uint32_t die)
     return INPHI_OK;
 }
 
+//! Shifts a segment out to the EEPROM without waiting for the
+//! internal write cycle to complete.
 //! @private
-inphi_status_t spica_spi_eeprom_write_data_segment(uint32_t die, uint32_t addr, uint32_t words[], uint32_t num_words)
+static inphi_status_t spica_spi_eeprom_program_segment(uint32_t die, uint32_t addr, const uint32_t words[], uint32_t num_words)
 {
     // Issue the write command
     uint32_t cmd = 0x02000000 | addr;
@@ -20305,9 +23768,20 @@ inphi_status_t spica_spi_eeprom_write_data_segment(uint32_t die, uint32_t addr,
     SPICA_APB_SPI_CONFIG0__WRITE(die, spi_cfg0);
     SPICA_APB_SPI_CONFIG1__WRITE(die, spi_cfg1);
 
+    return INPHI_OK;
+}
+
+//! @private
+inphi_status_t spica_spi_eeprom_write_data_segment(uint32_t die, uint32_t addr, uint32_t words[], uint32_t num_words)
+{
+    if(INPHI_OK != spica_spi_eeprom_program_segment(die, addr, words, num_words))
+    {
+        return INPHI_ERROR;
+    }
+
     // DEBUG BRAD: Need to reduce this time
     //INPHI_MDELAY(1000);
-    INPHI_MDELAY(10);
+    INPHI_MDELAY(SPICA_SPI_EEPROM_WRITE_CYCLE_MS);
 
     return INPHI_OK;
 }
@@ -20376,66 +23850,179 @@ inphi_status_t spica_spi_read_data_block(
 {
     inphi_status_t status = INPHI_OK;
 
-    spica_spi_reset(die);
-    spica_spi_read_init(die, eeprom_addr, clkdiv);
-    for(uint32_t i = 0; i < num_words; i++)
+    spica_spi_reset(die);
+    spica_spi_read_init(die, eeprom_addr, clkdiv);
+    for(uint32_t i = 0; i < num_words; i++)
+    {
+        status |= spica_spi_read_word(die, &words[i]);
+    }
+
+    return status;
+}
+
+//! This method is called to erase the EEPROM
+//!
+//! @param die         [I] - The physical ASIC die being accessed.
+//!
+//! @return INPHI_OK on success, INPHI_ERROR on failure.
+//!
+//! Note: This command does not work on EEPROMs. It only works
+//!       on Flash devices.
+//!
+//!       List of basic Flash commands:
+//!
+//!       1.  Write Status Register:   0x01
+//!       2.  Read:                    0x02
+//!       3.  Write:                   0x03
+//!       4.  Write Disable:           0x04
+//!       5.  Read Status Register:    0x05
+//!       6.  Write Enable:            0x06
+//!       7.  Chip Erase:              0x60 or 0xC7
+//!       8.  Read ID:                 0x90
+//!       9.  JEDEC ID:                0x9F
+//!       10. Power Down:              0xB9
+//!       11. Resume from Power down:  0xAB
+//!
+//! @since 1.0
+//!
+inphi_status_t spica_spi_eeprom_erase(uint32_t die)
+{
+    inphi_status_t status = INPHI_OK;
+
+    //Reset the SPI bus before sending the erase command
+    status |= spica_spi_reset(die);
+    if(status != INPHI_OK)
+    {
+        INPHI_NOTE("Error with spica_spi_reset()\n");
+        return status;
+    }
+
+    spica_spi_write_init(die, SPICA_SPI_CLK_DIV_64);
+
+    SPICA_APB_SPI_TX_DATA0__WRITE(die, 0x0000);
+    SPICA_APB_SPI_TX_DATA1__WRITE(die, 0x0600);
+    status |= spica_spi_poll_rx_fifo(die);
+
+    SPICA_APB_SPI_TX_DATA0__WRITE(die, 0x0000);
+    SPICA_APB_SPI_TX_DATA1__WRITE(die, 0x6000);
+    status |= spica_spi_poll_rx_fifo(die);
+
+    return status;
+}
+
+//! Prepare the package for streaming writes into the EEPROM. This does
+//! the same setup as spica_mcu_download_eeprom_from_file but without
+//! needing the whole image up front.
+inphi_status_t spica_spi_eeprom_stream_begin(
+    uint32_t            die,
+    e_spica_spi_clk_div clkdiv)
+{
+    inphi_status_t status = INPHI_OK;
+
+    // Alway use lowest die
+    die = spica_package_get_base_die(die);
+
+    uint32_t num_dies = spica_package_get_num_dies(die);
+
+    for(uint32_t i = 0; i < num_dies; i++)
+    {
+        uint16_t data;
+        uint32_t pdie = die + i;
+
+        // Force the MCU(s) to stall
+        data = SPICA_MCU_GEN_CFG__READ(pdie);
+        data = SPICA_MCU_GEN_CFG__RUNSTALL__SET(data, 1);
+        SPICA_MCU_GEN_CFG__WRITE(pdie, data);
+
+        // Reset the SPI block on the die(s)
+        data = SPICA_MCU_RESET__READ(pdie);
+        data = SPICA_MCU_RESET__SPIRST__SET(data, 1);
+        SPICA_MCU_RESET__WRITE(pdie, data);
+
+        // if clk overide is true then ensure divider is minimum 5
+        data = SPICA_MCU_BOOT_CTRL__READ(pdie);
+        if ((SPICA_MCU_BOOT_CTRL__SPI_CLK_DIVIDER_OVERRIDE__GET(data) == 1) &&
+           (SPICA_MCU_BOOT_CTRL__SPI_CLK_DIVIDER__GET(data) < 5))
+        {
+            data = SPICA_MCU_BOOT_CTRL__SPI_CLK_DIVIDER__SET(data, 5);
+            SPICA_MCU_BOOT_CTRL__WRITE(pdie, data);
+        }
+    }
+
+    // The SPI master is reset once for the whole stream
+    status |= spica_spi_reset(die);
+    status |= spica_spi_write_init(die, clkdiv);
+
+    return status;
+}
+
+//! Program one segment of an EEPROM stream. The SPI block is not reset
+//! between segments and the write cycle wait is left to the caller so
+//! it can overlap with fetching the next segment.
+inphi_status_t spica_spi_eeprom_stream_write(
+    uint32_t            die,
+    uint32_t            eeprom_addr,
+    const uint32_t*     words,
+    uint32_t            num_words,
+    e_spica_spi_clk_div clkdiv)
+{
+    inphi_status_t status = INPHI_OK;
+
+    if((num_words == 0) || (num_words > SPICA_SPI_EEPROM_SEGMENT_WORDS))
     {
-        status |= spica_spi_read_word(die, &words[i]);
+        INPHI_CRIT("Invalid segment length %lu\n", num_words);
+        return INPHI_ERROR;
     }
 
-    return status;
-}
+    die = spica_package_get_base_die(die);
 
-//! This method is called to erase the EEPROM
-//!
-//! @param die         [I] - The physical ASIC die being accessed.
-//!
-//! @return INPHI_OK on success, INPHI_ERROR on failure.
-//!
-//! Note: This command does not work on EEPROMs. It only works
-//!       on Flash devices.
-//!
-//!       List of basic Flash commands:
-//!
-//!       1.  Write Status Register:   0x01
-//!       2.  Read:                    0x02
-//!       3.  Write:                   0x03
-//!       4.  Write Disable:           0x04
-//!       5.  Read Status Register:    0x05
-//!       6.  Write Enable:            0x06
-//!       7.  Chip Erase:              0x60 or 0xC7
-//!       8.  Read ID:                 0x90
-//!       9.  JEDEC ID:                0x9F
-//!       10. Power Down:              0xB9
-//!       11. Resume from Power down:  0xAB
-//!
-//! @since 1.0
-//!
-inphi_status_t spica_spi_eeprom_erase(uint32_t die)
-{
-    inphi_status_t status = INPHI_OK;
+    // The previous segment left the SPI block in 32 bit manual CS mode,
+    // go back to 8 bit mode for the write enable command
+    status |= spica_spi_write_init(die, clkdiv);
 
-    //Reset the SPI bus before sending the erase command
-    status |= spica_spi_reset(die);
-    if(status != INPHI_OK)
+    // Send WREN command to SPI slave (EEPROM)
+    if(INPHI_OK != spica_spi_eeprom_write_enable(die))
     {
-        INPHI_NOTE("Error with spica_spi_reset()\n");
-        return status;
+        return INPHI_ERROR;
     }
 
-    spica_spi_write_init(die, SPICA_SPI_CLK_DIV_64);
+    // Set CS to Manual mode and xfer size to 32 bits
+    spica_spi_eeprom_write_data_init(die);
 
-    SPICA_APB_SPI_TX_DATA0__WRITE(die, 0x0000);
-    SPICA_APB_SPI_TX_DATA1__WRITE(die, 0x0600);
-    status |= spica_spi_poll_rx_fifo(die);
+    status |= spica_spi_eeprom_program_segment(die, eeprom_addr, words, num_words);
 
-    SPICA_APB_SPI_TX_DATA0__WRITE(die, 0x0000);
-    SPICA_APB_SPI_TX_DATA1__WRITE(die, 0x6000);
-    status |= spica_spi_poll_rx_fifo(die);
+    spica_spi_eeprom_write_data_fini(die);
 
     return status;
 }
 
+//! End an EEPROM stream and let the MCU(s) run again
+inphi_status_t spica_spi_eeprom_stream_end(
+    uint32_t die)
+{
+    die = spica_package_get_base_die(die);
+
+    uint32_t num_dies = spica_package_get_num_dies(die);
+
+    for(uint32_t i = 0; i < num_dies; i++)
+    {
+        uint16_t data;
+        uint32_t pdie = die + i;
+
+        // Reset the SPI block on the die(s)
+        data = SPICA_MCU_RESET__READ(pdie);
+        data = SPICA_MCU_RESET__SPIRST__SET(data, 1);
+        SPICA_MCU_RESET__WRITE(pdie, data);
+
+        // Unstall the the MCU(s)
+        data = SPICA_MCU_GEN_CFG__READ(pdie);
+        data = SPICA_MCU_GEN_CFG__RUNSTALL__SET(data, 0);
+        SPICA_MCU_GEN_CFG__WRITE(pdie, data);
+    }
+
+    return INPHI_OK;
+}
+
 #endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
 
 /** @file por_package.c
@@ -20529,6 +24116,19 @@ void por_package_cache_dump()
     spica_package_cache_dump();
 }
 
+void por_package_cache_set(
+    e_por_package_type package)
+{
+    spica_package_cache_set((e_spica_package_type)package);
+}
+
+inphi_status_t por_package_device_id_query(
+    uint32_t  die,
+    uint32_t* device_id)
+{
+    return spica_package_device_id_query(die, device_id);
+}
+
 /** @file por_reg_access.c
  *****************************************************************************
  *
@@ -21247,6 +24847,13 @@ inphi_status_t por_version_firmware(
                                   buffer_len);
 }
 
+inphi_status_t por_mcu_fw_version_query(
+    uint32_t  die,
+    uint32_t* version)
+{
+    return spica_mcu_fw_version_query(die, version);
+}
+
 void por_default_rules_populate(uint32_t die, 
                                 spica_rules_t* spica_rules,
                                 por_rules_t*   por_rules)
@@ -21677,6 +25284,99 @@ inphi_status_t por_enter_operational_state(
     return spica_enter_operational_state(die, &spica_rules);
 }
 
+/*
+ * Start resetting the device without blocking
+ */
+inphi_status_t por_init_start(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules)
+{
+    e_por_package_type package = por_package_get_type(die);
+
+    if ((package != POR_PACKAGE_TYPE_EML_12x13) &&
+        (package != POR_PACKAGE_TYPE_EML_12x13_REV1) &&
+        (package != POR_PACKAGE_TYPE_STD_10x13))
+    {
+        INPHI_CRIT("NOT a PG3 Device!\n");
+        return INPHI_ERROR;
+    }
+
+    spica_rules_t spica_rules;
+
+    // Copy por_rules_t to spica_rules_t
+    copy_rules(die, rules, &spica_rules);
+
+    return spica_init_start((spica_init_ctx_t*)ctx, die, &spica_rules);
+}
+
+/*
+ * Advance a non-blocking device reset
+ */
+inphi_status_t por_init_resume(
+    por_init_ctx_t* ctx,
+    bool* done)
+{
+    return spica_init_resume((spica_init_ctx_t*)ctx, done);
+}
+
+/*
+ * Send the rules to the device, the FW acks are polled by
+ * por_enter_operational_state_resume()
+ */
+inphi_status_t por_enter_operational_state_start(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules)
+{
+    spica_rules_t spica_rules;
+
+    // Copy por_rules_t to spica_rules_t
+    copy_rules(die, rules, &spica_rules);
+
+    return spica_enter_operational_state_start((spica_init_ctx_t*)ctx, die, &spica_rules);
+}
+
+/*
+ * Advance a non-blocking enter operational state
+ */
+inphi_status_t por_enter_operational_state_resume(
+    por_init_ctx_t* ctx,
+    bool* done)
+{
+    return spica_enter_operational_state_resume((spica_init_ctx_t*)ctx, done);
+}
+
+/*
+ * Send the rules to the device, recording the register writes
+ */
+inphi_status_t por_enter_operational_state_capture(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    por_rules_t* rules,
+    por_config_snapshot_t* snap)
+{
+    spica_rules_t spica_rules;
+
+    // Copy por_rules_t to spica_rules_t
+    copy_rules(die, rules, &spica_rules);
+
+    return spica_enter_operational_state_capture((spica_init_ctx_t*)ctx, die, &spica_rules,
+                                                 (spica_config_snapshot_t*)snap);
+}
+
+/*
+ * Write a snapshot of the rules back to the device
+ */
+inphi_status_t por_enter_operational_state_replay(
+    por_init_ctx_t* ctx,
+    uint32_t die,
+    const por_config_snapshot_t* snap)
+{
+    return spica_enter_operational_state_replay((spica_init_ctx_t*)ctx, die,
+                                                (const spica_config_snapshot_t*)snap);
+}
+
 /*
  * Is the designated interface of a channel in the locked state
  */
@@ -22653,6 +26353,24 @@ inphi_status_t por_tx_squelch(
     return spica_tx_squelch(die, channel, (e_spica_intf)intf, squelch);
 }
 
+// Resolve the squelch register of every channel of a TX interface
+inphi_status_t por_tx_squelch_map_init(
+    por_tx_squelch_map_t* map,
+    uint32_t              die,
+    e_por_intf            intf)
+{
+    return spica_tx_squelch_map_init((spica_tx_squelch_map_t*)map, die, (e_spica_intf)intf);
+}
+
+// Squelch or unsquelch a set of lanes with the minimum number of writes
+inphi_status_t por_tx_squelch_lanes(
+    por_tx_squelch_map_t* map,
+    uint32_t              lane_mask,
+    uint32_t              squelch_mask)
+{
+    return spica_tx_squelch_lanes((spica_tx_squelch_map_t*)map, lane_mask, squelch_mask);
+}
+
 inphi_status_t por_bundle_enable(
     uint32_t die, 
     uint32_t channel, 
@@ -22791,6 +26509,44 @@ inphi_status_t por_fec_stats_poller_clear(
     return status;
 }
 
+void por_msg2_async_init(
+    por_msg2_async_t* async,
+    uint32_t          die)
+{
+    spica_msg2_async_init((spica_msg2_async_t*)async, die);
+}
+
+inphi_status_t por_msg2_async_service(
+    por_msg2_async_t* async)
+{
+    return spica_msg2_async_service((spica_msg2_async_t*)async);
+}
+
+inphi_status_t por_fec_stats_poller_request_async(
+    por_msg2_async_t*         async,
+    e_por_intf                intf,
+    bool                      clear_on_read,
+    por_fec_stats_cp_block_t* stats,
+    por_msg2_async_callback_t callback,
+    void*                     user_data)
+{
+    return spica_fec_stats_poller_request_async((spica_msg2_async_t*)async, intf, clear_on_read,
+                                                (spica_fec_stats_cp_block_t*)stats,
+                                                (spica_msg2_async_callback_t)callback, user_data);
+}
+
+inphi_status_t por_hrx_pulse_resp_query_async(
+    por_msg2_async_t*         async,
+    uint32_t                  channel,
+    int32_t*                  resp_values,
+    uint32_t                  len,
+    por_msg2_async_callback_t callback,
+    void*                     user_data)
+{
+    return spica_srx_pulse_resp_query_async((spica_msg2_async_t*)async, channel, resp_values, len,
+                                            (spica_msg2_async_callback_t)callback, user_data);
+}
+
 #if defined(INPHI_HAS_FLOATING_POINT) && (INPHI_HAS_FLOATING_POINT==1)
 #if defined(INPHI_HAS_MATH_DOT_H) && (INPHI_HAS_MATH_DOT_H == 1)
 
@@ -22928,6 +26684,39 @@ inphi_status_t por_lrx_dsp_get_histogram(
     return spica_rx_dsp_hist_get(die, channel, SPICA_INTF_ORX, hist_data);
 }
 
+inphi_status_t por_lrx_dsp_hist_start(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t die,
+    uint32_t channel,
+    uint32_t *hist_data)
+{
+    return spica_rx_dsp_hist_start((spica_rx_dsp_hist_ctx_t*)ctx, die, channel, SPICA_INTF_ORX, hist_data);
+}
+
+inphi_status_t por_lrx_dsp_hist_start_slice(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t die,
+    uint32_t channel,
+    uint32_t slice,
+    uint32_t *hist_data)
+{
+    return spica_rx_dsp_hist_start_slice((spica_rx_dsp_hist_ctx_t*)ctx, die, channel, SPICA_INTF_ORX, slice, hist_data);
+}
+
+inphi_status_t por_lrx_dsp_hist_resume(
+    por_lrx_hist_ctx_t *ctx,
+    uint32_t *hist_data,
+    bool *done)
+{
+    return spica_rx_dsp_hist_resume((spica_rx_dsp_hist_ctx_t*)ctx, hist_data, done);
+}
+
+inphi_status_t por_lrx_dsp_hist_abort(
+    por_lrx_hist_ctx_t *ctx)
+{
+    return spica_rx_dsp_hist_abort((spica_rx_dsp_hist_ctx_t*)ctx);
+}
+
 inphi_status_t por_hrx_pulse_resp_query(uint32_t die,  uint32_t channel, int32_t* resp_values,  int32_t* len) 
 {
     inphi_status_t status = INPHI_OK;
@@ -23009,6 +26798,30 @@ inphi_status_t por_mcu_reset_into_boot_from_eeprom(
 
 #if defined(INPHI_HAS_DIRECT_DOWNLOAD) && (INPHI_HAS_DIRECT_DOWNLOAD==1)
 
+/* The word callback of por_mcu_download_firmware_from_external_memory()
+ * seen as an image source
+ */
+typedef struct
+{
+    uint32_t (*fw_get_word)(uint32_t offset, void* user_data);
+    void*    user_data;
+} por_fw_get_word_source_t;
+
+static inphi_status_t por_fw_get_word_read(
+    uint32_t  offset,
+    uint32_t* buf,
+    uint32_t  num_words,
+    void*     user_data)
+{
+    por_fw_get_word_source_t* src = (por_fw_get_word_source_t*)user_data;
+
+    for(uint32_t i = 0; i < num_words; i++)
+    {
+        buf[i] = src->fw_get_word(offset + i, src->user_data);
+    }
+    return INPHI_OK;
+}
+
 // Download the firmware from an external source like flash memory
 inphi_status_t por_mcu_download_firmware_from_external_memory(
     uint32_t die,
@@ -23017,8 +26830,56 @@ inphi_status_t por_mcu_download_firmware_from_external_memory(
     bool     verify,
     void*    user_data)
 {
-    INPHI_WARN("API currently NOT supported in v%s\n",POR_API_VERSION);
-    return INPHI_OK;
+    por_fw_get_word_source_t get_word;
+    spica_fw_source_t source;
+
+    if(fw_get_word == NULL)
+    {
+        INPHI_CRIT("ERROR: fw_get_word cannot be NULL!\n");
+        return INPHI_ERROR;
+    }
+
+    get_word.fw_get_word = fw_get_word;
+    get_word.user_data   = user_data;
+
+    source.read_start = por_fw_get_word_read;
+    source.read_wait  = NULL;
+    source.user_data  = &get_word;
+
+    return spica_mcu_download_firmware_from_source(die, &source, length, verify);
+}
+
+// Download the firmware from an image source read a chunk at a time
+inphi_status_t por_mcu_download_firmware_from_source(
+    uint32_t               die,
+    const por_fw_source_t* source,
+    uint32_t               length,
+    bool                   verify)
+{
+    return spica_mcu_download_firmware_from_source(die, (const spica_fw_source_t*)source, length, verify);
+}
+
+// Download a compressed firmware image, typically from flash
+inphi_status_t por_mcu_download_firmware_lz(
+    uint32_t       die,
+    const uint8_t* lz_image,
+    uint32_t       lz_length,
+    bool           verify)
+{
+    return spica_mcu_download_firmware_lz(die, lz_image, lz_length, verify);
+}
+
+// Program the same firmware into several dies at once
+inphi_status_t por_mcu_download_firmware_multi(
+    const uint32_t* dies,
+    uint32_t        num_dies,
+    const uint32_t* bcast_dies,
+    uint32_t        num_bcast,
+    const uint32_t* image,
+    uint32_t        image_length,
+    bool            verify)
+{
+    return spica_mcu_download_firmware_multi(dies, num_dies, bcast_dies, num_bcast, image, image_length, verify);
 }
 
 // Download the firmware image from a file
@@ -23124,6 +26985,12 @@ inphi_status_t por_mcu_fw_mode_query(
                                   (e_spica_fw_mode*) mode);
 }
 
+void por_mcu_msg2_cache_invalidate(
+    uint32_t die)
+{
+    spica_mcu_msg2_cache_invalidate(die);
+}
+
 inphi_status_t por_mcu_pc_log_query(
     uint32_t die,
     uint32_t* entries,
@@ -23148,8 +27015,35 @@ inphi_status_t por_mcu_boot_from_shared_eeprom(
     uint32_t* dies,
     uint32_t  num_dies)
 {
-    (void)num_dies;
-    return spica_mcu_download_bootloader(dies[0], false);
+    spica_shared_boot_ctx_t ctx;
+    inphi_status_t status = INPHI_OK;
+    bool done = false;
+
+    status |= spica_mcu_shared_boot_start(&ctx, dies, num_dies);
+    while((status == INPHI_OK) && !done)
+    {
+        INPHI_MDELAY(1);
+        status |= spica_mcu_shared_boot_resume(&ctx, &done);
+    }
+
+    return status;
+}
+
+// Start booting several dies from a shared EEPROM
+inphi_status_t por_mcu_shared_boot_start(
+    por_shared_boot_ctx_t* ctx,
+    const uint32_t* dies,
+    uint32_t num_dies)
+{
+    return spica_mcu_shared_boot_start((spica_shared_boot_ctx_t*)ctx, dies, num_dies);
+}
+
+// Advance a boot from a shared EEPROM
+inphi_status_t por_mcu_shared_boot_resume(
+    por_shared_boot_ctx_t* ctx,
+    bool* done)
+{
+    return spica_mcu_shared_boot_resume((spica_shared_boot_ctx_t*)ctx, done);
 }
 
 /**
@@ -23253,6 +27147,29 @@ inphi_status_t por_spi_write_data_block(
     return spica_spi_write_data_block(die, eeprom_addr, words, num_words, clkdiv); 
 }
 
+inphi_status_t por_spi_eeprom_stream_begin(
+    uint32_t          die,
+    e_por_spi_clk_div clkdiv)
+{
+    return spica_spi_eeprom_stream_begin(die, (e_spica_spi_clk_div)clkdiv);
+}
+
+inphi_status_t por_spi_eeprom_stream_write(
+    uint32_t          die,
+    uint32_t          eeprom_addr,
+    const uint32_t    *words,
+    uint32_t          num_words,
+    e_por_spi_clk_div clkdiv)
+{
+    return spica_spi_eeprom_stream_write(die, eeprom_addr, words, num_words, (e_spica_spi_clk_div)clkdiv);
+}
+
+inphi_status_t por_spi_eeprom_stream_end(
+    uint32_t die)
+{
+    return spica_spi_eeprom_stream_end(die);
+}
+
 #endif // defined(INPHI_HAS_EEPROM_ACCESS) && (INPHI_HAS_EEPROM_ACCESS==1)
 
 
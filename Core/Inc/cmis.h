@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file    cmis.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis.c file (CMIS management memory map on the I2C1 slave).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_H__
+#define __CMIS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Memory map geometry */
+#define CMIS_PAGE_SIZE              128U
+#define CMIS_UPPER_OFFSET           0x80U
+
+/* Lower page (00h) byte addresses */
+#define CMIS_LP_REVISION            0x01U
+#define CMIS_LP_MODULE_STATE        0x03U
+#define CMIS_LP_FLAGS_MODULE        0x08U   /* bytes 8..11, latched, clear on read */
+#define CMIS_LP_FLAGS_MODULE_LEN    4U
+#define CMIS_LP_FLAGS_TEMP_VCC      0x09U
+#define CMIS_LP_TEMP_MONITOR        0x0EU   /* s16, 1/256 degC, big-endian */
+#define CMIS_LP_MASKS_MODULE        0x1FU   /* masks for bytes 8..11 */
+#define CMIS_LP_CDB_STATUS1         0x25U
+#define CMIS_LP_CDB_STATUS2         0x26U
+#define CMIS_LP_BANK_SELECT         0x7EU
+#define CMIS_LP_PAGE_SELECT         0x7FU
+
+/* Module state byte 3: 1 = IntL deasserted */
+#define CMIS_MODULE_STATE_INT_OFF   0x01U
+
+/* Module flag byte 8 */
+#define CMIS_FLAG_CDB_CMD_COMPLETE1 0x40U
+
+/* Alarm/warning bits of a monitor, as in flag byte 9 for the temperature */
+#define CMIS_FLAG_HIGH_ALARM        0x01U
+#define CMIS_FLAG_LOW_ALARM         0x02U
+#define CMIS_FLAG_HIGH_WARNING      0x04U
+#define CMIS_FLAG_LOW_WARNING       0x08U
+
+/* Page 01h advertising, byte 8Eh */
+#define CMIS_P01_PAGES_ADVERTISED   0x8EU
+#define CMIS_P01_VDM_SUPPORTED      0x40U
+
+/* Page 2Fh number of VDM groups supported, minus one */
+#define CMIS_P2F_VDM_GROUPS         0x80U
+
+/* Page 02h thresholds */
+#define CMIS_P02_TEMP_THRESHOLDS    0x80U   /* high alarm, low alarm, high warning, low warning */
+
+/* Page 10h DPDeinit and TxDisable, one bit per lane */
+#define CMIS_P10_DP_DEINIT          0x80U
+#define CMIS_P10_TX_DISABLE         0x82U
+
+/* Page 10h lane masks, one byte per page 11h flag byte in the same order */
+#define CMIS_P10_LANE_MASKS         0xD5U
+
+/* Page 11h DPStateHostLane, 4 bits per lane, lane 1 in the low nibble of 80h */
+#define CMIS_P11_DP_STATE           0x80U
+#define CMIS_DP_STATE_DEACTIVATED   0x1U
+#define CMIS_DP_STATE_INIT          0x2U
+#define CMIS_DP_STATE_ACTIVATED     0x4U
+
+/* Page 11h lane flags, one bit per lane, latched, clear on read */
+#define CMIS_P11_LANE_FLAGS         0x86U
+#define CMIS_P11_LANE_FLAGS_LEN     19U
+#define CMIS_P11_DP_STATE_CHANGED   0x86U
+#define CMIS_P11_RX_LOL             0x94U
+
+/* Upper pages backed by RAM */
+#define CMIS_PAGE_00                0x00U
+#define CMIS_PAGE_01                0x01U
+#define CMIS_PAGE_02                0x02U
+#define CMIS_PAGE_10                0x10U
+#define CMIS_PAGE_11                0x11U
+#define CMIS_PAGE_20                0x20U   /* VDM descriptors, group 1 */
+#define CMIS_PAGE_24                0x24U   /* VDM samples, group 1 */
+#define CMIS_PAGE_2F                0x2FU   /* VDM advertisement and control */
+#define CMIS_PAGE_9F                0x9FU
+#define CMIS_PAGE_EPL_FIRST         0xA0U
+#define CMIS_PAGE_EPL_LAST          0xAFU
+#define CMIS_EPL_PAGES              (CMIS_PAGE_EPL_LAST - CMIS_PAGE_EPL_FIRST + 1U)
+
+/* Revision advertised in byte 01h: CMIS 5.0 */
+#define CMIS_REVISION               0x50U
+
+/* Maximum length of one host write transaction (one page) */
+#define CMIS_MAX_WRITE_LEN          CMIS_PAGE_SIZE
+
+/* Exported functions prototypes ---------------------------------------------*/
+void CMIS_Init(void);
+void CMIS_Process(void);
+uint8_t *CMIS_LowerPage(void);
+uint8_t *CMIS_Page(uint8_t bank, uint8_t page);
+void CMIS_SetModuleFlag(uint8_t offset, uint8_t mask);
+void CMIS_SetLaneFlag(uint8_t offset, uint8_t mask);
+void CMIS_SlaveAddress(uint8_t read);
+void CMIS_SlaveWriteByte(uint8_t byte);
+uint8_t CMIS_SlaveReadByte(void);
+void CMIS_SlaveStop(uint8_t read_nack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_H__ */
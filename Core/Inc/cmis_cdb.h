@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    cmis_cdb.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_cdb.c file (CMIS Command Data Block, firmware management).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_CDB_H__
+#define __CMIS_CDB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Page 9Fh layout, as offsets into the upper page */
+#define CDB_IDX_CMD                 0U      /* CMDID, 2 bytes, big-endian */
+#define CDB_IDX_EPL_LEN             2U      /* EPL length, 2 bytes, big-endian */
+#define CDB_IDX_LPL_LEN             4U
+#define CDB_IDX_CHK_CODE            5U
+#define CDB_IDX_RPL_LEN             6U
+#define CDB_IDX_RPL_CHK_CODE        7U
+#define CDB_IDX_LPL                 8U
+#define CDB_LPL_MAX                 (128U - CDB_IDX_LPL)
+#define CDB_EPL_MAX                 (CMIS_EPL_PAGES * CMIS_PAGE_SIZE)
+
+/* Writing this byte address (second CMDID byte) triggers the command */
+#define CDB_TRIGGER_ADDR            (CMIS_UPPER_OFFSET + CDB_IDX_CMD + 1U)
+
+/* Command IDs */
+#define CDB_CMD_FW_MGMT_FEATURES    0x0041U
+#define CDB_CMD_FW_START            0x0101U
+#define CDB_CMD_FW_ABORT            0x0102U
+#define CDB_CMD_FW_WRITE_LPL        0x0103U
+#define CDB_CMD_FW_WRITE_EPL        0x0104U
+#define CDB_CMD_FW_COMPLETE         0x0107U
+#define CDB_CMD_FW_RUN              0x0109U
+#define CDB_CMD_FW_COMMIT           0x010AU
+
+/* Vendor specific commands */
+#define CDB_CMD_VS_HIST_CAPTURE     0x8010U /* LPL: lane, slice (0..15); runs in the background */
+#define CDB_CMD_VS_HIST_READ        0x8011U /* LPL: first entry of the slice (4 bytes); data returned in EPL */
+
+/* CdbStatus values (lower page byte 25h) */
+#define CDB_STS_BUSY                0x80U
+#define CDB_STS_BUSY_CAPTURED       0x81U
+#define CDB_STS_BUSY_CHECKING       0x82U
+#define CDB_STS_BUSY_EXECUTING      0x83U
+#define CDB_STS_SUCCESS             0x01U
+#define CDB_STS_FAIL                0x40U
+#define CDB_STS_FAIL_UNKNOWN_CMD    0x41U
+#define CDB_STS_FAIL_PARAMETER      0x42U
+#define CDB_STS_FAIL_CHK_CODE       0x45U
+#define CDB_STS_FAIL_STATE          0x47U
+
+/* RPL reported while a command is busy: completion in percent */
+#define CDB_PROGRESS_RPL_LEN        1U
+
+/* Image bytes buffered per stage, one full EPL write */
+#define CDB_STAGE_BYTES             CDB_EPL_MAX
+#define CDB_STAGES                  2U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void CDB_Init(void);
+void CDB_Process(void);
+void CDB_Advertise(uint8_t *page01);
+void CDB_OnHostWrite(uint8_t first, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_CDB_H__ */
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    cmis_ddm.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_ddm.c file (module and lane monitoring, alarm flags).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_DDM_H__
+#define __CMIS_DDM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Line lanes monitored, CMIS lane n is LRX channel n */
+#define DDM_NUM_LANES               4U
+
+/* Time between the start of two monitoring cycles */
+#define DDM_SAMPLE_PERIOD_MS        100U
+
+/* por_rx_dsp_snr_read_db_fixp() counts per dB */
+#define DDM_SNR_FIXP_PER_DB         1600U
+
+/* Threshold table order */
+#define DDM_THR_HIGH_ALARM          0U
+#define DDM_THR_LOW_ALARM           1U
+#define DDM_THR_HIGH_WARNING        2U
+#define DDM_THR_LOW_WARNING         3U
+#define DDM_THR_NUM                 4U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DDM_Init(void);
+void DDM_Process(void);
+int32_t DDM_GetTemperature(void);
+uint16_t DDM_GetLaneSnr(uint8_t lane);
+uint8_t DDM_GetLaneSnrFlags(uint8_t lane);
+const int32_t *DDM_GetSnrThresholds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_DDM_H__ */
@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    cmis_dp.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_dp.c file (CMIS DataPath state machines, DSP bring-up).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_DP_H__
+#define __CMIS_DP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Lanes with a DataPath state machine, CMIS lane n is line channel n */
+#define DP_NUM_LANES                4U
+
+/* Scheduler tick, one bring-up step and one lane per tick */
+#define DP_TICK_MS                  1U
+
+/* Longest a lane waits in DPInit for the link before it is activated anyway */
+#define DP_LINK_TIMEOUT_MS          5000U
+
+/* Time before a failed DSP bring-up is retried */
+#define DP_RETRY_MS                 1000U
+
+/* Time between two checks that an operational DSP was not reset */
+#define DP_HEALTH_MS                100U
+
+/* Unhealthy bring-ups in a row, each after a complete download, before the
+   flash slot booted is rejected (DSP_FW_IN_FLASH) */
+#define DP_SLOT_REJECT_FAILS        3U
+
+/* Register writes of the rules kept for a restore after a DSP reset */
+#define DP_SNAPSHOT_PAIRS           256U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DP_Init(void);
+void DP_Process(void);
+uint8_t DP_IsDspUp(void);
+uint8_t DP_IsTrafficUp(void);
+void DP_Restart(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_DP_H__ */
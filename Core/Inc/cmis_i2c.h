@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    cmis_i2c.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_i2c.c file (I2C1 slave glue of the CMIS memory map).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_I2C_H__
+#define __CMIS_I2C_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Slave timing statistics, in core clock cycles */
+typedef struct
+{
+    uint32_t isr_count;             /* slave callbacks (address, byte, stop) */
+    uint32_t isr_cycles;            /* total time spent in them */
+    uint32_t isr_max_cycles;        /* longest single callback */
+    uint32_t xfer_count;            /* transactions, START to STOP */
+    uint32_t xfer_last_cycles;
+    uint32_t xfer_max_cycles;
+} CMIS_I2C_StatsTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void CMIS_I2C_Listen(void);
+void CMIS_I2C_GetStats(CMIS_I2C_StatsTypeDef *stats);
+void CMIS_I2C_ClearStats(void);
+uint8_t CMIS_I2C_GetFirstAck(uint32_t *tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_I2C_H__ */
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    cmis_txdis.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_txdis.c file (host Tx disable, page 10h byte 82h).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_TXDIS_H__
+#define __CMIS_TXDIS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void TXDIS_Init(void);
+void TXDIS_Resync(void);
+void TXDIS_SetLaneEnable(uint8_t mask);
+void TXDIS_OnHostWrite(uint8_t value);
+uint32_t TXDIS_GetLastLatencyUs(void);
+uint32_t TXDIS_GetMaxLatencyUs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_TXDIS_H__ */
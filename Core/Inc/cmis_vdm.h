@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    cmis_vdm.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the cmis_vdm.c file (CMIS Versatile Diagnostics Monitoring).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMIS_VDM_H__
+#define __CMIS_VDM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Observation interval, min/max/avg on page 24h cover the last complete one */
+#define VDM_INTERVAL_MS             1000U
+
+/* Instances of VDM group 1 (pages 20h/24h) */
+#define VDM_MAX_INSTANCES           64U
+
+/* Observable types, CMIS 5.0 */
+#define VDM_TYPE_ESNR_MEDIA         5U
+#define VDM_TYPE_LTP_MEDIA          7U
+#define VDM_TYPE_BER_MIN_MEDIA      9U
+#define VDM_TYPE_BER_MAX_MEDIA      11U
+#define VDM_TYPE_BER_AVG_MEDIA      13U
+#define VDM_TYPE_BER_CUR_MEDIA      15U
+#define VDM_TYPE_FERC_MIN_MEDIA     17U
+#define VDM_TYPE_FERC_MAX_MEDIA     19U
+#define VDM_TYPE_FERC_AVG_MEDIA     21U
+#define VDM_TYPE_FERC_CUR_MEDIA     23U
+
+/* Vendor specific observable types: interval statistics with no CMIS type */
+#define VDM_TYPE_VS_ESNR_MIN        0x80U
+#define VDM_TYPE_VS_ESNR_MAX        0x81U
+#define VDM_TYPE_VS_ESNR_AVG        0x82U
+#define VDM_TYPE_VS_LTP_MIN         0x83U
+#define VDM_TYPE_VS_LTP_MAX         0x84U
+#define VDM_TYPE_VS_LTP_AVG         0x85U
+#define VDM_TYPE_VS_TEMP_CUR        0x86U
+#define VDM_TYPE_VS_TEMP_MIN        0x87U
+#define VDM_TYPE_VS_TEMP_MAX        0x88U
+#define VDM_TYPE_VS_TEMP_AVG        0x89U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void VDM_Init(void);
+void VDM_Process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMIS_VDM_H__ */
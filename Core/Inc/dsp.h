@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    dsp.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp.c file (Inphi Porrima register access over I2C3).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_H__
+#define __DSP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "por_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Die handle passed to the por_* API for the DSP on this module */
+#define DSP_DIE                   0U
+
+/* 7-bit I2C address of the DSP register port (strapped on the board), shifted for HAL */
+#define DSP_I2C_DEV_ADDR          (0x40U << 1)
+
+/* Register access framing: 32-bit big-endian address followed by 16-bit data */
+#define DSP_I2C_ADDR_BYTES        4U
+#define DSP_I2C_DATA_BYTES        2U
+
+/* SPI EEPROM holding the DSP boot image */
+#define DSP_EEPROM_SIZE_BYTES     (256U * 1024U)
+#define DSP_EEPROM_CLK_DIV        POR_SPI_CLK_DIV_64
+
+/* Set to 1 to download the DSP firmware from the compressed image in flash
+   (dsp_fw_image.c) instead of letting the DSP boot from its SPI EEPROM */
+#define DSP_FW_IN_FLASH           0
+
+/* CRC-32 polynomial of spica_crc32(), the CRC unit reset value */
+#define DSP_CRC32_POLY            0x04C11DB7U
+
+/* Per transfer timeout on the DSP bus */
+#define DSP_I2C_TIMEOUT_MS        5U
+
+/* Burst writes (MCU burst mode): 16-bit data values sent after one address,
+   at most DSP_I2C_BURST_MAX_DATA per transfer */
+#define DSP_I2C_BURST_MAX_DATA    64U
+#define DSP_I2C_BURST_TIMEOUT_MS  10U
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint32_t DSP_GetBusErrorCount(void);
+uint8_t DSP_BusIsBusy(void);
+void DSP_BusRequestRelease(void);
+void DSP_BusReleaseCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_H__ */
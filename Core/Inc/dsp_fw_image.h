@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    dsp_fw_image.h
+  * @brief   This file declares the compressed DSP application firmware kept
+  *          in flash. dsp_fw_image.c is generated from the Inphi
+  *          porrima_gen3_app_fw_image.h release, dropped in
+  *          API/DSP_Inphi/Inc, by the pre-build step of the project:
+  *              Tools/dsp_fw_lz.py API/DSP_Inphi/Inc/porrima_gen3_app_fw_image.h Core/Src/dsp_fw_image.c
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_FW_IMAGE_H__
+#define __DSP_FW_IMAGE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported variables --------------------------------------------------------*/
+/* Image in the por_mcu_download_firmware_lz() format */
+extern const uint8_t dsp_fw_image_lz[];
+extern const uint32_t dsp_fw_image_lz_length;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_FW_IMAGE_H__ */
@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    dsp_fw_src.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp_fw_src.c file (DSP firmware image sources).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_FW_SRC_H__
+#define __DSP_FW_SRC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "por_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Channel copying image chunks out of the flash, memory to memory */
+#define DSP_FW_SRC_DMA_CHANNEL      DMA1_Channel1
+
+/* Longest wait for one chunk */
+#define DSP_FW_SRC_DMA_TIMEOUT_MS   5U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DSP_FwSrcFlash(por_fw_source_t *source, const uint32_t *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_FW_SRC_H__ */
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ident.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp_ident.c file (DSP package type kept in flash).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_IDENT_H__
+#define __DSP_IDENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DSP_IdentInit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_IDENT_H__ */
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    dsp_irq.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp_irq.c file (DSP interrupt line and event dispatcher).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_IRQ_H__
+#define __DSP_IRQ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "por_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Mailbox levels that raise the DSP interrupt: a message waiting in the
+   outbound mailbox, the inbound one drained by the FW */
+#define DSP_IRQ_MBOX_TX_THRESHOLD   1U
+#define DSP_IRQ_MBOX_RX_THRESHOLD   0U
+
+/* FW_INTH bits that report a link change (ORX, MRX, SRX, OTX, MTX, STX) */
+#define DSP_IRQ_FW_INTH_LINK_MASK   0x003FU
+
+/* Shortest time between two dispatches while the line stays low */
+#define DSP_IRQ_HELD_RETRY_US       1000U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DSP_IrqInit(void);
+void DSP_IrqDeInit(void);
+uint32_t DSP_IrqDispatch(void);
+uint32_t DSP_IrqGetCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_IRQ_H__ */
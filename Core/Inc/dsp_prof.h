@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    dsp_prof.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp_prof.c file (DSP bring-up phase timing).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_PROF_H__
+#define __DSP_PROF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "por_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Phases, the POR_BOOT_PHASE_* reported by the API first */
+#define DSP_PROF_PHASE_BRINGUP      POR_BOOT_PHASE_NUM          /* DSP down until operational */
+#define DSP_PROF_PHASE_LINK         (POR_BOOT_PHASE_NUM + 1U)   /* DPInit link wait, one per lane */
+#define DSP_PROF_LINK_PHASES        4U
+#define DSP_PROF_NUM_PHASES         (DSP_PROF_PHASE_LINK + DSP_PROF_LINK_PHASES)
+
+/* Set to 1 to print the record on USART2 when a bring-up has completed.
+   Blocking, the main loop stalls while it goes out: bench builds only */
+#define DSP_PROF_UART_DUMP          0
+#define DSP_PROF_UART_TIMEOUT_MS    50U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+    uint32_t count;                 // times the phase completed
+    uint32_t first_ms;              // first start, from DSP_ProfReset()
+    uint32_t total_us;
+    uint32_t max_us;
+    uint32_t start_cycles;          // DWT cycle count of the pending start
+    uint8_t active;
+} DSP_ProfPhaseTypeDef;
+
+typedef struct
+{
+    uint32_t reset_tick;            // HAL_GetTick() at DSP_ProfReset()
+    uint32_t sysclk_hz;
+    DSP_ProfPhaseTypeDef phase[DSP_PROF_NUM_PHASES];
+} DSP_ProfTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DSP_ProfReset(void);
+void DSP_ProfEnter(uint32_t phase);
+void DSP_ProfExit(uint32_t phase);
+void DSP_ProfAdd(uint32_t phase, uint32_t us);
+const DSP_ProfTypeDef *DSP_ProfGet(void);
+uint8_t DSP_ProfDump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_PROF_H__ */
@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file    dsp_slot.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the dsp_slot.c file (A/B DSP firmware slots in flash).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_SLOT_H__
+#define __DSP_SLOT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "flash_if.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define DSP_SLOT_NUM                2U
+#define DSP_SLOT_NONE               0xFFU
+
+/* Each slot is a header followed by the image */
+#define DSP_SLOT_HDR_SIZE           32U
+#define DSP_SLOT_IMAGE_MAX          (FLASH_IF_SLOT_SIZE - DSP_SLOT_HDR_SIZE)
+
+/* Most image bytes a caller should program per main loop pass */
+#define DSP_SLOT_WRITE_BYTES        256U
+
+/* Exported functions prototypes ---------------------------------------------*/
+void DSP_SlotInit(void);
+uint8_t DSP_SlotActive(void);
+const uint8_t *DSP_SlotImage(uint8_t slot, uint32_t *length);
+uint8_t DSP_SlotReject(uint8_t slot);
+HAL_StatusTypeDef DSP_SlotWriteBegin(uint32_t length, uint32_t version);
+HAL_StatusTypeDef DSP_SlotWrite(uint32_t offset, const uint8_t *data, uint32_t len);
+HAL_StatusTypeDef DSP_SlotWriteEnd(void);
+void DSP_SlotWriteAbort(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_SLOT_H__ */
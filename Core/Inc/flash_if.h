@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    flash_if.h
+  * @brief   This file contains the definitions and function prototypes for
+  *          the flash_if.c file (data pages kept in the internal flash).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_IF_H__
+#define __FLASH_IF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The data pages sit at the top of the 512K, the FLASH region of the linker
+   script stops below them. The DSP firmware slots are the top of the FLASH
+   region itself (.dsp_slots), see dsp_slot.c */
+#define FLASH_IF_END                (FLASH_BASE + 512U * 1024U)
+
+/* DSP identity record (dsp_ident.c), last page */
+#define FLASH_IF_IDENT_ADDR         (FLASH_IF_END - FLASH_PAGE_SIZE)
+
+/* DSP firmware slots A and B (dsp_slot.c), right below the identity page,
+   keep in line with .dsp_slots in STM32L452RETX_FLASH.ld */
+#define FLASH_IF_SLOT_SIZE          (126U * 1024U)
+
+/* Exported functions prototypes ---------------------------------------------*/
+HAL_StatusTypeDef FLASH_If_Erase(uint32_t addr, uint32_t len);
+HAL_StatusTypeDef FLASH_If_Write(uint32_t addr, const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASH_IF_H__ */
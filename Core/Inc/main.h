@@ -70,6 +70,9 @@ void Error_Handler(void);
 #define USART_RX_GPIO_Port GPIOA
 #define LD4_Pin GPIO_PIN_5
 #define LD4_GPIO_Port GPIOA
+#define DSP_INT_N_Pin GPIO_PIN_0
+#define DSP_INT_N_GPIO_Port GPIOB
+#define DSP_INT_N_EXTI_IRQn EXTI0_IRQn
 #define I2C2_Master_SCL_Pin GPIO_PIN_10
 #define I2C2_Master_SCL_GPIO_Port GPIOB
 #define I2C2_Master_SDA_Pin GPIO_PIN_11
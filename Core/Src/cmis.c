@@ -0,0 +1,425 @@
+/**
+  ******************************************************************************
+  * @file    cmis.c
+  * @brief   This file provides the CMIS management memory map presented to
+  *          the host on the I2C1 slave (address 0xA0).
+  *
+  *          Reads are served byte by byte from RAM inside the I2C1 interrupt.
+  *          Writes are collected for the whole transaction and committed on
+  *          STOP/repeated START, after which the write hooks run (page select,
+  *          CDB trigger, ...). The only hook that touches the DSP from the
+  *          interrupt is the Tx disable one, see cmis_txdis.c.
+  *
+  *          The interrupt drives the memory map through the CMIS_Slave*
+  *          events. The HAL glue is in cmis_i2c.c, so this file does not
+  *          depend on the I2C driver and the events can be replayed off
+  *          target, see Test/Src/cmis_host.c.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis.h"
+#include "cmis_cdb.h"
+#include "cmis_ddm.h"
+#include "cmis_dp.h"
+#include "cmis_vdm.h"
+#include "cmis_txdis.h"
+#include "cmis_i2c.h"
+#include "dsp_ident.h"
+#include "dsp.h"
+#if DSP_FW_IN_FLASH
+#include "dsp_slot.h"
+#endif
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    CMIS_XFER_IDLE = 0,
+    CMIS_XFER_WRITE,
+    CMIS_XFER_READ
+} CMIS_XferTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t cmis_lower[CMIS_PAGE_SIZE];
+static uint8_t cmis_page00[CMIS_PAGE_SIZE];
+static uint8_t cmis_page01[CMIS_PAGE_SIZE];
+static uint8_t cmis_page02[CMIS_PAGE_SIZE];
+static uint8_t cmis_page10[CMIS_PAGE_SIZE];
+static uint8_t cmis_page11[CMIS_PAGE_SIZE];
+static uint8_t cmis_page20[CMIS_PAGE_SIZE];
+static uint8_t cmis_page24[CMIS_PAGE_SIZE];
+static uint8_t cmis_page2f[CMIS_PAGE_SIZE];
+static uint8_t cmis_page9f[CMIS_PAGE_SIZE];
+static uint8_t cmis_epl[CMIS_EPL_PAGES][CMIS_PAGE_SIZE];
+
+/* Upper page currently selected by bytes 7Eh/7Fh, NULL if not implemented */
+static uint8_t *volatile cmis_upper = cmis_page00;
+
+/* Transaction state, owned by the I2C1 interrupt */
+static volatile CMIS_XferTypeDef cmis_xfer = CMIS_XFER_IDLE;
+static uint8_t cmis_addr;
+static uint8_t cmis_tx_prefetched;
+static uint8_t *cmis_rd_cleared;        /* latched byte cleared by the last prefetch */
+static uint8_t cmis_rd_cleared_value;
+static uint8_t cmis_wr_offset;
+static uint8_t cmis_wr_len;
+static uint8_t cmis_wr_addr_valid;
+static uint8_t cmis_wr_buf[CMIS_MAX_WRITE_LEN];
+
+/* Private function prototypes -----------------------------------------------*/
+static void CMIS_DefaultsInit(void);
+static uint8_t CMIS_NextAddr(uint8_t addr);
+static uint8_t CMIS_ReadByte(uint8_t addr);
+static uint8_t CMIS_IsWritable(uint8_t page, uint8_t addr);
+static void CMIS_CommitWrite(void);
+static void CMIS_UpdateInterrupt(void);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Populate the memory map and start listening on the I2C1 slave.
+  * @retval None
+  */
+void CMIS_Init(void)
+{
+    /* Cycle counter for the latency statistics (cmis_i2c.c, cmis_txdis.c) */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Package type first, every module maps its lanes with it */
+    DSP_IdentInit();
+#if DSP_FW_IN_FLASH
+    DSP_SlotInit();
+#endif
+
+    CMIS_DefaultsInit();
+    CDB_Init();
+    DDM_Init();
+    DP_Init();
+    TXDIS_Init();
+    VDM_Init();
+
+    CMIS_I2C_Listen();
+}
+
+/**
+  * @brief  Background work for the management interface, call from the main loop.
+  * @retval None
+  */
+void CMIS_Process(void)
+{
+    CDB_Process();
+    DDM_Process();
+    DP_Process();
+    VDM_Process();
+    CMIS_UpdateInterrupt();
+}
+
+/**
+  * @brief  Access the lower page (bytes 00h-7Fh).
+  * @retval pointer to the 128 byte lower page
+  */
+uint8_t *CMIS_LowerPage(void)
+{
+    return cmis_lower;
+}
+
+/**
+  * @brief  Access an upper page by bank/page number.
+  * @param  bank: bank number (only bank 0 is implemented)
+  * @param  page: page number
+  * @retval pointer to the 128 byte page, NULL if the page is not implemented
+  */
+uint8_t *CMIS_Page(uint8_t bank, uint8_t page)
+{
+    if(bank != 0U)
+    {
+        return NULL;
+    }
+
+    switch(page)
+    {
+        case CMIS_PAGE_00: return cmis_page00;
+        case CMIS_PAGE_01: return cmis_page01;
+        case CMIS_PAGE_02: return cmis_page02;
+        case CMIS_PAGE_10: return cmis_page10;
+        case CMIS_PAGE_11: return cmis_page11;
+        case CMIS_PAGE_20: return cmis_page20;
+        case CMIS_PAGE_24: return cmis_page24;
+        case CMIS_PAGE_2F: return cmis_page2f;
+        case CMIS_PAGE_9F: return cmis_page9f;
+        default: break;
+    }
+
+    if((page >= CMIS_PAGE_EPL_FIRST) && (page <= CMIS_PAGE_EPL_LAST))
+    {
+        return cmis_epl[page - CMIS_PAGE_EPL_FIRST];
+    }
+    return NULL;
+}
+
+/**
+  * @brief  Latch a flag in the lower page, it is cleared when the host reads it.
+  * @param  offset: lower page byte address of the flag byte
+  * @param  mask: flag bits to set
+  * @retval None
+  */
+void CMIS_SetModuleFlag(uint8_t offset, uint8_t mask)
+{
+    __disable_irq();
+    cmis_lower[offset] |= mask;
+    __enable_irq();
+}
+
+/**
+  * @brief  Latch a lane flag on page 11h, it is cleared when the host reads it.
+  * @param  offset: page 11h byte address of the flag byte
+  * @param  mask: lane bits to set
+  * @retval None
+  */
+void CMIS_SetLaneFlag(uint8_t offset, uint8_t mask)
+{
+    __disable_irq();
+    cmis_page11[offset - CMIS_UPPER_OFFSET] |= mask;
+    __enable_irq();
+}
+
+/* Slave events --------------------------------------------------------------*/
+/**
+  * @brief  Host addressed the module (START or repeated START).
+  * @note   Called from the I2C1 interrupt, see cmis_i2c.c.
+  * @param  read: 1 if the host reads, 0 if it writes
+  * @retval None
+  */
+void CMIS_SlaveAddress(uint8_t read)
+{
+    /* A repeated START ends any write in progress */
+    if(cmis_xfer == CMIS_XFER_WRITE)
+    {
+        CMIS_CommitWrite();
+    }
+
+    if(!read)
+    {
+        /* Host writes: first byte is the byte address */
+        cmis_xfer = CMIS_XFER_WRITE;
+        cmis_wr_addr_valid = 0;
+        cmis_wr_len = 0;
+    }
+    else
+    {
+        /* Host reads from the current address */
+        cmis_xfer = CMIS_XFER_READ;
+    }
+}
+
+/**
+  * @brief  Byte written by the host.
+  * @note   Called from the I2C1 interrupt, see cmis_i2c.c.
+  * @param  byte: the received byte
+  * @retval None
+  */
+void CMIS_SlaveWriteByte(uint8_t byte)
+{
+    if(!cmis_wr_addr_valid)
+    {
+        cmis_addr = byte;
+        cmis_wr_offset = byte;
+        cmis_wr_addr_valid = 1;
+    }
+    else if(cmis_wr_len < CMIS_MAX_WRITE_LEN)
+    {
+        cmis_wr_buf[cmis_wr_len++] = byte;
+    }
+}
+
+/**
+  * @brief  Next byte to send to the host, the address moves on.
+  * @note   Called from the I2C1 interrupt, see cmis_i2c.c.
+  * @retval the byte at the current address
+  */
+uint8_t CMIS_SlaveReadByte(void)
+{
+    uint8_t value;
+
+    cmis_rd_cleared = NULL;
+    value = CMIS_ReadByte(cmis_addr);
+    cmis_addr = CMIS_NextAddr(cmis_addr);
+    cmis_tx_prefetched = 1;
+    return value;
+}
+
+/**
+  * @brief  End of the transaction (STOP, or a bus error).
+  * @note   Called from the I2C1 interrupt, see cmis_i2c.c.
+  * @param  read_nack: 1 if the host NACKed a read byte
+  * @retval None
+  */
+void CMIS_SlaveStop(uint8_t read_nack)
+{
+    /* The host NACKs the last byte of a read. The byte queued behind it
+     * never left the shift register, so step the address back over it and
+     * give back the flags its prefetch cleared. */
+    if(read_nack && (cmis_xfer == CMIS_XFER_READ) && cmis_tx_prefetched)
+    {
+        cmis_addr = (cmis_addr == CMIS_UPPER_OFFSET) ? 0xFFU : (uint8_t)(cmis_addr - 1U);
+        if(cmis_rd_cleared != NULL)
+        {
+            *cmis_rd_cleared |= cmis_rd_cleared_value;
+        }
+    }
+    else if(cmis_xfer == CMIS_XFER_WRITE)
+    {
+        CMIS_CommitWrite();
+    }
+    cmis_tx_prefetched = 0;
+    cmis_rd_cleared = NULL;
+    cmis_xfer = CMIS_XFER_IDLE;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void CMIS_DefaultsInit(void)
+{
+    memset(cmis_lower, 0, sizeof(cmis_lower));
+    cmis_lower[0x00] = 0x18;                /* Identifier: QSFP-DD (CMIS) */
+    cmis_lower[CMIS_LP_REVISION] = CMIS_REVISION;
+    cmis_lower[0x02] = 0x00;                /* Paged memory, stepped config supported */
+    cmis_lower[CMIS_LP_MODULE_STATE] = (0x03 << 1) | CMIS_MODULE_STATE_INT_OFF; /* ModuleReady */
+
+    cmis_page00[0x00] = cmis_lower[0x00];
+    CDB_Advertise(cmis_page01);
+    cmis_upper = cmis_page00;
+}
+
+static uint8_t CMIS_NextAddr(uint8_t addr)
+{
+    /* Sequential access wraps within the upper page */
+    return (addr == 0xFFU) ? CMIS_UPPER_OFFSET : (uint8_t)(addr + 1U);
+}
+
+static uint8_t CMIS_ReadByte(uint8_t addr)
+{
+    uint8_t value;
+    uint8_t *upper;
+
+    if(addr < CMIS_UPPER_OFFSET)
+    {
+        value = cmis_lower[addr];
+        /* Latched flags clear on read, kept aside until the byte is sent */
+        if((addr >= CMIS_LP_FLAGS_MODULE) && (addr < CMIS_LP_FLAGS_MODULE + CMIS_LP_FLAGS_MODULE_LEN))
+        {
+            cmis_rd_cleared = &cmis_lower[addr];
+            cmis_rd_cleared_value = value;
+            cmis_lower[addr] = 0;
+        }
+        return value;
+    }
+
+    upper = cmis_upper;
+    if(upper == NULL)
+    {
+        return 0U;
+    }
+    value = upper[addr - CMIS_UPPER_OFFSET];
+    if((upper == cmis_page11) && (addr >= CMIS_P11_LANE_FLAGS) && (addr < CMIS_P11_LANE_FLAGS + CMIS_P11_LANE_FLAGS_LEN))
+    {
+        cmis_rd_cleared = &upper[addr - CMIS_UPPER_OFFSET];
+        cmis_rd_cleared_value = value;
+        upper[addr - CMIS_UPPER_OFFSET] = 0;
+    }
+    return value;
+}
+
+static uint8_t CMIS_IsWritable(uint8_t page, uint8_t addr)
+{
+    if(addr < CMIS_UPPER_OFFSET)
+    {
+        /* Module global controls, masks, password and page select bytes */
+        return (addr == 0x1AU) || ((addr >= 0x1FU) && (addr <= 0x24U)) ||
+               ((addr >= 0x7AU) && (addr <= CMIS_LP_PAGE_SELECT));
+    }
+    return (page == CMIS_PAGE_10) || (page == CMIS_PAGE_9F) ||
+           ((page >= CMIS_PAGE_EPL_FIRST) && (page <= CMIS_PAGE_EPL_LAST));
+}
+
+/* Runs in interrupt context at the end of a host write */
+static void CMIS_CommitWrite(void)
+{
+    uint8_t addr = cmis_wr_offset;
+    uint8_t page = cmis_lower[CMIS_LP_PAGE_SELECT];
+    uint8_t *upper = cmis_upper;
+    uint8_t page_changed = 0;
+    uint8_t first = cmis_wr_offset;
+    uint8_t i;
+
+    cmis_xfer = CMIS_XFER_IDLE;
+    if(!cmis_wr_addr_valid || (cmis_wr_len == 0U))
+    {
+        /* Address-only write, sets the pointer for the next read */
+        return;
+    }
+
+    for(i = 0; i < cmis_wr_len; i++)
+    {
+        if(CMIS_IsWritable(page, addr))
+        {
+            if(addr < CMIS_UPPER_OFFSET)
+            {
+                cmis_lower[addr] = cmis_wr_buf[i];
+                if((addr == CMIS_LP_BANK_SELECT) || (addr == CMIS_LP_PAGE_SELECT))
+                {
+                    page_changed = 1;
+                }
+            }
+            else if(upper != NULL)
+            {
+                upper[addr - CMIS_UPPER_OFFSET] = cmis_wr_buf[i];
+            }
+        }
+        addr = CMIS_NextAddr(addr);
+    }
+    cmis_addr = addr;
+
+    if(page_changed)
+    {
+        cmis_upper = CMIS_Page(cmis_lower[CMIS_LP_BANK_SELECT], cmis_lower[CMIS_LP_PAGE_SELECT]);
+    }
+    else if((page == CMIS_PAGE_9F) && (first >= CMIS_UPPER_OFFSET))
+    {
+        CDB_OnHostWrite(first, cmis_wr_len);
+    }
+    else if((page == CMIS_PAGE_10) && (first <= CMIS_P10_TX_DISABLE) &&
+            ((first + cmis_wr_len) > CMIS_P10_TX_DISABLE))
+    {
+        TXDIS_OnHostWrite(cmis_page10[CMIS_P10_TX_DISABLE - CMIS_UPPER_OFFSET]);
+    }
+}
+
+/* Drive the Interrupt bit of byte 3 from the unmasked latched flags */
+static void CMIS_UpdateInterrupt(void)
+{
+    uint8_t pending = 0;
+    uint8_t i;
+
+    for(i = 0; i < CMIS_LP_FLAGS_MODULE_LEN; i++)
+    {
+        pending |= cmis_lower[CMIS_LP_FLAGS_MODULE + i] & (uint8_t)~cmis_lower[CMIS_LP_MASKS_MODULE + i];
+    }
+    for(i = 0; i < CMIS_P11_LANE_FLAGS_LEN; i++)
+    {
+        pending |= cmis_page11[CMIS_P11_LANE_FLAGS - CMIS_UPPER_OFFSET + i] &
+                   (uint8_t)~cmis_page10[CMIS_P10_LANE_MASKS - CMIS_UPPER_OFFSET + i];
+    }
+
+    __disable_irq();
+    if(pending)
+    {
+        cmis_lower[CMIS_LP_MODULE_STATE] &= (uint8_t)~CMIS_MODULE_STATE_INT_OFF;
+    }
+    else
+    {
+        cmis_lower[CMIS_LP_MODULE_STATE] |= CMIS_MODULE_STATE_INT_OFF;
+    }
+    __enable_irq();
+}
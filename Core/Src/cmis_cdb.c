@@ -0,0 +1,751 @@
+/**
+  ******************************************************************************
+  * @file    cmis_cdb.c
+  * @brief   This file provides the CMIS CDB (Command Data Block) engine and the
+  *          firmware download commands that program the DSP boot EEPROM.
+  *
+  *          The I2C1 interrupt only marks a command as captured. Commands run
+  *          from CMIS_Process() in the main loop in background mode: a long
+  *          command is split into steps that each do a bounded amount of DSP
+  *          work, and is resumed on every loop pass until it finishes. While
+  *          busy, the RPL on page 9Fh reports its progress in percent. The
+  *          host keeps full access to the memory map in the meantime, as
+  *          reads and writes are served from RAM by the interrupt.
+  *
+  *          Image blocks written by the
+  *          host are copied into one of two stages and acknowledged straight
+  *          away; the stages are drained into the SPI EEPROM one segment per
+  *          loop pass, so the host can send the next block while the EEPROM
+  *          is busy with its write cycle.
+  *
+  *          With DSP_FW_IN_FLASH the DSP has no EEPROM and the image goes to
+  *          the standby flash slot instead (dsp_slot.c), DSP_SLOT_WRITE_BYTES
+  *          per loop pass. Blocks must then come in address order. Complete
+  *          makes the slot the active one, Run restarts the DSP from it.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_cdb.h"
+#include "cmis_dp.h"
+#include "dsp.h"
+#if DSP_FW_IN_FLASH
+#include "dsp_slot.h"
+#endif
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    CDB_FW_IDLE = 0,
+    CDB_FW_DOWNLOADING,
+    CDB_FW_COMPLETE
+} CDB_FwStateTypeDef;
+
+typedef struct
+{
+    uint32_t addr;          // EEPROM byte address of data[0]
+    uint16_t len;           // bytes held
+    uint16_t done;          // bytes already programmed
+    uint8_t  full;
+    uint8_t  data[CDB_STAGE_BYTES];
+} CDB_StageTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define CDB_SEGMENT_BYTES           (POR_SPI_EEPROM_SEGMENT_WORDS * 4U)
+#define CDB_HIST_SLICES             16U
+#define CDB_HIST_ENTRIES            (4U * 256U)     // one slice: 4 humps of 256 bins
+
+/* Where the image goes */
+#if DSP_FW_IN_FLASH
+#define CDB_IMAGE_MAX               DSP_SLOT_IMAGE_MAX
+#else
+#define CDB_IMAGE_MAX               DSP_EEPROM_SIZE_BYTES
+#endif
+
+/* Optional image version in the start command LPL, after size and reserved:
+   the vendor bytes of the start command payload */
+#define CDB_START_VERSION_IDX       8U
+#define CDB_START_VENDOR_BYTES      4U
+
+/* Private variables ---------------------------------------------------------*/
+/* Command capture, cdb_pending is set by the I2C1 interrupt */
+static volatile uint8_t cdb_pending = 0;
+static uint8_t cdb_captured = 0;
+static uint8_t cdb_cmd[CMIS_PAGE_SIZE];
+static uint8_t cdb_rpl_progress = 0;
+
+/* Firmware download */
+static CDB_FwStateTypeDef cdb_fw_state = CDB_FW_IDLE;
+static uint32_t cdb_fw_size;
+static uint32_t cdb_fw_received;
+static uint32_t cdb_fw_programmed;
+static uint8_t cdb_fw_error;
+static uint8_t cdb_stage_wr;
+static uint8_t cdb_stage_rd;
+static uint8_t cdb_seg_in_flight;
+static uint32_t cdb_seg_tick;
+
+/* Histogram capture, one slice at a time */
+static por_lrx_hist_ctx_t cdb_hist_ctx;
+static uint8_t cdb_hist_running;
+static uint8_t cdb_hist_valid;
+
+/* The stages and the histogram slice share their memory: a capture is
+   refused while downloading and a download start drops the slice */
+static union
+{
+    CDB_StageTypeDef stage[CDB_STAGES];
+    uint32_t hist[CDB_HIST_ENTRIES];
+} cdb_buf;
+
+/* Reply to CDB_CMD_FW_MGMT_FEATURES */
+static const uint8_t cdb_fw_features[] =
+{
+    0x00,           // reserved
+    0x00,           // no image readback, no copy, no abort of running image
+    CDB_START_VENDOR_BYTES, // start command payload: vendor bytes after size and reserved
+    0xFF,           // erased byte value
+    0xFF,           // read/write length extension: 8 * (1 + 255) = 2048 bytes
+    0x11,           // write mechanism: LPL and EPL
+    0x00,           // read mechanism: none
+    0x00,           // no hitless restart
+    0x00, 0x32,     // max duration start, ms
+    0x00, 0x32,     // max duration abort, ms
+    0x00, 0x64,     // max duration write, ms
+    0x03, 0xE8,     // max duration complete, ms
+    0x00, 0x00      // max duration copy, ms
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t CDB_Execute(void);
+static uint8_t CDB_FwStart(const uint8_t *lpl);
+static uint8_t CDB_FwAbort(void);
+static uint8_t CDB_FwWrite(const uint8_t *lpl, uint16_t len, uint8_t epl);
+static uint8_t CDB_FwComplete(void);
+static uint8_t CDB_FwRun(void);
+static uint8_t CDB_HistCapture(const uint8_t *lpl);
+static uint8_t CDB_HistRead(const uint8_t *lpl);
+static void CDB_StreamService(void);
+static uint8_t CDB_WriteCycleDone(void);
+static void CDB_StagesReset(void);
+static uint8_t CDB_ImageOpen(uint32_t size, uint32_t version);
+static uint8_t CDB_ImageClose(uint8_t complete);
+static void CDB_SetReply(const uint8_t *rpl, uint8_t len);
+static void CDB_SetProgress(uint32_t done, uint32_t total);
+static void CDB_Finish(uint8_t status);
+static uint8_t CDB_CheckCode(const uint8_t *buf, uint16_t len);
+static uint32_t CDB_GetBE32(const uint8_t *buf);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Reset the CDB engine.
+  * @retval None
+  */
+void CDB_Init(void)
+{
+    cdb_pending = 0;
+    cdb_captured = 0;
+    cdb_fw_state = CDB_FW_IDLE;
+    cdb_fw_error = 0;
+    cdb_hist_running = 0;
+    cdb_hist_valid = 0;
+    CDB_StagesReset();
+    CMIS_LowerPage()[CMIS_LP_CDB_STATUS1] = 0;
+}
+
+/**
+  * @brief  Run captured commands and drain staged image data, call from the main loop.
+  * @retval None
+  */
+void CDB_Process(void)
+{
+    uint8_t *lower = CMIS_LowerPage();
+    uint8_t *page9f;
+    uint8_t chk_code;
+    uint8_t status;
+
+    CDB_StreamService();
+
+    if(!cdb_pending)
+    {
+        return;
+    }
+
+    if(!cdb_captured)
+    {
+        // Work on a copy so a misbehaving host cannot change the command under us
+        page9f = CMIS_Page(0, CMIS_PAGE_9F);
+        memcpy(cdb_cmd, page9f, CMIS_PAGE_SIZE);
+        cdb_captured = 1;
+        lower[CMIS_LP_CDB_STATUS1] = CDB_STS_BUSY_CHECKING;
+        page9f[CDB_IDX_RPL_LEN] = 0;
+        page9f[CDB_IDX_RPL_CHK_CODE] = 0;
+
+        // The check code byte itself counts as zero
+        chk_code = cdb_cmd[CDB_IDX_CHK_CODE];
+        cdb_cmd[CDB_IDX_CHK_CODE] = 0;
+
+        if(cdb_cmd[CDB_IDX_LPL_LEN] > CDB_LPL_MAX)
+        {
+            CDB_Finish(CDB_STS_FAIL_PARAMETER);
+            return;
+        }
+        if(CDB_CheckCode(cdb_cmd, CDB_IDX_LPL + cdb_cmd[CDB_IDX_LPL_LEN]) != chk_code)
+        {
+            CDB_Finish(CDB_STS_FAIL_CHK_CODE);
+            return;
+        }
+        lower[CMIS_LP_CDB_STATUS1] = CDB_STS_BUSY_EXECUTING;
+    }
+
+    // Commands that must wait for the EEPROM report busy and are retried
+    status = CDB_Execute();
+    if(status != CDB_STS_BUSY_EXECUTING)
+    {
+        CDB_Finish(status);
+    }
+}
+
+/**
+  * @brief  Fill in the CDB advertisement on page 01h.
+  * @param  page01: the upper page 01h
+  * @retval None
+  */
+void CDB_Advertise(uint8_t *page01)
+{
+    page01[163 - CMIS_UPPER_OFFSET] = (1U << 6) | (1U << 5) | 0x05U;  // one CDB instance, background mode, EPL pages A0h-AFh
+    page01[164 - CMIS_UPPER_OFFSET] = 0xFFU;               // 2048 byte read/write length
+    page01[165 - CMIS_UPPER_OFFSET] = 0x00U;               // triggered by writing CMDID
+}
+
+/**
+  * @brief  Host write hook for page 9Fh, called from the I2C1 interrupt.
+  * @param  first: byte address of the first byte written
+  * @param  len: number of bytes written
+  * @retval None
+  */
+void CDB_OnHostWrite(uint8_t first, uint8_t len)
+{
+    uint8_t *lower = CMIS_LowerPage();
+
+    if((first > CDB_TRIGGER_ADDR) || (((uint16_t)first + len) <= CDB_TRIGGER_ADDR))
+    {
+        return;
+    }
+
+    // A new command is ignored while the previous one is still running
+    if(cdb_pending || (lower[CMIS_LP_CDB_STATUS1] & CDB_STS_BUSY))
+    {
+        return;
+    }
+
+    lower[CMIS_LP_CDB_STATUS1] = CDB_STS_BUSY_CAPTURED;
+    cdb_captured = 0;
+    cdb_pending = 1;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint8_t CDB_Execute(void)
+{
+    uint16_t cmd = ((uint16_t)cdb_cmd[CDB_IDX_CMD] << 8) | cdb_cmd[CDB_IDX_CMD + 1];
+    uint16_t epl_len = ((uint16_t)cdb_cmd[CDB_IDX_EPL_LEN] << 8) | cdb_cmd[CDB_IDX_EPL_LEN + 1];
+    const uint8_t *lpl = &cdb_cmd[CDB_IDX_LPL];
+
+    switch(cmd)
+    {
+        case CDB_CMD_FW_MGMT_FEATURES:
+            CDB_SetReply(cdb_fw_features, sizeof(cdb_fw_features));
+            return CDB_STS_SUCCESS;
+
+        case CDB_CMD_FW_START:
+            return CDB_FwStart(lpl);
+
+        case CDB_CMD_FW_ABORT:
+            return CDB_FwAbort();
+
+        case CDB_CMD_FW_WRITE_LPL:
+            if(cdb_cmd[CDB_IDX_LPL_LEN] <= 4U)
+            {
+                return CDB_STS_FAIL_PARAMETER;
+            }
+            return CDB_FwWrite(lpl, cdb_cmd[CDB_IDX_LPL_LEN] - 4U, 0);
+
+        case CDB_CMD_FW_WRITE_EPL:
+            if((epl_len == 0U) || (epl_len > CDB_EPL_MAX))
+            {
+                return CDB_STS_FAIL_PARAMETER;
+            }
+            return CDB_FwWrite(lpl, epl_len, 1);
+
+        case CDB_CMD_FW_COMPLETE:
+            return CDB_FwComplete();
+
+        case CDB_CMD_FW_RUN:
+            return CDB_FwRun();
+
+        case CDB_CMD_FW_COMMIT:
+            // The EEPROM holds a single image and a completed slot is the
+            // active one, the image is committed once written
+            return (cdb_fw_state == CDB_FW_DOWNLOADING) ? CDB_STS_FAIL_STATE : CDB_STS_SUCCESS;
+
+        case CDB_CMD_VS_HIST_CAPTURE:
+            return CDB_HistCapture(lpl);
+
+        case CDB_CMD_VS_HIST_READ:
+            return CDB_HistRead(lpl);
+
+        default:
+            return CDB_STS_FAIL_UNKNOWN_CMD;
+    }
+}
+
+static uint8_t CDB_FwStart(const uint8_t *lpl)
+{
+    uint32_t size = CDB_GetBE32(lpl);
+    uint32_t version = 0;
+
+    // Restarting aborts the previous download, let the last segment finish first
+    if(cdb_fw_state == CDB_FW_DOWNLOADING)
+    {
+        if(!CDB_WriteCycleDone())
+        {
+            return CDB_STS_BUSY_EXECUTING;
+        }
+        CDB_ImageClose(0);
+        cdb_fw_state = CDB_FW_IDLE;
+    }
+
+    if((size == 0U) || (size > CDB_IMAGE_MAX))
+    {
+        return CDB_STS_FAIL_PARAMETER;
+    }
+    if(cdb_cmd[CDB_IDX_LPL_LEN] >= (CDB_START_VERSION_IDX + CDB_START_VENDOR_BYTES))
+    {
+        version = CDB_GetBE32(&lpl[CDB_START_VERSION_IDX]);
+    }
+
+    CDB_StagesReset();
+    if(!CDB_ImageOpen(size, version))
+    {
+        return CDB_STS_FAIL;
+    }
+
+    cdb_fw_size = size;
+    cdb_fw_received = 0;
+    cdb_fw_programmed = 0;
+    cdb_fw_error = 0;
+    cdb_fw_state = CDB_FW_DOWNLOADING;
+    return CDB_STS_SUCCESS;
+}
+
+static uint8_t CDB_FwAbort(void)
+{
+    if(cdb_fw_state == CDB_FW_DOWNLOADING)
+    {
+        if(!CDB_WriteCycleDone())
+        {
+            return CDB_STS_BUSY_EXECUTING;
+        }
+        CDB_ImageClose(0);
+    }
+    CDB_StagesReset();
+    cdb_fw_state = CDB_FW_IDLE;
+    return CDB_STS_SUCCESS;
+}
+
+static uint8_t CDB_FwWrite(const uint8_t *lpl, uint16_t len, uint8_t epl)
+{
+    uint32_t addr = CDB_GetBE32(lpl);
+    CDB_StageTypeDef *stage = &cdb_buf.stage[cdb_stage_wr];
+    uint16_t copied;
+    uint16_t chunk;
+    uint8_t page;
+
+    if(cdb_fw_state != CDB_FW_DOWNLOADING)
+    {
+        return CDB_STS_FAIL_STATE;
+    }
+    if((addr & 3U) || (addr >= cdb_fw_size) || (len > cdb_fw_size - addr))
+    {
+        return CDB_STS_FAIL_PARAMETER;
+    }
+
+    // Both stages still queued for the EEPROM, keep the host waiting
+    if(stage->full)
+    {
+        return CDB_STS_BUSY_EXECUTING;
+    }
+
+    if(!epl)
+    {
+        memcpy(stage->data, &lpl[4], len);
+    }
+    else
+    {
+        // EPL pages are separate 128 byte pages in the memory map
+        for(copied = 0, page = CMIS_PAGE_EPL_FIRST; copied < len; copied += chunk, page++)
+        {
+            chunk = (len - copied > CMIS_PAGE_SIZE) ? CMIS_PAGE_SIZE : (len - copied);
+            memcpy(&stage->data[copied], CMIS_Page(0, page), chunk);
+        }
+    }
+
+    stage->addr = addr;
+    stage->len = len;
+    stage->done = 0;
+    stage->full = 1;
+    cdb_stage_wr ^= 1U;
+    cdb_fw_received += len;
+    return CDB_STS_SUCCESS;
+}
+
+static uint8_t CDB_FwComplete(void)
+{
+    uint8_t i;
+
+    if(cdb_fw_state != CDB_FW_DOWNLOADING)
+    {
+        return CDB_STS_FAIL_STATE;
+    }
+
+    // Drain what is still staged before closing the stream
+    for(i = 0; i < CDB_STAGES; i++)
+    {
+        if(cdb_buf.stage[i].full)
+        {
+            CDB_SetProgress(cdb_fw_programmed, cdb_fw_received);
+            return CDB_STS_BUSY_EXECUTING;
+        }
+    }
+    if(!CDB_WriteCycleDone())
+    {
+        return CDB_STS_BUSY_EXECUTING;
+    }
+
+    if(!CDB_ImageClose(!cdb_fw_error && (cdb_fw_received >= cdb_fw_size)))
+    {
+        cdb_fw_state = CDB_FW_IDLE;
+        return CDB_STS_FAIL;
+    }
+
+    cdb_fw_state = CDB_FW_COMPLETE;
+    return CDB_STS_SUCCESS;
+}
+
+static uint8_t CDB_FwRun(void)
+{
+    if(cdb_fw_state == CDB_FW_DOWNLOADING)
+    {
+        return CDB_STS_FAIL_STATE;
+    }
+#if DSP_FW_IN_FLASH
+    // The DSP is restarted from the active slot by the DataPath code
+    DP_Restart();
+#else
+    if(por_mcu_reset_into_boot_from_eeprom(DSP_DIE, true) != INPHI_OK)
+    {
+        return CDB_STS_FAIL;
+    }
+#endif
+    return CDB_STS_SUCCESS;
+}
+
+/* One poll of the estimation semaphore or one SNR step per call, the
+   capture takes a little over a second, most of it the settle of the DSP
+   algorithms before the semaphore is granted */
+static uint8_t CDB_HistCapture(const uint8_t *lpl)
+{
+    uint32_t lane = lpl[0];
+    uint32_t slice = lpl[1];
+    uint32_t min;
+    uint32_t max;
+    bool done;
+
+    if(!cdb_hist_running)
+    {
+        if(cdb_fw_state == CDB_FW_DOWNLOADING)
+        {
+            return CDB_STS_FAIL_STATE;
+        }
+        por_package_get_channels(DSP_DIE, POR_INTF_LRX, &min, &max);
+        if((lane < min) || (lane > max) || (slice >= CDB_HIST_SLICES))
+        {
+            return CDB_STS_FAIL_PARAMETER;
+        }
+
+        cdb_hist_valid = 0;
+        if(por_lrx_dsp_hist_start_slice(&cdb_hist_ctx, DSP_DIE, lane, slice, cdb_buf.hist) != INPHI_OK)
+        {
+            return CDB_STS_FAIL;
+        }
+        cdb_hist_running = 1;
+        CDB_SetProgress(0, 1);
+        return CDB_STS_BUSY_EXECUTING;
+    }
+
+    if(por_lrx_dsp_hist_resume(&cdb_hist_ctx, cdb_buf.hist, &done) != INPHI_OK)
+    {
+        cdb_hist_running = 0;
+        return CDB_STS_FAIL;
+    }
+    if(!done)
+    {
+        CDB_SetProgress(cdb_hist_ctx.step, cdb_hist_ctx.num_steps);
+        return CDB_STS_BUSY_EXECUTING;
+    }
+
+    cdb_hist_running = 0;
+    cdb_hist_valid = 1;
+    return CDB_STS_SUCCESS;
+}
+
+/* Returns up to one EPL worth of big-endian histogram entries */
+static uint8_t CDB_HistRead(const uint8_t *lpl)
+{
+    uint32_t first = CDB_GetBE32(lpl);
+    uint32_t count;
+    uint32_t i;
+    uint32_t pos;
+    uint8_t rpl[6];
+    uint8_t *page;
+
+    if(!cdb_hist_valid)
+    {
+        return CDB_STS_FAIL_STATE;
+    }
+    if(first >= CDB_HIST_ENTRIES)
+    {
+        return CDB_STS_FAIL_PARAMETER;
+    }
+
+    count = CDB_HIST_ENTRIES - first;
+    if(count > CDB_EPL_MAX / 4U)
+    {
+        count = CDB_EPL_MAX / 4U;
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        pos = i * 4U;
+        page = CMIS_Page(0, (uint8_t)(CMIS_PAGE_EPL_FIRST + pos / CMIS_PAGE_SIZE));
+        pos %= CMIS_PAGE_SIZE;
+        page[pos]     = (uint8_t)(cdb_buf.hist[first + i] >> 24);
+        page[pos + 1] = (uint8_t)(cdb_buf.hist[first + i] >> 16);
+        page[pos + 2] = (uint8_t)(cdb_buf.hist[first + i] >> 8);
+        page[pos + 3] = (uint8_t)cdb_buf.hist[first + i];
+    }
+
+    // RPL: first entry and number of entries placed in the EPL
+    memcpy(rpl, lpl, 4);
+    rpl[4] = (uint8_t)(count >> 8);
+    rpl[5] = (uint8_t)count;
+    CDB_SetReply(rpl, sizeof(rpl));
+    return CDB_STS_SUCCESS;
+}
+
+#if DSP_FW_IN_FLASH
+/* Program the next chunk of the oldest stage into the standby slot */
+static void CDB_StreamService(void)
+{
+    CDB_StageTypeDef *stage = &cdb_buf.stage[cdb_stage_rd];
+    uint32_t num_bytes;
+
+    if((cdb_fw_state != CDB_FW_DOWNLOADING) || !stage->full)
+    {
+        return;
+    }
+
+    num_bytes = stage->len - stage->done;
+    if(num_bytes > DSP_SLOT_WRITE_BYTES)
+    {
+        num_bytes = DSP_SLOT_WRITE_BYTES;
+    }
+
+    if(DSP_SlotWrite(stage->addr + stage->done, &stage->data[stage->done], num_bytes) != HAL_OK)
+    {
+        // Reported when the host sends Complete
+        cdb_fw_error = 1;
+    }
+
+    stage->done += (uint16_t)num_bytes;
+    cdb_fw_programmed += num_bytes;
+    if(stage->done >= stage->len)
+    {
+        stage->full = 0;
+        cdb_stage_rd ^= 1U;
+    }
+}
+#else
+/* Program one EEPROM segment from the oldest stage once the previous write cycle is over */
+static void CDB_StreamService(void)
+{
+    CDB_StageTypeDef *stage = &cdb_buf.stage[cdb_stage_rd];
+    uint32_t words[POR_SPI_EEPROM_SEGMENT_WORDS];
+    uint32_t addr;
+    uint32_t num_bytes;
+    uint32_t num_words;
+    uint32_t i;
+    uint32_t j;
+    uint32_t data;
+    uint32_t idx;
+
+    if((cdb_fw_state != CDB_FW_DOWNLOADING) || !stage->full || !CDB_WriteCycleDone())
+    {
+        return;
+    }
+
+    // Segments must not cross an EEPROM page
+    addr = stage->addr + stage->done;
+    num_bytes = CDB_SEGMENT_BYTES - (addr % CDB_SEGMENT_BYTES);
+    if(num_bytes > (uint32_t)(stage->len - stage->done))
+    {
+        num_bytes = stage->len - stage->done;
+    }
+    num_words = (num_bytes + 3U) / 4U;
+
+    // Same word format as the por_mcu_download_eeprom_from_file image, tail padded with the erased value
+    for(i = 0; i < num_words; i++)
+    {
+        data = 0;
+        for(j = 0; j < 4U; j++)
+        {
+            idx = stage->done + (i * 4U) + j;
+            data = (data << 8) | ((idx < stage->len) ? stage->data[idx] : 0xFFU);
+        }
+        data = INPHI_NTOHL(data);
+#if defined(INPHI_I2C_NEEDS_BYTES_REVERSED)
+        data = INPHI_NTOHL(data);
+#endif
+        words[i] = data;
+    }
+
+    if(por_spi_eeprom_stream_write(DSP_DIE, addr, words, num_words, DSP_EEPROM_CLK_DIV) != INPHI_OK)
+    {
+        // Reported when the host sends Complete
+        cdb_fw_error = 1;
+    }
+    cdb_seg_tick = HAL_GetTick();
+    cdb_seg_in_flight = 1;
+
+    stage->done += (uint16_t)num_bytes;
+    cdb_fw_programmed += num_bytes;
+    if(stage->done >= stage->len)
+    {
+        stage->full = 0;
+        cdb_stage_rd ^= 1U;
+    }
+}
+#endif
+
+static uint8_t CDB_WriteCycleDone(void)
+{
+    // One extra tick so a partial first millisecond is not counted
+    if(cdb_seg_in_flight && ((HAL_GetTick() - cdb_seg_tick) <= POR_SPI_EEPROM_WRITE_CYCLE_MS))
+    {
+        return 0;
+    }
+    cdb_seg_in_flight = 0;
+    return 1;
+}
+
+static void CDB_StagesReset(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < CDB_STAGES; i++)
+    {
+        cdb_buf.stage[i].full = 0;
+        cdb_buf.stage[i].len = 0;
+        cdb_buf.stage[i].done = 0;
+    }
+    cdb_stage_wr = 0;
+    cdb_stage_rd = 0;
+    cdb_hist_valid = 0;
+}
+
+/* Open the image destination, 1 on success */
+static uint8_t CDB_ImageOpen(uint32_t size, uint32_t version)
+{
+#if DSP_FW_IN_FLASH
+    return (DSP_SlotWriteBegin(size, version) == HAL_OK);
+#else
+    (void)size;
+    (void)version;
+    if(por_spi_eeprom_stream_begin(DSP_DIE, DSP_EEPROM_CLK_DIV) != INPHI_OK)
+    {
+        por_spi_eeprom_stream_end(DSP_DIE);
+        return 0;
+    }
+    return 1;
+#endif
+}
+
+/* Close the image destination, keeping the image if complete; 1 if it was kept */
+static uint8_t CDB_ImageClose(uint8_t complete)
+{
+#if DSP_FW_IN_FLASH
+    if(!complete)
+    {
+        DSP_SlotWriteAbort();
+        return 0;
+    }
+    return (DSP_SlotWriteEnd() == HAL_OK);
+#else
+    por_spi_eeprom_stream_end(DSP_DIE);
+    return complete;
+#endif
+}
+
+static void CDB_SetReply(const uint8_t *rpl, uint8_t len)
+{
+    uint8_t *page9f = CMIS_Page(0, CMIS_PAGE_9F);
+
+    memcpy(&page9f[CDB_IDX_LPL], rpl, len);
+    page9f[CDB_IDX_RPL_LEN] = len;
+    page9f[CDB_IDX_RPL_CHK_CODE] = CDB_CheckCode(rpl, len);
+    cdb_rpl_progress = 0;
+}
+
+/* Progress of a busy command, the RPL is replaced by the result when it finishes */
+static void CDB_SetProgress(uint32_t done, uint32_t total)
+{
+    uint8_t percent = (total != 0U) ? (uint8_t)((done * 100U) / total) : 0U;
+
+    CDB_SetReply(&percent, CDB_PROGRESS_RPL_LEN);
+    cdb_rpl_progress = 1;
+}
+
+static void CDB_Finish(uint8_t status)
+{
+    uint8_t *page9f = CMIS_Page(0, CMIS_PAGE_9F);
+
+    // Commands without a reply must not leave the progress RPL behind
+    if(cdb_rpl_progress)
+    {
+        page9f[CDB_IDX_RPL_LEN] = 0;
+        page9f[CDB_IDX_RPL_CHK_CODE] = 0;
+        cdb_rpl_progress = 0;
+    }
+    CMIS_LowerPage()[CMIS_LP_CDB_STATUS1] = status;
+    cdb_pending = 0;
+    CMIS_SetModuleFlag(CMIS_LP_FLAGS_MODULE, CMIS_FLAG_CDB_CMD_COMPLETE1);
+}
+
+/* Ones complement of the byte sum */
+static uint8_t CDB_CheckCode(const uint8_t *buf, uint16_t len)
+{
+    uint8_t sum = 0;
+    uint16_t i;
+
+    for(i = 0; i < len; i++)
+    {
+        sum += buf[i];
+    }
+    return (uint8_t)~sum;
+}
+
+static uint32_t CDB_GetBE32(const uint8_t *buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+}
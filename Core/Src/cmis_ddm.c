@@ -0,0 +1,226 @@
+/**
+  ******************************************************************************
+  * @file    cmis_ddm.c
+  * @brief   This file provides the monitoring engine: it samples the DSP
+  *          temperature and the per lane SNR and FW lock, and keeps the CMIS
+  *          monitor values and latched alarm/warning flags up to date.
+  *
+  *          A monitoring cycle is one temperature sample followed by one
+  *          sample per lane, one item per CMIS_Process() pass so the DSP bus
+  *          time spent per pass stays bounded. Samples are compared against
+  *          the threshold tables in integer units (1/256 degC, 1/256 dB). The
+  *          memory map is only written when a monitor value changed or a
+  *          flag the condition calls for is not latched any more.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_ddm.h"
+#include "dsp.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Cycle items: temperature first, then lanes 1..DDM_NUM_LANES */
+#define DDM_ITEM_TEMP               0U
+#define DDM_ITEM_IDLE               (DDM_NUM_LANES + 1U)
+
+/* Private variables ---------------------------------------------------------*/
+/* Module temperature thresholds, 1/256 degC, mirrored on page 02h */
+static const int32_t ddm_temp_thr[DDM_THR_NUM] =
+{
+    75 * 256,       // high alarm
+    -5 * 256,       // low alarm
+    70 * 256,       // high warning
+    0 * 256         // low warning
+};
+
+/* Lane SNR thresholds, 1/256 dB */
+static const int32_t ddm_snr_thr[DDM_THR_NUM] =
+{
+    0xFFFF,         // high alarm, never
+    15 * 256,       // low alarm
+    0xFFFF,         // high warning, never
+    17 * 256        // low warning
+};
+
+static uint8_t ddm_item = DDM_ITEM_IDLE;
+static uint32_t ddm_cycle_tick;
+static uint32_t ddm_lane_min;
+
+static int32_t ddm_temp = INT32_MIN;
+static uint8_t ddm_temp_cond;
+
+static uint16_t ddm_snr[DDM_NUM_LANES];
+static uint8_t ddm_snr_cond[DDM_NUM_LANES];
+static uint8_t ddm_lol = 0xFF;              // lane bitmap, bit n-1 for lane n
+
+/* Private function prototypes -----------------------------------------------*/
+static void DDM_SampleTemperature(void);
+static void DDM_SampleLane(uint8_t lane);
+static uint8_t DDM_Compare(int32_t value, const int32_t *thr);
+static void DDM_PutBE16(uint8_t *buf, uint16_t value);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Publish the thresholds and start monitoring.
+  * @retval None
+  */
+void DDM_Init(void)
+{
+    uint8_t *page02 = CMIS_Page(0, CMIS_PAGE_02);
+    uint32_t max;
+    uint8_t i;
+
+    for(i = 0; i < DDM_THR_NUM; i++)
+    {
+        DDM_PutBE16(&page02[CMIS_P02_TEMP_THRESHOLDS - CMIS_UPPER_OFFSET + 2U * i], (uint16_t)ddm_temp_thr[i]);
+    }
+
+    por_package_get_channels(DSP_DIE, POR_INTF_LRX, &ddm_lane_min, &max);
+
+    ddm_item = DDM_ITEM_IDLE;
+    ddm_cycle_tick = HAL_GetTick() - DDM_SAMPLE_PERIOD_MS;
+}
+
+/**
+  * @brief  Take the next sample of the monitoring cycle, call from the main loop.
+  * @retval None
+  */
+void DDM_Process(void)
+{
+    if(ddm_item == DDM_ITEM_IDLE)
+    {
+        if((HAL_GetTick() - ddm_cycle_tick) < DDM_SAMPLE_PERIOD_MS)
+        {
+            return;
+        }
+        ddm_cycle_tick = HAL_GetTick();
+        ddm_item = DDM_ITEM_TEMP;
+    }
+
+    if(ddm_item == DDM_ITEM_TEMP)
+    {
+        DDM_SampleTemperature();
+    }
+    else
+    {
+        DDM_SampleLane(ddm_item);
+    }
+    ddm_item++;
+}
+
+/**
+  * @brief  Last module temperature sampled.
+  * @retval temperature in 1/256 degC, INT32_MIN before the first sample
+  */
+int32_t DDM_GetTemperature(void)
+{
+    return ddm_temp;
+}
+
+/**
+  * @brief  Last SNR sampled on a lane.
+  * @param  lane: CMIS lane, 1..DDM_NUM_LANES
+  * @retval SNR in 1/256 dB, 0 while the lane is not locked
+  */
+uint16_t DDM_GetLaneSnr(uint8_t lane)
+{
+    return ddm_snr[lane - 1U];
+}
+
+/**
+  * @brief  Current SNR alarm/warning conditions of a lane.
+  * @param  lane: CMIS lane, 1..DDM_NUM_LANES
+  * @retval CMIS_FLAG_* bits
+  */
+uint8_t DDM_GetLaneSnrFlags(uint8_t lane)
+{
+    return ddm_snr_cond[lane - 1U];
+}
+
+/**
+  * @brief  SNR threshold table, indexed by DDM_THR_*.
+  * @retval thresholds in 1/256 dB
+  */
+const int32_t *DDM_GetSnrThresholds(void)
+{
+    return ddm_snr_thr;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void DDM_SampleTemperature(void)
+{
+    uint8_t *lower = CMIS_LowerPage();
+    int16_t deg_c;
+    int32_t temp;
+    uint8_t cond;
+
+    if(por_temperature_query(DSP_DIE, &deg_c) != INPHI_OK)
+    {
+        return;
+    }
+
+    temp = (int32_t)deg_c * 256;
+    if(temp != ddm_temp)
+    {
+        ddm_temp = temp;
+        ddm_temp_cond = DDM_Compare(temp, ddm_temp_thr);
+
+        // Both bytes change together for a host reading the pair
+        __disable_irq();
+        DDM_PutBE16(&lower[CMIS_LP_TEMP_MONITOR], (uint16_t)temp);
+        __enable_irq();
+    }
+
+    // Re-latch while the condition lasts, the host read may have cleared it
+    cond = ddm_temp_cond;
+    if((lower[CMIS_LP_FLAGS_TEMP_VCC] & cond) != cond)
+    {
+        CMIS_SetModuleFlag(CMIS_LP_FLAGS_TEMP_VCC, cond);
+    }
+}
+
+static void DDM_SampleLane(uint8_t lane)
+{
+    uint8_t *page11 = CMIS_Page(0, CMIS_PAGE_11);
+    uint8_t bit = (uint8_t)(1U << (lane - 1U));
+    uint32_t channel = ddm_lane_min + lane - 1U;
+    uint32_t snr = 0;
+    uint8_t lol;
+
+    lol = por_channel_is_link_ready(DSP_DIE, channel, POR_INTF_LRX) ? 0U : bit;
+    if(!lol)
+    {
+        snr = (por_rx_dsp_snr_read_db_fixp(DSP_DIE, channel, POR_INTF_LRX) * 256U) / DDM_SNR_FIXP_PER_DB;
+    }
+
+    // Nothing to recompute unless the lane changed
+    if((snr != ddm_snr[lane - 1U]) || (lol != (ddm_lol & bit)))
+    {
+        ddm_snr[lane - 1U] = (uint16_t)snr;
+        ddm_snr_cond[lane - 1U] = lol ? 0U : DDM_Compare((int32_t)snr, ddm_snr_thr);
+        ddm_lol = (uint8_t)((ddm_lol & ~bit) | lol);
+    }
+
+    // Re-latch while the lane is unlocked, the host read may have cleared it
+    if(lol && !(page11[CMIS_P11_RX_LOL - CMIS_UPPER_OFFSET] & bit))
+    {
+        CMIS_SetLaneFlag(CMIS_P11_RX_LOL, bit);
+    }
+}
+
+static uint8_t DDM_Compare(int32_t value, const int32_t *thr)
+{
+    uint8_t cond = 0;
+
+    if(value > thr[DDM_THR_HIGH_ALARM])   cond |= CMIS_FLAG_HIGH_ALARM;
+    if(value < thr[DDM_THR_LOW_ALARM])    cond |= CMIS_FLAG_LOW_ALARM;
+    if(value > thr[DDM_THR_HIGH_WARNING]) cond |= CMIS_FLAG_HIGH_WARNING;
+    if(value < thr[DDM_THR_LOW_WARNING])  cond |= CMIS_FLAG_LOW_WARNING;
+    return cond;
+}
+
+static void DDM_PutBE16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = (uint8_t)(value >> 8);
+    buf[1] = (uint8_t)value;
+}
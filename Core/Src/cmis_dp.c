@@ -0,0 +1,570 @@
+/**
+  ******************************************************************************
+  * @file    cmis_dp.c
+  * @brief   This file provides the CMIS DataPath state machines of the lanes
+  *          (DPDeactivated, DPInit, DPActivated) and the DSP bring-up they
+  *          depend on.
+  *
+  *          por_init() and por_enter_operational_state() block for the FW
+  *          handshakes, so the bring-up is driven through their resumable
+  *          variants instead: one handshake step per DP_TICK_MS tick. The
+  *          lanes are serviced one per tick after it, so the management
+  *          interface stays responsive and the host sees every state
+  *          transition as it happens.
+  *
+  *          A lane leaves DPDeactivated when its DPDeinit bit is cleared. It
+  *          stays in DPInit until the DSP is operational and its line
+  *          receiver reports link ready (or DP_LINK_TIMEOUT_MS expired), and
+  *          its transmitter is only enabled once it is DPActivated.
+  *
+  *          The DSP keeps running across an MCU reset. A record in .noinit
+  *          RAM remembers the FW version and rules of the last bring-up, and
+  *          DP_Init() adopts a DSP that still runs that image in application
+  *          mode with its FW reporting healthy: no download and no re-init,
+  *          and the lanes with a link go straight back to DPActivated.
+  *
+  *          The first bring-up records the register writes the rules make
+  *          (por_enter_operational_state_capture()). An operational DSP is
+  *          checked every DP_HEALTH_MS; when it was reset on its own the
+  *          active lanes fall back to DPInit, and once the init is done the
+  *          snapshot is written back instead of running the rules again,
+  *          provided the DSP came back with the same FW.
+  *
+  *          With DSP_FW_IN_FLASH the FW is downloaded from the active flash
+  *          slot (dsp_slot.c), or from the built-in image while no slot
+  *          holds one. Compressed images are decompressed on the fly,
+  *          uncompressed ones are copied out by DMA a chunk at a time
+  *          (dsp_fw_src.c). The download is the one step that is not split
+  *          across ticks: it is a single call that programs the whole image
+  *          and waits for the application to start, so the main loop (CDB,
+  *          DDM, health checks) stalls for its duration. The memory map is
+  *          still served from the I2C1 interrupt meanwhile.
+  *
+  *          When the image was programmed completely and the init ran to its
+  *          end but the FW is not healthy, DP_SLOT_REJECT_FAILS times in a
+  *          row, the slot is rejected and the retry boots the other one. A
+  *          failed transfer never rejects it.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_dp.h"
+#include "cmis_txdis.h"
+#include "dsp.h"
+#include "dsp_irq.h"
+#include "dsp_prof.h"
+#if DSP_FW_IN_FLASH
+#include "dsp_fw_image.h"
+#include "dsp_slot.h"
+#include "dsp_fw_src.h"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    DP_DSP_DOWN = 0,
+    DP_DSP_INIT,
+    DP_DSP_ENTER_OP,
+    DP_DSP_UP,
+    DP_DSP_FAILED
+} DP_DspStateTypeDef;
+
+/* Bring-up remembered across an MCU reset */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t fw_version;                    // por_mcu_fw_version_query()
+    uint32_t rules_id;
+    uint32_t check;                         // ~(magic ^ fw_version ^ rules_id)
+} DP_WarmTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define DP_WARM_MAGIC               0x55575044U     /* "DPWU" */
+
+/* First word of the compressed images, "SPLZ" and "SPZC" */
+#define DP_FW_LZ_MAGIC              0x5A4C5053U
+#define DP_FW_LZ_MAGIC_CRC          0x435A5053U
+
+/* Rules the bring-up is done with, checked before adopting a running DSP */
+#define DP_MODE                     POR_MODE_MISSION_MODE
+#define DP_PROTOCOL                 POR_MODE_400G_KP8_TO_KP4
+#define DP_FEC                      POR_FEC_BYPASS
+#define DP_RULES_ID                 (((uint32_t)DP_MODE << 16) | ((uint32_t)DP_PROTOCOL << 8) | (uint32_t)DP_FEC)
+
+/* Private variables ---------------------------------------------------------*/
+/* Not cleared by the startup code, only valid with a matching check word */
+static DP_WarmTypeDef dp_warm __attribute__((section(".noinit")));
+
+static por_rules_t dp_rules;
+static por_init_ctx_t dp_init_ctx;
+static DP_DspStateTypeDef dp_dsp_state = DP_DSP_DOWN;
+static uint32_t dp_dsp_tick;
+
+static uint8_t dp_state[DP_NUM_LANES];
+static uint32_t dp_init_tick[DP_NUM_LANES];
+static uint8_t dp_active = 0;               // lane bitmap of the DPActivated lanes
+static uint8_t dp_lane = 0;
+static uint8_t dp_wanted = 0;               // lane bitmap of the lanes the host wants up
+static uint32_t dp_tick;
+static uint32_t dp_lane_min;
+static uint8_t dp_prof_pending = 0;         // bring-up profile not printed yet
+
+/* Register writes of the rules, taken on a full bring-up */
+static por_reg_pair_t dp_snap_pairs[DP_SNAPSHOT_PAIRS];
+static por_config_snapshot_t dp_snap = { dp_snap_pairs, DP_SNAPSHOT_PAIRS, 0, false };
+static uint8_t dp_snap_valid = 0;
+static uint32_t dp_snap_fw_version;
+
+#if DSP_FW_IN_FLASH
+static uint8_t dp_boot_slot = DSP_SLOT_NONE;
+static uint8_t dp_boot_downloaded = 0;      // the FW of this bring-up was programmed completely
+static uint8_t dp_boot_fails = 0;           // consecutive unhealthy bring-ups of dp_boot_slot
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void DP_DspStep(uint8_t wanted);
+static void DP_LaneStep(uint8_t lane);
+static void DP_SetState(uint8_t lane, uint8_t state);
+static void DP_DspLost(void);
+static uint8_t DP_SnapshotMatches(void);
+static uint8_t DP_DspHealthy(void);
+#if DSP_FW_IN_FLASH
+static inphi_status_t DP_Download(void);
+#endif
+static uint8_t DP_WarmAdopt(void);
+static void DP_WarmSave(void);
+static void DP_WarmInvalidate(void);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Publish every lane as DPDeactivated, or adopt the DSP left running
+  *         by the previous MCU run and re-activate the lanes it carries.
+  *         Call before TXDIS_Init() so adopted lanes are never squelched.
+  * @retval None
+  */
+void DP_Init(void)
+{
+    uint8_t *page10 = CMIS_Page(0, CMIS_PAGE_10);
+    uint32_t max;
+    uint8_t deinit;
+    uint8_t lane;
+
+    por_package_get_channels(DSP_DIE, POR_INTF_LRX, &dp_lane_min, &max);
+
+    for(lane = 0; lane < DP_NUM_LANES; lane++)
+    {
+        DP_SetState(lane, CMIS_DP_STATE_DEACTIVATED);
+    }
+    dp_active = 0;
+    dp_dsp_state = DP_DSP_DOWN;
+
+    if(DP_WarmAdopt())
+    {
+        DSP_IrqInit();
+        dp_dsp_state = DP_DSP_UP;
+        dp_dsp_tick = HAL_GetTick();
+
+        deinit = page10[CMIS_P10_DP_DEINIT - CMIS_UPPER_OFFSET];
+        for(lane = 0; lane < DP_NUM_LANES; lane++)
+        {
+            if(!(deinit & (1U << lane)) &&
+               por_channel_is_link_ready(DSP_DIE, dp_lane_min + lane, POR_INTF_LRX))
+            {
+                dp_active |= (uint8_t)(1U << lane);
+                DP_SetState(lane, CMIS_DP_STATE_ACTIVATED);
+            }
+        }
+    }
+    TXDIS_SetLaneEnable(dp_active);
+
+    dp_tick = HAL_GetTick();
+}
+
+/**
+  * @brief  Run one scheduler tick of the state machines, call from the main loop.
+  * @retval None
+  */
+void DP_Process(void)
+{
+    uint8_t *page10 = CMIS_Page(0, CMIS_PAGE_10);
+    uint8_t wanted;
+
+    if((HAL_GetTick() - dp_tick) < DP_TICK_MS)
+    {
+        return;
+    }
+    dp_tick = HAL_GetTick();
+
+    // Lanes the host wants up, bit n-1 for lane n
+    wanted = (uint8_t)(~page10[CMIS_P10_DP_DEINIT - CMIS_UPPER_OFFSET] & ((1U << DP_NUM_LANES) - 1U));
+    dp_wanted = wanted;
+
+    DP_DspStep(wanted);
+
+    DP_LaneStep(dp_lane);
+    dp_lane = (uint8_t)((dp_lane + 1U) % DP_NUM_LANES);
+
+#if DSP_PROF_UART_DUMP
+    // Print once every lane the host wants is up and USART2 runs
+    if(dp_prof_pending && DP_IsTrafficUp() && DSP_ProfDump())
+    {
+        dp_prof_pending = 0;
+    }
+#endif
+}
+
+/**
+  * @brief  Whether the DSP has completed its bring-up.
+  * @retval 1 if operational, 0 otherwise
+  */
+uint8_t DP_IsDspUp(void)
+{
+    return (dp_dsp_state == DP_DSP_UP);
+}
+
+/**
+  * @brief  Whether every lane the host wants up is DPActivated.
+  * @retval 1 if carrying traffic, 0 otherwise (also while no lane is wanted)
+  */
+uint8_t DP_IsTrafficUp(void)
+{
+    return (dp_dsp_state == DP_DSP_UP) && (dp_wanted != 0U) && (dp_active == dp_wanted);
+}
+
+/**
+  * @brief  Take the lanes down and bring the DSP up again from scratch, to
+  *         run a new FW image.
+  * @retval None
+  */
+void DP_Restart(void)
+{
+    dp_snap_valid = 0;
+    DP_DspLost();
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* Advance the DSP bring-up by one FW handshake while some lane wants it */
+static void DP_DspStep(uint8_t wanted)
+{
+    inphi_status_t status = INPHI_OK;
+    e_por_fw_mode mode;
+    bool done = false;
+
+    switch(dp_dsp_state)
+    {
+        case DP_DSP_DOWN:
+            if(!wanted)
+            {
+                return;
+            }
+            // The DSP is about to change, a reset from here on must not adopt it
+            DP_WarmInvalidate();
+            DSP_ProfReset();
+            DSP_ProfEnter(DSP_PROF_PHASE_BRINGUP);
+            status |= por_rules_set_default(DSP_DIE, DP_MODE, DP_PROTOCOL, DP_FEC, &dp_rules);
+#if DSP_FW_IN_FLASH
+            // No EEPROM to boot from, program the application FW directly.
+            // Blocks the main loop for the whole image, see the file header
+            dp_boot_downloaded = 0;
+            if(status == INPHI_OK)
+            {
+                status |= DP_Download();
+                dp_boot_downloaded = (status == INPHI_OK);
+            }
+#endif
+            if(status == INPHI_OK)
+            {
+                status |= por_init_start(&dp_init_ctx, DSP_DIE, &dp_rules);
+            }
+            dp_dsp_state = DP_DSP_INIT;
+            break;
+
+        case DP_DSP_INIT:
+            status |= por_init_resume(&dp_init_ctx, &done);
+            if(done)
+            {
+                if(DP_SnapshotMatches())
+                {
+                    // Same FW and rules as the capture, no need to run the rules
+                    status |= por_enter_operational_state_replay(&dp_init_ctx, DSP_DIE, &dp_snap);
+                }
+                else
+                {
+                    dp_snap_valid = 0;
+                    status |= por_enter_operational_state_capture(&dp_init_ctx, DSP_DIE, &dp_rules, &dp_snap);
+                }
+                dp_dsp_state = DP_DSP_ENTER_OP;
+            }
+            break;
+
+        case DP_DSP_ENTER_OP:
+            status |= por_enter_operational_state_resume(&dp_init_ctx, &done);
+            if(done && !DP_DspHealthy())
+            {
+#if DSP_FW_IN_FLASH
+                // The image went in and the init completed, yet the FW is not
+                // healthy: after a few in a row it gives way to the other slot
+                if(dp_boot_downloaded && (++dp_boot_fails >= DP_SLOT_REJECT_FAILS))
+                {
+                    dp_boot_fails = 0;
+                    DSP_SlotReject(dp_boot_slot);
+                }
+#endif
+                status = INPHI_ERROR;
+            }
+            else if(done)
+            {
+#if DSP_FW_IN_FLASH
+                dp_boot_fails = 0;
+#endif
+                // The FW may have changed the squelch of the lanes
+                TXDIS_Resync();
+                DP_WarmSave();
+                DSP_ProfExit(DSP_PROF_PHASE_BRINGUP);
+                dp_prof_pending = 1;
+
+                // Keep a complete capture for the next DSP reset
+                if(!dp_snap_valid && !dp_snap.overflow && (dp_snap.num_pairs != 0U) &&
+                   (por_mcu_fw_version_query(DSP_DIE, &dp_snap_fw_version) == INPHI_OK))
+                {
+                    dp_snap_valid = 1;
+                }
+                DSP_IrqInit();
+                dp_dsp_state = DP_DSP_UP;
+                dp_dsp_tick = HAL_GetTick();
+            }
+            break;
+
+        case DP_DSP_UP:
+            if((HAL_GetTick() - dp_dsp_tick) < DP_HEALTH_MS)
+            {
+                return;
+            }
+            dp_dsp_tick = HAL_GetTick();
+
+            // A DSP reset drops the FW back to the bootloader
+            if((por_mcu_fw_mode_query(DSP_DIE, &mode) == INPHI_OK) &&
+               (mode != POR_FW_MODE_APPLICATION))
+            {
+                DP_DspLost();
+            }
+            break;
+
+        case DP_DSP_FAILED:
+            if((HAL_GetTick() - dp_dsp_tick) >= DP_RETRY_MS)
+            {
+                dp_dsp_state = DP_DSP_DOWN;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if(status != INPHI_OK)
+    {
+        // Retry with the full rules, the snapshot may be what failed
+        dp_snap_valid = 0;
+        dp_dsp_state = DP_DSP_FAILED;
+        dp_dsp_tick = HAL_GetTick();
+    }
+}
+
+static void DP_LaneStep(uint8_t lane)
+{
+    uint8_t *page10 = CMIS_Page(0, CMIS_PAGE_10);
+    uint8_t bit = (uint8_t)(1U << lane);
+    uint8_t deinit = page10[CMIS_P10_DP_DEINIT - CMIS_UPPER_OFFSET] & bit;
+
+    switch(dp_state[lane])
+    {
+        case CMIS_DP_STATE_DEACTIVATED:
+            if(!deinit)
+            {
+                dp_init_tick[lane] = HAL_GetTick();
+                DP_SetState(lane, CMIS_DP_STATE_INIT);
+            }
+            break;
+
+        case CMIS_DP_STATE_INIT:
+            if(deinit)
+            {
+                DP_SetState(lane, CMIS_DP_STATE_DEACTIVATED);
+                CMIS_SetLaneFlag(CMIS_P11_DP_STATE_CHANGED, bit);
+            }
+            else if(dp_dsp_state != DP_DSP_UP)
+            {
+                // The link timeout only runs once the DSP is operational
+                dp_init_tick[lane] = HAL_GetTick();
+            }
+            else if(por_channel_is_link_ready(DSP_DIE, dp_lane_min + lane, POR_INTF_LRX) ||
+                    ((HAL_GetTick() - dp_init_tick[lane]) >= DP_LINK_TIMEOUT_MS))
+            {
+                dp_active |= bit;
+                TXDIS_SetLaneEnable(dp_active);
+                DP_SetState(lane, CMIS_DP_STATE_ACTIVATED);
+                CMIS_SetLaneFlag(CMIS_P11_DP_STATE_CHANGED, bit);
+
+                DSP_ProfAdd(DSP_PROF_PHASE_LINK + lane, (HAL_GetTick() - dp_init_tick[lane]) * 1000U);
+            }
+            break;
+
+        case CMIS_DP_STATE_ACTIVATED:
+            if(deinit)
+            {
+                dp_active &= (uint8_t)~bit;
+                TXDIS_SetLaneEnable(dp_active);
+                DP_SetState(lane, CMIS_DP_STATE_DEACTIVATED);
+                CMIS_SetLaneFlag(CMIS_P11_DP_STATE_CHANGED, bit);
+            }
+            break;
+
+        default:
+            DP_SetState(lane, CMIS_DP_STATE_DEACTIVATED);
+            break;
+    }
+}
+
+/* Publish the state of a lane in its page 11h nibble */
+static void DP_SetState(uint8_t lane, uint8_t state)
+{
+    uint8_t *page11 = CMIS_Page(0, CMIS_PAGE_11);
+    uint8_t *dst = &page11[CMIS_P11_DP_STATE - CMIS_UPPER_OFFSET + lane / 2U];
+    uint8_t shift = (uint8_t)((lane & 1U) * 4U);
+
+    dp_state[lane] = state;
+    *dst = (uint8_t)((*dst & ~(0x0FU << shift)) | (state << shift));
+}
+
+/* The DSP was reset under the lanes, bring it up again */
+static void DP_DspLost(void)
+{
+    uint8_t lane;
+    uint8_t bit;
+
+    DP_WarmInvalidate();
+    por_mcu_msg2_cache_invalidate(DSP_DIE);
+    DSP_IrqDeInit();
+
+    for(lane = 0; lane < DP_NUM_LANES; lane++)
+    {
+        bit = (uint8_t)(1U << lane);
+        if(dp_active & bit)
+        {
+            dp_active &= (uint8_t)~bit;
+            dp_init_tick[lane] = HAL_GetTick();
+            DP_SetState(lane, CMIS_DP_STATE_INIT);
+            CMIS_SetLaneFlag(CMIS_P11_DP_STATE_CHANGED, bit);
+        }
+    }
+    TXDIS_SetLaneEnable(dp_active);
+
+    dp_dsp_state = DP_DSP_DOWN;
+}
+
+/* Whether the snapshot was taken on the FW the DSP just booted */
+static uint8_t DP_SnapshotMatches(void)
+{
+    uint32_t version;
+
+    return dp_snap_valid &&
+           (por_mcu_fw_version_query(DSP_DIE, &version) == INPHI_OK) &&
+           (version == dp_snap_fw_version);
+}
+
+/* Boot health check: the FW runs the application and reports no fault */
+static uint8_t DP_DspHealthy(void)
+{
+    e_por_fw_mode mode;
+
+    return (por_mcu_fw_mode_query(DSP_DIE, &mode) == INPHI_OK) &&
+           (mode == POR_FW_MODE_APPLICATION) &&
+           por_is_fw_running_ok(DSP_DIE);
+}
+
+#if DSP_FW_IN_FLASH
+/* Program the application FW from the active slot */
+static inphi_status_t DP_Download(void)
+{
+    const uint8_t *image = dsp_fw_image_lz;
+    uint32_t length = dsp_fw_image_lz_length;
+    por_fw_source_t source;
+    uint32_t magic;
+    uint8_t slot;
+
+    // The built-in image is only used while no slot holds one
+    slot = DSP_SlotActive();
+    if(slot != dp_boot_slot)
+    {
+        dp_boot_slot = slot;
+        dp_boot_fails = 0;
+    }
+    if(dp_boot_slot != DSP_SLOT_NONE)
+    {
+        image = DSP_SlotImage(dp_boot_slot, &length);
+    }
+
+    magic = *(const uint32_t *)image;
+    if((magic == DP_FW_LZ_MAGIC) || (magic == DP_FW_LZ_MAGIC_CRC))
+    {
+        return por_mcu_download_firmware_lz(DSP_DIE, image, length, false);
+    }
+
+    // Uncompressed slot image, streamed out of the flash a chunk at a time
+    DSP_FwSrcFlash(&source, (const uint32_t *)image);
+    return por_mcu_download_firmware_from_source(DSP_DIE, &source, length / 4U, false);
+}
+#endif
+
+/* Whether the DSP still runs the image and rules of the last bring-up */
+static uint8_t DP_WarmAdopt(void)
+{
+    e_por_fw_mode mode;
+    uint32_t version;
+
+    if((dp_warm.magic != DP_WARM_MAGIC) || (dp_warm.rules_id != DP_RULES_ID) ||
+       (dp_warm.check != ~(dp_warm.magic ^ dp_warm.fw_version ^ dp_warm.rules_id)))
+    {
+        return 0;
+    }
+
+    if((por_mcu_fw_mode_query(DSP_DIE, &mode) != INPHI_OK) ||
+       (mode != POR_FW_MODE_APPLICATION) ||
+       (por_mcu_fw_version_query(DSP_DIE, &version) != INPHI_OK) ||
+       (version != dp_warm.fw_version) ||
+       !por_is_fw_running_ok(DSP_DIE))
+    {
+        DP_WarmInvalidate();
+        return 0;
+    }
+
+    // The rules are only set in software, the DSP already runs with them
+    if(por_rules_set_default(DSP_DIE, DP_MODE, DP_PROTOCOL, DP_FEC, &dp_rules) != INPHI_OK)
+    {
+        DP_WarmInvalidate();
+        return 0;
+    }
+    return 1;
+}
+
+/* Remember the bring-up just completed */
+static void DP_WarmSave(void)
+{
+    uint32_t version;
+
+    if(por_mcu_fw_version_query(DSP_DIE, &version) != INPHI_OK)
+    {
+        return;
+    }
+
+    dp_warm.magic = DP_WARM_MAGIC;
+    dp_warm.fw_version = version;
+    dp_warm.rules_id = DP_RULES_ID;
+    dp_warm.check = ~(dp_warm.magic ^ dp_warm.fw_version ^ dp_warm.rules_id);
+}
+
+static void DP_WarmInvalidate(void)
+{
+    dp_warm.magic = 0;
+    dp_warm.check = 0;
+}
@@ -0,0 +1,210 @@
+/**
+  ******************************************************************************
+  * @file    cmis_i2c.c
+  * @brief   This file provides the I2C1 slave glue of the CMIS memory map: the
+  *          HAL slave callbacks turn the bus events into the CMIS_Slave*
+  *          events of cmis.c and re-arm the one byte transfers.
+  *
+  *          Every callback is timed with the DWT cycle counter, as is every
+  *          transaction from its first START to its STOP, to keep track of
+  *          the interrupt load and the latency the host sees.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_i2c.h"
+#include "i2c.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t cmis_rx_byte;
+static uint8_t cmis_tx_byte;
+
+static CMIS_I2C_StatsTypeDef cmis_i2c_stats;
+static uint8_t cmis_i2c_in_xfer = 0;
+static uint32_t cmis_i2c_xfer_start;
+static volatile uint8_t cmis_i2c_acked = 0;
+static uint32_t cmis_i2c_first_ack;
+
+/* Private function prototypes -----------------------------------------------*/
+static void CMIS_I2C_IsrDone(uint32_t start);
+static void CMIS_I2C_XferDone(uint32_t now);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Start listening for the host on the I2C1 slave.
+  * @retval None
+  */
+void CMIS_I2C_Listen(void)
+{
+    if(HAL_I2C_EnableListen_IT(&hi2c1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+/**
+  * @brief  Copy the slave timing statistics.
+  * @param  stats: the copy
+  * @retval None
+  */
+void CMIS_I2C_GetStats(CMIS_I2C_StatsTypeDef *stats)
+{
+    __disable_irq();
+    *stats = cmis_i2c_stats;
+    __enable_irq();
+}
+
+/**
+  * @brief  Restart the slave timing statistics.
+  * @retval None
+  */
+void CMIS_I2C_ClearStats(void)
+{
+    __disable_irq();
+    memset(&cmis_i2c_stats, 0, sizeof(cmis_i2c_stats));
+    __enable_irq();
+}
+
+/**
+  * @brief  When the host was first answered, a boot time metric.
+  * @param  tick: set to the HAL_GetTick() of the first address match
+  * @retval 1 if the host addressed the module since reset, 0 otherwise
+  */
+uint8_t CMIS_I2C_GetFirstAck(uint32_t *tick)
+{
+    if(!cmis_i2c_acked)
+    {
+        return 0;
+    }
+    *tick = cmis_i2c_first_ack;
+    return 1;
+}
+
+/* I2C1 slave callbacks ------------------------------------------------------*/
+void HAL_I2C_AddrCallback(I2C_HandleTypeDef *hi2c, uint8_t TransferDirection, uint16_t AddrMatchCode)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    (void)AddrMatchCode;
+    if(hi2c->Instance != I2C1)
+    {
+        return;
+    }
+
+    if(!cmis_i2c_acked)
+    {
+        cmis_i2c_first_ack = HAL_GetTick();
+        cmis_i2c_acked = 1;
+    }
+
+    /* A repeated START continues the transaction */
+    if(!cmis_i2c_in_xfer)
+    {
+        cmis_i2c_in_xfer = 1;
+        cmis_i2c_xfer_start = start;
+    }
+
+    if(TransferDirection == I2C_DIRECTION_TRANSMIT)
+    {
+        CMIS_SlaveAddress(0);
+        HAL_I2C_Slave_Seq_Receive_IT(hi2c, &cmis_rx_byte, 1, I2C_FIRST_FRAME);
+    }
+    else
+    {
+        CMIS_SlaveAddress(1);
+        cmis_tx_byte = CMIS_SlaveReadByte();
+        HAL_I2C_Slave_Seq_Transmit_IT(hi2c, &cmis_tx_byte, 1, I2C_FIRST_FRAME);
+    }
+    CMIS_I2C_IsrDone(start);
+}
+
+void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    if(hi2c->Instance != I2C1)
+    {
+        return;
+    }
+
+    CMIS_SlaveWriteByte(cmis_rx_byte);
+    HAL_I2C_Slave_Seq_Receive_IT(hi2c, &cmis_rx_byte, 1, I2C_NEXT_FRAME);
+    CMIS_I2C_IsrDone(start);
+}
+
+void HAL_I2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    if(hi2c->Instance != I2C1)
+    {
+        return;
+    }
+
+    cmis_tx_byte = CMIS_SlaveReadByte();
+    HAL_I2C_Slave_Seq_Transmit_IT(hi2c, &cmis_tx_byte, 1, I2C_NEXT_FRAME);
+    CMIS_I2C_IsrDone(start);
+}
+
+void HAL_I2C_ListenCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    if(hi2c->Instance != I2C1)
+    {
+        return;
+    }
+
+    CMIS_SlaveStop(0);
+    HAL_I2C_EnableListen_IT(hi2c);
+    CMIS_I2C_XferDone(start);
+    CMIS_I2C_IsrDone(start);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    if(hi2c->Instance != I2C1)
+    {
+        return;
+    }
+
+    CMIS_SlaveStop(HAL_I2C_GetError(hi2c) == HAL_I2C_ERROR_AF);
+    HAL_I2C_EnableListen_IT(hi2c);
+    CMIS_I2C_XferDone(start);
+    CMIS_I2C_IsrDone(start);
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void CMIS_I2C_IsrDone(uint32_t start)
+{
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    cmis_i2c_stats.isr_count++;
+    cmis_i2c_stats.isr_cycles += cycles;
+    if(cycles > cmis_i2c_stats.isr_max_cycles)
+    {
+        cmis_i2c_stats.isr_max_cycles = cycles;
+    }
+}
+
+static void CMIS_I2C_XferDone(uint32_t now)
+{
+    uint32_t cycles;
+
+    if(!cmis_i2c_in_xfer)
+    {
+        return;
+    }
+    cmis_i2c_in_xfer = 0;
+
+    cycles = now - cmis_i2c_xfer_start;
+    cmis_i2c_stats.xfer_count++;
+    cmis_i2c_stats.xfer_last_cycles = cycles;
+    if(cycles > cmis_i2c_stats.xfer_max_cycles)
+    {
+        cmis_i2c_stats.xfer_max_cycles = cycles;
+    }
+}
@@ -0,0 +1,202 @@
+/**
+  ******************************************************************************
+  * @file    cmis_txdis.c
+  * @brief   This file provides the host Tx disable path: a write to the
+  *          TxDisable lane bitmap (page 10h byte 82h) squelches the line
+  *          transmitters from the I2C1 interrupt, without waiting for the
+  *          main loop.
+  *
+  *          The squelch registers of the LTX channels are resolved once at
+  *          init, so applying a bitmap is only the register writes of the
+  *          lanes that change (a single broadcast when all lanes go the same
+  *          way). If the main loop is in the middle of a DSP transfer the
+  *          writes are made as soon as that transfer ends, from
+  *          DSP_BusReleaseCallback().
+  *
+  *          A squelch write that fails on the DSP bus is made again at the
+  *          end of the next DSP transfer.
+  *
+  *          Lanes that are not DPActivated (see cmis_dp.c) stay squelched
+  *          whatever the host TxDisable says.
+  *
+  *          The time from the end of the host write to the last squelch write
+  *          is measured with the DWT cycle counter.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_txdis.h"
+#include "dsp.h"
+
+/* Private variables ---------------------------------------------------------*/
+static por_tx_squelch_map_t txdis_map;
+static volatile uint8_t txdis_ready = 0;
+static volatile uint8_t txdis_value;
+static volatile uint8_t txdis_enabled = 0;
+static volatile uint8_t txdis_host_change = 0;
+static volatile uint8_t txdis_pending = 0;
+static volatile uint8_t txdis_applying = 0;
+static volatile uint32_t txdis_stamp;
+static volatile uint32_t txdis_last_cycles;
+static volatile uint32_t txdis_max_cycles;
+
+/* Private function prototypes -----------------------------------------------*/
+static inphi_status_t TXDIS_Apply(void);
+static uint32_t TXDIS_CyclesToUs(uint32_t cycles);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Resolve the LTX squelch registers and apply the current TxDisable.
+  * @retval None
+  */
+void TXDIS_Init(void)
+{
+    TXDIS_Resync();
+}
+
+/**
+  * @brief  Re-read the squelch state from the DSP and re-apply TxDisable,
+  *         call from the main loop after the DSP has been re-initialized.
+  * @retval None
+  */
+void TXDIS_Resync(void)
+{
+    uint8_t *page10 = CMIS_Page(0, CMIS_PAGE_10);
+
+    txdis_ready = 0;
+    if(por_tx_squelch_map_init(&txdis_map, DSP_DIE, POR_INTF_LTX) != INPHI_OK)
+    {
+        return;
+    }
+
+    __disable_irq();
+    txdis_value = page10[CMIS_P10_TX_DISABLE - CMIS_UPPER_OFFSET];
+    txdis_ready = 1;
+    __enable_irq();
+
+    TXDIS_Apply();
+}
+
+/**
+  * @brief  Set the lanes allowed to transmit, call from the main loop.
+  * @param  mask: lane bitmap, bit n-1 for lane n
+  * @retval None
+  */
+void TXDIS_SetLaneEnable(uint8_t mask)
+{
+    txdis_enabled = mask;
+    if(txdis_ready)
+    {
+        TXDIS_Apply();
+    }
+}
+
+/**
+  * @brief  TxDisable byte written by the host, called from the I2C1 interrupt.
+  * @param  value: the new lane bitmap, bit n-1 for lane n
+  * @retval None
+  */
+void TXDIS_OnHostWrite(uint8_t value)
+{
+    txdis_value = value;
+    txdis_stamp = DWT->CYCCNT;
+    txdis_host_change = 1;
+
+    if(!txdis_ready)
+    {
+        /* Picked up by TXDIS_Resync() */
+        return;
+    }
+
+    if(txdis_applying)
+    {
+        /* Preempted TXDIS_Apply() goes round again */
+        txdis_pending = 1;
+    }
+    else if(DSP_BusIsBusy())
+    {
+        txdis_pending = 1;
+        DSP_BusRequestRelease();
+    }
+    else
+    {
+        TXDIS_Apply();
+    }
+}
+
+/**
+  * @brief  Latency of the last TxDisable change.
+  * @retval microseconds from the end of the host write to the last squelch write
+  */
+uint32_t TXDIS_GetLastLatencyUs(void)
+{
+    return TXDIS_CyclesToUs(txdis_last_cycles);
+}
+
+/**
+  * @brief  Worst TxDisable latency since reset.
+  * @retval microseconds from the end of the host write to the last squelch write
+  */
+uint32_t TXDIS_GetMaxLatencyUs(void)
+{
+    return TXDIS_CyclesToUs(txdis_max_cycles);
+}
+
+/**
+  * @brief  DSP bus free again after a TxDisable write found it busy.
+  * @retval None
+  */
+void DSP_BusReleaseCallback(void)
+{
+    if(txdis_pending && !txdis_applying)
+    {
+        TXDIS_Apply();
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* Called from the I2C1 interrupt or the main context with the DSP bus free */
+static inphi_status_t TXDIS_Apply(void)
+{
+    inphi_status_t status;
+    uint32_t cycles;
+    uint8_t host_change = 0;
+
+    txdis_applying = 1;
+    do
+    {
+        txdis_pending = 0;
+        host_change |= txdis_host_change;
+        txdis_host_change = 0;
+        status = por_tx_squelch_lanes(&txdis_map, 0xFFU, (uint8_t)(txdis_value | ~txdis_enabled));
+    } while(txdis_pending);
+    txdis_applying = 0;
+
+    if(status != INPHI_OK)
+    {
+        /* The map kept the lanes not written, retry them after the next
+           transfer and time the host change until they are */
+        txdis_host_change |= host_change;
+        txdis_pending = 1;
+        DSP_BusRequestRelease();
+        return status;
+    }
+
+    if(!host_change)
+    {
+        return status;
+    }
+
+    cycles = DWT->CYCCNT - txdis_stamp;
+    txdis_last_cycles = cycles;
+    if(cycles > txdis_max_cycles)
+    {
+        txdis_max_cycles = cycles;
+    }
+    return status;
+}
+
+static uint32_t TXDIS_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
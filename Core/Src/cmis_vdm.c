@@ -0,0 +1,388 @@
+/**
+  ******************************************************************************
+  * @file    cmis_vdm.c
+  * @brief   This file provides the VDM (Versatile Diagnostics Monitoring)
+  *          group 1: the instance descriptors on page 20h and the sample
+  *          values on page 24h.
+  *
+  *          Every observable accumulates one observation interval. A sample
+  *          only updates the min/max/sum of that interval and the current
+  *          value, so the cost per sample is constant. When the interval ends
+  *          its min/max/avg are published and it starts over; page 24h keeps
+  *          the last complete one. Host reads are served from the RAM pages
+  *          and never reach the DSP.
+  *
+  *          SNR and temperature come from the DDM cache. LTP is read from the
+  *          DSP, one lane per CMIS_Process() pass, so the sampling cost grows
+  *          linearly with the number of lanes. Pre-FEC BER and errored frames
+  *          are already reduced to CMIS F16 min/max/avg/current by the DSP FW
+  *          FEC stats poller, one request per interval, and are published
+  *          as is.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cmis_vdm.h"
+#include "cmis_ddm.h"
+#include "cmis_dp.h"
+#include "dsp.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    VDM_FIELD_CUR = 0,
+    VDM_FIELD_MIN,
+    VDM_FIELD_MAX,
+    VDM_FIELD_AVG,
+    VDM_FIELDS
+} VDM_FieldTypeDef;
+
+typedef struct
+{
+    int32_t min;
+    int32_t max;
+    int32_t sum;
+    uint16_t count;
+} VDM_IntervalTypeDef;
+
+typedef struct
+{
+    VDM_IntervalTypeDef iv;                 // interval being accumulated
+    uint8_t inst[VDM_FIELDS];               // page 24h instance of each field
+} VDM_SeriesTypeDef;
+
+typedef enum
+{
+    VDM_FEC_OFF = 0,
+    VDM_FEC_IDLE,
+    VDM_FEC_WAIT,
+    VDM_FEC_GET,
+    VDM_FEC_UNSUPPORTED
+} VDM_FecStateTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define VDM_NO_INSTANCE             0xFFU
+
+/* Series: module temperature, then SNR and LTP of each lane */
+#define VDM_SER_TEMP                0U
+#define VDM_SER_SNR(lane)           (1U + (lane))
+#define VDM_SER_LTP(lane)           (1U + DDM_NUM_LANES + (lane))
+#define VDM_NUM_SERIES              (1U + 2U * DDM_NUM_LANES)
+
+/* Cycle items: temperature first, then lanes 1..DDM_NUM_LANES */
+#define VDM_ITEM_TEMP               0U
+#define VDM_ITEM_IDLE               (DDM_NUM_LANES + 1U)
+
+/* FW FEC stats blocks holding BER and FERC avg/cur/max/min */
+#define VDM_FEC_BLOCKS              0x0FU
+#define VDM_FEC_ACCUMULATION_MS     100U
+
+/* LTP special values of por_rx_dsp_ltp_read_fixp(), no dB to average */
+#define VDM_LTP_UNAVAILABLE         0x0000U
+#define VDM_LTP_LARGE               0xFFFEU     // > 255.996 dB
+#define VDM_LTP_INFINITE            0xFFFFU
+
+/* Private variables ---------------------------------------------------------*/
+static VDM_SeriesTypeDef vdm_series[VDM_NUM_SERIES];
+static uint8_t vdm_num_inst;
+
+static uint8_t vdm_item = VDM_ITEM_IDLE;
+static uint32_t vdm_cycle_tick;
+static uint32_t vdm_interval_tick;
+static uint32_t vdm_lane_min;
+
+static por_fec_stats_cp_block_t vdm_fec;
+static VDM_FecStateTypeDef vdm_fec_state = VDM_FEC_OFF;
+static uint8_t vdm_fec_request;
+static uint8_t vdm_fec_ber_inst;            // first of min/max/avg/cur
+static uint8_t vdm_fec_ferc_inst;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t VDM_AddInstance(uint8_t lane, uint8_t type);
+static void VDM_AddSeries(uint8_t series, uint8_t lane, const uint8_t *types);
+static void VDM_Sample(uint8_t series, int32_t value);
+static void VDM_Current(uint8_t series, int32_t value);
+static void VDM_CloseInterval(void);
+static void VDM_FecStep(void);
+static void VDM_Put(uint8_t inst, uint16_t value);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Describe the VDM instances and advertise the VDM pages.
+  * @retval None
+  */
+void VDM_Init(void)
+{
+    static const uint8_t temp_types[VDM_FIELDS] =
+        { VDM_TYPE_VS_TEMP_CUR, VDM_TYPE_VS_TEMP_MIN, VDM_TYPE_VS_TEMP_MAX, VDM_TYPE_VS_TEMP_AVG };
+    static const uint8_t snr_types[VDM_FIELDS] =
+        { VDM_TYPE_ESNR_MEDIA, VDM_TYPE_VS_ESNR_MIN, VDM_TYPE_VS_ESNR_MAX, VDM_TYPE_VS_ESNR_AVG };
+    static const uint8_t ltp_types[VDM_FIELDS] =
+        { VDM_TYPE_LTP_MEDIA, VDM_TYPE_VS_LTP_MIN, VDM_TYPE_VS_LTP_MAX, VDM_TYPE_VS_LTP_AVG };
+    uint8_t *page01 = CMIS_Page(0, CMIS_PAGE_01);
+    uint8_t *page2f = CMIS_Page(0, CMIS_PAGE_2F);
+    uint32_t max;
+    uint8_t lane;
+
+    memset(CMIS_Page(0, CMIS_PAGE_20), 0, CMIS_PAGE_SIZE);
+    memset(CMIS_Page(0, CMIS_PAGE_24), 0, CMIS_PAGE_SIZE);
+    memset(vdm_series, 0, sizeof(vdm_series));
+    vdm_num_inst = 0;
+
+    VDM_AddSeries(VDM_SER_TEMP, 0, temp_types);
+    for(lane = 0; lane < DDM_NUM_LANES; lane++)
+    {
+        VDM_AddSeries(VDM_SER_SNR(lane), lane, snr_types);
+        VDM_AddSeries(VDM_SER_LTP(lane), lane, ltp_types);
+    }
+
+    // Same order as the min/max/avg/cur of the FW stats
+    vdm_fec_ber_inst = VDM_AddInstance(0, VDM_TYPE_BER_MIN_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_BER_MAX_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_BER_AVG_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_BER_CUR_MEDIA);
+    vdm_fec_ferc_inst = VDM_AddInstance(0, VDM_TYPE_FERC_MIN_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_FERC_MAX_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_FERC_AVG_MEDIA);
+    VDM_AddInstance(0, VDM_TYPE_FERC_CUR_MEDIA);
+
+    page2f[CMIS_P2F_VDM_GROUPS - CMIS_UPPER_OFFSET] = 0;   // one group
+    page01[CMIS_P01_PAGES_ADVERTISED - CMIS_UPPER_OFFSET] |= CMIS_P01_VDM_SUPPORTED;
+
+    por_package_get_channels(DSP_DIE, POR_INTF_LRX, &vdm_lane_min, &max);
+
+    vdm_fec_state = VDM_FEC_OFF;
+    vdm_item = VDM_ITEM_IDLE;
+    vdm_cycle_tick = HAL_GetTick() - DDM_SAMPLE_PERIOD_MS;
+    vdm_interval_tick = HAL_GetTick();
+}
+
+/**
+  * @brief  Take the next sample, close the interval when it is due and
+  *         advance the FEC stats request. Call from the main loop.
+  * @retval None
+  */
+void VDM_Process(void)
+{
+    uint8_t lane;
+    uint16_t snr;
+    uint16_t ltp;
+    int32_t temp;
+
+    if((HAL_GetTick() - vdm_interval_tick) >= VDM_INTERVAL_MS)
+    {
+        vdm_interval_tick += VDM_INTERVAL_MS;
+        VDM_CloseInterval();
+        vdm_fec_request = 1;
+    }
+
+    VDM_FecStep();
+
+    if(vdm_item == VDM_ITEM_IDLE)
+    {
+        if((HAL_GetTick() - vdm_cycle_tick) < DDM_SAMPLE_PERIOD_MS)
+        {
+            return;
+        }
+        vdm_cycle_tick = HAL_GetTick();
+        vdm_item = VDM_ITEM_TEMP;
+    }
+
+    if(vdm_item == VDM_ITEM_TEMP)
+    {
+        temp = DDM_GetTemperature();
+        if(temp != INT32_MIN)
+        {
+            VDM_Sample(VDM_SER_TEMP, temp);
+        }
+    }
+    else
+    {
+        // Unlocked lanes (SNR 0) are left out of the interval statistics
+        lane = vdm_item - 1U;
+        snr = DDM_GetLaneSnr(vdm_item);
+        if(snr != 0U)
+        {
+            VDM_Sample(VDM_SER_SNR(lane), snr);
+            // An infinite or out of range LTP is only shown as current
+            if(DP_IsDspUp() &&
+               (por_rx_dsp_ltp_read_fixp(DSP_DIE, vdm_lane_min + lane, POR_INTF_LRX, &ltp) == INPHI_OK) &&
+               (ltp != VDM_LTP_UNAVAILABLE))
+            {
+                if((ltp == VDM_LTP_LARGE) || (ltp == VDM_LTP_INFINITE))
+                {
+                    VDM_Current(VDM_SER_LTP(lane), ltp);
+                }
+                else
+                {
+                    VDM_Sample(VDM_SER_LTP(lane), ltp);
+                }
+            }
+        }
+    }
+    vdm_item++;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* Append a descriptor to page 20h, returns its instance index */
+static uint8_t VDM_AddInstance(uint8_t lane, uint8_t type)
+{
+    uint8_t *page20 = CMIS_Page(0, CMIS_PAGE_20);
+    uint8_t inst;
+
+    if(vdm_num_inst >= VDM_MAX_INSTANCES)
+    {
+        return VDM_NO_INSTANCE;
+    }
+
+    inst = vdm_num_inst++;
+    page20[2U * inst]      = lane & 0x0FU;  // threshold set 0
+    page20[2U * inst + 1U] = type;
+    return inst;
+}
+
+static void VDM_AddSeries(uint8_t series, uint8_t lane, const uint8_t *types)
+{
+    uint8_t field;
+
+    for(field = 0; field < VDM_FIELDS; field++)
+    {
+        vdm_series[series].inst[field] = VDM_AddInstance(lane, types[field]);
+    }
+}
+
+/* O(1): fold the sample into the current interval and publish it as current */
+static void VDM_Sample(uint8_t series, int32_t value)
+{
+    VDM_IntervalTypeDef *iv = &vdm_series[series].iv;
+
+    if((iv->count == 0U) || (value < iv->min))
+    {
+        iv->min = value;
+    }
+    if((iv->count == 0U) || (value > iv->max))
+    {
+        iv->max = value;
+    }
+    iv->sum += value;
+    iv->count++;
+
+    VDM_Current(series, value);
+}
+
+/* Publish the sample as current only, the interval statistics are left alone */
+static void VDM_Current(uint8_t series, int32_t value)
+{
+    __disable_irq();
+    VDM_Put(vdm_series[series].inst[VDM_FIELD_CUR], (uint16_t)value);
+    __enable_irq();
+}
+
+/* Publish min/max/avg of the interval just completed and start the next one */
+static void VDM_CloseInterval(void)
+{
+    VDM_SeriesTypeDef *ser;
+    VDM_IntervalTypeDef *iv;
+    uint8_t i;
+
+    // All the statistics of an interval change together for the host
+    __disable_irq();
+    for(i = 0; i < VDM_NUM_SERIES; i++)
+    {
+        ser = &vdm_series[i];
+        iv = &ser->iv;
+        if(iv->count != 0U)
+        {
+            VDM_Put(ser->inst[VDM_FIELD_MIN], (uint16_t)iv->min);
+            VDM_Put(ser->inst[VDM_FIELD_MAX], (uint16_t)iv->max);
+            VDM_Put(ser->inst[VDM_FIELD_AVG], (uint16_t)(iv->sum / (int32_t)iv->count));
+        }
+    }
+    __enable_irq();
+
+    for(i = 0; i < VDM_NUM_SERIES; i++)
+    {
+        memset(&vdm_series[i].iv, 0, sizeof(vdm_series[i].iv));
+    }
+}
+
+/* One step of the FW FEC stats request, cleared on read so it covers one interval */
+static void VDM_FecStep(void)
+{
+    por_fec_stats_poller_rules_t rules;
+    e_por_poller_status poll;
+
+    switch(vdm_fec_state)
+    {
+        case VDM_FEC_OFF:
+            if(!DP_IsDspUp())
+            {
+                break;
+            }
+            rules.en = true;
+            rules.interval_time = 0;
+            rules.accumulation_time = VDM_FEC_ACCUMULATION_MS;
+            vdm_fec_state = (por_fec_stats_poller_cfg(DSP_DIE, POR_INTF_IG_FEC, &rules) == INPHI_OK) ?
+                            VDM_FEC_IDLE : VDM_FEC_UNSUPPORTED;
+            vdm_fec_request = 0;
+            break;
+
+        case VDM_FEC_IDLE:
+            if(vdm_fec_request)
+            {
+                vdm_fec_request = 0;
+                if(por_fec_stats_poller_request(DSP_DIE, POR_INTF_IG_FEC, true, &vdm_fec) == INPHI_OK)
+                {
+                    vdm_fec_state = VDM_FEC_WAIT;
+                }
+            }
+            break;
+
+        case VDM_FEC_WAIT:
+            poll = por_fec_stats_poller_get(DSP_DIE, POR_INTF_IG_FEC, 0, &vdm_fec);
+            if(poll != POR_POLLER_WAITING)
+            {
+                vdm_fec_state = (poll == POR_POLLER_OK) ? VDM_FEC_GET : VDM_FEC_IDLE;
+            }
+            break;
+
+        case VDM_FEC_GET:
+            poll = por_fec_stats_poller_get(DSP_DIE, POR_INTF_IG_FEC, VDM_FEC_BLOCKS, &vdm_fec);
+            if(poll == POR_POLLER_WAITING)
+            {
+                break;
+            }
+            if(poll == POR_POLLER_OK)
+            {
+                __disable_irq();
+                VDM_Put(vdm_fec_ber_inst + 0U, vdm_fec.ber_min);
+                VDM_Put(vdm_fec_ber_inst + 1U, vdm_fec.ber_max);
+                VDM_Put(vdm_fec_ber_inst + 2U, vdm_fec.ber_avg);
+                VDM_Put(vdm_fec_ber_inst + 3U, vdm_fec.ber_curr);
+                VDM_Put(vdm_fec_ferc_inst + 0U, vdm_fec.ferc_min);
+                VDM_Put(vdm_fec_ferc_inst + 1U, vdm_fec.ferc_max);
+                VDM_Put(vdm_fec_ferc_inst + 2U, vdm_fec.ferc_avg);
+                VDM_Put(vdm_fec_ferc_inst + 3U, vdm_fec.ferc_curr);
+                __enable_irq();
+            }
+            vdm_fec_state = VDM_FEC_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Store a sample big-endian on page 24h, interrupts must be off */
+static void VDM_Put(uint8_t inst, uint16_t value)
+{
+    uint8_t *page24 = CMIS_Page(0, CMIS_PAGE_24);
+
+    if(inst >= VDM_MAX_INSTANCES)
+    {
+        return;
+    }
+    page24[2U * inst]      = (uint8_t)(value >> 8);
+    page24[2U * inst + 1U] = (uint8_t)value;
+}
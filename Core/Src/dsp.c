@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file    dsp.c
+  * @brief   This file provides the low level register access methods that the
+  *          Inphi API requires (spica_reg_get/spica_reg_set), implemented over
+  *          the I2C3 master connected to the DSP.
+  *
+  *          The inbound PIF data of a firmware download is sent with
+  *          spica_reg_set_burst(): one address and many data values per
+  *          transfer, the DSP writes them all to that register while its
+  *          MCU burst mode (MCU_MDIO_CFG) is on. The firmware blocks are
+  *          checked with spica_crc32() on the CRC unit.
+  *
+  *          Register transfers are tracked so that interrupt level code (the
+  *          CMIS Tx disable path) can tell whether the bus is free. When it is
+  *          not, the interrupt asks for DSP_BusReleaseCallback() which runs
+  *          right after the transfer in progress completes.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp.h"
+#include "i2c.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t dsp_bus_errors = 0;
+static volatile uint8_t dsp_bus_busy = 0;
+static volatile uint8_t dsp_bus_release_req = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void DSP_PackAddr(uint8_t *buf, uint32_t addr);
+static void DSP_BusRelease(void);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Lowest level register read used by the Inphi API.
+  *         Do not call directly, use the por_* / spica_reg_read methods.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @param  addr: the register address
+  * @param  data: the 16-bit register value
+  * @retval INPHI_OK on success, INPHI_ERROR on failure
+  */
+inphi_status_t spica_reg_get(uint32_t die, uint32_t addr, uint32_t *data)
+{
+    uint8_t addr_buf[DSP_I2C_ADDR_BYTES];
+    uint8_t data_buf[DSP_I2C_DATA_BYTES] = {0};
+    (void)die;
+
+    DSP_PackAddr(addr_buf, addr);
+    dsp_bus_busy = 1;
+    if((HAL_I2C_Master_Transmit(&hi2c3, DSP_I2C_DEV_ADDR, addr_buf, DSP_I2C_ADDR_BYTES, DSP_I2C_TIMEOUT_MS) != HAL_OK) ||
+       (HAL_I2C_Master_Receive(&hi2c3, DSP_I2C_DEV_ADDR, data_buf, DSP_I2C_DATA_BYTES, DSP_I2C_TIMEOUT_MS) != HAL_OK))
+    {
+        dsp_bus_errors++;
+        *data = 0;
+        DSP_BusRelease();
+        return INPHI_ERROR;
+    }
+    DSP_BusRelease();
+
+    *data = ((uint32_t)data_buf[0] << 8) | (uint32_t)data_buf[1];
+    return INPHI_OK;
+}
+
+/**
+  * @brief  Lowest level register write used by the Inphi API.
+  *         Do not call directly, use the por_* / spica_reg_write methods.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @param  addr: the register address
+  * @param  data: the 16-bit register value
+  * @retval INPHI_OK on success, INPHI_ERROR on failure
+  */
+inphi_status_t spica_reg_set(uint32_t die, uint32_t addr, uint32_t data)
+{
+    uint8_t buf[DSP_I2C_ADDR_BYTES + DSP_I2C_DATA_BYTES];
+    (void)die;
+
+    DSP_PackAddr(buf, addr);
+    buf[DSP_I2C_ADDR_BYTES]     = (uint8_t)(data >> 8);
+    buf[DSP_I2C_ADDR_BYTES + 1] = (uint8_t)data;
+    dsp_bus_busy = 1;
+    if(HAL_I2C_Master_Transmit(&hi2c3, DSP_I2C_DEV_ADDR, buf, sizeof(buf), DSP_I2C_TIMEOUT_MS) != HAL_OK)
+    {
+        dsp_bus_errors++;
+        DSP_BusRelease();
+        return INPHI_ERROR;
+    }
+    DSP_BusRelease();
+    return INPHI_OK;
+}
+
+/**
+  * @brief  Burst register write used by the Inphi API for the inbound PIF
+  *         data while the DSP MCU burst mode is on: the address is sent once
+  *         per transfer and followed by up to DSP_I2C_BURST_MAX_DATA values,
+  *         all written to that same register.
+  *         Do not call directly, used by the por_* firmware download methods.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @param  addr: the register address
+  * @param  data: the 16-bit register values, in write order
+  * @param  num_data: number of values
+  * @retval INPHI_OK on success, INPHI_ERROR on failure
+  */
+inphi_status_t spica_reg_set_burst(uint32_t die, uint32_t addr, const uint16_t *data, uint32_t num_data)
+{
+    uint8_t buf[DSP_I2C_ADDR_BYTES + DSP_I2C_BURST_MAX_DATA * DSP_I2C_DATA_BYTES];
+    uint32_t n;
+    uint32_t i;
+    (void)die;
+
+    DSP_PackAddr(buf, addr);
+    while(num_data > 0U)
+    {
+        n = (num_data < DSP_I2C_BURST_MAX_DATA) ? num_data : DSP_I2C_BURST_MAX_DATA;
+        for(i = 0; i < n; i++)
+        {
+            buf[DSP_I2C_ADDR_BYTES + 2U * i]      = (uint8_t)(data[i] >> 8);
+            buf[DSP_I2C_ADDR_BYTES + 2U * i + 1U] = (uint8_t)data[i];
+        }
+
+        dsp_bus_busy = 1;
+        if(HAL_I2C_Master_Transmit(&hi2c3, DSP_I2C_DEV_ADDR, buf, (uint16_t)(DSP_I2C_ADDR_BYTES + n * DSP_I2C_DATA_BYTES),
+                                   DSP_I2C_BURST_TIMEOUT_MS) != HAL_OK)
+        {
+            dsp_bus_errors++;
+            DSP_BusRelease();
+            return INPHI_ERROR;
+        }
+        DSP_BusRelease();
+
+        data += n;
+        num_data -= n;
+    }
+    return INPHI_OK;
+}
+
+/**
+  * @brief  CRC-32 used by the Inphi API to check firmware blocks, computed on
+  *         the CRC unit: words are bit reversed on input and the result on
+  *         output, which gives the reflected CRC-32 of their little-endian
+  *         bytes. A previous result is resumed by loading its internal form
+  *         as the initial value.
+  * @param  crc: CRC-32 of the data before words, 0 to start
+  * @param  words: the data
+  * @param  num_words: number of 32-bit words
+  * @retval CRC-32 of the data up to the end of words
+  */
+uint32_t spica_crc32(uint32_t crc, const uint32_t *words, uint32_t num_words)
+{
+    uint32_t i;
+
+    if(!__HAL_RCC_CRC_IS_CLK_ENABLED())
+    {
+        __HAL_RCC_CRC_CLK_ENABLE();
+    }
+
+    CRC->POL = DSP_CRC32_POLY;
+    CRC->INIT = __RBIT(~crc);
+    CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT | CRC_CR_RESET;
+    for(i = 0; i < num_words; i++)
+    {
+        CRC->DR = words[i];
+    }
+    return ~CRC->DR;
+}
+
+/**
+  * @brief  Number of failed DSP register transfers since reset.
+  * @retval error count
+  */
+uint32_t DSP_GetBusErrorCount(void)
+{
+    return dsp_bus_errors;
+}
+
+/**
+  * @brief  Whether a register transfer is in progress on the DSP bus.
+  *         Only meaningful from an interrupt that may have preempted it.
+  * @retval 1 if busy, 0 if the bus is free
+  */
+uint8_t DSP_BusIsBusy(void)
+{
+    return dsp_bus_busy;
+}
+
+/**
+  * @brief  Ask for DSP_BusReleaseCallback() once the transfer in progress
+  *         has completed. Call from interrupt context when DSP_BusIsBusy().
+  * @retval None
+  */
+void DSP_BusRequestRelease(void)
+{
+    dsp_bus_release_req = 1;
+}
+
+/**
+  * @brief  Called from the main context at the end of a register transfer
+  *         after DSP_BusRequestRelease(), the bus is free at this point.
+  * @note   This function should not be modified, when the callback is
+  *         needed it is implemented in the user file.
+  * @retval None
+  */
+__weak void DSP_BusReleaseCallback(void)
+{
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void DSP_PackAddr(uint8_t *buf, uint32_t addr)
+{
+    buf[0] = (uint8_t)(addr >> 24);
+    buf[1] = (uint8_t)(addr >> 16);
+    buf[2] = (uint8_t)(addr >> 8);
+    buf[3] = (uint8_t)addr;
+}
+
+/* End of a transfer: free the bus, then serve a release request made while busy */
+static void DSP_BusRelease(void)
+{
+    dsp_bus_busy = 0;
+    if(dsp_bus_release_req)
+    {
+        dsp_bus_release_req = 0;
+        DSP_BusReleaseCallback();
+    }
+}
@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    dsp_fw_src.c
+  * @brief   This file provides the image sources for
+  *          por_mcu_download_firmware_from_source().
+  *
+  *          The flash source copies each chunk of an uncompressed image out
+  *          of the memory mapped flash with a memory to memory DMA
+  *          transfer. The API requests the next chunk before it programs
+  *          the current one, so the copy runs while the CPU drives the
+  *          register writes on the DSP bus. Only the API's two chunk
+  *          buffers are needed in RAM, whatever the size of the image.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_fw_src.h"
+
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef dsp_fw_src_dma;
+static uint8_t dsp_fw_src_dma_ready = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static inphi_status_t DSP_FwSrcFlashRead(uint32_t offset, uint32_t *buf, uint32_t num_words, void *user_data);
+static inphi_status_t DSP_FwSrcFlashWait(void *user_data);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Set up a source reading an image kept in the internal flash.
+  * @param  source: the source to fill in
+  * @param  image: the image, in the por_mcu_download_firmware() word format
+  * @retval None
+  */
+void DSP_FwSrcFlash(por_fw_source_t *source, const uint32_t *image)
+{
+    if(!dsp_fw_src_dma_ready)
+    {
+        __HAL_RCC_DMA1_CLK_ENABLE();
+
+        dsp_fw_src_dma.Instance = DSP_FW_SRC_DMA_CHANNEL;
+        dsp_fw_src_dma.Init.Request = DMA_REQUEST_0;
+        dsp_fw_src_dma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+        dsp_fw_src_dma.Init.PeriphInc = DMA_PINC_ENABLE;
+        dsp_fw_src_dma.Init.MemInc = DMA_MINC_ENABLE;
+        dsp_fw_src_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+        dsp_fw_src_dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+        dsp_fw_src_dma.Init.Mode = DMA_NORMAL;
+        dsp_fw_src_dma.Init.Priority = DMA_PRIORITY_LOW;
+        dsp_fw_src_dma_ready = (HAL_DMA_Init(&dsp_fw_src_dma) == HAL_OK);
+    }
+
+    source->read_start = DSP_FwSrcFlashRead;
+    source->read_wait = DSP_FwSrcFlashWait;
+    source->user_data = (void *)image;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* Start copying a chunk, or copy it straight away without the DMA */
+static inphi_status_t DSP_FwSrcFlashRead(uint32_t offset, uint32_t *buf, uint32_t num_words, void *user_data)
+{
+    const uint32_t *image = (const uint32_t *)user_data;
+    uint32_t i;
+
+    if(dsp_fw_src_dma_ready &&
+       (HAL_DMA_Start(&dsp_fw_src_dma, (uint32_t)&image[offset], (uint32_t)buf, num_words) == HAL_OK))
+    {
+        return INPHI_OK;
+    }
+
+    for(i = 0; i < num_words; i++)
+    {
+        buf[i] = image[offset + i];
+    }
+    return INPHI_OK;
+}
+
+static inphi_status_t DSP_FwSrcFlashWait(void *user_data)
+{
+    (void)user_data;
+
+    if(dsp_fw_src_dma.State != HAL_DMA_STATE_BUSY)
+    {
+        return INPHI_OK;
+    }
+    if(HAL_DMA_PollForTransfer(&dsp_fw_src_dma, HAL_DMA_FULL_TRANSFER, DSP_FW_SRC_DMA_TIMEOUT_MS) != HAL_OK)
+    {
+        HAL_DMA_Abort(&dsp_fw_src_dma);
+        return INPHI_ERROR;
+    }
+    return INPHI_OK;
+}
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ident.c
+  * @brief   This file provides the DSP identity record: the package type the
+  *          Inphi API discovers from the EFUSE, kept in a flash page together
+  *          with the DSP device ID it was read from.
+  *
+  *          At boot the device ID registers are read and compared with the
+  *          record. When they match, the API package cache is loaded from the
+  *          record and the EFUSE power-up/fetch/power-down sequence is
+  *          skipped. Otherwise (first boot, another part) the package type is
+  *          discovered the usual way and the record is rewritten.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_ident.h"
+#include "dsp.h"
+#include "flash_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t device_id;                     // por_package_device_id_query()
+    uint32_t package;                       // e_por_package_type
+    uint32_t check;                         // ~(magic ^ device_id ^ package)
+} DSP_IdentTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define DSP_IDENT_MAGIC             0x44494450U     /* "PDID" */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t DSP_IdentCheck(const DSP_IdentTypeDef *rec);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Load the API package cache from the record, or discover the
+  *         package type and record it. Call before any other DSP access
+  *         and before the host interface is enabled (page erase).
+  * @retval None
+  */
+void DSP_IdentInit(void)
+{
+    const DSP_IdentTypeDef *rec = (const DSP_IdentTypeDef *)FLASH_IF_IDENT_ADDR;
+    DSP_IdentTypeDef fresh;
+    uint32_t device_id;
+    e_por_package_type package;
+
+    if(por_package_device_id_query(DSP_DIE, &device_id) != INPHI_OK)
+    {
+        // No DSP on the bus, the API finds out on its own later
+        return;
+    }
+
+    if((rec->magic == DSP_IDENT_MAGIC) && (rec->check == DSP_IdentCheck(rec)) &&
+       (rec->device_id == device_id))
+    {
+        por_package_cache_set((e_por_package_type)rec->package);
+        return;
+    }
+
+    // First boot or another part: one EFUSE fetch, then remember the result
+    package = por_package_get_type(DSP_DIE);
+    if((package != POR_PACKAGE_TYPE_EML_12x13) && (package != POR_PACKAGE_TYPE_EML_12x13_REV1) &&
+       (package != POR_PACKAGE_TYPE_STD_10x13))
+    {
+        // Unfused or unsupported, keep asking the EFUSE
+        return;
+    }
+
+    fresh.magic = DSP_IDENT_MAGIC;
+    fresh.device_id = device_id;
+    fresh.package = (uint32_t)package;
+    fresh.check = DSP_IdentCheck(&fresh);
+
+    if(FLASH_If_Erase(FLASH_IF_IDENT_ADDR, sizeof(fresh)) == HAL_OK)
+    {
+        FLASH_If_Write(FLASH_IF_IDENT_ADDR, &fresh, sizeof(fresh));
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t DSP_IdentCheck(const DSP_IdentTypeDef *rec)
+{
+    return ~(rec->magic ^ rec->device_id ^ rec->package);
+}
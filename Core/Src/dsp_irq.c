@@ -0,0 +1,219 @@
+/**
+  ******************************************************************************
+  * @file    dsp_irq.c
+  * @brief   This file provides the DSP interrupt line (DSP_INT_N on EXTI0)
+  *          and the timing hooks of the Inphi API, spica_event_wait() and
+  *          spica_timestamp_ms().
+  *
+  *          The API used to sleep a fixed time between two polls of the
+  *          mailbox, the estimation semaphores and the link state. It now
+  *          calls spica_event_wait() instead, which returns as soon as the
+  *          DSP signals one of the events the caller is waiting for.
+  *
+  *          The interrupt itself only records that the line fell: the
+  *          registers are on the DSP bus, which is only used from the main
+  *          context. The dispatcher runs from the wait, reads the interrupt
+  *          status once (FW_INTH and MBOX_STATUS), clears it and turns it
+  *          into POR_EVENT_* bits. Each wait consumes the bits it asked
+  *          for, the others stay for the waiter concerned.
+  *
+  *          The line is edge triggered, the dispatcher checks it once the
+  *          status is cleared and runs again while it is still low, at most
+  *          once per DSP_IRQ_HELD_RETRY_US so that a line stuck low does not
+  *          turn the waits into back to back reads of the status.
+  *
+  *          The waits are timed on the DWT cycle counter (enabled by
+  *          CMIS_Init()) and return the time spent in us, which the API
+  *          adds up against its timeouts.
+  *
+  *          The line is only armed while the DSP is operational. Before that,
+  *          or when the line stays quiet, a wait simply lasts its full time
+  *          and the API polls as it did before.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_irq.h"
+#include "dsp.h"
+#include "spica_registers.h"
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint8_t dsp_irq_pending = 0;
+static uint8_t dsp_irq_held = 0;                /* line still low after the last dispatch */
+static uint32_t dsp_irq_held_stamp;             /* DWT cycle count of that dispatch */
+static uint8_t dsp_irq_armed = 0;
+static uint32_t dsp_irq_events = 0;
+static uint32_t dsp_irq_count = 0;
+static uint16_t dsp_irq_mbox_status = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t DSP_IrqDue(void);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Event wait hook of the Inphi API.
+  *         Do not call directly, called by the por_* methods between polls.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @param  events: POR_EVENT_* bits that end the wait
+  * @param  msecs: longest time to wait, under the 53 s the cycle counter
+  *         takes to wrap
+  * @retval time waited in us, less than msecs when an event came
+  */
+uint32_t spica_event_wait(uint32_t die, uint32_t events, uint32_t msecs)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t limit = msecs * (SystemCoreClock / 1000U);
+    uint32_t elapsed = 0;
+    (void)die;
+
+    while(elapsed < limit)
+    {
+        if(DSP_IrqDue())
+        {
+            DSP_IrqDispatch();
+        }
+        if(dsp_irq_events & events)
+        {
+            dsp_irq_events &= ~events;
+            break;
+        }
+        elapsed = DWT->CYCCNT - start;
+    }
+    return elapsed / (SystemCoreClock / 1000000U);
+}
+
+/**
+  * @brief  Timestamp hook of the Inphi API, the resumable methods time
+  *         their waits for the FW against it.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @retval the HAL tick, in ms
+  */
+uint32_t spica_timestamp_ms(uint32_t die)
+{
+    (void)die;
+    return HAL_GetTick();
+}
+
+/**
+  * @brief  Arm the DSP interrupt on the mailbox levels, call once the DSP is
+  *         operational (an MCU reset of the DSP clears its configuration).
+  * @retval None
+  */
+void DSP_IrqInit(void)
+{
+    SPICA_MCU_MBOX_CFG__TX_INT_THRESHOLD__RMW(DSP_DIE, DSP_IRQ_MBOX_TX_THRESHOLD);
+    SPICA_MCU_MBOX_CFG__RX_INT_THRESHOLD__RMW(DSP_DIE, DSP_IRQ_MBOX_RX_THRESHOLD);
+    SPICA_MCU_MBOX_INTE__TX_CNTE__RMW(DSP_DIE, 1);
+    SPICA_MCU_MBOX_INTE__RX_EMPTYE__RMW(DSP_DIE, 1);
+
+    dsp_irq_mbox_status = (uint16_t)SPICA_MCU_MBOX_STATUS__READ(DSP_DIE);
+    dsp_irq_events = 0;
+    dsp_irq_held = 0;
+    dsp_irq_armed = 1;
+
+    // Serve an edge that came before the line was armed
+    dsp_irq_pending = (HAL_GPIO_ReadPin(DSP_INT_N_GPIO_Port, DSP_INT_N_Pin) == GPIO_PIN_RESET);
+}
+
+/**
+  * @brief  Stop serving the DSP interrupt, call when the DSP was lost. The
+  *         waits of the API then last their full time.
+  * @retval None
+  */
+void DSP_IrqDeInit(void)
+{
+    dsp_irq_armed = 0;
+    dsp_irq_pending = 0;
+    dsp_irq_held = 0;
+    dsp_irq_events = 0;
+}
+
+/**
+  * @brief  Read and clear the DSP interrupt status, main context only.
+  *         Called by the waits, a caller outside the API may use it to
+  *         serve the line too.
+  * @retval POR_EVENT_* bits raised by this interrupt
+  */
+uint32_t DSP_IrqDispatch(void)
+{
+    uint32_t events = 0;
+    uint16_t inth;
+    uint16_t mbox;
+
+    dsp_irq_pending = 0;
+    dsp_irq_held = 0;
+    if(!dsp_irq_armed)
+    {
+        return 0;
+    }
+    dsp_irq_count++;
+
+    inth = (uint16_t)SPICA_MCU_FW_INTH__READ(DSP_DIE);
+    mbox = (uint16_t)SPICA_MCU_MBOX_STATUS__READ(DSP_DIE);
+
+    if(inth & DSP_IRQ_FW_INTH_LINK_MASK)
+    {
+        events |= POR_EVENT_LINK;
+    }
+    if(SPICA_MCU_FW_INTH__FW__GET(inth))
+    {
+        // Requests and replies of the FW go through the mailbox or msg2
+        events |= POR_EVENT_MBOX | POR_EVENT_ALG;
+    }
+    if((mbox != dsp_irq_mbox_status) || (SPICA_MCU_MBOX_STATUS__TXCNT__GET(mbox) != 0U))
+    {
+        events |= POR_EVENT_MBOX;
+    }
+    dsp_irq_mbox_status = mbox;
+
+    // Write the bits seen back to clear them
+    if(inth != 0U)
+    {
+        SPICA_MCU_FW_INTH__WRITE(DSP_DIE, inth);
+    }
+
+    // The line is edge triggered: while a source still holds it low no new
+    // edge comes, serve it again from a later wait once the retry time is up
+    if(HAL_GPIO_ReadPin(DSP_INT_N_GPIO_Port, DSP_INT_N_Pin) == GPIO_PIN_RESET)
+    {
+        dsp_irq_held = 1;
+        dsp_irq_held_stamp = DWT->CYCCNT;
+    }
+
+    dsp_irq_events |= events;
+    return events;
+}
+
+/**
+  * @brief  Number of DSP interrupts served.
+  * @retval count
+  */
+uint32_t DSP_IrqGetCount(void)
+{
+    return dsp_irq_count;
+}
+
+/**
+  * @brief  EXTI line detection callback, the DSP interrupt line fell.
+  * @param  GPIO_Pin: the EXTI line
+  * @retval None
+  */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if(GPIO_Pin == DSP_INT_N_Pin)
+    {
+        dsp_irq_pending = 1;
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* A new edge came, or the line was left low and the retry time is up */
+static uint8_t DSP_IrqDue(void)
+{
+    if(dsp_irq_pending)
+    {
+        return 1;
+    }
+    return dsp_irq_held &&
+           ((DWT->CYCCNT - dsp_irq_held_stamp) >= DSP_IRQ_HELD_RETRY_US * (SystemCoreClock / 1000000U));
+}
@@ -0,0 +1,196 @@
+/**
+  ******************************************************************************
+  * @file    dsp_prof.c
+  * @brief   This file provides the timing record of the DSP bring-up: the
+  *          Inphi API reports the start and end of its phases (EFUSE fetch,
+  *          RAM init, firmware download, chip init, rules...) through
+  *          spica_boot_mark(), the DataPath module adds the whole bring-up
+  *          and the link wait of every lane.
+  *
+  *          Phases are timed on the DWT cycle counter (enabled by
+  *          CMIS_Init()). Each keeps a count, the total and the longest time
+  *          and when it was first entered, so nested and repeated phases
+  *          (one APP_MODE wait per bundle, one VERIFY per block) add up.
+  *          The record stays in RAM for a debugger and can be printed on
+  *          USART2 to compare builds.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_prof.h"
+#include "usart.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+static DSP_ProfTypeDef dsp_prof;
+
+static const char * const dsp_prof_names[DSP_PROF_NUM_PHASES] =
+{
+    "init", "bootloader", "efuse", "app_mode", "chip_init",
+    "enter_op", "rules", "rules_ack", "ram_init", "download", "verify",
+    "bringup", "link1", "link2", "link3", "link4"
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t DSP_ProfCyclesToUs(uint32_t cycles);
+static void DSP_ProfPrint(const char *line);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Boot profiling hook of the Inphi API.
+  *         Do not call directly, called by the por_* bring-up methods.
+  * @param  die: the ASIC die being accessed (single DSP on this module)
+  * @param  phase: POR_BOOT_PHASE_*
+  * @param  enter: true when the phase starts, false when it ends
+  * @retval None
+  */
+void spica_boot_mark(uint32_t die, uint32_t phase, bool enter)
+{
+    (void)die;
+
+    if(enter)
+    {
+        DSP_ProfEnter(phase);
+    }
+    else
+    {
+        DSP_ProfExit(phase);
+    }
+}
+
+/**
+  * @brief  Clear the record, call when a bring-up starts.
+  * @retval None
+  */
+void DSP_ProfReset(void)
+{
+    memset(&dsp_prof, 0, sizeof(dsp_prof));
+    dsp_prof.reset_tick = HAL_GetTick();
+    dsp_prof.sysclk_hz = SystemCoreClock;
+}
+
+/**
+  * @brief  Start timing a phase.
+  * @param  phase: POR_BOOT_PHASE_* or DSP_PROF_PHASE_*
+  * @retval None
+  */
+void DSP_ProfEnter(uint32_t phase)
+{
+    DSP_ProfPhaseTypeDef *p;
+
+    if(phase >= DSP_PROF_NUM_PHASES)
+    {
+        return;
+    }
+
+    p = &dsp_prof.phase[phase];
+    if(p->count == 0U && !p->active)
+    {
+        p->first_ms = HAL_GetTick() - dsp_prof.reset_tick;
+    }
+    p->start_cycles = DWT->CYCCNT;
+    p->active = 1;
+}
+
+/**
+  * @brief  Stop timing a phase, nothing if it was not started.
+  * @param  phase: POR_BOOT_PHASE_* or DSP_PROF_PHASE_*
+  * @retval None
+  */
+void DSP_ProfExit(uint32_t phase)
+{
+    DSP_ProfPhaseTypeDef *p;
+
+    if((phase >= DSP_PROF_NUM_PHASES) || !dsp_prof.phase[phase].active)
+    {
+        return;
+    }
+
+    p = &dsp_prof.phase[phase];
+    p->active = 0;
+    DSP_ProfAdd(phase, DSP_ProfCyclesToUs(DWT->CYCCNT - p->start_cycles));
+}
+
+/**
+  * @brief  Account a phase timed by the caller, ending now.
+  * @param  phase: POR_BOOT_PHASE_* or DSP_PROF_PHASE_*
+  * @param  us: its duration
+  * @retval None
+  */
+void DSP_ProfAdd(uint32_t phase, uint32_t us)
+{
+    DSP_ProfPhaseTypeDef *p;
+
+    if(phase >= DSP_PROF_NUM_PHASES)
+    {
+        return;
+    }
+
+    p = &dsp_prof.phase[phase];
+    if(p->count == 0U && p->first_ms == 0U)
+    {
+        p->first_ms = HAL_GetTick() - dsp_prof.reset_tick - us / 1000U;
+    }
+    p->count++;
+    p->total_us += us;
+    if(us > p->max_us)
+    {
+        p->max_us = us;
+    }
+}
+
+/**
+  * @brief  The record of the last bring-up.
+  * @retval record
+  */
+const DSP_ProfTypeDef *DSP_ProfGet(void)
+{
+    return &dsp_prof;
+}
+
+/**
+  * @brief  Print the phases that ran on USART2, one line each. Blocking.
+  * @retval 1 if printed, 0 while USART2 is not initialized yet
+  */
+uint8_t DSP_ProfDump(void)
+{
+    char line[80];
+    const DSP_ProfPhaseTypeDef *p;
+    uint32_t i;
+
+    // USART2 is brought up late in the boot, see main()
+    if(huart2.gState == HAL_UART_STATE_RESET)
+    {
+        return 0;
+    }
+
+    snprintf(line, sizeof(line), "DSP boot profile, SYSCLK %lu Hz\r\n", (unsigned long)dsp_prof.sysclk_hz);
+    DSP_ProfPrint(line);
+    DSP_ProfPrint("phase         count  first_ms    total_us      max_us\r\n");
+
+    for(i = 0; i < DSP_PROF_NUM_PHASES; i++)
+    {
+        p = &dsp_prof.phase[i];
+        if(p->count == 0U)
+        {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-12s %6lu %9lu %11lu %11lu\r\n", dsp_prof_names[i],
+                 (unsigned long)p->count, (unsigned long)p->first_ms,
+                 (unsigned long)p->total_us, (unsigned long)p->max_us);
+        DSP_ProfPrint(line);
+    }
+    return 1;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t DSP_ProfCyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+static void DSP_ProfPrint(const char *line)
+{
+    HAL_UART_Transmit(&huart2, (uint8_t *)line, (uint16_t)strlen(line), DSP_PROF_UART_TIMEOUT_MS);
+}
@@ -0,0 +1,351 @@
+/**
+  ******************************************************************************
+  * @file    dsp_slot.c
+  * @brief   This file provides the two DSP firmware slots kept in flash when
+  *          the DSP is booted by the MCU (DSP_FW_IN_FLASH).
+  *
+  *          A slot is a header (version, length, CRC-32, sequence number)
+  *          followed by an image in the por_mcu_download_firmware_lz()
+  *          format. The active slot is the valid one with the highest
+  *          sequence number. A new image always goes to the other slot, so
+  *          the running one stays intact while it is written. The header is
+  *          programmed last, once the CRC of the image read back matches:
+  *          until then the slot holds no image at all.
+  *
+  *          A slot whose image fails its boot health check is rejected in
+  *          place (one double word of its header), and the other slot
+  *          becomes the active one.
+  *
+  *          The slots take the top 2 x 126K of the FLASH region of the linker
+  *          script, which checks that the code and the built-in image end
+  *          below them.
+  *
+  *          The flash has a single bank, the CPU stalls while a page is
+  *          erased (about 22 ms) or programmed. Image data is taken a chunk
+  *          at a time and pages are erased as the image reaches them, so a
+  *          download runs in the background of the main loop.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_slot.h"
+#include "dsp.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;                       // given by the writer, for reporting
+    uint32_t length;                        // image bytes
+    uint32_t crc;                           // spica_crc32() of the image, tail padded with 0xFF
+    uint32_t seq;                           // higher is newer
+    uint32_t check;                         // ~(magic ^ version ^ length ^ crc ^ seq)
+    uint64_t rejected;                      // erased until the image fails its boot check
+} DSP_SlotHdrTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define DSP_SLOT_MAGIC              0x53505344U     /* "DSPS" */
+
+/* Header up to, not including, the rejected double word */
+#define DSP_SLOT_HDR_PROGRAM        offsetof(DSP_SlotHdrTypeDef, rejected)
+
+#define DSP_SLOT_ADDR(slot)         ((uint32_t)dsp_slot_area[slot])
+
+/* Exported variables --------------------------------------------------------*/
+/* The slots, placed by the linker script at the top of the FLASH region
+   (.dsp_slots, not loaded). The flash is only reserved when this module is
+   linked in, that is with DSP_FW_IN_FLASH. Not static and not const, the
+   compiler must not assume the erased contents it would otherwise see */
+uint8_t dsp_slot_area[DSP_SLOT_NUM][FLASH_IF_SLOT_SIZE] __attribute__((section(".dsp_slots")));
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t slot_ok[DSP_SLOT_NUM];
+
+/* Image being written */
+static uint8_t slot_wr = DSP_SLOT_NONE;
+static uint32_t slot_wr_length;
+static uint32_t slot_wr_version;
+static uint32_t slot_wr_offset;             // image bytes taken
+static uint32_t slot_wr_written;            // image bytes programmed, a multiple of 8
+static uint32_t slot_wr_erased;             // slot bytes erased
+static uint8_t slot_wr_pend[8];             // bytes of the next double word
+static uint8_t slot_wr_npend;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t DSP_SlotScan(uint8_t slot);
+static HAL_StatusTypeDef DSP_SlotProgram(const uint8_t *data, uint32_t len);
+static uint32_t DSP_SlotCrc(uint8_t slot, uint32_t length);
+static uint32_t DSP_SlotCheck(const DSP_SlotHdrTypeDef *hdr);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Check the headers and images of both slots.
+  * @retval None
+  */
+void DSP_SlotInit(void)
+{
+    uint8_t slot;
+
+    for(slot = 0; slot < DSP_SLOT_NUM; slot++)
+    {
+        slot_ok[slot] = DSP_SlotScan(slot);
+    }
+    slot_wr = DSP_SLOT_NONE;
+}
+
+/**
+  * @brief  Slot to boot the DSP from.
+  * @retval slot index, DSP_SLOT_NONE if no slot holds a usable image
+  */
+uint8_t DSP_SlotActive(void)
+{
+    const DSP_SlotHdrTypeDef *hdr;
+    uint8_t active = DSP_SLOT_NONE;
+    uint32_t seq = 0;
+    uint8_t slot;
+
+    for(slot = 0; slot < DSP_SLOT_NUM; slot++)
+    {
+        hdr = (const DSP_SlotHdrTypeDef *)DSP_SLOT_ADDR(slot);
+        if(slot_ok[slot] && ((active == DSP_SLOT_NONE) || (hdr->seq > seq)))
+        {
+            active = slot;
+            seq = hdr->seq;
+        }
+    }
+    return active;
+}
+
+/**
+  * @brief  Image held by a slot.
+  * @param  slot: slot index
+  * @param  length: set to the image length in bytes
+  * @retval image, NULL if the slot holds no usable image
+  */
+const uint8_t *DSP_SlotImage(uint8_t slot, uint32_t *length)
+{
+    if((slot >= DSP_SLOT_NUM) || !slot_ok[slot])
+    {
+        return NULL;
+    }
+
+    *length = ((const DSP_SlotHdrTypeDef *)DSP_SLOT_ADDR(slot))->length;
+    return (const uint8_t *)(DSP_SLOT_ADDR(slot) + DSP_SLOT_HDR_SIZE);
+}
+
+/**
+  * @brief  Reject the image of a slot after a failed boot. The last usable
+  *         image is never rejected, there would be nothing left to boot.
+  * @param  slot: slot index
+  * @retval 1 if the other slot took over, 0 otherwise
+  */
+uint8_t DSP_SlotReject(uint8_t slot)
+{
+    const uint64_t rejected = 0;
+    uint8_t other = (uint8_t)(slot ^ 1U);
+
+    if((slot >= DSP_SLOT_NUM) || !slot_ok[slot] || !slot_ok[other])
+    {
+        return 0;
+    }
+
+    FLASH_If_Write(DSP_SLOT_ADDR(slot) + offsetof(DSP_SlotHdrTypeDef, rejected), &rejected, sizeof(rejected));
+    slot_ok[slot] = 0;
+    return 1;
+}
+
+/**
+  * @brief  Start writing an image to the slot that is not active. Its
+  *         previous image is invalidated straight away.
+  * @param  length: image bytes
+  * @param  version: image version kept in the header
+  * @retval HAL status
+  */
+HAL_StatusTypeDef DSP_SlotWriteBegin(uint32_t length, uint32_t version)
+{
+    uint8_t slot = (DSP_SlotActive() == 0U) ? 1U : 0U;
+
+    if((length == 0U) || (length > DSP_SLOT_IMAGE_MAX))
+    {
+        return HAL_ERROR;
+    }
+
+    slot_wr = DSP_SLOT_NONE;
+    slot_ok[slot] = 0;
+
+    // First page holds the header
+    if(FLASH_If_Erase(DSP_SLOT_ADDR(slot), FLASH_PAGE_SIZE) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    slot_wr = slot;
+    slot_wr_length = length;
+    slot_wr_version = version;
+    slot_wr_offset = 0;
+    slot_wr_written = 0;
+    slot_wr_erased = FLASH_PAGE_SIZE;
+    slot_wr_npend = 0;
+    return HAL_OK;
+}
+
+/**
+  * @brief  Program the next bytes of the image, in order. Pages are erased
+  *         as the image reaches them.
+  * @param  offset: image offset of data[0], the number of bytes taken so far
+  * @param  data: the bytes
+  * @param  len: number of bytes, DSP_SLOT_WRITE_BYTES per call keeps the
+  *         stall short
+  * @retval HAL status
+  */
+HAL_StatusTypeDef DSP_SlotWrite(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    HAL_StatusTypeDef ret = HAL_OK;
+    uint32_t n;
+
+    if((slot_wr == DSP_SLOT_NONE) || (offset != slot_wr_offset) || (len > slot_wr_length - offset))
+    {
+        return HAL_ERROR;
+    }
+
+    while((len > 0U) && (ret == HAL_OK))
+    {
+        if((slot_wr_npend == 0U) && (len >= 8U))
+        {
+            // Whole double words straight from the caller
+            n = len & ~7U;
+            ret = DSP_SlotProgram(data, n);
+        }
+        else
+        {
+            n = 8U - slot_wr_npend;
+            if(n > len)
+            {
+                n = len;
+            }
+            memcpy(&slot_wr_pend[slot_wr_npend], data, n);
+            slot_wr_npend += (uint8_t)n;
+            if(slot_wr_npend == 8U)
+            {
+                ret = DSP_SlotProgram(slot_wr_pend, 8U);
+                slot_wr_npend = 0;
+            }
+        }
+
+        data += n;
+        len -= n;
+        slot_wr_offset += n;
+    }
+    return ret;
+}
+
+/**
+  * @brief  Check the image written and make its slot the active one.
+  * @retval HAL status, HAL_ERROR if the image is incomplete or reads back wrong
+  */
+HAL_StatusTypeDef DSP_SlotWriteEnd(void)
+{
+    DSP_SlotHdrTypeDef hdr;
+    const DSP_SlotHdrTypeDef *cur;
+    uint8_t slot = slot_wr;
+    uint32_t crc;
+    uint8_t i;
+
+    if((slot == DSP_SLOT_NONE) || (slot_wr_offset != slot_wr_length))
+    {
+        return HAL_ERROR;
+    }
+
+    // Partial last double word, padded with 0xFF
+    if((slot_wr_npend != 0U) && (DSP_SlotProgram(slot_wr_pend, slot_wr_npend) != HAL_OK))
+    {
+        slot_wr = DSP_SLOT_NONE;
+        return HAL_ERROR;
+    }
+    slot_wr = DSP_SLOT_NONE;
+
+    crc = DSP_SlotCrc(slot, slot_wr_length);
+
+    hdr.magic = DSP_SLOT_MAGIC;
+    hdr.version = slot_wr_version;
+    hdr.length = slot_wr_length;
+    hdr.crc = crc;
+    hdr.seq = 0;
+    for(i = 0; i < DSP_SLOT_NUM; i++)
+    {
+        cur = (const DSP_SlotHdrTypeDef *)DSP_SLOT_ADDR(i);
+        if(slot_ok[i] && (cur->seq >= hdr.seq))
+        {
+            hdr.seq = cur->seq + 1U;
+        }
+    }
+    hdr.check = DSP_SlotCheck(&hdr);
+
+    if(FLASH_If_Write(DSP_SLOT_ADDR(slot), &hdr, DSP_SLOT_HDR_PROGRAM) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    // The image is read back once more through the header just written
+    slot_ok[slot] = DSP_SlotScan(slot);
+    return slot_ok[slot] ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Give up on the image being written, its slot stays empty.
+  * @retval None
+  */
+void DSP_SlotWriteAbort(void)
+{
+    slot_wr = DSP_SLOT_NONE;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* Whether a slot holds a usable image */
+static uint8_t DSP_SlotScan(uint8_t slot)
+{
+    const DSP_SlotHdrTypeDef *hdr = (const DSP_SlotHdrTypeDef *)DSP_SLOT_ADDR(slot);
+
+    if((hdr->magic != DSP_SLOT_MAGIC) || (hdr->check != DSP_SlotCheck(hdr)) ||
+       (hdr->length == 0U) || (hdr->length > DSP_SLOT_IMAGE_MAX) || (hdr->rejected != UINT64_MAX))
+    {
+        return 0;
+    }
+    return (DSP_SlotCrc(slot, hdr->length) == hdr->crc);
+}
+
+/* Program image bytes at the write position, erasing the pages they reach */
+static HAL_StatusTypeDef DSP_SlotProgram(const uint8_t *data, uint32_t len)
+{
+    uint32_t base = DSP_SLOT_ADDR(slot_wr);
+    uint32_t end = DSP_SLOT_HDR_SIZE + slot_wr_written + len;
+
+    while(slot_wr_erased < end)
+    {
+        if(FLASH_If_Erase(base + slot_wr_erased, FLASH_PAGE_SIZE) != HAL_OK)
+        {
+            return HAL_ERROR;
+        }
+        slot_wr_erased += FLASH_PAGE_SIZE;
+    }
+
+    if(FLASH_If_Write(base + DSP_SLOT_HDR_SIZE + slot_wr_written, data, len) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    slot_wr_written += len;
+    return HAL_OK;
+}
+
+/* CRC-32 of an image in place, its last word is padded with 0xFF in flash */
+static uint32_t DSP_SlotCrc(uint8_t slot, uint32_t length)
+{
+    return spica_crc32(0, (const uint32_t *)(DSP_SLOT_ADDR(slot) + DSP_SLOT_HDR_SIZE), (length + 3U) / 4U);
+}
+
+static uint32_t DSP_SlotCheck(const DSP_SlotHdrTypeDef *hdr)
+{
+    return ~(hdr->magic ^ hdr->version ^ hdr->length ^ hdr->crc ^ hdr->seq);
+}
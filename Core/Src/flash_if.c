@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    flash_if.c
+  * @brief   This file provides the erase and program methods for the data
+  *          pages kept in the internal flash. Data is read back directly
+  *          from the memory mapped flash.
+  *
+  *          The flash stalls instruction fetches while it erases or programs,
+  *          interrupts included, so these are meant for init time or for
+  *          callers that can afford a page erase (about 22 ms).
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_if.h"
+#include <string.h>
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Erase the pages holding a range of the flash.
+  * @param  addr: first byte, page aligned
+  * @param  len: number of bytes, rounded up to whole pages
+  * @retval HAL status
+  */
+HAL_StatusTypeDef FLASH_If_Erase(uint32_t addr, uint32_t len)
+{
+    FLASH_EraseInitTypeDef erase;
+    uint32_t page_error;
+    HAL_StatusTypeDef ret;
+
+    if(((addr - FLASH_BASE) % FLASH_PAGE_SIZE) || (len == 0U) || ((addr + len) > FLASH_IF_END))
+    {
+        return HAL_ERROR;
+    }
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.Page = (addr - FLASH_BASE) / FLASH_PAGE_SIZE;
+    erase.NbPages = (len + FLASH_PAGE_SIZE - 1U) / FLASH_PAGE_SIZE;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    ret = HAL_FLASHEx_Erase(&erase, &page_error);
+    HAL_FLASH_Lock();
+
+    return ret;
+}
+
+/**
+  * @brief  Program erased flash, a double word at a time. A partial last
+  *         double word is padded with 0xFF.
+  * @param  addr: first byte, 8-byte aligned
+  * @param  data: the bytes to program
+  * @param  len: number of bytes
+  * @retval HAL status
+  */
+HAL_StatusTypeDef FLASH_If_Write(uint32_t addr, const void *data, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    HAL_StatusTypeDef ret = HAL_OK;
+    uint64_t dword;
+    uint32_t n;
+
+    if((addr & 7U) || ((addr + len) > FLASH_IF_END))
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    while((len > 0U) && (ret == HAL_OK))
+    {
+        n = (len < 8U) ? len : 8U;
+        dword = UINT64_MAX;
+        memcpy(&dword, src, n);
+
+        ret = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr, dword);
+
+        addr += 8U;
+        src += n;
+        len -= n;
+    }
+    HAL_FLASH_Lock();
+
+    return ret;
+}
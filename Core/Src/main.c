@@ -27,6 +27,9 @@
 /* USER CODE BEGIN Includes */
 #include <string.h>
 #include <stdio.h>
+#include "cmis.h"
+#include "cmis_dp.h"
+#include "cmis_i2c.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,6 +39,14 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+/* Staged boot: the host slave and the DSP bus come up first, USART2 and
+   I2C2 once the lanes carry traffic or after BOOT_DEFER_MS */
+#define BOOT_DEFER_MS           10000U
+
+/* Set to 1 on the bench to run the I2C/UART self tests before the host
+   interface comes up. They block for seconds and stop in Error_Handler()
+   on a NACK, never enable them on a module */
+#define BOOT_SELF_TEST          0
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -46,7 +57,8 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-
+static uint8_t boot_deferred_done = 0;
+static uint32_t boot_host_ms;           /* I2C1 listening */
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -54,6 +66,8 @@ void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
 void I2C_Master_Test(void);
 void UART_Test(void);
+static void Boot_Deferred(void);
+static void Boot_Report(uint8_t traffic);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -89,22 +103,33 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
-  MX_USART2_UART_Init();
   MX_I2C1_Init();
-  MX_I2C2_Init();
   MX_I2C3_Init();
   /* USER CODE BEGIN 2 */
+  /* Host interface first, the DSP bring-up runs from the main loop.
+     MX_USART2_UART_Init() and MX_I2C2_Init() are not called here (function
+     call not generated in the .ioc), see Boot_Deferred() */
+#if BOOT_SELF_TEST
+  MX_USART2_UART_Init();
   I2C_Master_Test();
+  UART_Test();
+#endif
+  CMIS_Init();
+  boot_host_ms = HAL_GetTick();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    UART_Test();
+    CMIS_Process();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    if(!boot_deferred_done)
+    {
+      Boot_Deferred();
+    }
   }
   /* USER CODE END 3 */
 }
@@ -157,6 +182,53 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/* Bring up what the traffic does not need, once it is up */
+static void Boot_Deferred(void)
+{
+    uint8_t traffic = DP_IsTrafficUp();
+
+    if(!traffic && ((HAL_GetTick() - boot_host_ms) < BOOT_DEFER_MS))
+    {
+        return;
+    }
+    boot_deferred_done = 1;
+
+    if(huart2.gState == HAL_UART_STATE_RESET)
+    {
+        MX_USART2_UART_Init();
+    }
+    MX_I2C2_Init();
+    Boot_Report(traffic);
+}
+
+/* Boot time metrics on USART2, in ms since reset */
+static void Boot_Report(uint8_t traffic)
+{
+    char line[96];
+    uint32_t now = HAL_GetTick();
+    uint32_t ack;
+    int len;
+
+    len = snprintf(line, sizeof(line), "Boot: host up %lu ms, first ACK ", (unsigned long)boot_host_ms);
+    if(CMIS_I2C_GetFirstAck(&ack))
+    {
+        len += snprintf(&line[len], sizeof(line) - len, "%lu ms", (unsigned long)ack);
+    }
+    else
+    {
+        len += snprintf(&line[len], sizeof(line) - len, "none");
+    }
+    if(traffic)
+    {
+        snprintf(&line[len], sizeof(line) - len, ", traffic %lu ms\r\n", (unsigned long)now);
+    }
+    else
+    {
+        snprintf(&line[len], sizeof(line) - len, ", no traffic\r\n");
+    }
+    HAL_UART_Transmit(&huart2, (uint8_t *)line, strlen(line), HAL_MAX_DELAY);
+}
+
 void I2C_Master_Test(void)
 {
     HAL_StatusTypeDef ret;
@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    hal_host.h
+  * @brief   Host stand-ins for the parts of the STM32L4 HAL and CMSIS used by
+  *          the CMIS slave path (cmis.c, cmis_i2c.c, cmis_txdis.c).
+  *
+  *          The Makefile forces this header in front of every source. It
+  *          claims the include guard of stm32l4xx_hal.h, so main.h and i2c.h
+  *          compile unchanged and only take the names defined here.
+  *
+  *          DWT->CYCCNT counts target core cycles: the simulated time of the
+  *          bus and of the DSP load plus the real time spent on the host,
+  *          see hal_host.c.
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HAL_HOST_H__
+#define __HAL_HOST_H__
+
+/* Taken in place of the HAL, see above */
+#define STM32L4xx_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Target core clock, the rate of DWT->CYCCNT */
+#define HOST_CORE_HZ                80000000U
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL)
+
+#define I2C_DIRECTION_TRANSMIT      (0x00000000U)
+#define I2C_DIRECTION_RECEIVE       (0x00000001U)
+#define I2C_FIRST_FRAME             (0x00000001U)
+#define I2C_NEXT_FRAME              (0x00000002U)
+#define HAL_I2C_ERROR_AF            (0x00000004U)
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+    uint32_t id;
+} I2C_TypeDef;
+
+typedef struct
+{
+    I2C_TypeDef *Instance;
+    uint32_t ErrorCode;
+    uint8_t *pBuffPtr;              /* byte armed by the last Seq_*_IT call */
+    uint32_t XferOptions;
+} I2C_HandleTypeDef;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/* Exported variables --------------------------------------------------------*/
+extern I2C_TypeDef HOST_I2C1;
+extern CoreDebug_Type HOST_CoreDebug;
+extern uint32_t SystemCoreClock;
+
+#define I2C1                        (&HOST_I2C1)
+#define CoreDebug                   (&HOST_CoreDebug)
+#define DWT                         HOST_Dwt()      /* CYCCNT is refreshed on every access */
+
+/* Exported functions prototypes ---------------------------------------------*/
+DWT_Type *HOST_Dwt(void);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t HAL_GetTick(void);
+HAL_StatusTypeDef HAL_I2C_EnableListen_IT(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Slave_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size,
+                                                uint32_t XferOptions);
+HAL_StatusTypeDef HAL_I2C_Slave_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size,
+                                               uint32_t XferOptions);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+
+/* Slave callbacks, provided by cmis_i2c.c */
+void HAL_I2C_AddrCallback(I2C_HandleTypeDef *hi2c, uint8_t TransferDirection, uint16_t AddrMatchCode);
+void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ListenCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HAL_HOST_H__ */
@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    host.h
+  * @brief   This file contains the definitions and function prototypes of the
+  *          host harness: simulated time (hal_host.c), simulated DSP load and
+  *          register bus, and the modules behind the memory map (dsp_host.c).
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal_host.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define HOST_CYCLES_PER_US          (HOST_CORE_HZ / 1000000U)
+
+/* Exported types ------------------------------------------------------------*/
+/* Background load of the main loop, in us of target time */
+typedef struct
+{
+    uint32_t dsp_xfer_us;           /* one DSP bus transfer, squelch writes are deferred meanwhile */
+    uint32_t dsp_gap_us;            /* main loop time between two transfers */
+    uint32_t masked_us;             /* interrupts masked after each transfer */
+} HOST_LoadTypeDef;
+
+/* What the memory map handed to the modules behind it */
+typedef struct
+{
+    uint32_t cdb_calls;             /* CDB_OnHostWrite() */
+    uint8_t cdb_first;
+    uint8_t cdb_len;
+    uint32_t txdis_deferred;        /* DSP_BusRequestRelease() */
+    uint32_t dsp_reads;             /* on the simulated DSP register bus */
+    uint32_t dsp_writes;
+} HOST_HooksTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void HOST_Advance(uint32_t cycles);
+uint64_t HOST_Now(void);
+void HOST_SetCpuScale(uint32_t scale);
+
+void HOST_DspInit(uint32_t bus_khz);
+void HOST_SetLoad(const HOST_LoadTypeDef *load);
+void HOST_Wire(uint32_t cycles);
+uint32_t HOST_IrqEntry(void);
+uint8_t HOST_DspBusBusy(void);
+void HOST_DspBusFail(uint32_t count);
+uint8_t HOST_DspSquelched(void);
+void HOST_GetHooks(HOST_HooksTypeDef *hooks);
+void HOST_ClearHooks(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_H__ */
@@ -0,0 +1,541 @@
+/**
+  ******************************************************************************
+  * @file    cmis_host.c
+  * @brief   Host harness of the CMIS slave path: scripted host transactions
+  *          are replayed through the I2C1 slave callbacks of cmis_i2c.c,
+  *          which drive the memory map of cmis.c, the same code the
+  *          interrupt runs on the module.
+  *
+  *          The harness plays the bus and the HAL driver: each byte takes
+  *          its time on the wire at the bus clock, then the callback the
+  *          driver would raise for it runs. A read ends with the host NACK
+  *          reported as an AF error, a write with the STOP.
+  *
+  *          It first checks the memory map behaviour (byte reads, sequential
+  *          reads across the lower/upper and the upper wrap boundaries,
+  *          page selects, CDB and TxDisable writes), then replays the same
+  *          mix idle and under the simulated DSP load of dsp_host.c and
+  *          reports the callback time per byte, the transaction latency
+  *          the host sees and the worst time from a TxDisable write to its
+  *          last squelch write, as measured by cmis_txdis.c.
+  *
+  *          Usage: cmis_host [-n iterations] [-k bus_khz] [-s cpu_scale]
+  *                           [-x dsp_xfer_us] [-g dsp_gap_us]
+  *                           [-m masked_us] [-d dsp_bus_khz]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "cmis_i2c.h"
+#include "cmis_cdb.h"
+#include "cmis_txdis.h"
+#include "i2c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    HOST_OP_BYTE_READ = 0,
+    HOST_OP_SEQ_READ,
+    HOST_OP_PAGE_SELECT,
+    HOST_OP_CDB_WRITE,
+    HOST_OP_TXDIS_WRITE,
+    HOST_OP_NUM
+} HOST_OpTypeDef;
+
+/* Host view of the transactions of one kind, in core cycles */
+typedef struct
+{
+    uint32_t count;
+    uint32_t bytes;                 /* on the wire, address bytes included */
+    uint64_t cycles;                /* START to STOP */
+    uint64_t max_cycles;
+    uint64_t stretch;               /* over the time of the bytes on the wire */
+    uint64_t max_stretch;
+} HOST_OpStatsTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define HOST_SLAVE_ADDR             0xA0U
+#define HOST_BITS_PER_BYTE          9U      /* 8 data bits and the ACK */
+
+#define HOST_CHECK(cond, msg)       HOST_Check((cond), (msg), __LINE__)
+
+/* Private variables ---------------------------------------------------------*/
+static const char *const host_op_names[HOST_OP_NUM] =
+{
+    "byte read",
+    "seq read 8",
+    "page select",
+    "CDB write",
+    "TxDisable write"
+};
+
+static uint32_t host_bus_khz = 400U;
+static uint32_t host_byte_cycles;
+static HOST_OpTypeDef host_op;
+static HOST_OpStatsTypeDef host_ops[HOST_OP_NUM];
+static uint8_t host_in_xfer = 0;
+static uint64_t host_xfer_start;
+static uint32_t host_xfer_bytes;
+static uint32_t host_failures = 0;
+static uint32_t host_txdis_max_us;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Bus_Byte(void);
+static void Bus_Start(uint8_t read);
+static void Bus_Write(uint8_t byte);
+static uint8_t Bus_Read(void);
+static void Bus_Stop(void);
+static void Bus_Nack(void);
+static void Bus_XferDone(void);
+static void Host_Read(uint8_t addr, uint8_t *data, uint8_t len);
+static void Host_ReadCurrent(uint8_t *data, uint8_t len);
+static void Host_Write(uint8_t addr, const uint8_t *data, uint8_t len);
+static void Host_SelectPage(uint8_t page);
+static void Host_CdbCommand(uint16_t cmd, const uint8_t *lpl, uint8_t lpl_len);
+static void HOST_Check(int cond, const char *msg, int line);
+static void HOST_CheckMap(void);
+static void HOST_RunMix(uint32_t iterations);
+static void HOST_Report(const char *name);
+static uint32_t HOST_CyclesToNs(uint64_t cycles);
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    HOST_LoadTypeDef idle;
+    HOST_LoadTypeDef dsp;
+    uint32_t iterations = 1000U;
+    uint32_t dsp_bus_khz = 400U;
+    int opt;
+
+    memset(&idle, 0, sizeof(idle));
+    dsp.dsp_xfer_us = 200U;
+    dsp.dsp_gap_us = 50U;
+    dsp.masked_us = 20U;
+
+    while((opt = getopt(argc, argv, "n:k:s:x:g:m:d:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'k': host_bus_khz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': HOST_SetCpuScale((uint32_t)strtoul(optarg, NULL, 0)); break;
+            case 'x': dsp.dsp_xfer_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'g': dsp.dsp_gap_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'm': dsp.masked_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'd': dsp_bus_khz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-k bus_khz] [-s cpu_scale] "
+                        "[-x dsp_xfer_us] [-g dsp_gap_us] [-m masked_us] [-d dsp_bus_khz]\n", argv[0]);
+                return 2;
+        }
+    }
+    if(host_bus_khz == 0U)
+    {
+        host_bus_khz = 400U;
+    }
+    if(dsp_bus_khz == 0U)
+    {
+        dsp_bus_khz = 400U;
+    }
+    host_byte_cycles = (HOST_BITS_PER_BYTE * HOST_CORE_HZ) / (host_bus_khz * 1000U);
+
+    HOST_DspInit(dsp_bus_khz);
+    CMIS_Init();
+
+    HOST_SetLoad(&idle);
+    HOST_CheckMap();
+    if(host_failures != 0U)
+    {
+        printf("%lu check(s) failed\n", (unsigned long)host_failures);
+        return 1;
+    }
+    printf("memory map checks passed\n\n");
+
+    printf("%lu iterations, %lu kHz bus, idle\n", (unsigned long)iterations, (unsigned long)host_bus_khz);
+    HOST_RunMix(iterations);
+    HOST_Report("idle");
+
+    printf("\n%lu iterations, %lu kHz bus, DSP load: %lu us transfers, %lu us gaps, "
+           "%lu us masked, %lu kHz DSP bus\n",
+           (unsigned long)iterations, (unsigned long)host_bus_khz, (unsigned long)dsp.dsp_xfer_us,
+           (unsigned long)dsp.dsp_gap_us, (unsigned long)dsp.masked_us, (unsigned long)dsp_bus_khz);
+    HOST_SetLoad(&dsp);
+    HOST_RunMix(iterations);
+    HOST_Report("dsp load");
+
+    return (host_failures == 0U) ? 0 : 1;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/* One byte on the wire */
+static void Bus_Byte(void)
+{
+    HOST_Wire(host_byte_cycles);
+    host_xfer_bytes++;
+}
+
+/* START or repeated START and the address byte */
+static void Bus_Start(uint8_t read)
+{
+    if(!host_in_xfer)
+    {
+        host_in_xfer = 1;
+        host_xfer_start = HOST_Now();
+        host_xfer_bytes = 0;
+    }
+    Bus_Byte();
+    HOST_IrqEntry();
+    HAL_I2C_AddrCallback(&hi2c1, read ? I2C_DIRECTION_RECEIVE : I2C_DIRECTION_TRANSMIT, HOST_SLAVE_ADDR);
+}
+
+static void Bus_Write(uint8_t byte)
+{
+    Bus_Byte();
+    *hi2c1.pBuffPtr = byte;
+    HOST_IrqEntry();
+    HAL_I2C_SlaveRxCpltCallback(&hi2c1);
+}
+
+/* The driver already holds the byte, sending it raises the next one */
+static uint8_t Bus_Read(void)
+{
+    uint8_t byte = *hi2c1.pBuffPtr;
+
+    Bus_Byte();
+    HOST_IrqEntry();
+    HAL_I2C_SlaveTxCpltCallback(&hi2c1);
+    return byte;
+}
+
+static void Bus_Stop(void)
+{
+    HOST_IrqEntry();
+    HAL_I2C_ListenCpltCallback(&hi2c1);
+    Bus_XferDone();
+}
+
+/* The host NACKs the last byte read, reported by the driver as AF */
+static void Bus_Nack(void)
+{
+    hi2c1.ErrorCode = HAL_I2C_ERROR_AF;
+    HOST_IrqEntry();
+    HAL_I2C_ErrorCallback(&hi2c1);
+    Bus_XferDone();
+}
+
+static void Bus_XferDone(void)
+{
+    HOST_OpStatsTypeDef *op = &host_ops[host_op];
+    uint64_t cycles = HOST_Now() - host_xfer_start;
+    uint64_t wire = (uint64_t)host_xfer_bytes * host_byte_cycles;
+    uint64_t stretch = (cycles > wire) ? (cycles - wire) : 0U;
+
+    /* A TxDisable change lands at most once per transaction */
+    if(TXDIS_GetLastLatencyUs() > host_txdis_max_us)
+    {
+        host_txdis_max_us = TXDIS_GetLastLatencyUs();
+    }
+
+    host_in_xfer = 0;
+    op->count++;
+    op->bytes += host_xfer_bytes;
+    op->cycles += cycles;
+    op->stretch += stretch;
+    if(cycles > op->max_cycles)
+    {
+        op->max_cycles = cycles;
+    }
+    if(stretch > op->max_stretch)
+    {
+        op->max_stretch = stretch;
+    }
+}
+
+/* Random read: address write, repeated START, read */
+static void Host_Read(uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    Bus_Start(0);
+    Bus_Write(addr);
+    Bus_Start(1);
+    for(i = 0; i < len; i++)
+    {
+        data[i] = Bus_Read();
+    }
+    Bus_Nack();
+}
+
+static void Host_ReadCurrent(uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    Bus_Start(1);
+    for(i = 0; i < len; i++)
+    {
+        data[i] = Bus_Read();
+    }
+    Bus_Nack();
+}
+
+static void Host_Write(uint8_t addr, const uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+
+    Bus_Start(0);
+    Bus_Write(addr);
+    for(i = 0; i < len; i++)
+    {
+        Bus_Write(data[i]);
+    }
+    Bus_Stop();
+}
+
+static void Host_SelectPage(uint8_t page)
+{
+    Host_Write(CMIS_LP_PAGE_SELECT, &page, 1);
+}
+
+/* Header and LPL on page 9Fh, then the CMDID that triggers the command */
+static void Host_CdbCommand(uint16_t cmd, const uint8_t *lpl, uint8_t lpl_len)
+{
+    uint8_t hdr[CDB_IDX_LPL - 2U + CDB_LPL_MAX];
+    uint8_t cmd_id[2];
+    uint8_t chk;
+    uint8_t i;
+
+    memset(hdr, 0, sizeof(hdr));
+    hdr[CDB_IDX_LPL_LEN - 2U] = lpl_len;
+    memcpy(&hdr[CDB_IDX_LPL - 2U], lpl, lpl_len);
+    cmd_id[0] = (uint8_t)(cmd >> 8);
+    cmd_id[1] = (uint8_t)cmd;
+
+    chk = cmd_id[0] + cmd_id[1] + lpl_len;
+    for(i = 0; i < lpl_len; i++)
+    {
+        chk += lpl[i];
+    }
+    hdr[CDB_IDX_CHK_CODE - 2U] = (uint8_t)~chk;
+
+    Host_SelectPage(CMIS_PAGE_9F);
+    Host_Write(CMIS_UPPER_OFFSET + 2U, hdr, (uint8_t)(CDB_IDX_LPL - 2U + lpl_len));
+    Host_Write(CMIS_UPPER_OFFSET + CDB_IDX_CMD, cmd_id, sizeof(cmd_id));
+}
+
+static void HOST_Check(int cond, const char *msg, int line)
+{
+    if(!cond)
+    {
+        printf("FAIL line %d: %s\n", line, msg);
+        host_failures++;
+    }
+}
+
+/* Memory map behaviour, run idle */
+static void HOST_CheckMap(void)
+{
+    uint8_t *lower = CMIS_LowerPage();
+    uint8_t *page00 = CMIS_Page(0, CMIS_PAGE_00);
+    uint8_t *page10 = CMIS_Page(0, CMIS_PAGE_10);
+    uint8_t *page9f = CMIS_Page(0, CMIS_PAGE_9F);
+    HOST_HooksTypeDef hooks;
+    uint8_t lpl[4] = { 0x01, 0x02, 0x03, 0x04 };
+    uint8_t buf[8];
+    uint8_t value;
+    uint8_t i;
+
+    /* Byte reads */
+    Host_Read(0x00, buf, 1);
+    HOST_CHECK(buf[0] == 0x18U, "identifier byte 00h");
+    Host_Read(CMIS_LP_REVISION, buf, 1);
+    HOST_CHECK(buf[0] == CMIS_REVISION, "revision byte 01h");
+
+    /* Sequential reads across the lower/upper boundary and the upper wrap */
+    for(i = 0; i < 4U; i++)
+    {
+        lower[0x7A + i] = (uint8_t)(0x40U + i);
+    }
+    for(i = 0; i < CMIS_PAGE_SIZE; i++)
+    {
+        page00[i] = (uint8_t)(0x80U + i);
+    }
+    Host_Read(0x7A, buf, 8);
+    HOST_CHECK((buf[0] == 0x40U) && (buf[3] == 0x43U), "sequential read, lower page part");
+    HOST_CHECK((buf[4] == 0x00U) && (buf[5] == 0x00U), "sequential read, page select bytes");
+    HOST_CHECK((buf[6] == 0x80U) && (buf[7] == 0x81U), "sequential read, upper page part");
+    Host_Read(0xFC, buf, 8);
+    HOST_CHECK((buf[0] == 0xFCU) && (buf[3] == 0xFFU), "sequential read, end of the upper page");
+    HOST_CHECK((buf[4] == 0x80U) && (buf[7] == 0x83U), "sequential read wraps to 80h");
+    Host_ReadCurrent(buf, 1);
+    HOST_CHECK(buf[0] == 0x84U, "current address read after a NACK");
+
+    /* Latched flags clear on read, only once sent: the byte prefetched
+       behind the last one read keeps its flags */
+    CMIS_SetModuleFlag(CMIS_LP_FLAGS_MODULE, CMIS_FLAG_CDB_CMD_COMPLETE1);
+    CMIS_SetModuleFlag(CMIS_LP_FLAGS_TEMP_VCC, CMIS_FLAG_HIGH_ALARM);
+    Host_Read(CMIS_LP_FLAGS_MODULE, buf, 1);
+    HOST_CHECK(buf[0] == CMIS_FLAG_CDB_CMD_COMPLETE1, "module flag latched");
+    Host_Read(CMIS_LP_FLAGS_MODULE, buf, 1);
+    HOST_CHECK(buf[0] == 0x00U, "module flag cleared on read");
+    Host_Read(CMIS_LP_FLAGS_TEMP_VCC, buf, 1);
+    HOST_CHECK(buf[0] == CMIS_FLAG_HIGH_ALARM, "flag byte 09h survives a 1 byte read of 08h");
+    Host_Read(CMIS_LP_FLAGS_TEMP_VCC, buf, 1);
+    HOST_CHECK(buf[0] == 0x00U, "flag byte 09h cleared once read");
+    CMIS_SetLaneFlag(CMIS_P11_RX_LOL, 0x01U);
+    Host_SelectPage(CMIS_PAGE_11);
+    Host_Read(CMIS_P11_RX_LOL - 1U, buf, 1);
+    Host_Read(CMIS_P11_RX_LOL, buf, 1);
+    HOST_CHECK(buf[0] == 0x01U, "lane flag survives a 1 byte read of the byte before");
+    Host_SelectPage(CMIS_PAGE_00);
+
+    /* Page selects */
+    page10[0x90 - CMIS_UPPER_OFFSET] = 0x5AU;
+    Host_SelectPage(CMIS_PAGE_10);
+    Host_Read(CMIS_LP_PAGE_SELECT, buf, 1);
+    HOST_CHECK(buf[0] == CMIS_PAGE_10, "page select reads back");
+    Host_Read(0x90, buf, 1);
+    HOST_CHECK(buf[0] == 0x5AU, "upper page follows the page select");
+    Host_SelectPage(0x55U);
+    Host_Read(0x90, buf, 1);
+    HOST_CHECK(buf[0] == 0x00U, "page not implemented reads 00h");
+    Host_SelectPage(CMIS_PAGE_00);
+    value = 0xEEU;
+    Host_Write(0x90, &value, 1);
+    HOST_CHECK(page00[0x90 - CMIS_UPPER_OFFSET] == 0x90U, "page 00h is read only");
+
+    /* CDB write: only the CMDID write triggers the command */
+    HOST_ClearHooks();
+    Host_CdbCommand(CDB_CMD_FW_MGMT_FEATURES, lpl, sizeof(lpl));
+    HOST_GetHooks(&hooks);
+    HOST_CHECK((hooks.cdb_first == CMIS_UPPER_OFFSET + CDB_IDX_CMD) && (hooks.cdb_len == 2U),
+               "CDB hook sees the CMDID write last");
+    HOST_CHECK(page9f[CDB_IDX_CMD + 1U] == (uint8_t)CDB_CMD_FW_MGMT_FEATURES, "CMDID on page 9Fh");
+    HOST_CHECK(page9f[CDB_IDX_LPL_LEN] == sizeof(lpl), "LPL length on page 9Fh");
+    HOST_CHECK(memcmp(&page9f[CDB_IDX_LPL], lpl, sizeof(lpl)) == 0, "LPL on page 9Fh");
+    Host_SelectPage(CMIS_PAGE_00);
+
+    /* TxDisable write squelches from the interrupt, only the lanes that
+       change, all of them in a single broadcast */
+    HOST_ClearHooks();
+    Host_SelectPage(CMIS_PAGE_10);
+    value = 0x03U;
+    Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+    HOST_GetHooks(&hooks);
+    HOST_CHECK(HOST_DspSquelched() == 0x03U, "TxDisable squelches from the interrupt");
+    HOST_CHECK(hooks.dsp_writes == 2U, "one squelch write per lane that changes");
+    value = 0x02U;
+    Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+    HOST_GetHooks(&hooks);
+    HOST_CHECK((HOST_DspSquelched() == 0x02U) && (hooks.dsp_writes == 3U), "lanes left alone are not written");
+    value = 0x0FU;
+    Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+    HOST_GetHooks(&hooks);
+    HOST_CHECK((HOST_DspSquelched() == 0x0FU) && (hooks.dsp_writes == 4U), "all lanes in one broadcast");
+
+    /* A squelch write that fails is made again once the DSP bus is released */
+    HOST_DspBusFail(1);
+    value = 0x05U;
+    Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+    HOST_CHECK(HOST_DspSquelched() == 0x07U, "failed squelch write leaves its lane");
+    Host_Read(CMIS_P10_TX_DISABLE, buf, 1);
+    HOST_GetHooks(&hooks);
+    HOST_CHECK((HOST_DspSquelched() == 0x05U) && (hooks.txdis_deferred == 1U),
+               "failed squelch write retried after the DSP transfer");
+    value = 0x00U;
+    Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+    HOST_CHECK(HOST_DspSquelched() == 0x00U, "TxDisable cleared");
+    Host_SelectPage(CMIS_PAGE_00);
+}
+
+/* The same transaction mix for every load, a main loop pass in between */
+static void HOST_RunMix(uint32_t iterations)
+{
+    uint8_t lpl[8] = { 0 };
+    uint8_t buf[8];
+    uint8_t value;
+    uint32_t n;
+
+    memset(host_ops, 0, sizeof(host_ops));
+    HOST_ClearHooks();
+    CMIS_I2C_ClearStats();
+    host_txdis_max_us = 0;
+
+    for(n = 0; n < iterations; n++)
+    {
+        host_op = HOST_OP_BYTE_READ;
+        Host_Read(CMIS_LP_MODULE_STATE, buf, 1);
+        CMIS_Process();
+
+        host_op = HOST_OP_SEQ_READ;
+        Host_Read(0x7C, buf, 8);
+        Host_Read(0xFC, buf, 8);
+        CMIS_Process();
+
+        host_op = HOST_OP_PAGE_SELECT;
+        Host_SelectPage(CMIS_PAGE_11);
+        host_op = HOST_OP_SEQ_READ;
+        Host_Read(CMIS_P11_LANE_FLAGS, buf, 8);
+        host_op = HOST_OP_PAGE_SELECT;
+        Host_SelectPage(CMIS_PAGE_00);
+        CMIS_Process();
+
+        host_op = HOST_OP_CDB_WRITE;
+        Host_CdbCommand(CDB_CMD_FW_MGMT_FEATURES, lpl, sizeof(lpl));
+        host_op = HOST_OP_PAGE_SELECT;
+        Host_SelectPage(CMIS_PAGE_10);
+        host_op = HOST_OP_TXDIS_WRITE;
+        value = (uint8_t)((n & 1U) ? 0x00U : (1U << (n % 4U)));
+        Host_Write(CMIS_P10_TX_DISABLE, &value, 1);
+        host_op = HOST_OP_PAGE_SELECT;
+        Host_SelectPage(CMIS_PAGE_00);
+        CMIS_Process();
+    }
+}
+
+static void HOST_Report(const char *name)
+{
+    CMIS_I2C_StatsTypeDef stats;
+    HOST_HooksTypeDef hooks;
+    uint32_t bytes = 0;
+    uint8_t i;
+
+    CMIS_I2C_GetStats(&stats);
+    HOST_GetHooks(&hooks);
+
+    printf("  %-16s %8s %12s %12s %12s %12s\n", "transaction", "count", "avg us", "max us",
+           "stretch us", "max stretch");
+    for(i = 0; i < HOST_OP_NUM; i++)
+    {
+        HOST_OpStatsTypeDef *op = &host_ops[i];
+
+        if(op->count == 0U)
+        {
+            continue;
+        }
+        bytes += op->bytes;
+        printf("  %-16s %8lu %12.1f %12.1f %12.1f %12.1f\n", host_op_names[i], (unsigned long)op->count,
+               HOST_CyclesToNs(op->cycles / op->count) / 1000.0, HOST_CyclesToNs(op->max_cycles) / 1000.0,
+               HOST_CyclesToNs(op->stretch / op->count) / 1000.0, HOST_CyclesToNs(op->max_stretch) / 1000.0);
+    }
+
+    printf("  %s: %lu callbacks, %lu ns avg, %lu ns max, %lu ns per byte on the wire\n", name,
+           (unsigned long)stats.isr_count,
+           (unsigned long)HOST_CyclesToNs(stats.isr_count ? stats.isr_cycles / stats.isr_count : 0U),
+           (unsigned long)HOST_CyclesToNs(stats.isr_max_cycles),
+           (unsigned long)HOST_CyclesToNs(bytes ? stats.isr_cycles / bytes : 0U));
+    printf("  %s: slave side %lu transactions, %lu us max START to STOP, %lu TxDisable writes deferred\n",
+           name, (unsigned long)stats.xfer_count, (unsigned long)(HOST_CyclesToNs(stats.xfer_max_cycles) / 1000U),
+           (unsigned long)hooks.txdis_deferred);
+    printf("  %s: %lu squelch writes, %lu us worst from a TxDisable write to its last squelch write\n", name,
+           (unsigned long)hooks.dsp_writes, (unsigned long)host_txdis_max_us);
+}
+
+static uint32_t HOST_CyclesToNs(uint64_t cycles)
+{
+    return (uint32_t)((cycles * 1000U) / HOST_CYCLES_PER_US);
+}
@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    dsp_host.c
+  * @brief   This file provides the simulated DSP load and register bus of the
+  *          harness and the modules behind the memory map, reduced to what
+  *          the slave path sees of them.
+  *
+  *          The main loop is modelled as back to back DSP bus transfers,
+  *          each followed by a section with the interrupts masked and by a
+  *          gap. A slave callback that falls in a masked section only runs
+  *          once it ends, the host sees it as clock stretching.
+  *
+  *          TxDisable writes go through the real cmis_txdis.c and the
+  *          squelch methods of the Inphi API, down to spica_reg_get() and
+  *          spica_reg_set() here: each access takes the time of its bytes on
+  *          the DSP bus and lands in a small register store. DSP_BusIsBusy()
+  *          follows the transfers of the load, and DSP_BusReleaseCallback()
+  *          runs at the end of the transfer that was in progress when it
+  *          was asked for, in the main context, while the slave bus carries
+  *          on.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "dsp.h"
+#include "cmis_cdb.h"
+#include "cmis_ddm.h"
+#include "cmis_dp.h"
+#include "cmis_vdm.h"
+#include "cmis_txdis.h"
+#include "dsp_ident.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t die;
+    uint32_t addr;
+    uint16_t value;
+} HOST_RegTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define HOST_DSP_REGS               64U     /* registers the harness touches */
+#define HOST_BITS_PER_BYTE          9U      /* 8 data bits and the ACK */
+
+/* Device address, register address and data, the read restarts for the data */
+#define HOST_DSP_WRITE_BYTES        (1U + DSP_I2C_ADDR_BYTES + DSP_I2C_DATA_BYTES)
+#define HOST_DSP_READ_BYTES         (1U + DSP_I2C_ADDR_BYTES + 1U + DSP_I2C_DATA_BYTES)
+
+/* Private variables ---------------------------------------------------------*/
+static HOST_LoadTypeDef host_load;
+static HOST_HooksTypeDef host_hooks;
+static HOST_RegTypeDef host_regs[HOST_DSP_REGS];
+static uint32_t host_num_regs = 0;
+static uint32_t host_dsp_byte_cycles;
+static uint32_t host_dsp_fail = 0;
+static uint8_t host_release_req = 0;
+static por_tx_squelch_map_t host_squelch;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t HOST_LoadPhase(uint32_t *period);
+static HOST_RegTypeDef *HOST_Reg(uint32_t die, uint32_t addr);
+static inphi_status_t HOST_DspAccess(uint32_t bytes);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Set the DSP bus clock and resolve the squelch registers, call
+  *         before CMIS_Init().
+  * @param  bus_khz: DSP bus clock
+  * @retval None
+  */
+void HOST_DspInit(uint32_t bus_khz)
+{
+    host_dsp_byte_cycles = (HOST_BITS_PER_BYTE * HOST_CORE_HZ) / (bus_khz * 1000U);
+    if(por_tx_squelch_map_init(&host_squelch, DSP_DIE, POR_INTF_LTX) != INPHI_OK)
+    {
+        fprintf(stderr, "no LTX squelch registers\n");
+        exit(2);
+    }
+}
+
+/**
+  * @brief  Set the background load of the main loop, all zero for none.
+  * @param  load: the load
+  * @retval None
+  */
+void HOST_SetLoad(const HOST_LoadTypeDef *load)
+{
+    host_load = *load;
+}
+
+/**
+  * @brief  Move the time on by bytes on the slave bus, the main loop runs
+  *         meanwhile: a DSP bus release asked for is served when the
+  *         transfer in progress ends.
+  * @param  cycles: time on the wire
+  * @retval None
+  */
+void HOST_Wire(uint32_t cycles)
+{
+    uint32_t period;
+    uint32_t phase;
+    uint32_t xfer = host_load.dsp_xfer_us * HOST_CYCLES_PER_US;
+    uint32_t wait = 0;
+    uint64_t start;
+    uint64_t spent;
+
+    if(!host_release_req)
+    {
+        HOST_Advance(cycles);
+        return;
+    }
+
+    phase = HOST_LoadPhase(&period);
+    if((period != 0U) && (phase < xfer))
+    {
+        wait = xfer - phase;
+    }
+    if(wait > cycles)
+    {
+        HOST_Advance(cycles);
+        return;
+    }
+
+    HOST_Advance(wait);
+    host_release_req = 0;
+    start = HOST_Now();
+    DSP_BusReleaseCallback();
+    spent = HOST_Now() - start;
+    if(spent < (uint64_t)(cycles - wait))
+    {
+        HOST_Advance((uint32_t)(cycles - wait - spent));
+    }
+}
+
+/**
+  * @brief  Wait for the interrupts to be unmasked, call before a callback.
+  * @retval cycles the interrupt entry was delayed by
+  */
+uint32_t HOST_IrqEntry(void)
+{
+    uint32_t period;
+    uint32_t phase = HOST_LoadPhase(&period);
+    uint32_t xfer = host_load.dsp_xfer_us * HOST_CYCLES_PER_US;
+    uint32_t masked_end = xfer + host_load.masked_us * HOST_CYCLES_PER_US;
+    uint32_t delay;
+
+    if((period == 0U) || (phase < xfer) || (phase >= masked_end))
+    {
+        return 0;
+    }
+    delay = masked_end - phase;
+    HOST_Advance(delay);
+    return delay;
+}
+
+/**
+  * @brief  Whether the main loop is in the middle of a DSP bus transfer.
+  * @retval 1 if busy, 0 otherwise
+  */
+uint8_t HOST_DspBusBusy(void)
+{
+    uint32_t period;
+    uint32_t phase = HOST_LoadPhase(&period);
+
+    return (period != 0U) && (phase < host_load.dsp_xfer_us * HOST_CYCLES_PER_US);
+}
+
+/**
+  * @brief  Fail the next register accesses on the DSP bus.
+  * @param  count: number of accesses to fail
+  * @retval None
+  */
+void HOST_DspBusFail(uint32_t count)
+{
+    host_dsp_fail = count;
+}
+
+/**
+  * @brief  Squelch state of the LTX lanes in the register store.
+  * @retval lane bitmap, bit n-1 for lane n
+  */
+uint8_t HOST_DspSquelched(void)
+{
+    uint8_t squelched = 0;
+    uint32_t lane;
+
+    for(lane = 0; lane < host_squelch.num_lanes; lane++)
+    {
+        if(HOST_Reg(host_squelch.die[lane], host_squelch.addr[lane])->value & 0x1U)
+        {
+            squelched |= (uint8_t)(1U << lane);
+        }
+    }
+    return squelched;
+}
+
+/**
+  * @brief  Copy what the memory map handed to the modules.
+  * @param  hooks: the copy
+  * @retval None
+  */
+void HOST_GetHooks(HOST_HooksTypeDef *hooks)
+{
+    *hooks = host_hooks;
+}
+
+/**
+  * @brief  Forget what the memory map handed to the modules.
+  * @retval None
+  */
+void HOST_ClearHooks(void)
+{
+    memset(&host_hooks, 0, sizeof(host_hooks));
+}
+
+/* DSP bus of dsp.c ----------------------------------------------------------*/
+uint8_t DSP_BusIsBusy(void)
+{
+    return HOST_DspBusBusy();
+}
+
+void DSP_BusRequestRelease(void)
+{
+    host_hooks.txdis_deferred++;
+    host_release_req = 1;
+}
+
+inphi_status_t spica_reg_get(uint32_t die, uint32_t addr, uint32_t *data)
+{
+    host_hooks.dsp_reads++;
+    if(HOST_DspAccess(HOST_DSP_READ_BYTES) != INPHI_OK)
+    {
+        *data = 0;
+        return INPHI_ERROR;
+    }
+    *data = HOST_Reg(die, addr)->value;
+    return INPHI_OK;
+}
+
+inphi_status_t spica_reg_set(uint32_t die, uint32_t addr, uint32_t data)
+{
+    uint32_t lane;
+
+    host_hooks.dsp_writes++;
+    if(HOST_DspAccess(HOST_DSP_WRITE_BYTES) != INPHI_OK)
+    {
+        return INPHI_ERROR;
+    }
+
+    /* The squelch broadcast reaches the register of every lane */
+    if((host_squelch.num_lanes != 0U) && (die == host_squelch.bcast_die) && (addr == host_squelch.bcast_addr))
+    {
+        for(lane = 0; lane < host_squelch.num_lanes; lane++)
+        {
+            HOST_Reg(host_squelch.die[lane], host_squelch.addr[lane])->value = (uint16_t)data;
+        }
+        return INPHI_OK;
+    }
+    HOST_Reg(die, addr)->value = (uint16_t)data;
+    return INPHI_OK;
+}
+
+inphi_status_t spica_reg_set_burst(uint32_t die, uint32_t addr, const uint16_t *data, uint32_t num_data)
+{
+    host_hooks.dsp_writes++;
+    if(HOST_DspAccess(1U + DSP_I2C_ADDR_BYTES + num_data * DSP_I2C_DATA_BYTES) != INPHI_OK)
+    {
+        return INPHI_ERROR;
+    }
+    if(num_data != 0U)
+    {
+        HOST_Reg(die, addr)->value = data[num_data - 1U];
+    }
+    return INPHI_OK;
+}
+
+/* Hooks of the Inphi API the harness does not exercise */
+uint32_t spica_event_wait(uint32_t die, uint32_t events, uint32_t msecs)
+{
+    (void)die;
+    (void)events;
+    HOST_Advance(msecs * 1000U * HOST_CYCLES_PER_US);
+    return msecs * 1000U;
+}
+
+uint32_t spica_timestamp_ms(uint32_t die)
+{
+    (void)die;
+    return HAL_GetTick();
+}
+
+void spica_boot_mark(uint32_t die, uint32_t phase, bool enter)
+{
+    (void)die;
+    (void)phase;
+    (void)enter;
+}
+
+uint32_t spica_crc32(uint32_t crc, const uint32_t *words, uint32_t num_words)
+{
+    uint32_t i;
+    uint8_t bit;
+
+    crc = ~crc;
+    for(i = 0; i < num_words * 4U; i++)
+    {
+        crc ^= ((const uint8_t *)words)[i];
+        for(bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320U : 0U);
+        }
+    }
+    return ~crc;
+}
+
+/* Modules behind the memory map ---------------------------------------------*/
+void DSP_IdentInit(void)
+{
+}
+
+void CDB_Init(void)
+{
+}
+
+void CDB_Process(void)
+{
+}
+
+void CDB_Advertise(uint8_t *page01)
+{
+    page01[163 - CMIS_UPPER_OFFSET] = (1U << 6) | (1U << 5) | 0x05U;
+}
+
+void CDB_OnHostWrite(uint8_t first, uint8_t len)
+{
+    host_hooks.cdb_calls++;
+    host_hooks.cdb_first = first;
+    host_hooks.cdb_len = len;
+}
+
+void DDM_Init(void)
+{
+}
+
+void DDM_Process(void)
+{
+}
+
+/* Every lane DPActivated, TxDisable alone decides the squelch */
+void DP_Init(void)
+{
+    TXDIS_SetLaneEnable(0xFFU);
+}
+
+void DP_Process(void)
+{
+}
+
+void VDM_Init(void)
+{
+}
+
+void VDM_Process(void)
+{
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t HOST_LoadPhase(uint32_t *period)
+{
+    *period = (host_load.dsp_xfer_us + host_load.masked_us + host_load.dsp_gap_us) * HOST_CYCLES_PER_US;
+    if(*period == 0U)
+    {
+        return 0;
+    }
+    return (uint32_t)(HOST_Now() % *period);
+}
+
+/* Register of the store, registers never written read 0 */
+static HOST_RegTypeDef *HOST_Reg(uint32_t die, uint32_t addr)
+{
+    uint32_t i;
+
+    for(i = 0; i < host_num_regs; i++)
+    {
+        if((host_regs[i].die == die) && (host_regs[i].addr == addr))
+        {
+            return &host_regs[i];
+        }
+    }
+    if(host_num_regs == HOST_DSP_REGS)
+    {
+        fprintf(stderr, "register store full\n");
+        exit(2);
+    }
+    host_regs[host_num_regs].die = die;
+    host_regs[host_num_regs].addr = addr;
+    host_regs[host_num_regs].value = 0;
+    return &host_regs[host_num_regs++];
+}
+
+/* One transfer on the DSP bus */
+static inphi_status_t HOST_DspAccess(uint32_t bytes)
+{
+    HOST_Advance(bytes * host_dsp_byte_cycles);
+    if(host_dsp_fail != 0U)
+    {
+        host_dsp_fail--;
+        return INPHI_ERROR;
+    }
+    return INPHI_OK;
+}
@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    hal_host.c
+  * @brief   This file provides the host stand-ins of hal_host.h and the
+  *          simulated time of the harness.
+  *
+  *          Time is counted in target core cycles. It is the sum of the
+  *          simulated time (bus bytes, interrupt entry delayed by the DSP
+  *          load, DSP register accesses) advanced by the harness, and of the real
+  *          time spent running the code on the host, multiplied by the CPU
+  *          scale to account for a target slower than the host.
+  *
+  *          Everything runs in one thread: the harness raises the slave
+  *          callbacks itself, so masking interrupts has nothing to do.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "i2c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Exported variables --------------------------------------------------------*/
+I2C_TypeDef HOST_I2C1;
+CoreDebug_Type HOST_CoreDebug;
+I2C_HandleTypeDef hi2c1 = { .Instance = &HOST_I2C1 };
+uint32_t SystemCoreClock = HOST_CORE_HZ;
+
+/* Private variables ---------------------------------------------------------*/
+static DWT_Type host_dwt;
+static uint64_t host_sim_cycles = 0;
+static uint64_t host_real_start = 0;
+static uint32_t host_cpu_scale = 1U;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t HOST_RealNs(void);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Move the simulated time on.
+  * @param  cycles: target core cycles
+  * @retval None
+  */
+void HOST_Advance(uint32_t cycles)
+{
+    host_sim_cycles += cycles;
+}
+
+/**
+  * @brief  Current time.
+  * @retval target core cycles since the first call
+  */
+uint64_t HOST_Now(void)
+{
+    uint64_t real_ns;
+
+    if(host_real_start == 0U)
+    {
+        host_real_start = HOST_RealNs();
+    }
+    real_ns = HOST_RealNs() - host_real_start;
+    return host_sim_cycles + (real_ns * HOST_CYCLES_PER_US * host_cpu_scale) / 1000U;
+}
+
+/**
+  * @brief  Set how much slower than the host the target runs.
+  * @param  scale: target time per unit of host time, 1 or more
+  * @retval None
+  */
+void HOST_SetCpuScale(uint32_t scale)
+{
+    host_cpu_scale = (scale == 0U) ? 1U : scale;
+}
+
+DWT_Type *HOST_Dwt(void)
+{
+    host_dwt.CYCCNT = (uint32_t)HOST_Now();
+    return &host_dwt;
+}
+
+void __disable_irq(void)
+{
+}
+
+void __enable_irq(void)
+{
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(HOST_Now() / (HOST_CORE_HZ / 1000U));
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler()\n");
+    exit(2);
+}
+
+HAL_StatusTypeDef HAL_I2C_EnableListen_IT(I2C_HandleTypeDef *hi2c)
+{
+    hi2c->ErrorCode = 0;
+    hi2c->pBuffPtr = NULL;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Slave_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size,
+                                                uint32_t XferOptions)
+{
+    (void)Size;
+    hi2c->pBuffPtr = pData;
+    hi2c->XferOptions = XferOptions;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Slave_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size,
+                                               uint32_t XferOptions)
+{
+    (void)Size;
+    hi2c->pBuffPtr = pData;
+    hi2c->XferOptions = XferOptions;
+    return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c)
+{
+    return hi2c->ErrorCode;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint64_t HOST_RealNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
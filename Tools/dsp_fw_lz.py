@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Compress the DSP application firmware for direct download from flash.
+
+Reads the spica_app_fw_image[] initializer of porrima_gen3_app_fw_image.h
+and writes a C source holding the image in the format decoded by
+por_mcu_download_firmware_lz(): an 8 byte header (magic "SPZC", image
+length in 32b words, little endian) followed by LZSS tokens with a 4KB
+window, 3..18 byte matches, 8 tokens per flag byte. Every block of the
+image is followed by the CRC-32 of its data words in the compressed
+stream.
+
+Usage: dsp_fw_lz.py porrima_gen3_app_fw_image.h Core/Src/dsp_fw_image.c
+
+Run as the pre-build step of the CubeIDE project. The output is only
+rewritten when it is older than the input or this script, and a missing
+input is not an error: the FW release is not part of the tree and the
+image is only linked in with DSP_FW_IN_FLASH.
+"""
+
+import os
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = 0x435A5053
+WINDOW = 4096
+MIN_MATCH = 3
+MAX_MATCH = MIN_MATCH + 15
+MAX_CHAIN = 256
+
+
+def read_image(path):
+    text = open(path).read()
+    body = re.search(r"spica_app_fw_image\[\]\s*=\s*\{(.*?)\};", text, re.S)
+    if not body:
+        sys.exit("%s: no spica_app_fw_image[] initializer" % path)
+    body = re.sub(r"//[^\n]*", "", body.group(1))
+    return [int(w, 0) for w in re.findall(r"0x[0-9a-fA-F]+|\d+", body)]
+
+
+def add_block_crcs(words):
+    out = []
+    pos = 0
+    while pos < len(words):
+        if pos + 2 > len(words) or words[pos + 1] == 0 or pos + 2 + words[pos + 1] > len(words):
+            sys.exit("malformed image at word %d" % pos)
+        n = words[pos + 1]
+        data = words[pos + 2:pos + 2 + n]
+        out += words[pos:pos + 2 + n]
+        out.append(zlib.crc32(struct.pack("<%dI" % n, *data)) & 0xFFFFFFFF)
+        pos += 2 + n
+    return out
+
+
+def compress(data):
+    out = bytearray()
+    chains = {}
+    pos = 0
+    while pos < len(data):
+        flag_at = len(out)
+        out.append(0)
+        for bit in range(8):
+            if pos >= len(data):
+                break
+            best_len, best_dist = 0, 0
+            key = bytes(data[pos:pos + MIN_MATCH])
+            cands = chains.get(key, [])
+            for cand in reversed(cands[-MAX_CHAIN:]):
+                if pos - cand > WINDOW:
+                    break
+                n = 0
+                while n < MAX_MATCH and pos + n < len(data) and data[cand + n] == data[pos + n]:
+                    n += 1
+                if n > best_len:
+                    best_len, best_dist = n, pos - cand
+                    if n == MAX_MATCH:
+                        break
+            if best_len >= MIN_MATCH:
+                token = (best_dist - 1) | ((best_len - MIN_MATCH) << 12)
+                out += struct.pack("<H", token)
+                step = best_len
+            else:
+                out[flag_at] |= 1 << bit
+                out.append(data[pos])
+                step = 1
+            for p in range(pos, pos + step):
+                chains.setdefault(bytes(data[p:p + MIN_MATCH]), []).append(p)
+            pos += step
+    return out
+
+
+def up_to_date(src, dst):
+    if not os.path.exists(dst):
+        return False
+    newest = max(os.path.getmtime(src), os.path.getmtime(__file__))
+    return os.path.getmtime(dst) >= newest
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    if not os.path.exists(sys.argv[1]):
+        print("dsp_fw_lz.py: no %s, %s left as is" % (sys.argv[1], sys.argv[2]))
+        return
+    if up_to_date(sys.argv[1], sys.argv[2]):
+        return
+    words = read_image(sys.argv[1])
+    stream = add_block_crcs(words)
+    raw = struct.pack("<%dI" % len(stream), *stream)
+    lz = struct.pack("<II", MAGIC, len(words)) + compress(raw)
+
+    with open(sys.argv[2], "w") as f:
+        f.write("/* Generated by Tools/dsp_fw_lz.py from %s, do not edit */\n"
+                % sys.argv[1].replace("\\", "/").split("/")[-1])
+        f.write('#include "dsp_fw_image.h"\n\n')
+        f.write("/* %d bytes of firmware in %d bytes */\n" % (4 * len(words), len(lz)))
+        f.write("const uint8_t dsp_fw_image_lz[] =\n{\n")
+        for i in range(0, len(lz), 16):
+            f.write("    " + " ".join("0x%02x," % b for b in lz[i:i + 16]) + "\n")
+        f.write("};\n\nconst uint32_t dsp_fw_image_lz_length = sizeof(dsp_fw_image_lz);\n")
+
+
+if __name__ == "__main__":
+    main()